@@ -0,0 +1,168 @@
+#ifndef ARDUINO_HOST_H_
+#define ARDUINO_HOST_H_
+
+// Reemplazo mínimo de la API de Arduino para compilar el firmware
+// robotArm_v0.62sim en la PC. Solo cubre lo que usa el sketch en modo SIMULATION:
+// String, Serial, micros/millis/delay y los pines (que no hacen nada).
+
+#include <cmath>
+#include <cstdlib>
+#include <cstdint>
+#include <cstring>
+#include <cctype>
+#include <string>
+
+using std::abs;
+using std::isnan;
+using std::isinf;
+
+typedef uint8_t byte;
+
+#define HIGH 0x1
+#define LOW  0x0
+
+#define INPUT        0x0
+#define OUTPUT       0x1
+#define INPUT_PULLUP 0x2
+
+#ifndef PI
+#define PI 3.1415926535897932384626433832795
+#endif
+
+#define sq(x) ((x)*(x))
+
+inline bool isAlpha(int c) { return std::isalpha(c) != 0; }
+
+// --- String ---
+
+/// @brief Subconjunto de la clase String de Arduino sobre std::string.
+class String {
+public:
+  String(const char* text = "") : value_(text ? text : "") {}
+  String(const std::string& text) : value_(text) {}
+  explicit String(char c) : value_(1, c) {}
+  String(int number) : value_(std::to_string(number)) {}
+  String(unsigned int number) : value_(std::to_string(number)) {}
+  String(long number) : value_(std::to_string(number)) {}
+  String(unsigned long number) : value_(std::to_string(number)) {}
+  String(float number, int decimals = 2) : value_(formatDecimal(number, decimals)) {}
+  String(double number, int decimals = 2) : value_(formatDecimal(number, decimals)) {}
+
+  unsigned int length() const { return value_.size(); }
+  const char* c_str() const { return value_.c_str(); }
+
+  // Como en Arduino, un índice fuera de rango devuelve el carácter nulo.
+  char operator[](unsigned int index) const { return index < value_.size() ? value_[index] : '\0'; }
+
+  String substring(unsigned int from) const { return substring(from, value_.size()); }
+  String substring(unsigned int from, unsigned int to) const {
+    if (from > to) { unsigned int tmp = from; from = to; to = tmp; }
+    if (from >= value_.size()) { return String(); }
+    if (to > value_.size()) { to = value_.size(); }
+    return String(value_.substr(from, to - from));
+  }
+
+  long toInt() const { return std::atol(value_.c_str()); }
+  float toFloat() const { return static_cast<float>(std::atof(value_.c_str())); }
+
+  void toUpperCase() {
+    for (char& c : value_) { c = static_cast<char>(std::toupper(static_cast<unsigned char>(c))); }
+  }
+
+  void replace(const String& find, const String& replacement) {
+    if (find.value_.empty()) { return; }
+    std::string::size_type pos = 0;
+    while ((pos = value_.find(find.value_, pos)) != std::string::npos) {
+      value_.replace(pos, find.value_.size(), replacement.value_);
+      pos += replacement.value_.size();
+    }
+  }
+
+  String& operator+=(const String& other) { value_ += other.value_; return *this; }
+  String& operator+=(const char* other) { value_ += other; return *this; }
+  String& operator+=(char c) { value_ += c; return *this; }
+
+  friend String operator+(const String& a, const String& b) { return String(a.value_ + b.value_); }
+  friend String operator+(const String& a, const char* b) { return String(a.value_ + b); }
+  friend String operator+(const char* a, const String& b) { return String(a + b.value_); }
+  bool operator==(const String& other) const { return value_ == other.value_; }
+
+  const std::string& str() const { return value_; }
+
+private:
+  static std::string formatDecimal(double number, int decimals);
+  std::string value_;
+};
+
+// --- Serial ---
+
+/// @brief Puerto serie del emulador: lee y escribe el lado maestro de un pseudo-terminal.
+class HostSerial {
+public:
+  /// @brief Velocidad del firmware; solo cuenta si se modela la línea (setLineLimit()).
+  void begin(long baud) { baud_ = baud; rxNextAt_ = txNextAt_ = 0; }
+  /// @brief Las escrituras al pty ya son sincrónicas.
+  void flush() {}
+  void attach(int fd) { fd_ = fd; }
+  int available();
+  int read();
+  void print(const String& text);
+  void print(const char* text) { print(String(text)); }
+  void print(char c) { print(String(c)); }
+  void println(const String& text) { print(text); print("\r\n"); }
+  void println(const char* text = "") { println(String(text)); }
+  template <typename T> void print(T value) { print(String(value)); }
+  template <typename T> void println(T value) { println(String(value)); }
+
+  size_t write(const uint8_t* data, size_t length);
+  size_t write(uint8_t c) { return write(&c, 1); }
+
+  /// @brief Descarta lo que haya quedado sin leer (reinicio de la placa).
+  void reset() { head_ = tail_ = 0; }
+
+  /// @brief Simula ruido en la línea: invierte un bit de cada n-ésimo byte recibido (0 = sin ruido).
+  void setReadNoise(unsigned long everyNthByte) { noiseEvery_ = everyNthByte; }
+
+  /// @brief Modela la línea física: los bytes viajan a la velocidad de begin() (10 bits
+  /// por byte, en tiempo real) y por encima de maxBaud la línea no es confiable y se
+  /// corrompe uno de cada LINE_NOISE_EVERY bytes en cada sentido (0 = pty ideal).
+  void setLineLimit(long maxBaud) { maxBaud_ = maxBaud; }
+
+  static const unsigned long LINE_NOISE_EVERY = 8;
+
+private:
+  /// @brief Espera a que la línea haya podido transportar 'bytes' más desde 'nextAt'.
+  void pace(double& nextAt, size_t bytes);
+  bool lineNoisy() const { return maxBaud_ > 0 && baud_ > maxBaud_; }
+
+  int fd_ = -1;
+  unsigned char buffer_[256];
+  int head_ = 0;
+  int tail_ = 0;
+  unsigned long noiseEvery_ = 0;
+  unsigned long bytesRead_ = 0;
+  long baud_ = 0;
+  long maxBaud_ = 0;
+  unsigned long lineBytes_ = 0;
+  double rxNextAt_ = 0; // Segundos (reloj real) en que la línea queda libre en cada sentido.
+  double txNextAt_ = 0;
+};
+
+extern HostSerial Serial;
+
+// --- Tiempo (reloj virtual) ---
+
+/// @brief Factor con el que el reloj virtual avanza respecto del real (1 = tiempo real).
+void setClockScale(double scale);
+unsigned long micros();
+unsigned long millis();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+// --- Pines (sin efecto en la PC) ---
+
+inline void pinMode(int pin, int mode) { (void)pin; (void)mode; }
+inline void digitalWrite(int pin, int value) { (void)pin; (void)value; }
+inline int digitalRead(int pin) { (void)pin; return HIGH; }
+
+#endif
@@ -0,0 +1,123 @@
+#include "Arduino.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <unistd.h>
+#include <poll.h>
+
+HostSerial Serial;
+
+// --- String ---
+
+std::string String::formatDecimal(double number, int decimals) {
+  char text[64];
+  std::snprintf(text, sizeof(text), "%.*f", decimals, number);
+  return text;
+}
+
+// --- Serial ---
+
+int HostSerial::available() {
+  if (head_ == tail_ && fd_ != -1) {
+    struct pollfd pfd = {fd_, POLLIN, 0};
+    if (poll(&pfd, 1, 0) > 0 && (pfd.revents & POLLIN)) {
+      ssize_t n = ::read(fd_, buffer_, sizeof(buffer_));
+      head_ = 0;
+      tail_ = n > 0 ? static_cast<int>(n) : 0;
+    }
+  }
+  return tail_ - head_;
+}
+
+int HostSerial::read() {
+  if (available() == 0) {
+    return -1;
+  }
+  unsigned char c = buffer_[head_++];
+  if (noiseEvery_ != 0 && ++bytesRead_ % noiseEvery_ == 0) {
+    c ^= 0x10;
+  }
+  if (maxBaud_ > 0) {
+    pace(rxNextAt_, 1);
+    if (lineNoisy() && ++lineBytes_ % LINE_NOISE_EVERY == 0) {
+      c ^= 0x10;
+    }
+  }
+  return c;
+}
+
+void HostSerial::pace(double& nextAt, size_t bytes) {
+  if (baud_ <= 0) {
+    return;
+  }
+  double now = std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+  nextAt = std::max(nextAt, now) + bytes * 10.0 / baud_;
+  // Se duerme recién cuando el atraso acumulado lo justifica: dormir byte a byte
+  // a 1 Mbaud (10 us) sería más lento que la línea que se quiere modelar.
+  if (nextAt - now > 0.0002) {
+    std::this_thread::sleep_for(std::chrono::duration<double>(nextAt - now));
+  }
+}
+
+size_t HostSerial::write(const uint8_t* data, size_t length) {
+  if (fd_ == -1) {
+    return 0;
+  }
+  std::string noisy;
+  if (maxBaud_ > 0) {
+    pace(txNextAt_, length);
+    if (lineNoisy()) {
+      noisy.assign(reinterpret_cast<const char*>(data), length);
+      for (char& c : noisy) {
+        if (++lineBytes_ % LINE_NOISE_EVERY == 0) {
+          c ^= 0x10;
+        }
+      }
+      data = reinterpret_cast<const uint8_t*>(noisy.data());
+    }
+  }
+  size_t remaining = length;
+  while (remaining > 0) {
+    ssize_t n = ::write(fd_, data, remaining);
+    if (n <= 0) {
+      break; // Nadie tiene abierto el puerto: lo escrito se pierde, como en la placa.
+    }
+    data += n;
+    remaining -= static_cast<size_t>(n);
+  }
+  return length - remaining;
+}
+
+void HostSerial::print(const String& text) {
+  write(reinterpret_cast<const uint8_t*>(text.c_str()), text.length());
+}
+
+// --- Tiempo (reloj virtual) ---
+
+namespace {
+  const std::chrono::steady_clock::time_point clockStart = std::chrono::steady_clock::now();
+  double clockScale = 1.0;
+}
+
+void setClockScale(double scale) {
+  clockScale = scale > 0.0 ? scale : 1.0;
+}
+
+unsigned long micros() {
+  double realMicros = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - clockStart).count();
+  return static_cast<unsigned long>(realMicros * clockScale);
+}
+
+unsigned long millis() {
+  return micros() / 1000;
+}
+
+void delay(unsigned long ms) {
+  std::this_thread::sleep_for(std::chrono::duration<double, std::milli>(ms / clockScale));
+}
+
+void delayMicroseconds(unsigned int us) {
+  std::this_thread::sleep_for(std::chrono::duration<double, std::micro>(us / clockScale));
+}
@@ -0,0 +1,12 @@
+#ifndef SERVO_HOST_H_
+#define SERVO_HOST_H_
+
+// Servo sin hardware: servo_gripper.h declara el miembro aunque en SIMULATION no se use.
+class Servo {
+public:
+  void attach(int pin) { (void)pin; }
+  void write(int angle) { (void)angle; }
+  void detach() {}
+};
+
+#endif
@@ -0,0 +1,179 @@
+// Emulador del firmware robotArm_v0.62sim para la PC.
+//
+// Compila el sketch real (setup/loop, command, interpolation, robotGeometry, queue...)
+// contra el reemplazo de Arduino.h de este directorio y expone su puerto serie como
+// un pseudo-terminal. El servidor puede abrir ese pty en lugar de /dev/ttyUSB0.
+//
+// Uso: firmware_emulator [--speed <factor>] [--link <ruta>] [--noise <n>] [--boot-ms <ms>] [--max-baud <n>]
+//   --speed  El reloj virtual avanza <factor> veces más rápido que el real
+//            (movimientos, G28 y G4 terminan antes). Por defecto 1.
+//   --link   Crea un enlace simbólico <ruta> hacia el pty (por ejemplo /tmp/ttyRobot).
+//   --noise  Corrompe uno de cada <n> bytes recibidos, para probar el reenvío
+//            de tramas binarias (M900). Por defecto 0 (sin ruido).
+//   --boot-ms  Milisegundos (reales) que tarda el bootloader tras cada conexión, durante
+//            los cuales lo recibido se pierde, como en la placa. Por defecto 0.
+//   --max-baud  Modela la línea física: los bytes viajan a la velocidad que fijó el
+//            firmware (BAUD o M901) y por encima de <n> baudios la línea se corrompe,
+//            como un adaptador USB-serie o un cable que no la sostiene. Por defecto 0
+//            (pty ideal, sin límite de velocidad).
+
+#include <Arduino.h>
+#include "command.h"
+
+// El IDE de Arduino genera estos prototipos automáticamente a partir del .ino.
+void executeCommand(Cmd cmd);
+void setStepperEnable(bool enable);
+void homeSequence();
+void homeSequence_UNO();
+
+#include "robotArm_v0.62sim.ino"
+
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+
+namespace {
+
+std::atomic<bool> running{true};
+
+void handleSignal(int) {
+  running = false;
+}
+
+// Mientras nadie tenga abierto el lado esclavo, el maestro reporta POLLHUP.
+bool slaveIsOpen(int masterFd) {
+  struct pollfd pfd = {masterFd, POLLIN, 0};
+  poll(&pfd, 1, 0);
+  return !(pfd.revents & POLLHUP);
+}
+
+// Descarta lo que llegue durante 'ms' milisegundos: el bootloader no lo atiende.
+void runBootloader(int masterFd, int ms) {
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(ms);
+  char discard[256];
+  while (running) {
+    auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now()).count();
+    if (remaining <= 0) {
+      break;
+    }
+    struct pollfd pfd = {masterFd, POLLIN, 0};
+    if (poll(&pfd, 1, static_cast<int>(remaining)) > 0 && (pfd.revents & POLLIN)) {
+      (void)!read(masterFd, discard, sizeof(discard));
+    }
+  }
+}
+
+// Como la placa real, que se reinicia cuando el host abre el puerto (DTR),
+// el emulador arranca el sketch de cero en cada nueva conexión.
+void resetBoard(int masterFd, int bootMs) {
+  if (bootMs > 0) {
+    runBootloader(masterFd, bootMs);
+  }
+  while (!queue.isEmpty()) {
+    queue.pop();
+  }
+  command = Command();
+  Serial.reset();
+  setup();
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+  double speed = 1.0;
+  std::string linkPath;
+  unsigned long noise = 0;
+  int bootMs = 0;
+  long maxBaud = 0;
+  for (int i = 1; i + 1 < argc; i += 2) {
+    std::string option = argv[i];
+    if (option == "--speed") {
+      speed = std::atof(argv[i + 1]);
+    } else if (option == "--link") {
+      linkPath = argv[i + 1];
+    } else if (option == "--noise") {
+      noise = std::strtoul(argv[i + 1], nullptr, 10);
+    } else if (option == "--boot-ms") {
+      bootMs = std::atoi(argv[i + 1]);
+    } else if (option == "--max-baud") {
+      maxBaud = std::atol(argv[i + 1]);
+    } else {
+      std::fprintf(stderr, "Opción desconocida: %s\n", option.c_str());
+      return 1;
+    }
+  }
+  setClockScale(speed);
+
+  int masterFd = posix_openpt(O_RDWR | O_NOCTTY);
+  if (masterFd == -1 || grantpt(masterFd) != 0 || unlockpt(masterFd) != 0) {
+    std::perror("posix_openpt");
+    return 1;
+  }
+  // Sin eco ni conversión de fin de línea: si el pty devolviera el eco de lo que
+  // escribe la placa, el firmware lo leería como comandos propios.
+  struct termios tty;
+  tcgetattr(masterFd, &tty);
+  cfmakeraw(&tty);
+  tcsetattr(masterFd, TCSANOW, &tty);
+
+  std::string slaveName = ptsname(masterFd);
+
+  // Un pty que nunca se abrió no reporta POLLHUP; abrirlo y cerrarlo una vez deja
+  // al maestro en estado "colgado" hasta que el servidor lo abra de verdad.
+  int probeFd = open(slaveName.c_str(), O_RDWR | O_NOCTTY);
+  if (probeFd != -1) {
+    close(probeFd);
+  }
+  if (!linkPath.empty()) {
+    unlink(linkPath.c_str());
+    if (symlink(slaveName.c_str(), linkPath.c_str()) != 0) {
+      std::perror("symlink");
+      return 1;
+    }
+  }
+
+  std::signal(SIGINT, handleSignal);
+  std::signal(SIGTERM, handleSignal);
+  std::printf("Firmware emulado en %s (reloj x%g)\n", linkPath.empty() ? slaveName.c_str() : linkPath.c_str(), speed);
+  std::fflush(stdout);
+
+  Serial.attach(masterFd);
+  Serial.setReadNoise(noise);
+  Serial.setLineLimit(maxBaud);
+  bool connected = false;
+  while (running) {
+    if (!connected) {
+      if (slaveIsOpen(masterFd)) {
+        connected = true;
+        resetBoard(masterFd, bootMs);
+      } else {
+        usleep(5000);
+      }
+      continue;
+    }
+
+    loop();
+
+    // Sin nada que hacer, se espera la próxima entrada en lugar de girar en vacío.
+    if (queue.isEmpty() && interpolator.isFinished() && Serial.available() == 0) {
+      struct pollfd pfd = {masterFd, POLLIN, 0};
+      poll(&pfd, 1, 1);
+      if (pfd.revents & POLLHUP) {
+        connected = false;
+      }
+    }
+  }
+
+  if (!linkPath.empty()) {
+    unlink(linkPath.c_str());
+  }
+  close(masterFd);
+  return 0;
+}
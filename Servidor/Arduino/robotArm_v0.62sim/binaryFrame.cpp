@@ -0,0 +1,36 @@
+#include "binaryFrame.h"
+
+uint16_t frameCrc16(const uint8_t* data, int len) {
+  uint16_t crc = 0xFFFF;
+  for (int i = 0; i < len; i++) {
+    crc ^= (uint16_t)data[i] << 8;
+    for (int bit = 0; bit < 8; bit++) {
+      crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : (crc << 1);
+    }
+  }
+  return crc;
+}
+
+void sendFrame(uint8_t type, uint8_t seq, const uint8_t* payload, uint8_t len) {
+  uint8_t frame[FRAME_HEADER_SIZE + FRAME_MAX_PAYLOAD + 2];
+  frame[0] = FRAME_SOF;
+  frame[1] = type;
+  frame[2] = seq;
+  frame[3] = len;
+  for (int i = 0; i < len; i++) {
+    frame[FRAME_HEADER_SIZE + i] = payload[i];
+  }
+  uint16_t crc = frameCrc16(frame + 1, FRAME_HEADER_SIZE - 1 + len);
+  frame[FRAME_HEADER_SIZE + len] = crc & 0xFF;
+  frame[FRAME_HEADER_SIZE + len + 1] = crc >> 8;
+  Serial.write(frame, FRAME_HEADER_SIZE + len + 2);
+}
+
+void sendAck(uint8_t seq, bool failed) {
+  uint8_t status = failed ? 1 : 0;
+  sendFrame(FRAME_ACK, seq, &status, 1);
+}
+
+void sendNak(uint8_t seq, uint8_t reason) {
+  sendFrame(FRAME_NAK, seq, &reason, 1);
+}
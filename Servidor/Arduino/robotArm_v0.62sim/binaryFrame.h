@@ -0,0 +1,38 @@
+#ifndef BINARYFRAME_H_
+#define BINARYFRAME_H_
+
+#include <Arduino.h>
+
+//COMPACT BINARY FRAMING, ENABLED WITH M900 UNTIL THE NEXT RESET
+//FRAME: [SOF 0xA5][TYPE][SEQ][LEN][PAYLOAD: LEN BYTES][CRC16 LOW][CRC16 HIGH]
+//CRC16-CCITT (POLY 0x1021, INIT 0xFFFF) COMPUTED OVER TYPE..PAYLOAD
+//FLOATS ARE 32 BIT IEEE-754, LITTLE ENDIAN (SAME LAYOUT AS AVR AND X86)
+//MUST MATCH server/include/BinaryFraming.h
+
+#define FRAME_SOF 0xA5
+#define FRAME_HEADER_SIZE 4
+#define FRAME_MAX_PAYLOAD 64
+
+//SERVER -> FIRMWARE
+#define FRAME_MOVE 0x01     // [FLAGS][X][Y][Z][E][F] FLAGS BIT0..4 = X,Y,Z,E,F PRESENT, BIT7 = G0
+#define FRAME_MODE 0x02     // [0 = G90 ABSOLUTE, 1 = G91 RELATIVE]
+#define FRAME_EFFECTOR 0x03 // [1 = M3, 0 = M5]
+#define FRAME_MOTORS 0x04   // [1 = M17, 0 = M18]
+#define FRAME_TEXT 0x05     // ASCII G-CODE LINE WITHOUT TERMINATOR
+
+//FIRMWARE -> SERVER
+#define FRAME_ACK 0x80      // [0 = OK, 1 = ERROR] REPLACES "OK" FOR FRAMED COMMANDS
+#define FRAME_NAK 0x81      // [REASON] SEQ = NEXT EXPECTED SEQUENCE, SERVER RESENDS FROM IT
+
+#define FRAME_MOVE_PAYLOAD 21
+
+#define NAK_BAD_CRC 1
+#define NAK_OUT_OF_ORDER 2
+#define NAK_BAD_FRAME 3
+
+uint16_t frameCrc16(const uint8_t* data, int len);
+void sendFrame(uint8_t type, uint8_t seq, const uint8_t* payload, uint8_t len);
+void sendAck(uint8_t seq, bool failed);
+void sendNak(uint8_t seq, uint8_t reason);
+
+#endif
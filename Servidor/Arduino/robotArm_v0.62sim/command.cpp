@@ -11,13 +11,26 @@ Command::Command() {
   new_command.valueF = 0;
   new_command.valueE = NAN;
   new_command.valueS = 0;
+  new_command.framed = false;
+  new_command.seq = 0;
   message = "";
   isRelativeCoord = false;
+  isBinaryMode = false;
+  frameLen = 0;
+  expectedSeq = 0;
+  currentBaud = BAUD;
+  previousBaud = BAUD;
+  pendingBaud = 0;
+  baudUnconfirmed = false;
+  baudSwitchedAt = 0;
 }
 
 bool Command::handleGcode() {
   if (Serial.available()) {
     char c = Serial.read();
+    if (isBinaryMode) {
+      return handleFrameByte((uint8_t)c);
+    }
     if (c == '\n') {
        return false; 
     }
@@ -40,6 +53,7 @@ bool Command::processMessage(String msg){
   new_command.valueE = NAN;
   new_command.valueF = 0;
   new_command.valueS = 0;  
+  new_command.framed = false;
   msg.toUpperCase();
   msg.replace(" ", "");
   int active_index = 0;
@@ -84,6 +98,116 @@ void Command::value_segment(String msg_segment){
 }
 
 
+bool Command::handleFrameByte(uint8_t c) {
+  if (frameLen == 0 && c != FRAME_SOF) {
+    return false; //SKIP NOISE UNTIL THE NEXT START OF FRAME
+  }
+  frame[frameLen++] = c;
+  if (frameLen < FRAME_HEADER_SIZE) {
+    return false;
+  }
+  int len = frame[3];
+  if (len > FRAME_MAX_PAYLOAD) {
+    frameLen = 0;
+    rejectFrame(NAK_BAD_FRAME);
+    return false;
+  }
+  if (frameLen < FRAME_HEADER_SIZE + len + 2) {
+    return false;
+  }
+  frameLen = 0;
+
+  uint16_t crc = frame[FRAME_HEADER_SIZE + len] | ((uint16_t)frame[FRAME_HEADER_SIZE + len + 1] << 8);
+  if (crc != frameCrc16(frame + 1, FRAME_HEADER_SIZE - 1 + len)) {
+    rejectFrame(NAK_BAD_CRC);
+    return false;
+  }
+  //FRAMES ARE ACCEPTED STRICTLY IN ORDER (GO-BACK-N): DUPLICATES ARE DROPPED,
+  //A GAP IS REPORTED SO THE SERVER RESENDS EVERYTHING FROM expectedSeq
+  int8_t diff = (int8_t)(frame[2] - expectedSeq);
+  if (diff < 0) {
+    return false;
+  }
+  if (diff > 0) {
+    rejectFrame(NAK_OUT_OF_ORDER);
+    return false;
+  }
+  expectedSeq++;
+  return decodeFrame();
+}
+
+bool Command::decodeFrame() {
+  uint8_t seq = frame[2];
+  int len = frame[3];
+  const uint8_t* payload = frame + FRAME_HEADER_SIZE;
+
+  new_command.valueX = NAN;
+  new_command.valueY = NAN;
+  new_command.valueZ = NAN;
+  new_command.valueE = NAN;
+  new_command.valueF = 0;
+  new_command.valueS = 0;
+
+  switch (frame[1]) {
+    case FRAME_MOVE:
+      if (len == FRAME_MOVE_PAYLOAD) {
+        float values[5];
+        memcpy(values, payload + 1, sizeof(values));
+        new_command.id = 'G';
+        new_command.num = (payload[0] & 0x80) ? 0 : 1;
+        if (payload[0] & 0x01) new_command.valueX = values[0];
+        if (payload[0] & 0x02) new_command.valueY = values[1];
+        if (payload[0] & 0x04) new_command.valueZ = values[2];
+        if (payload[0] & 0x08) new_command.valueE = values[3];
+        if (payload[0] & 0x10) new_command.valueF = values[4];
+        new_command.framed = true;
+        new_command.seq = seq;
+        return true;
+      }
+      break;
+    case FRAME_MODE:
+    case FRAME_EFFECTOR:
+    case FRAME_MOTORS:
+      if (len == 1) {
+        bool on = payload[0] != 0;
+        if (frame[1] == FRAME_MODE) {
+          new_command.id = 'G';
+          new_command.num = on ? 91 : 90;
+        } else if (frame[1] == FRAME_EFFECTOR) {
+          new_command.id = 'M';
+          new_command.num = on ? 3 : 5;
+        } else {
+          new_command.id = 'M';
+          new_command.num = on ? 17 : 18;
+        }
+        new_command.framed = true;
+        new_command.seq = seq;
+        return true;
+      }
+      break;
+    case FRAME_TEXT:
+    {
+      char text[FRAME_MAX_PAYLOAD + 1];
+      memcpy(text, payload, len);
+      text[len] = '\0';
+      if (processMessage(String(text))) {
+        new_command.framed = true;
+        new_command.seq = seq;
+        return true;
+      }
+      sendAck(seq, true); //processMessage ALREADY PRINTED THE ERROR
+      return false;
+    }
+  }
+  printErr();
+  sendAck(seq, true);
+  return false;
+}
+
+void Command::rejectFrame(uint8_t reason) {
+  sendNak(expectedSeq, reason);
+}
+
 Cmd Command::getCmd() const {
   return new_command; 
 }
@@ -120,6 +244,51 @@ void Command::cmdToAbsolute(){
   Logger::logINFO("ABSOLUTE MODE ON");
 }
 
+void Command::cmdToBinary(){
+  //THE "OK" FOR M900 IS STILL TEXT, EVERYTHING RECEIVED AFTER IT MUST BE FRAMED
+  isBinaryMode = true;
+  frameLen = 0;
+  expectedSeq = 0;
+  Logger::logINFO("BINARY FRAMING V1");
+}
+
+void Command::cmdSetBaud(float baud){
+  //THE REPLY AND ITS "OK" STILL GO OUT AT THE CURRENT RATE, applyPendingBaud() SWITCHES AFTER THEM
+  long rate = (long)baud;
+  if (rate < MIN_BAUD || rate > MAX_BAUD) {
+    Logger::logERROR("UNSUPPORTED BAUD");
+    return;
+  }
+  if (rate == currentBaud) {
+    baudUnconfirmed = false; //THE HOST READ OUR "OK" AND WRITES CORRECTLY AT THIS RATE
+  } else {
+    pendingBaud = rate;
+  }
+  Logger::logINFO("BAUD " + String(rate));
+}
+
+void Command::applyPendingBaud(){
+  if (pendingBaud == 0) {
+    return;
+  }
+  Serial.flush();
+  previousBaud = currentBaud;
+  currentBaud = pendingBaud;
+  pendingBaud = 0;
+  Serial.begin(currentBaud);
+  baudUnconfirmed = true;
+  baudSwitchedAt = millis();
+}
+
+void Command::checkBaudConfirm(){
+  //NO "M901 S<SAME BAUD>" AT THE NEW RATE: THE HOST (OR THE CABLE) CAN'T KEEP UP, GO BACK SILENTLY
+  if (baudUnconfirmed && millis() - baudSwitchedAt >= BAUD_CONFIRM_MS) {
+    baudUnconfirmed = false;
+    currentBaud = previousBaud;
+    Serial.begin(currentBaud);
+  }
+}
+
 void cmdMove(Cmd(&cmd), Point pos, Point pos_offset, bool isRelativeCoord){
 
   if(isRelativeCoord == true){
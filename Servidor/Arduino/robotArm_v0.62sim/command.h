@@ -3,6 +3,7 @@
 
 #include <Arduino.h>
 #include "interpolation.h"
+#include "binaryFrame.h"
 
 struct Cmd {
   char id;
@@ -13,6 +14,8 @@ struct Cmd {
   float valueF;
   float valueE;
   float valueS; 
+  bool framed; // RECEIVED AS A BINARY FRAME, ACK WITH seq INSTEAD OF "OK"
+  uint8_t seq;
 };
 
 class Command {
@@ -25,11 +28,27 @@ class Command {
     void cmdGetPosition(Point pos, Point pos_offset, float highRad, float lowRad, float rotRad, bool onFan, bool onMotors);
     void cmdToRelative();
     void cmdToAbsolute();
+    void cmdToBinary();
+    void cmdSetBaud(float baud);
+    void applyPendingBaud();
+    void checkBaudConfirm();
     bool isRelativeCoord;
+    bool isBinaryMode;
     Cmd new_command;
 
   private: 
     String message;
+    bool handleFrameByte(uint8_t c);
+    bool decodeFrame();
+    void rejectFrame(uint8_t reason);
+    uint8_t frame[FRAME_HEADER_SIZE + FRAME_MAX_PAYLOAD + 2];
+    int frameLen;
+    uint8_t expectedSeq;
+    long currentBaud;
+    long previousBaud;
+    long pendingBaud;
+    bool baudUnconfirmed;
+    unsigned long baudSwitchedAt;
 };
 
 void cmdMove(Cmd(&cmd), Point pos, Point pos_offset, bool isRelativeCoord);
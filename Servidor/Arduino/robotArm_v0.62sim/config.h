@@ -3,6 +3,9 @@
 
 //SERIAL SETTINGS
 #define BAUD 115200
+#define MIN_BAUD 1200 // RANGE ACCEPTED BY M901 S<BAUD>
+#define MAX_BAUD 2000000 // 2M IS THE FASTEST EXACT RATE OF A 16MHZ ATMEGA (U2X)
+#define BAUD_CONFIRM_MS 1000 // M901: FALL BACK TO THE PREVIOUS RATE IF NOT CONFIRMED IN TIME
 
 //MEGA2560 BY DEFAULT, SET TO true IF UNO & CNC SHILED USED TO DRIVE ROBOT
 #define USE_UNO false
@@ -1,6 +1,8 @@
 #include "logger.h"
 #include "config.h"
 
+unsigned int Logger::errorCount = 0;
+
 void Logger::log(String message, int level) {
   if(LOG_LEVEL >= level) {
     String logMsg;
@@ -21,6 +23,7 @@ void Logger::log(String message, int level) {
   }
 }
 void Logger::logERROR(String message) {
+  errorCount++;
   log(message, LOG_ERROR);
 }
 void Logger::logINFO(String message) {
@@ -13,5 +13,6 @@ class Logger {
     static void logINFO(String message);
     static void logERROR(String message);
     static void logDEBUG(String message);
+    static unsigned int errorCount; // ERRORS LOGGED SO FAR, TELLS A FAILED COMMAND APART IN ITS ACK
 };
 #endif
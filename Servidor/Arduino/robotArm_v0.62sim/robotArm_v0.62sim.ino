@@ -14,6 +14,8 @@
 //V0.62sim ADAPTED FOR SIMULATION
 //      NON-FUNCTIONAL
 //      FOR Puma3D (Cesar Aranda)
+//V0.62sim+bin WITH OPTIONAL BINARY FRAMING (M900): SEQUENCE NUMBERS, CRC16, ACK/NAK
+//      BAUD RATE SWITCH (M901 S<BAUD>) WITH FALLBACK IF THE NEW RATE IS NOT CONFIRMED
 
 #include "config.h"
 
@@ -152,16 +154,22 @@ void loop() {
   }
   fan.update();
 
+  command.checkBaudConfirm();
   if (!queue.isFull()) {
     if (command.handleGcode()) {
       queue.push(command.getCmd());
     }
   }
   if ((!queue.isEmpty()) && interpolator.isFinished()) {
-    executeCommand(queue.pop());
-    if (PRINT_REPLY) {
+    Cmd cmd = queue.pop();
+    unsigned int errorsBefore = Logger::errorCount;
+    executeCommand(cmd);
+    if (cmd.framed) {
+      sendAck(cmd.seq, Logger::errorCount != errorsBefore);
+    } else if (PRINT_REPLY) {
       Serial.println(PRINT_REPLY_MSG);
     }
+    command.applyPendingBaud();
   }
   
 //  if (millis() % 500 < 250) {
@@ -188,7 +196,9 @@ void executeCommand(Cmd cmd) {
       posoffset = interpolator.getPosOffset();      
       cmdMove(cmd, interpolator.getPosmm(), posoffset, command.isRelativeCoord);
       interpolator.setInterpolation(cmd.valueX, cmd.valueY, cmd.valueZ, cmd.valueE, cmd.valueF);
-      Logger::logINFO("LINEAR MOVE: [X:" + String(cmd.valueX-posoffset.xmm) + " Y:" + String(cmd.valueY-posoffset.ymm) + " Z:" + String(cmd.valueZ-posoffset.zmm) + " E:" + String(cmd.valueE-posoffset.emm) + "]");
+      if (!cmd.framed) { //THE ACK FRAME ALREADY CONFIRMS THE MOVE
+        Logger::logINFO("LINEAR MOVE: [X:" + String(cmd.valueX-posoffset.xmm) + " Y:" + String(cmd.valueY-posoffset.ymm) + " Z:" + String(cmd.valueZ-posoffset.zmm) + " E:" + String(cmd.valueE-posoffset.emm) + "]");
+      }
       break;
     case 4: 
       cmdDwell(cmd); 
@@ -270,6 +280,8 @@ void executeCommand(Cmd cmd) {
     case 114: 
       command.cmdGetPosition(interpolator.getPosmm(), interpolator.getPosOffset(), stepperHigher.getPosition(), stepperLower.getPosition(), stepperRotate.getPosition(), fan.getState(), stepperRotate.getState()); 
       break;// Return the current positions of all axis and other info
+    case 900: command.cmdToBinary(); break; // SWITCH TO BINARY FRAMING
+    case 901: command.cmdSetBaud(cmd.valueS); break; // SWITCH BAUD RATE AFTER THE "OK", CONFIRM WITH THE SAME RATE
     case 119:
     {
       String endstopMsg = "ENDSTOP: [X:";
@@ -126,9 +126,11 @@ void CLIHandlerNamespace::CLIHandler::displayMenuAdmin() {
     std::cout << "+-----------------------------------------------------------------------------------------+" << std::endl;
     std::cout << "| Comandos de Información y Salida:                                                       |" << std::endl;
     std::cout << "|   estado                        - Muestra el estado actual del robot.                   |" << std::endl;
+    std::cout << "|   robots                        - Lista los brazos del servidor con su estado.          |" << std::endl;
     std::cout << "|   reporte                       - Muestra un reporte de actividad.                      |" << std::endl;
     std::cout << "|   report_admin [filtro] [val]   - Muestra reporte admin con filtros usuario, resultado. |" << std::endl;
     std::cout << "|   report_log   [filtro] [val]   - Muestra reporte log con filtros usuario, nivel.       |" << std::endl;
+    std::cout << "|   link_stats [reset]            - Latencias y contadores del enlace serie.              |" << std::endl;
     std::cout << "|   ayuda                         - Muestra esta ayuda.                                   |" << std::endl;
     std::cout << "|   salir                         - Cierra la consola.                                    |" << std::endl;
     std::cout << "+-----------------------------------------------------------------------------------------+" << std::endl;
@@ -155,6 +157,7 @@ void CLIHandlerNamespace::CLIHandler::displayMenuOperator() {
     std::cout << "+--------------------------------------------------------------------------------+" << std::endl;
     std::cout << "| Comandos de Información y Salida:                                              |" << std::endl;
     std::cout << "|   estado                    - Muestra el estado actual del robot.              |" << std::endl;
+    std::cout << "|   robots                    - Lista los brazos del servidor con su estado.     |" << std::endl;
     std::cout << "|   reporte                   - Muestra un reporte de actividad.                 |" << std::endl;
     std::cout << "|   ayuda                     - Muestra esta ayuda.                              |" << std::endl;
     std::cout << "|   salir                     - Cierra la consola.                               |" << std::endl;
@@ -301,6 +304,34 @@ void CLIHandlerNamespace::CLIHandler::processCommand(const std::string& full_com
             std::cout << "Posición Actual: (" << std::fixed << std::setprecision(2) << posX << ", " << posY << ", " << posZ << ")" << std::endl;
             std::cout << "---------------------------------" << std::endl;
 
+        } else if (command == "robots") {
+            rpcClient.call(serverUrl, "robot.listRobots", "s", &result, token.c_str());
+
+            xmlrpc_c::value_array const robotsArray(result);
+            std::vector<xmlrpc_c::value> const robotsVector(robotsArray.vectorValueValue());
+
+            std::cout << "\n--- Brazos del Servidor ---" << std::endl;
+            std::cout << std::left << std::setw(14) << "ID" << std::setw(28) << "Puerto"
+                      << std::setw(12) << "Conectado" << std::setw(16) << "Estado" << "Posición" << std::endl;
+            std::cout << std::string(100, '-') << std::endl;
+            for (const auto& robotValue : robotsVector) {
+                std::map<std::string, xmlrpc_c::value> const robotMap{xmlrpc_c::value_struct(robotValue)};
+                std::map<std::string, xmlrpc_c::value> const posMap{xmlrpc_c::value_struct(robotMap.at("position"))};
+                std::string id = xmlrpc_c::value_string(robotMap.at("id"));
+                if (xmlrpc_c::value_boolean(robotMap.at("isDefault"))) {
+                    id += " *";
+                }
+                std::cout << std::left << std::setw(14) << id
+                          << std::setw(28) << xmlrpc_c::value_string(robotMap.at("port")).cvalue()
+                          << std::setw(12) << (xmlrpc_c::value_boolean(robotMap.at("isConnected")) ? "Sí" : "No")
+                          << std::setw(16) << xmlrpc_c::value_string(robotMap.at("activityState")).cvalue()
+                          << "(" << std::fixed << std::setprecision(2)
+                          << xmlrpc_c::value_double(posMap.at("x")).cvalue() << ", "
+                          << xmlrpc_c::value_double(posMap.at("y")).cvalue() << ", "
+                          << xmlrpc_c::value_double(posMap.at("z")).cvalue() << ")" << std::endl;
+            }
+            std::cout << std::string(100, '-') << std::endl;
+            std::cout << "(*) Brazo por defecto." << std::endl;
         } else if (command == "ayuda") {
             rpcClient.call(serverUrl, "robot.help", "s", &result, token.c_str());
             
@@ -447,6 +478,53 @@ void CLIHandlerNamespace::CLIHandler::processCommand(const std::string& full_com
                 }
             }
             std::cout << std::string(107, '-') << std::endl;
+        } else if (command == "link_stats") {
+            if (!isAdmin) {
+                std::cout << "[CLI] Error: Permiso denegado. Solo los administradores pueden usar 'link_stats'." << std::endl;
+                return;
+            }
+            std::string option;
+            ss >> option;
+            if (option == "reset") {
+                rpcClient.call(serverUrl, "robot.getLinkStats", "sb", &result, token.c_str(), true);
+            } else {
+                rpcClient.call(serverUrl, "robot.getLinkStats", "s", &result, token.c_str());
+            }
+
+            std::map<std::string, xmlrpc_c::value> const statsMap{xmlrpc_c::value_struct(result)};
+            std::vector<xmlrpc_c::value> const familiesVector(xmlrpc_c::value_array(statsMap.at("families")).vectorValueValue());
+
+            std::cout << "\n--- Estadísticas del Enlace Serie ---" << std::endl;
+            std::cout << "Comandos: " << xmlrpc_c::value_i8(statsMap.at("commands")).cvalue()
+                      << " | Bytes enviados: " << xmlrpc_c::value_i8(statsMap.at("bytesSent")).cvalue()
+                      << " | Bytes recibidos: " << xmlrpc_c::value_i8(statsMap.at("bytesReceived")).cvalue()
+                      << " | Timeouts: " << xmlrpc_c::value_i8(statsMap.at("timeouts")).cvalue()
+                      << " | Errores: " << xmlrpc_c::value_i8(statsMap.at("errors")).cvalue() << std::endl;
+            std::cout << std::left << std::setw(10) << "Familia"
+                      << std::setw(10) << "Cantidad"
+                      << std::setw(10) << "Errores"
+                      << std::setw(10) << "Timeouts"
+                      << std::setw(12) << "p50 (ms)"
+                      << std::setw(12) << "p90 (ms)"
+                      << std::setw(12) << "p99 (ms)"
+                      << std::setw(12) << "máx (ms)" << std::endl;
+            std::cout << std::string(88, '-') << std::endl;
+            for (const auto& familyValue : familiesVector) {
+                std::map<std::string, xmlrpc_c::value> const familyMap{xmlrpc_c::value_struct(familyValue)};
+                std::cout << std::left << std::fixed << std::setprecision(2)
+                          << std::setw(10) << xmlrpc_c::value_string(familyMap.at("family")).cvalue()
+                          << std::setw(10) << xmlrpc_c::value_i8(familyMap.at("count")).cvalue()
+                          << std::setw(10) << xmlrpc_c::value_i8(familyMap.at("errors")).cvalue()
+                          << std::setw(10) << xmlrpc_c::value_i8(familyMap.at("timeouts")).cvalue()
+                          << std::setw(12) << xmlrpc_c::value_double(familyMap.at("p50Ms")).cvalue()
+                          << std::setw(12) << xmlrpc_c::value_double(familyMap.at("p90Ms")).cvalue()
+                          << std::setw(12) << xmlrpc_c::value_double(familyMap.at("p99Ms")).cvalue()
+                          << std::setw(12) << xmlrpc_c::value_double(familyMap.at("maxMs")).cvalue() << std::endl;
+            }
+            std::cout << std::string(88, '-') << std::endl;
+            if (option == "reset") {
+                std::cout << "Contadores reiniciados." << std::endl;
+            }
         } else if (command == "lista_tareas") {
             rpcClient.call(serverUrl, "robot.listTasks", "s", &result, token.c_str());
 
@@ -5,7 +5,7 @@
 #include <string>
 #include <vector>
 #include "DatabaseManager.h"
-#include <optional>
+#include <memory>
 
 #include "User.h"
 #include "SessionManager.h"
@@ -42,7 +42,8 @@ public:
 
   std::string login(const std::string& username, const std::string& password, const std::string& clientIp);
   void logout(const std::string& token);
-  std::optional<UserNamespace::User> validateToken(const std::string& token) const;
+  /// @brief Usuario de la sesión, compartido con la tabla de sesiones; nullptr si el token no es válido.
+  std::shared_ptr<const UserNamespace::User> validateToken(const std::string& token) const;
 
 
   std::map<std::string, std::pair<UserNamespace::User, std::string>> getActiveUsersWithIPs();
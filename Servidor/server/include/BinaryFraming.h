@@ -0,0 +1,78 @@
+#ifndef BINARYFRAMING_H
+#define BINARYFRAMING_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace ComunicatorPort {
+
+/// @brief Protocolo binario opcional entre el servidor y el firmware.
+/// Se negocia al conectar enviando M900: si el firmware responde "BINARY FRAMING V1",
+/// todo lo que se le envía a partir de su "OK" viaja en tramas de la forma
+///   [0xA5][tipo][secuencia][largo][carga útil][CRC16 bajo][CRC16 alto]
+/// con CRC16-CCITT (polinomio 0x1021, inicial 0xFFFF) sobre tipo..carga útil.
+/// Los movimientos, el modo de coordenadas, el efector y los motores tienen tramas de
+/// tamaño fijo; el resto del G-Code viaja como texto dentro de una trama.
+/// El firmware confirma cada comando con una trama ACK (en lugar de "OK") y pide
+/// reenvío con una trama NAK que indica la secuencia que espera (go-back-N).
+/// Las líneas "INFO:"/"ERROR:" siguen llegando como texto, antes del ACK.
+/// Debe coincidir con Arduino/robotArm_v0.62sim/binaryFrame.h.
+namespace Framing {
+
+constexpr std::uint8_t SOF = 0xA5;
+constexpr std::size_t HEADER_SIZE = 4;
+constexpr std::size_t CRC_SIZE = 2;
+constexpr std::size_t MAX_PAYLOAD = 64;
+
+/// @brief Tipos de trama. Los menores a 0x80 van al firmware; el resto vuelven de él.
+enum FrameType : std::uint8_t {
+    MOVE = 0x01,     // [flags][X][Y][Z][E][F] (float32); flags bit0..4 = ejes presentes, bit7 = G0.
+    MODE = 0x02,     // [0 = G90, 1 = G91]
+    EFFECTOR = 0x03, // [1 = M3, 0 = M5]
+    MOTORS = 0x04,   // [1 = M17, 0 = M18]
+    TEXT = 0x05,     // Línea de G-Code sin terminador.
+    ACK = 0x80,      // [0 = OK, 1 = ERROR]
+    NAK = 0x81       // [motivo]; la secuencia es la próxima que espera el firmware.
+};
+
+constexpr std::size_t MOVE_PAYLOAD = 1 + 5 * sizeof(float);
+
+/// @brief Comando con el que se pide el modo binario y texto con el que el firmware lo acepta.
+constexpr const char* NEGOTIATE_COMMAND = "M900\r\n";
+constexpr const char* NEGOTIATE_REPLY = "BINARY FRAMING V1";
+
+/// @brief Una trama decodificada.
+struct Frame {
+    std::uint8_t type = 0;
+    std::uint8_t seq = 0;
+    std::string payload;
+};
+
+enum class DecodeStatus {
+    Incomplete, // Faltan bytes para completar la trama.
+    Ok,         // Trama válida.
+    Corrupt     // Largo imposible o CRC incorrecto: hay que descartar el byte de inicio.
+};
+
+/// @brief CRC16-CCITT (0x1021, inicial 0xFFFF).
+std::uint16_t crc16(const std::uint8_t* data, std::size_t length);
+
+/// @brief Arma una trama completa con su CRC.
+std::string buildFrame(std::uint8_t type, std::uint8_t seq, const std::string& payload);
+
+/// @brief Traduce una línea de G-Code a la trama más compacta que la representa.
+/// @param gcode El comando (con o sin "\r\n").
+/// @param seq Número de secuencia de la trama.
+/// @param frame Recibe la trama lista para escribir.
+/// @return False si la línea está vacía o no cabe en una trama de texto.
+bool encodeCommand(const std::string& gcode, std::uint8_t seq, std::string& frame);
+
+/// @brief Intenta decodificar una trama que empieza en buffer[offset] (que debe ser SOF).
+/// @param size Recibe el largo total de la trama cuando el resultado es Ok.
+DecodeStatus decodeFrame(const std::string& buffer, std::size_t offset, Frame& frame, std::size_t& size);
+
+} // namespace Framing
+} // namespace ComunicatorPort
+
+#endif // BINARYFRAMING_H
@@ -0,0 +1,57 @@
+#ifndef GCODEOPTIMIZER_H
+#define GCODEOPTIMIZER_H
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace GCodeNamespace {
+
+/// @brief Una línea del programa optimizado y el tramo de líneas originales que reemplaza.
+struct OptimizedLine {
+  std::string command;
+  std::size_t firstSource = 0; // Índice (base 0) de la primera línea original que representa.
+  std::size_t lastSource = 0;  // Índice de la última; igual a firstSource si no se fusionó nada.
+};
+
+/// @brief Resultado de optimizar una tarea.
+struct OptimizedProgram {
+  std::vector<OptimizedLine> lines;
+  std::size_t sourceLines = 0; // Largo del programa original.
+
+  /// @brief Las líneas a enviar al firmware, en orden.
+  std::vector<std::string> commands() const;
+
+  /// @brief "línea 7" o "líneas 3-7" (base 1) de la línea optimizada 'index'.
+  std::string describeSource(std::size_t index) const;
+};
+
+/// @brief Optimizador "de mirilla" del G-Code de las tareas: recorre el programa una vez
+/// siguiendo el estado modal que puede deducir y elimina lo que no cambia nada en el brazo.
+///  - G90/G91 que repiten el modo vigente, y M3/M5 que repiten el estado del efector.
+///  - Movimientos de largo cero, incluidos los G1 con solo F: en este firmware F no es
+///    modal (vale solo para su propio movimiento), así que un cambio de velocidad suelto
+///    no tiene efecto.
+///  - Líneas vacías y comentarios.
+/// Además fusiona movimientos consecutivos colineales en el mismo sentido, con el mismo
+/// código (G0/G1) y la misma F explícita (de al menos MIN_MERGE_FEED), en un único movimiento
+/// hasta el último destino. Sin F el firmware elige la velocidad según el largo del tramo
+/// (sqrt(dist) * 10), así que fusionarlos cambiaría la velocidad del movimiento.
+/// El estado inicial se considera desconocido (la tarea puede empezar en cualquier modo
+/// y posición), y cualquier comando que no entiende (G28, G92...) lo vuelve a desconocido.
+class GCodeOptimizer {
+public:
+  /// @brief Desvío máximo (mm) de un tramo respecto de la recta del anterior para fusionarlos.
+  static constexpr double COLLINEAR_TOLERANCE_MM = 0.001;
+
+  /// @brief F mínima para fusionar: por debajo de 5 el firmware también usa sqrt(dist) * 10.
+  static constexpr double MIN_MERGE_FEED = 5.0;
+
+  /// @brief Optimiza un programa.
+  /// @param gcode Las líneas tal como están guardadas en la tarea.
+  static OptimizedProgram optimize(const std::vector<std::string>& gcode);
+};
+
+} // namespace GCodeNamespace
+
+#endif // GCODEOPTIMIZER_H
@@ -2,9 +2,38 @@
 #define ISERIALCOMMUNICATOR_H
 
 #include <string>
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <thread>
 
 namespace ComunicatorPort {
 
+/// @brief Respuesta del firmware a un comando enviado con submit().
+struct SerialReply {
+    std::string text;     // Líneas recibidas, incluida la terminal ("OK"/"ERROR").
+    bool complete = false; // True si llegó la línea terminal antes del tiempo límite.
+    bool error = false;    // True si alguna línea empieza con "ERROR".
+    std::chrono::steady_clock::time_point sentAt;     // Momento en que se escribió el comando.
+    std::chrono::steady_clock::time_point receivedAt; // Momento en que se completó la respuesta.
+    std::size_t wireBytesSent = 0;     // Bytes escritos en el puerto (0 si el comunicador no los mide).
+    std::size_t wireBytesReceived = 0; // Bytes leídos del puerto para esta respuesta.
+};
+
+/// @brief Resultado del saludo inicial con el firmware (ver waitForFirmware()).
+struct HandshakeResult {
+    bool ready = false;      // El firmware respondió antes del tiempo límite.
+    bool bannerSeen = false; // Llegó el mensaje de arranque; si no, respondió a un sondeo.
+    int probes = 0;          // Sondeos M114 enviados.
+    std::chrono::milliseconds elapsed{0};
+};
+
+/// @brief Se invoca con la respuesta, o con una excepción si el puerto falló.
+using ReplyCallback = std::function<void(const SerialReply& reply, std::exception_ptr error)>;
+
 class ISerialCommunicator {
 public:
     virtual ~ISerialCommunicator() = default;
@@ -15,8 +44,92 @@ public:
     virtual void cleanBuffer() = 0;
     virtual void close() = 0;
     virtual bool isConfigured() const = 0;
+
+    /// @brief Encola un comando y entrega su respuesta al callback cuando esté completa.
+    /// La implementación por defecto es sincrónica (sendMessage + reciveMessage en el
+    /// hilo llamador); SerialComunicator la reemplaza por su hilo dedicado de E/S.
+    /// @param command El comando a enviar, con su terminador ("\r\n").
+    /// @param callback Recibe la respuesta o la excepción producida.
+    /// @param time Tiempo máximo de espera de la respuesta, en segundos.
+    virtual void submitAsync(const std::string& command, ReplyCallback callback, int time = 2) {
+        SerialReply reply;
+        try {
+            reply.sentAt = std::chrono::steady_clock::now();
+            sendMessage(command);
+            reply.text = reciveMessage(time);
+            reply.receivedAt = std::chrono::steady_clock::now();
+            reply.complete = reply.text.find("OK") != std::string::npos || reply.text.find("ERROR") != std::string::npos;
+            reply.error = reply.text.find("ERROR") != std::string::npos;
+        } catch (...) {
+            callback(reply, std::current_exception());
+            return;
+        }
+        callback(reply, nullptr);
+    }
+
+    /// @brief Pide al firmware el protocolo binario con tramas (ver BinaryFraming.h).
+    /// Se llama justo después de conectar, sin otros comandos en curso.
+    /// @return True si el firmware lo aceptó; false si se sigue en modo texto.
+    virtual bool enableBinaryFraming(int time = 2) {
+        (void)time;
+        return false;
+    }
+
+    /// @brief Cambia la velocidad del enlace ya abierto (M901 en el firmware) y la confirma
+    /// repitiendo M901 a la nueva velocidad; sin esa confirmación el firmware vuelve solo a
+    /// la velocidad anterior al cabo de BAUD_CONFIRM_MS. Se llama después de
+    /// waitForFirmware() y antes de negociar el protocolo binario, sin comandos en curso.
+    /// @return True si el enlace quedó funcionando a 'speed'. Si es false después de que el
+    /// firmware aceptó el cambio, el estado del enlace es incierto: hay que reabrir el
+    /// puerto (lo que reinicia la placa a su velocidad de arranque).
+    virtual bool changeBaudRate(int speed, int time = 2) {
+        (void)speed;
+        (void)time;
+        return false;
+    }
+
+    /// @brief Velocidad actual del enlace en baudios (0 si el comunicador no la conoce).
+    virtual int getBaudRate() const {
+        return 0;
+    }
+
+    /// @brief Espera a que el firmware termine de arrancar después de abrir el puerto
+    /// y deja el buffer de entrada vacío. Se llama justo después de config().
+    /// La implementación por defecto es la espera fija de siempre seguida de cleanBuffer();
+    /// SerialComunicator la reemplaza por un saludo que termina apenas el firmware responde.
+    /// @param banner Texto de la línea con la que el firmware avisa que arrancó.
+    /// @param timeout Tiempo máximo de espera.
+    virtual HandshakeResult waitForFirmware(const std::string& banner, std::chrono::milliseconds timeout) {
+        (void)banner;
+        HandshakeResult result;
+        result.elapsed = std::min(timeout, std::chrono::milliseconds(2000));
+        std::this_thread::sleep_for(result.elapsed);
+        cleanBuffer();
+        result.ready = true;
+        return result;
+    }
+
+    /// @brief True si el comunicador detectó que el enlace se cortó (puerto colgado o
+    /// error de E/S). Se vuelve a false al reabrir el puerto con config().
+    virtual bool linkLost() const {
+        return false;
+    }
+
+    /// @brief Versión de submitAsync que devuelve un std::future con la respuesta.
+    std::future<SerialReply> submit(const std::string& command, int time = 2) {
+        auto promise = std::make_shared<std::promise<SerialReply>>();
+        std::future<SerialReply> future = promise->get_future();
+        submitAsync(command, [promise](const SerialReply& reply, std::exception_ptr error) {
+            if (error) {
+                promise->set_exception(error);
+            } else {
+                promise->set_value(reply);
+            }
+        }, time);
+        return future;
+    }
 };
 
 } // namespace ComunicatorPort
 
-#endif // ISERIALCOMMUNICATOR_H
\ No newline at end of file
+#endif // ISERIALCOMMUNICATOR_H
@@ -0,0 +1,65 @@
+#ifndef LINKBENCHMARK_H
+#define LINKBENCHMARK_H
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+#include "ISerialCommunicator.h"
+
+namespace ComunicatorPort {
+
+/// @brief Rendimiento del enlace medido a una velocidad.
+struct ThroughputSample {
+    int baudRate = 0;
+    bool stable = false;      // Todas las respuestas llegaron completas y bien formadas.
+    std::size_t commands = 0; // Comandos enviados en la ráfaga.
+    std::size_t failures = 0; // Respuestas incompletas, con ERROR o ilegibles.
+    double seconds = 0;
+    double commandsPerSecond = 0;
+    double bytesSentPerSecond = 0;     // Servidor -> firmware.
+    double bytesReceivedPerSecond = 0; // Firmware -> servidor.
+};
+
+/// @brief Resultado de buscar la velocidad más rápida estable.
+struct BaudSelection {
+    int baudRate = 0;                     // Velocidad con la que quedó el enlace.
+    std::vector<ThroughputSample> samples; // Una por velocidad probada, en el orden en que se probaron.
+};
+
+/// @brief Mide el rendimiento real del enlace serie y elige la velocidad a usar.
+/// La medición es una ráfaga de M114 encolados a la vez (el hilo de E/S los escribe
+/// hasta llenar la cola del firmware), así que cuenta tanto lo que tarda la línea en
+/// transportar comandos y respuestas como lo que tarda el firmware en atenderlos.
+/// Se usa al conectar, antes de negociar el protocolo binario y sin otros comandos en curso.
+class LinkBenchmark {
+public:
+    static constexpr std::size_t DEFAULT_COMMANDS = 100;
+
+    /// @brief Una velocidad mayor solo reemplaza a la elegida si rinde al menos esta
+    /// proporción más: si el cuello de botella es el firmware, no vale perder margen.
+    static constexpr double MIN_GAIN = 1.05;
+
+    /// @brief Velocidades que se prueban por defecto: las que un ATmega a 16 MHz genera
+    /// con poco error (250000, 500000 y 1000000 son exactas) y que el puerto admite.
+    static std::vector<int> defaultCandidates();
+
+    explicit LinkBenchmark(ISerialCommunicator& communicator, std::size_t commandsPerRate = DEFAULT_COMMANDS);
+
+    /// @brief Mide el enlace a la velocidad actual.
+    ThroughputSample measure();
+
+    /// @brief Prueba los candidatos de menor a mayor a partir de la velocidad actual y deja
+    /// el enlace en la más rápida estable. La prueba se detiene en la primera velocidad que
+    /// falla, porque la línea que no sostiene una velocidad tampoco sostiene las mayores.
+    /// @param reopen Vuelve a abrir el enlace a la velocidad de arranque (reinicia la placa);
+    /// se usa cuando una velocidad falla y el estado del enlace quedó incierto.
+    BaudSelection selectFastest(const std::vector<int>& candidates, const std::function<void()>& reopen);
+
+private:
+    ISerialCommunicator& communicator_;
+    std::size_t commandsPerRate_;
+};
+
+} // namespace ComunicatorPort
+
+#endif // LINKBENCHMARK_H
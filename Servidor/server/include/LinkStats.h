@@ -0,0 +1,118 @@
+#ifndef LINKSTATS_H
+#define LINKSTATS_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "ISerialCommunicator.h"
+
+namespace ComunicatorPort {
+
+/// @brief Histograma de latencias sin bloqueos, con cubetas log-lineales al estilo HDR.
+/// Los valores (en microsegundos) menores a 32 tienen su propia cubeta; los mayores
+/// se agrupan por potencia de dos en 16 sub-cubetas, con un error relativo máximo
+/// de ~6%. Registrar un valor es un fetch_add relajado: se puede llamar desde
+/// cualquier hilo sin coordinación.
+class LatencyHistogram {
+public:
+    LatencyHistogram();
+
+    /// @brief Registra una muestra.
+    void record(std::uint64_t micros);
+
+    /// @brief Valor (en microsegundos) por debajo del cual queda la fracción 'quantile' de las muestras.
+    /// @param quantile Entre 0 y 1 (p. ej. 0.99).
+    std::uint64_t percentile(double quantile) const;
+
+    std::uint64_t count() const { return count_.load(std::memory_order_relaxed); }
+    std::uint64_t max() const { return max_.load(std::memory_order_relaxed); }
+
+    /// @brief Vuelve todas las cubetas a cero. Las muestras concurrentes pueden conservarse o no.
+    void reset();
+
+    static constexpr int SUB_BUCKETS = 16;
+    static constexpr int BUCKET_COUNT = 32 + 27 * SUB_BUCKETS; // Hasta 2^32 us (~71 minutos).
+
+private:
+    static int bucketFor(std::uint64_t micros);
+    static std::uint64_t bucketUpperBound(int bucket);
+
+    std::array<std::atomic<std::uint64_t>, BUCKET_COUNT> buckets_;
+    std::atomic<std::uint64_t> count_{0};
+    std::atomic<std::uint64_t> max_{0};
+};
+
+/// @brief Resumen de una familia de comandos para reportar.
+struct CommandFamilyStats {
+    std::string family;        // "G1", "M114", ...
+    std::uint64_t count = 0;   // Respuestas completas medidas.
+    std::uint64_t errors = 0;  // Respuestas con línea "ERROR".
+    std::uint64_t timeouts = 0; // Comandos sin respuesta a tiempo.
+    double p50Ms = 0;
+    double p90Ms = 0;
+    double p99Ms = 0;
+    double maxMs = 0;
+};
+
+/// @brief Totales del enlace serie y latencias envío→OK por familia de comando.
+struct LinkStatsSnapshot {
+    std::uint64_t commands = 0;
+    std::uint64_t bytesSent = 0;
+    std::uint64_t bytesReceived = 0;
+    std::uint64_t timeouts = 0;
+    std::uint64_t errors = 0;
+    std::vector<CommandFamilyStats> families; // Solo las familias con actividad.
+};
+
+/// @brief Estadísticas del enlace serie de un robot. Todas las operaciones de registro
+/// son sin bloqueos; los histogramas de cada familia se crean la primera vez que se usan.
+class LinkStats {
+public:
+    LinkStats();
+    ~LinkStats();
+
+    LinkStats(const LinkStats&) = delete;
+    LinkStats& operator=(const LinkStats&) = delete;
+
+    /// @brief Registra el resultado de un comando enviado con submit().
+    /// @param command El comando tal como se envió (con su terminador).
+    void record(const std::string& command, const SerialReply& reply);
+
+    /// @brief Cuenta un comando que no obtuvo respuesta (tiempo agotado o puerto caído).
+    void recordTimeout(const std::string& command);
+
+    LinkStatsSnapshot snapshot() const;
+    void reset();
+
+    /// @brief Familia de un comando: letra y número en mayúsculas ("g1 x10" -> "G1").
+    static std::string familyOf(const std::string& command);
+
+private:
+    // Una ranura por cada G0..G127 y M0..M127, y una última para el resto.
+    static constexpr int CODES_PER_LETTER = 128;
+    static constexpr int OTHER_SLOT = 2 * CODES_PER_LETTER;
+    static constexpr int SLOT_COUNT = OTHER_SLOT + 1;
+
+    struct FamilySlot {
+        LatencyHistogram latency;
+        std::atomic<std::uint64_t> errors{0};
+        std::atomic<std::uint64_t> timeouts{0};
+    };
+
+    static int slotFor(const std::string& command);
+    static std::string slotName(int slot);
+    FamilySlot& slot(int index);
+
+    std::array<std::atomic<FamilySlot*>, SLOT_COUNT> slots_;
+    std::atomic<std::uint64_t> commands_{0};
+    std::atomic<std::uint64_t> bytesSent_{0};
+    std::atomic<std::uint64_t> bytesReceived_{0};
+    std::atomic<std::uint64_t> timeouts_{0};
+    std::atomic<std::uint64_t> errors_{0};
+};
+
+} // namespace ComunicatorPort
+
+#endif // LINKSTATS_H
@@ -0,0 +1,200 @@
+#ifndef LOGSCANNER_H
+#define LOGSCANNER_H
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/// @brief Una línea del log partida en campos, sin copiar: apunta al texto escaneado.
+/// Los campos se separan por comas, como siempre lo hizo el reporte: fecha, nivel, mensaje,
+/// usuario y, en el último, el resto de la línea. Los que faltan quedan vacíos.
+struct LogRow {
+    std::string_view timestamp;
+    std::string_view level;
+    std::string_view message;
+    std::string_view user;
+    std::string_view node;
+    std::uint64_t offset = 0;  // Dónde empieza la línea
+    std::uint32_t length = 0;  // Bytes de la línea, con el '\n' si lo tiene
+};
+
+///
+/// class LogScanner
+///
+/// Recorre un archivo de log mapeado en memoria (mmap) sin copiarlo. Los saltos de línea y las
+/// comas se buscan de a 64 bytes con SSE2 (una máscara de bits por carácter) y las filas se
+/// entregan como string_view: quien filtra compara sin reservar memoria y arma strings solo
+/// para las filas que se queda. Un archivo grande se reparte por trozos entre varios hilos.
+
+class LogScanner
+{
+public:
+    /// @brief Tamaño mínimo del trozo de cada hilo: con menos, no conviene repartir.
+    static constexpr std::size_t MIN_CHUNK_BYTES = 8 * 1024 * 1024;
+
+    /// @brief Mapea el archivo en modo lectura. Si no existe o está vacío, no hay filas.
+    explicit LogScanner(const std::string& path);
+    ~LogScanner();
+
+    LogScanner(const LogScanner&) = delete;
+    LogScanner& operator=(const LogScanner&) = delete;
+
+    std::string_view data() const { return std::string_view(data_, size_); }
+
+    /// @brief Parte el texto en hasta 'parts' trozos de al menos minBytes, cortados en un salto de línea.
+    static std::vector<std::string_view> chunks(std::string_view text, std::size_t parts,
+                                                std::size_t minBytes = MIN_CHUNK_BYTES);
+
+    /// @brief Llama a visit(const LogRow&) por cada línea no vacía del texto, en orden.
+    /// @param base Posición del texto dentro del archivo, para LogRow::offset.
+    template <typename Visit>
+    static void forEachRow(std::string_view text, std::uint64_t base, Visit&& visit);
+
+    /// @brief Los campos de una sola línea (sin escanear un archivo).
+    static LogRow split(std::string_view line);
+
+    /// @brief Escanea todo el archivo, repartido entre hilos. select(const LogRow&, std::vector<T>&)
+    /// agrega a su vector lo que quiera guardar de cada fila; se llama desde varios hilos a la vez,
+    /// cada uno con su vector. El resultado queda en el orden del archivo.
+    /// @param threads Hilos a usar (0 = uno por núcleo).
+    template <typename T, typename Select>
+    std::vector<T> collect(Select&& select, unsigned threads = 0, std::size_t minChunkBytes = MIN_CHUNK_BYTES) const;
+
+    /// @brief "AAAA-MM-DD | HH:MM:SS" (hora local) a segundos desde la época. Llama a mktime()
+    /// una vez por hora distinta y por hilo; el resto es aritmética.
+    static bool parseTimestamp(std::string_view timestamp, std::int64_t& seconds);
+
+private:
+    /// @brief Bits de los '\n' y de las ',' en los 64 bytes que empiezan en 'p'.
+    static void separatorMasks(const char* p, std::uint64_t& newlines, std::uint64_t& commas);
+
+    const char* data_ = nullptr;
+    std::size_t size_ = 0;
+};
+
+inline void LogScanner::separatorMasks(const char* p, std::uint64_t& newlines, std::uint64_t& commas) {
+#if defined(__SSE2__)
+    __m128i const newline = _mm_set1_epi8('\n');
+    __m128i const comma = _mm_set1_epi8(',');
+    newlines = 0;
+    commas = 0;
+    for (int i = 0; i < 4; ++i) {
+        __m128i const block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 16 * i));
+        newlines |= static_cast<std::uint64_t>(static_cast<std::uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, newline)))) << (16 * i);
+        commas |= static_cast<std::uint64_t>(static_cast<std::uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(block, comma)))) << (16 * i);
+    }
+#else
+    newlines = 0;
+    commas = 0;
+    for (int i = 0; i < 64; ++i) {
+        newlines |= static_cast<std::uint64_t>(p[i] == '\n') << i;
+        commas |= static_cast<std::uint64_t>(p[i] == ',') << i;
+    }
+#endif
+}
+
+template <typename Visit>
+void LogScanner::forEachRow(std::string_view text, std::uint64_t base, Visit&& visit) {
+    const char* const begin = text.data();
+    const char* const end = begin + text.size();
+    const char* lineStart = begin;
+    const char* commas[4];
+    int commaCount = 0;
+
+    // 'lineEnd' apunta al '\n' (o al final del texto si la última línea no lo tiene).
+    auto emit = [&](const char* lineEnd) {
+        if (lineEnd > lineStart) { // Las líneas vacías se saltean, como en el parser anterior.
+            LogRow row;
+            const char* fieldStart = lineStart;
+            std::string_view* fields[5] = {&row.timestamp, &row.level, &row.message, &row.user, &row.node};
+            for (int i = 0; i < 5; ++i) {
+                if (i < commaCount) {
+                    *fields[i] = std::string_view(fieldStart, static_cast<std::size_t>(commas[i] - fieldStart));
+                    fieldStart = commas[i] + 1;
+                } else if (i == commaCount) {
+                    *fields[i] = std::string_view(fieldStart, static_cast<std::size_t>(lineEnd - fieldStart));
+                    fieldStart = lineEnd;
+                }
+            }
+            row.offset = base + static_cast<std::uint64_t>(lineStart - begin);
+            row.length = static_cast<std::uint32_t>(lineEnd - lineStart + (lineEnd < end ? 1 : 0));
+            visit(static_cast<const LogRow&>(row));
+        }
+        lineStart = lineEnd + 1;
+        commaCount = 0;
+    };
+    auto separator = [&](const char* q) {
+        if (*q == '\n') {
+            emit(q);
+        } else if (commaCount < 4) {
+            commas[commaCount++] = q;
+        }
+    };
+
+    const char* p = begin;
+    for (; end - p >= 64; p += 64) {
+        std::uint64_t newlines;
+        std::uint64_t commaBits;
+        separatorMasks(p, newlines, commaBits);
+        std::uint64_t bits = newlines | commaBits;
+        while (bits != 0) {
+            separator(p + __builtin_ctzll(bits));
+            bits &= bits - 1;
+        }
+    }
+    for (; p < end; ++p) {
+        if (*p == '\n' || *p == ',') {
+            separator(p);
+        }
+    }
+    if (lineStart < end) {
+        emit(end);
+    }
+}
+
+template <typename T, typename Select>
+std::vector<T> LogScanner::collect(Select&& select, unsigned threads, std::size_t minChunkBytes) const {
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    std::vector<std::string_view> const parts = chunks(data(), threads, minChunkBytes);
+    std::vector<std::vector<T>> results(parts.size());
+    auto scanPart = [&](std::size_t i) {
+        std::uint64_t const base = static_cast<std::uint64_t>(parts[i].data() - data_);
+        forEachRow(parts[i], base, [&](const LogRow& row) { select(row, results[i]); });
+    };
+
+    std::vector<std::thread> workers;
+    for (std::size_t i = 1; i < parts.size(); ++i) {
+        workers.emplace_back(scanPart, i);
+    }
+    if (!parts.empty()) {
+        scanPart(0); // El primer trozo lo escanea el hilo que llama.
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    if (results.size() == 1) {
+        return std::move(results[0]);
+    }
+    std::size_t total = 0;
+    for (const auto& part : results) {
+        total += part.size();
+    }
+    std::vector<T> merged;
+    merged.reserve(total);
+    for (auto& part : results) {
+        std::move(part.begin(), part.end(), std::back_inserter(merged));
+    }
+    return merged;
+}
+
+#endif // LOGSCANNER_H
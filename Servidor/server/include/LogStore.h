@@ -0,0 +1,167 @@
+#ifndef LOGSTORE_H
+#define LOGSTORE_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <vector>
+#include "Logger.h"
+
+/// @brief Dónde y cuándo cortar los segmentos del log.
+struct LogStoreOptions {
+    /// @brief Segmento activo: el de siempre, para poder seguirlo con tail -F.
+    std::string activePath = "application.csv";
+    /// @brief Carpeta de los segmentos cerrados (segment-000001.csv + segment-000001.idx).
+    std::string segmentDir = "logs";
+    /// @brief El segmento activo se cierra al pasar este tamaño...
+    std::uint64_t maxSegmentBytes = 16 * 1024 * 1024;
+    /// @brief ...o cuando su primera línea tiene esta antigüedad (0 = sin límite de tiempo).
+    std::chrono::seconds maxSegmentAge{24 * 60 * 60};
+};
+
+///
+/// class LogStore
+///
+/// El log en segmentos. Las líneas se agregan al segmento activo y, al pasar el tamaño o la
+/// antigüedad configurados, el segmento se cierra: se mueve a segmentDir y se escribe a su lado
+/// un índice (.idx) con el rango de tiempo y, por nivel y por usuario, dónde empieza cada línea.
+/// Del índice de los segmentos cerrados solo se tiene en memoria la cabecera; las listas de
+/// posiciones se leen al consultar. Una consulta abre solo los segmentos que pueden tener
+/// resultados y lee directamente las líneas que coinciden: el costo depende de cuántas líneas
+/// devuelve, no del tamaño del historial.
+///
+/// append() la llama un solo hilo (el de escritura del Logger); query() se puede llamar desde
+/// cualquiera, al mismo tiempo.
+
+class LogStore
+{
+public:
+    /// @brief Una línea de la tanda que se agrega.
+    struct Entry {
+        std::uint32_t length;  // Bytes de la línea en la tanda, con el '\n'
+        LogLevel level;
+        std::int64_t time;     // Segundos desde la época
+        std::string user;      // Vacío si la línea no tiene usuario
+    };
+
+    /// @brief Filtros de una consulta; los vacíos no filtran.
+    struct Query {
+        std::optional<LogLevel> level;
+        std::optional<std::string> user;
+        std::int64_t from = std::numeric_limits<std::int64_t>::min(); // Segundos desde la época, inclusive
+        std::int64_t to = std::numeric_limits<std::int64_t>::max();
+    };
+
+    /// @brief Abre (o crea) el segmento activo y carga las cabeceras de los índices existentes.
+    /// Si el segmento activo ya tenía líneas, las indexa una vez.
+    explicit LogStore(const LogStoreOptions& options = LogStoreOptions());
+    ~LogStore();
+
+    LogStore(const LogStore&) = delete;
+    LogStore& operator=(const LogStore&) = delete;
+
+    /// @brief Si el segmento activo está abierto para escribir.
+    bool isOpen() const { return fd_ >= 0; }
+
+    /// @brief Escribe la tanda en el segmento activo y la indexa. Antes, si el segmento ya
+    /// superó el tamaño o la antigüedad, lo cierra y empieza otro.
+    /// @param batch Las líneas, una detrás de otra.
+    /// @param entries Una por línea de la tanda, en el mismo orden.
+    void append(const std::string& batch, const std::vector<Entry>& entries);
+
+    /// @brief fdatasync() del segmento activo.
+    void sync();
+
+    /// @brief Cierra el segmento activo aunque no esté lleno (si tiene líneas). Solo desde el
+    /// hilo que llama a append().
+    void rotate();
+
+    void setLimits(std::uint64_t maxSegmentBytes, std::chrono::seconds maxSegmentAge);
+
+    /// @brief Las líneas (sin el '\n') que cumplen los filtros, en orden de escritura.
+    std::vector<std::string> query(const Query& query) const;
+
+    /// @brief Segmentos cerrados, sin contar el activo.
+    std::size_t segmentCount() const;
+
+private:
+    static constexpr std::size_t LEVEL_COUNT = 5;
+
+    /// @brief Una línea en una lista del índice. time es relativo al inicio del segmento.
+    struct Posting {
+        std::uint64_t offset;
+        std::uint32_t length;
+        std::int32_t time;
+    };
+    static_assert(sizeof(Posting) == 16, "Las listas del .idx se escriben y se leen tal cual están en memoria");
+
+    /// @brief Dónde está una lista de posiciones dentro del .idx.
+    struct PostingList {
+        std::uint64_t offset = 0;
+        std::uint64_t count = 0;
+    };
+
+    /// @brief Un segmento cerrado: la cabecera de su índice.
+    struct Segment {
+        std::string dataPath;
+        std::string indexPath;
+        std::int64_t firstTime = 0;
+        std::int64_t lastTime = 0;
+        std::array<PostingList, LEVEL_COUNT> levels;
+        std::map<std::string, PostingList> users;
+    };
+
+    /// @brief El segmento activo, con el índice completo en memoria.
+    struct ActiveIndex {
+        std::uint64_t bytes = 0;
+        std::uint64_t records = 0;
+        std::int64_t firstTime = 0;
+        std::int64_t lastTime = 0;
+        std::array<std::vector<Posting>, LEVEL_COUNT> levels;
+        std::map<std::string, std::vector<Posting>> users;
+    };
+
+    /// @brief Lo que hay que leer de un segmento cerrado para responder una consulta.
+    struct Plan {
+        std::string dataPath;
+        std::string indexPath;
+        std::int64_t firstTime;
+        std::vector<PostingList> lists;
+    };
+
+    void openActive();
+    /// @brief Indexa las líneas que el segmento activo ya tenía al arrancar.
+    void indexExisting();
+    void loadSegments();
+    /// @brief Agrega una línea al índice del segmento activo. Requiere mutex_ (salvo al construir).
+    void addToIndex(std::uint64_t offset, const Entry& entry);
+    /// @brief Cierra el segmento activo. Requiere mutex_.
+    void sealLocked();
+    std::string segmentPath(std::uint64_t sequence, const char* extension) const;
+
+    static bool readHeader(const std::string& indexPath, Segment& segment);
+    static bool readPostings(const std::string& indexPath, const std::vector<PostingList>& lists,
+                             std::vector<std::vector<Posting>>& postings);
+    /// @brief Une (o, si se filtra por nivel y usuario, intersecta) las listas y aplica el rango de tiempo.
+    static std::vector<Posting> combine(std::vector<std::vector<Posting>> lists, const Query& query,
+                                        std::int64_t firstTime);
+    static void readLines(int fd, const std::vector<Posting>& postings, std::vector<std::string>& lines);
+
+    LogStoreOptions options_;
+    std::atomic<std::uint64_t> maxSegmentBytes_;
+    std::atomic<std::int64_t> maxSegmentAge_;
+    int fd_ = -1;
+    std::uint64_t nextSequence_ = 1;
+
+    mutable std::mutex mutex_; // Protege segments_ y active_ (no la escritura en fd_)
+    std::vector<Segment> segments_;
+    ActiveIndex active_;
+};
+
+#endif // LOGSTORE_H
@@ -1,9 +1,19 @@
-
 #ifndef LOGGER_H
 #define LOGGER_H
 #include <string>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdarg>
+#include <ctime>
+#include <memory>
+#include <mutex>
 #include <optional> // Para std::optional
-#include "FileManager.h"
+#include <thread>
+#include "MpscRing.h"
+
+class LogStore;
 
 
 
@@ -11,27 +21,82 @@
 enum class LogLevel {
     /// @brief Mensajes de diagnóstico detallados, útiles para depuración.
     /// Ejemplo: "Valor de la variable X es 10 en la función Y".
-    DEBUG, 
+    DEBUG,
     /// @brief Mensajes informativos sobre el progreso normal de la aplicación.
     /// Ejemplo: "Servidor iniciado en el puerto 8080", "Usuario 'admin' ha iniciado sesión".
-    INFO,    
+    INFO,
     /// @brief Indica una situación inesperada que no es un error, pero que podría serlo.
     /// Ejemplo: "La conexión a la base de datos tardó más de lo esperado".
-    WARNING, 
+    WARNING,
     /// @brief Indica un error en una operación específica que no detiene la aplicación.
     /// Ejemplo: "No se pudo crear el usuario 'test' porque ya existe".
-    ERROR,   
+    ERROR,
     /// @brief Un error grave que probablemente cause la terminación de la aplicación.
     /// Ejemplo: "No se pudo abrir la base de datos. El servidor no puede continuar".
-    CRITICAL 
+    CRITICAL
+};
+
+/// @brief Origen de un mensaje, para poder silenciar por partes el DEBUG y el INFO.
+enum class LogCategory {
+    GENERAL,  // log() sin categoría
+    RPC,
+    AUTH,
+    SERIAL,
+    ROBOT,
+    DATABASE,
+    TASKS,
+    COUNT     // Cantidad de categorías; no es una categoría.
+};
+
+/// @brief Hasta dónde llega cada tanda de líneas antes de seguir.
+enum class LogDurability {
+    /// @brief write() al archivo: sobrevive a la caída del proceso, no a un corte de energía.
+    BUFFERED,
+    /// @brief write() y fdatasync(): sobrevive también a un corte de energía.
+    FSYNC
+};
+
+/// @brief Qué hacer cuando la cola de log está llena.
+enum class LogOverflow {
+    /// @brief Descartar los DEBUG e INFO (se anota cuántos); WARNING o más graves esperan lugar.
+    DROP,
+    /// @brief Todos esperan lugar: no se pierde nada, pero el que loguea se frena.
+    BLOCK
+};
+
+/// @brief Configuración del hilo de escritura del log.
+struct LoggerOptions {
+    /// @brief Cada cuánto se escribe lo acumulado en la cola.
+    std::chrono::milliseconds flushInterval{50};
+    LogDurability durability = LogDurability::BUFFERED;
+    LogOverflow overflow = LogOverflow::DROP;
+    /// @brief application.csv se cierra como segmento (en logs/, con su índice) al pasar este
+    /// tamaño o esta antigüedad (0 = sin límite).
+    std::uint64_t segmentBytes = 16 * 1024 * 1024;
+    std::chrono::seconds segmentAge{24 * 60 * 60};
 };
 
-/// 
+///
 /// class Logger
+///
+/// log() no escribe: arma la línea y la deja en una cola sin bloqueos (MpscRing). Un hilo
+/// propio la vacía cada flushInterval y escribe todo junto, con un write() para el archivo y
+/// otro para la consola. Los CRITICAL son síncronos: log() vuelve cuando la línea está escrita.
+/// El archivo lo maneja un LogStore: segmentos con índice, para consultar sin releer todo.
+///
+/// Lo que queda por debajo del nivel mínimo (o es DEBUG/INFO de una categoría silenciada) se
+/// descarta antes de armar la línea. logf() recibe un formato printf y los argumentos sin
+/// formatear: si el mensaje no se va a escribir, no se arma ningún string. El compilador revisa
+/// el formato contra los argumentos. Para preparar argumentos caros, consultar isEnabled() antes.
 
 class Logger
 {
 public:
+    /// @brief Capacidad de la cola, en líneas.
+    static constexpr std::size_t QUEUE_CAPACITY = 8192;
+    /// @brief Largo máximo de una línea; lo que sobra se corta. Acota la memoria de la cola.
+    static constexpr std::size_t MAX_LINE_BYTES = 4096;
+
     // Método estático para obtener la única instancia de la clase
     static Logger& getInstance();
 
@@ -40,18 +105,102 @@ public:
     void operator=(const Logger&) = delete;
 
     // Método principal para registrar un mensaje
-    void log(LogLevel level, 
-             const std::string& message, 
-             const std::optional<std::string>& user = std::nullopt, 
+    void log(LogLevel level,
+             const std::string& message,
+             const std::optional<std::string>& user = std::nullopt,
              const std::optional<std::string>& node = std::nullopt);
 
+    /// @brief Como log(), pero solo formatea el mensaje si se va a escribir.
+    /// Ejemplo: logf(LogLevel::DEBUG, LogCategory::SERIAL, "Respuesta: %s", text.c_str()).
+    void logf(LogLevel level, LogCategory category, const char* format, ...)
+        __attribute__((format(printf, 4, 5)));
+
+    /// @brief Como logf(), con el usuario y el nodo (IP) en sus columnas.
+    void logfAs(LogLevel level, LogCategory category, const std::string& user, const std::string& node,
+                const char* format, ...)
+        __attribute__((format(printf, 6, 7)));
+
+    /// @brief Si un mensaje de ese nivel y categoría se escribiría. Son dos lecturas atómicas.
+    static bool isEnabled(LogLevel level, LogCategory category) {
+        if (static_cast<int>(level) < minLevel_.load(std::memory_order_relaxed)) {
+            return false;
+        }
+        return level >= LogLevel::WARNING ||
+               (quietCategories_.load(std::memory_order_relaxed) & (1u << static_cast<unsigned>(category))) == 0;
+    }
+
+    /// @brief Nivel mínimo que se escribe (por defecto INFO). Se puede cambiar en cualquier momento.
+    static void setMinLevel(LogLevel level);
+    static LogLevel minLevel();
+
+    /// @brief Silencia (o vuelve a habilitar) el DEBUG y el INFO de una categoría.
+    /// WARNING y los más graves se escriben siempre.
+    static void setCategoryEnabled(LogCategory category, bool enabled);
+
+    /// @brief Nombre del nivel tal como aparece en el log ("INFO", "WARNING"...).
+    static const char* levelToString(LogLevel level);
+
+    /// @brief Nombre en minúsculas ("debug", "serial"...) a nivel o categoría; nullopt si no existe.
+    static std::optional<LogLevel> levelFromString(const std::string& name);
+    static std::optional<LogCategory> categoryFromString(const std::string& name);
+
+    /// @brief Espera a que todo lo logueado hasta ahora esté escrito (con la durabilidad configurada).
+    void flush();
+
+    void configure(const LoggerOptions& options);
+
+    /// @brief Los segmentos del log, para consultarlos. Conviene llamar a flush() antes.
+    const LogStore& store() const { return *store_; }
+
+    /// @brief Líneas descartadas desde el arranque porque la cola estaba llena.
+    std::uint64_t droppedCount() const { return droppedTotal_.load(std::memory_order_relaxed); }
+
 private:
+    /// @brief Una línea en la cola: el momento se formatea recién al escribirla.
+    struct LogRecord {
+        std::chrono::system_clock::time_point time;
+        LogLevel level;
+        std::string user;  // Para el índice del LogStore; vacío si no hay usuario
+        std::string text;  // ", NIVEL, mensaje[, usuario][, nodo]\n"
+    };
+
     // Constructor y destructor privados para asegurar que no se creen instancias externamente
     Logger();
     ~Logger();
-    std::string levelToString(LogLevel level);
 
-    FileNamespace::FileManager fileManager_;
+    /// @brief Arma la línea y la deja en la cola; el nivel ya se revisó.
+    void enqueue(LogLevel level, const std::string& message, const std::string* user, const std::string* node);
+    static std::string formatMessage(const char* format, va_list args);
+
+    void writerLoop();
+    /// @brief Vacía la cola y escribe lo que había. Solo la llama el hilo de escritura.
+    void writeBatch(std::string& batch);
+    void appendTimestamp(std::string& batch, std::chrono::system_clock::time_point time);
+
+    static inline std::atomic<int> minLevel_{static_cast<int>(LogLevel::INFO)};
+    static inline std::atomic<unsigned> quietCategories_{0}; // Un bit por LogCategory silenciada
+
+    std::unique_ptr<LogStore> store_; // application.csv y los segmentos cerrados
+    MpscRing<LogRecord> queue_{QUEUE_CAPACITY};
+    std::atomic<std::uint64_t> queued_{0};   // Líneas aceptadas por la cola
+    std::atomic<std::uint64_t> dropped_{0};  // Descartadas desde la última tanda
+    std::atomic<std::uint64_t> droppedTotal_{0};
+    std::atomic<int> flushIntervalMs_{50};
+    std::atomic<LogDurability> durability_{LogDurability::BUFFERED};
+    std::atomic<LogOverflow> overflow_{LogOverflow::DROP};
+    std::atomic<bool> wakeRequested_{false}; // Cola llena o configuración nueva: no esperar el intervalo
+
+    std::thread writer_;
+    std::mutex writerMutex_;
+    std::condition_variable writerWake_;   // Despierta al hilo antes de tiempo
+    std::condition_variable batchWritten_; // Avisa a los que esperan en flush()
+    bool writerRunning_ = true;            // Protegido por writerMutex_
+    std::uint64_t flushRequested_ = 0;     // Protegido por writerMutex_
+    std::uint64_t written_ = 0;            // Protegido por writerMutex_
+
+    // Solo del hilo de escritura: el prefijo de fecha se reutiliza dentro del mismo segundo.
+    std::time_t cachedSecond_ = -1;
+    std::string cachedTimestamp_;
 };
 
 #endif // LOGGER_H
@@ -0,0 +1,90 @@
+#ifndef MPSCRING_H
+#define MPSCRING_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+/// @brief Cola circular acotada y sin bloqueos para múltiples productores y un único consumidor.
+/// Cada celda lleva un número de secuencia que indica si está libre para escribir o lista
+/// para leer, de modo que los productores solo compiten con un CAS sobre
+/// la posición de escritura y nunca toman un mutex.
+/// @tparam T Tipo de elemento; debe poder construirse por defecto y moverse.
+template <typename T>
+class MpscRing {
+public:
+    /// @brief Crea la cola con una capacidad redondeada a la siguiente potencia de dos.
+    /// @param capacity Cantidad mínima de elementos que debe admitir.
+    explicit MpscRing(std::size_t capacity) {
+        std::size_t size = 2;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        mask_ = size - 1;
+        cells_.reset(new Cell[size]);
+        for (std::size_t i = 0; i < size; ++i) {
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpscRing(const MpscRing&) = delete;
+    MpscRing& operator=(const MpscRing&) = delete;
+
+    /// @brief Intenta encolar un elemento. Es seguro llamarlo desde varios hilos a la vez.
+    /// @return False si la cola está llena.
+    bool tryPush(T&& value) {
+        Cell* cell;
+        std::size_t pos = enqueuePos_.load(std::memory_order_relaxed);
+        for (;;) {
+            cell = &cells_[pos & mask_];
+            std::size_t seq = cell->sequence.load(std::memory_order_acquire);
+            std::intptr_t diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos);
+            if (diff == 0) {
+                if (enqueuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false; // La celda todavía no fue consumida: cola llena.
+            } else {
+                pos = enqueuePos_.load(std::memory_order_relaxed);
+            }
+        }
+        cell->value = std::move(value);
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// @brief Intenta desencolar un elemento. Solo debe llamarlo el hilo consumidor.
+    /// @return False si la cola está vacía.
+    bool tryPop(T& out) {
+        Cell* cell = &cells_[dequeuePos_ & mask_];
+        std::size_t seq = cell->sequence.load(std::memory_order_acquire);
+        if (static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(dequeuePos_ + 1) < 0) {
+            return false;
+        }
+        out = std::move(cell->value);
+        cell->sequence.store(dequeuePos_ + mask_ + 1, std::memory_order_release);
+        dequeuePos_++;
+        return true;
+    }
+
+    /// @brief Capacidad real de la cola.
+    std::size_t capacity() const {
+        return mask_ + 1;
+    }
+
+private:
+    struct Cell {
+        std::atomic<std::size_t> sequence{0};
+        T value{};
+    };
+
+    std::unique_ptr<Cell[]> cells_;
+    std::size_t mask_ = 0;
+    alignas(64) std::atomic<std::size_t> enqueuePos_{0};
+    alignas(64) std::size_t dequeuePos_ = 0; // Solo lo toca el consumidor.
+};
+
+#endif // MPSCRING_H
@@ -0,0 +1,123 @@
+#ifndef ORDERHISTORY_H
+#define ORDERHISTORY_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/// @brief Representa una orden ejecutada por el robot.
+struct Order {
+  std::string timestamp;
+  std::string username;
+  std::string commandName;
+  std::string details;
+  std::string success;
+};
+
+///
+/// class OrderHistory
+///
+/// Las últimas órdenes de un robot en un anillo de capacidad fija. Cada orden ocupa un
+/// registro de tamaño fijo dentro de un único bloque contiguo (los textos van en el mismo
+/// registro, sin memoria propia), así que registrar una orden no reserva memoria. Al llenarse,
+/// la orden más vieja se agrega al archivo de desborde (CSV) antes de pisarla.
+///
+/// Los registros se publican como en SeqLock: el lector copia el registro y lo descarta si
+/// su número de secuencia cambió en el medio. snapshot() no toma el mutex de los escritores y
+/// devuelve órdenes consecutivas, hasta la última publicada al empezar; si un escritor pisa
+/// alguna mientras se copia, el resultado empieza después de ella (las anteriores ya pasaron
+/// al archivo).
+
+class OrderHistory
+{
+public:
+  /// @brief Órdenes que se guardan en memoria si no se configura otra cosa.
+  static constexpr std::size_t DEFAULT_CAPACITY = 1000;
+  /// @brief Bytes de texto de cada registro (usuario, comando, detalles y resultado juntos).
+  /// Si no alcanzan, se recortan los campos más largos.
+  static constexpr std::size_t TEXT_BYTES = 488;
+
+  /// @param capacity Órdenes en memoria (al menos 1).
+  /// @param spillPath Archivo al que pasan las órdenes desplazadas; vacío (por defecto) = se descartan.
+  explicit OrderHistory(std::size_t capacity = DEFAULT_CAPACITY, const std::string& spillPath = "");
+  /// @brief Pasa al archivo las órdenes que siguen en memoria.
+  ~OrderHistory();
+
+  OrderHistory(const OrderHistory&) = delete;
+  OrderHistory& operator=(const OrderHistory&) = delete;
+
+  /// @brief Registra una orden. Si el anillo está lleno, desborda la más vieja.
+  /// @param time Segundos desde la época.
+  void record(std::int64_t time, const std::string& username, const std::string& commandName,
+              const std::string& details, const std::string& success);
+
+  /// @brief Copia de las órdenes en memoria, de la más vieja a la más nueva. No bloquea a record().
+  std::vector<Order> snapshot() const;
+
+  /// @brief Vacía el historial en memoria, pasando sus órdenes al archivo.
+  void clear();
+
+  /// @brief Cambia la cantidad de órdenes en memoria. Si hay más que la nueva capacidad,
+  /// las más viejas pasan al archivo.
+  /// @throws std::invalid_argument Si capacity es 0.
+  void setCapacity(std::size_t capacity);
+  std::size_t capacity() const;
+
+  void setSpillPath(const std::string& path);
+  std::string spillPath() const;
+
+  /// @brief Órdenes que pasaron al archivo desde que se creó el historial.
+  std::uint64_t spilledCount() const
+  {
+    return spilled_.load(std::memory_order_relaxed);
+  }
+
+private:
+  /// @brief Una orden tal como se guarda en el anillo (trivialmente copiable).
+  struct Record {
+    std::int64_t time;
+    std::uint16_t lengths[4]; // usuario, comando, detalles, resultado
+    char text[TEXT_BYTES];
+  };
+  static_assert(sizeof(Record) % sizeof(std::uint64_t) == 0, "Record se copia de a palabras");
+  static constexpr std::size_t WORDS = sizeof(Record) / sizeof(std::uint64_t);
+
+  /// @brief Un lugar del anillo. version = 2n+2 cuando guarda la orden n (0, la primera);
+  /// impar mientras se escribe.
+  struct Slot {
+    std::atomic<std::uint64_t> version{0};
+    std::atomic<std::uint64_t> words[WORDS];
+  };
+
+  /// @brief El anillo; se reemplaza entero al cambiar la capacidad, así que un lector que ya
+  /// lo tomó lo puede seguir recorriendo.
+  struct Ring {
+    explicit Ring(std::size_t capacity) : slots(new Slot[capacity]), capacity(capacity) {}
+    std::unique_ptr<Slot[]> slots;
+    std::size_t capacity;
+    std::atomic<std::uint64_t> begin{0}; // Primera orden que sigue en el anillo
+    std::atomic<std::uint64_t> end{0};   // Una más que la última publicada
+  };
+
+  static Record pack(std::int64_t time, const std::string& username, const std::string& commandName,
+                     const std::string& details, const std::string& success);
+  static Order unpack(const Record& record);
+  /// @brief Copia la orden n, si sigue en el anillo. Sin bloqueos.
+  static bool read(const Ring& ring, std::uint64_t n, Record& record);
+  /// @brief Escribe la orden n. Requiere writeMutex_.
+  static void write(Ring& ring, std::uint64_t n, const Record& record);
+
+  /// @brief Pasa al archivo las órdenes [begin, until) del anillo. Requiere writeMutex_.
+  void spillLocked(Ring& ring, std::uint64_t until);
+
+  std::shared_ptr<Ring> ring_; // Se lee y se reemplaza con std::atomic_load/atomic_store
+  mutable std::mutex writeMutex_; // Turna a los escritores; protege spillPath_ y spillFd_
+  std::string spillPath_;
+  int spillFd_ = -1;           // Se abre con el primer desborde
+  std::atomic<std::uint64_t> spilled_{0};
+};
+
+#endif // ORDERHISTORY_H
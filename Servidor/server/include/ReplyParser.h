@@ -0,0 +1,93 @@
+#ifndef REPLYPARSER_H
+#define REPLYPARSER_H
+
+#include <cstddef>
+#include <string_view>
+
+namespace ComunicatorPort {
+
+/// @brief Qué informa una línea del firmware.
+enum class ReplyKind {
+    Ok,             // "OK": fin de la respuesta.
+    Error,          // "ERROR: ..."
+    Position,       // "INFO: CURRENT POSITION: [X:.. Y:.. Z:.. E:..]" (M114)
+    Mode,           // "INFO: ABSOLUTE MODE" / "INFO: RELATIVE MODE"
+    MotorsState,    // "INFO: MOTORS ENABLED" / "INFO: MOTORS DISABLED"
+    LinearMove,     // "INFO: LINEAR MOVE: [X:.. Y:.. Z:.. E:..]" (G0/G1)
+    HomingComplete, // "INFO: HOMING COMPLETE"
+    LimitReached,   // "INFO: ENDSTOP: [X:. Y:. Z:.]" (M119)
+    Info            // Cualquier otra línea.
+};
+
+/// @brief Los errores que el firmware informa, para no comparar textos en cada consumidor.
+enum class ReplyError {
+    None,
+    CommandNotRecognized, // "COMMAND NOT RECOGNIZED"
+    NotImplemented,       // "... NOT IMPLEMENTED"
+    RobotFailure,         // "ROBOT FAILURE" (falló el homing)
+    Other
+};
+
+/// @brief Una línea del firmware ya interpretada. Las vistas apuntan al búfer del
+/// parser y valen solo durante la llamada al manejador.
+struct ReplyEvent {
+    ReplyKind kind = ReplyKind::Info;
+    std::string_view line;          // La línea completa, sin terminador.
+    std::string_view text;          // Lo que sigue a "INFO: " / "ERROR: ".
+    ReplyError error = ReplyError::None;
+    double x = 0, y = 0, z = 0, e = 0; // Position y LinearMove.
+    bool absolute = false;          // Mode.
+    bool motorsEnabled = false;     // MotorsState.
+    bool limitX = false, limitY = false, limitZ = false; // LimitReached.
+
+    /// @brief True si algún final de carrera está activo (LimitReached).
+    bool anyLimit() const { return limitX || limitY || limitZ; }
+};
+
+/// @brief Parser incremental de las respuestas del firmware: recibe los bytes tal como
+/// llegan (en trozos de cualquier tamaño) y entrega un ReplyEvent por cada línea
+/// completa. No reserva memoria: la línea en curso vive en un búfer fijo y los números
+/// se leen con std::from_chars. Las líneas más largas que MAX_LINE se truncan.
+class ReplyParser {
+public:
+    static constexpr std::size_t MAX_LINE = 160;
+
+    /// @brief Consume 'bytes' y llama a onEvent(const ReplyEvent&) por cada línea terminada.
+    /// "\r", "\n" o "\r\n" terminan la línea; las líneas vacías se ignoran.
+    template <typename Handler>
+    void feed(std::string_view bytes, Handler&& onEvent) {
+        for (char c : bytes) {
+            if (c == '\r' || c == '\n') {
+                if (length_ > 0) {
+                    onEvent(parseLine(std::string_view(line_, length_)));
+                    length_ = 0;
+                }
+            } else if (length_ < MAX_LINE) {
+                line_[length_++] = c;
+            }
+        }
+    }
+
+    /// @brief Entrega la línea en curso aunque no haya llegado su terminador.
+    template <typename Handler>
+    void finish(Handler&& onEvent) {
+        if (length_ > 0) {
+            onEvent(parseLine(std::string_view(line_, length_)));
+            length_ = 0;
+        }
+    }
+
+    /// @brief Descarta la línea a medio recibir.
+    void reset() { length_ = 0; }
+
+    /// @brief Interpreta una línea sin terminador.
+    static ReplyEvent parseLine(std::string_view line);
+
+private:
+    char line_[MAX_LINE];
+    std::size_t length_ = 0;
+};
+
+} // namespace ComunicatorPort
+
+#endif // REPLYPARSER_H
@@ -3,6 +3,7 @@
 #define REPORTGENERATOR_H
 
 #include <string>
+#include <cstdint>
 #include <map>
 #include "User.h"
 #include "Robot.h" // Necesario para acceder a los datos del robot
@@ -49,10 +50,16 @@ public:
 
   /// 
   /// @return string
-  /// @param  filters Un mapa de filtros (ej. "username", "level").
+  /// @param  filters Un mapa de filtros (ej. "username", "level", "from", "to").
+  /// "from" y "to" son fechas locales "AAAA-MM-DD HH:MM:SS", inclusive.
   /// @return Un xmlrpc_c::value_struct con el reporte del log.
   xmlrpc_c::value generateLogReport(const std::map<std::string, std::string>& filters);
 
+private:
+  /// @brief Fecha local "AAAA-MM-DD HH:MM:SS" (o "AAAA-MM-DD | HH:MM:SS", como en el log) a
+  /// segundos desde la época. Lanza std::invalid_argument si no tiene ese formato.
+  static std::int64_t parseLogTime(const std::string& text);
+
 
 };
 
@@ -4,7 +4,7 @@
 
 #include <string>
 #include <any>
-#include <list>
+#include <vector>
 #include "Position.h"
 
 // --- Definiciones de Platzhalter ---
@@ -15,20 +15,47 @@ struct RobotStatus {
   bool areMotorsEnabled = false;
   Position currentPosition;
   bool isAbsolute = true; // Por defecto, asumimos modo absoluto
+  long long statusAgeMs = -1; // Antigüedad (ms) de la posición informada; -1 si nunca se leyó
+  unsigned long long version = 0; // Crece cada vez que cambia algo de lo anterior (ver waitForChange)
   // ... otros campos de estado
 };
 
 #include "Position.h"
 #include "GCode.h"
 #include "Logger.h"
+#include "LinkStats.h"
+#include "LinkBenchmark.h"
+#include "OrderHistory.h"
+#include "SeqLock.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+/// @brief Resultado de una línea de G-Code enviada durante un streaming de tarea.
+struct GCodeLineResult {
+  std::size_t lineIndex = 0; // Índice de la línea dentro de la tarea original.
+  std::string command;       // Línea tal como se envió (o se intentó enviar).
+  std::string response;      // Respuesta del firmware o motivo del fallo.
+  bool success = false;
+};
 
-/// @brief Representa una orden ejecutada por el robot.
-struct Order {
-  std::string timestamp;
-  std::string username;
-  std::string commandName;
-  std::string details;
-  std::string success;
+/// @brief Seguimiento de un movimiento pedido con moveTo(). Empieza con el OK del firmware
+/// (que lo saca de su cola) y termina con la respuesta a cualquier comando posterior,
+/// porque el firmware no saca el siguiente de la cola hasta terminar de moverse.
+struct MotionJob {
+  std::uint64_t id = 0;
+  std::string command;              // G-Code enviado, sin terminador.
+  std::string state = "EN_CURSO";   // EN_CURSO, COMPLETADO o FALLIDO.
+  std::string detail;               // Motivo cuando falló.
+  Position target;                  // Destino absoluto, válido si hasTarget.
+  bool hasTarget = false;           // Sin destino conocido (G28, relativo sin partida) no se verifica.
+  double predictedMs = 0;           // Duración estimada con el perfil de velocidad del firmware.
+  long long elapsedMs = -1;         // Desde el OK hasta la confirmación; -1 mientras sigue en curso.
+  std::int64_t startedAtUs = 0;     // steady_clock al llegar el OK.
+  std::int64_t expectedDoneUs = 0;  // startedAtUs + predictedMs.
 };
 
 namespace RobotNamespace {
@@ -68,16 +95,82 @@ public:
   /// 
   /// @param  position 
   /// @param  speed 
-  void moveTo(const Position& position, double speed);
+  /// @return Id del movimiento, para waitMotion().
+  std::uint64_t moveTo(const Position& position, double speed);
 
   /// @param  position 
-  void moveTo(const Position& position);
-  void executeMoviment(const Position& position, double speed = 2000.0);
+  std::uint64_t moveTo(const Position& position);
+  std::uint64_t executeMoviment(const Position& position, double speed = 2000.0);
+
+  /// @brief Espera hasta 'timeoutMs' a que termine un movimiento. Cumplida la duración
+  /// estimada, lo confirma con un M114 (el firmware lo responde recién al terminar) y
+  /// verifica que la posición informada coincida con el destino. El M114 tampoco espera
+  /// más allá del plazo.
+  /// @param jobId Id devuelto por moveTo(); 0 es el último movimiento.
+  /// @param timeoutMs 0 devuelve el estado actual sin esperar; como mucho MAX_CHANGE_WAIT_MS.
+  /// @return El movimiento; con state "EN_CURSO" si venció el plazo.
+  /// @throws RobotException Si el id no existe o ya salió del historial.
+  MotionJob waitMotion(std::uint64_t jobId, int timeoutMs);
 
   /// @brief Envía un comando G-Code crudo al robot.
   /// @param gcode El comando G-Code a enviar (ej. "G1 X10").
+  /// @throws RobotException Si la línea no empieza con G o M (no se envía).
   void sendRawGCode(const std::string& gcode);
 
+  /// @brief Envía una secuencia de G-Code manteniendo hasta `window` comandos en vuelo,
+  /// de modo que la cola del firmware nunca se vacíe entre segmentos.
+  /// El firmware responde "OK" al sacar cada comando de su cola, así que contando
+  /// los OK sabemos cuántos lugares libres quedan. Ante el primer error se deja de
+  /// enviar, se esperan las respuestas pendientes y se informa línea por línea.
+  /// @param lines Las líneas de G-Code a ejecutar, en orden.
+  /// @param window Máximo de comandos enviados sin confirmar (1 equivale al modo anterior).
+  /// @return Un resultado por cada línea de entrada.
+  std::vector<GCodeLineResult> streamGCode(const std::vector<std::string>& lines,
+                                           std::size_t window = FIRMWARE_QUEUE_DEPTH);
+
+  /// @brief Profundidad de la cola de comandos del firmware (QUEUE_SIZE en config.h).
+  static constexpr std::size_t FIRMWARE_QUEUE_DEPTH = 15;
+
+  /// @brief Línea con la que el firmware avisa que terminó de arrancar ("INFO: ROBOT ONLINE").
+  static constexpr const char* BOOT_BANNER = "ROBOT ONLINE";
+
+  /// @brief Tiempo máximo (ms) para que el firmware arranque y responda tras abrir el puerto.
+  static constexpr int BOOT_TIMEOUT_MS = 10000;
+
+  /// @brief Velocidad con la que arranca el firmware (BAUD en config.h).
+  static constexpr int BASE_BAUD = 115200;
+
+  /// @brief Valor de setBaudRate() para medir el enlace y elegir la velocidad más rápida estable.
+  static constexpr int AUTO_BAUD = 0;
+
+  /// @brief Tiempo (ms) que el puerto queda cerrado (DTR bajo) para que la placa se reinicie
+  /// cuando hay que volver a BASE_BAUD tras una velocidad que falló.
+  static constexpr int RESET_HOLD_MS = 100;
+
+  /// @brief Reconexión automática: primera espera y tope (ms) entre intentos, y plazo total.
+  static constexpr int RECONNECT_FIRST_DELAY_MS = 100;
+  static constexpr int RECONNECT_MAX_DELAY_MS = 2000;
+  static constexpr int RECONNECT_TIMEOUT_MS = 15000;
+
+  /// @brief Intervalo (ms) por defecto del muestreo de estado en segundo plano.
+  static constexpr int DEFAULT_STATUS_POLL_MS = 250;
+
+  /// @brief Tope (ms) al que se estira el intervalo de muestreo mientras el brazo está quieto.
+  static constexpr int STATUS_POLL_MAX_MS = 4000;
+
+  /// @brief Valor de getStatus() para aceptar la muestra en memoria sin importar su antigüedad.
+  static constexpr int ANY_STALENESS = -1;
+
+  /// @brief Movimientos que se recuerdan para waitMotion().
+  static constexpr std::size_t MOTION_HISTORY = 32;
+
+  /// @brief Distancia (mm) al destino por debajo de la cual un movimiento llegó (M114 informa dos decimales).
+  static constexpr double MOTION_TOLERANCE_MM = 0.05;
+
+  /// @brief Tiempo máximo (s) entre dos confirmaciones durante el streaming.
+  /// Cada OK llega al comenzar el comando, así que incluye la duración del movimiento previo.
+  static constexpr int STREAM_REPLY_TIMEOUT = 30;
+
   /// 
   /// @param  active 
   void setEffector(bool active);
@@ -109,19 +202,144 @@ public:
   {
   }
 
-  /// 
+  /// @brief Actualiza el estado con la respuesta cruda (con saltos de línea) de un M114.
   void parseM114Response(const std::string& response);
 
-  /// 
-  /// @return RobotStatus
-  RobotStatus getStatus();
+  /// @brief Estado del robot. Se responde desde la última muestra en memoria (sin tocar el
+  /// puerto) si no tiene más de 'maxStalenessMs'; si no, se lee con un M114 y se publica.
+  /// @param maxStalenessMs Antigüedad máxima aceptada; 0 fuerza la lectura y ANY_STALENESS
+  /// acepta cualquiera (salvo que el muestreo en segundo plano esté apagado).
+  RobotStatus getStatus(int maxStalenessMs = 0);
+
+  /// @brief Espera a que el estado publicado cambie. Si ya es más nuevo que 'lastVersion'
+  /// vuelve enseguida; si no, duerme en una variable de condición hasta el próximo cambio
+  /// o hasta 'timeoutMs' (como mucho MAX_CHANGE_WAIT_MS).
+  /// @return El estado con su versión; igual a 'lastVersion' si venció el plazo sin cambios.
+  RobotStatus waitForChange(unsigned long long lastVersion, int timeoutMs);
+
+  /// @brief Tope (ms) de una espera de waitForChange() o waitMotion().
+  static constexpr int MAX_CHANGE_WAIT_MS = 30000;
 
 private:
+  /// @brief Lo que getStatus() responde desde memoria; trivialmente copiable para el SeqLock.
+  struct StatusSample {
+    bool isConnected = false;
+    bool areMotorsEnabled = false;
+    bool isAbsolute = true;
+    Position currentPosition;
+    char activityState[32] = "DESCONOCIDO";
+    std::int64_t sampledAtUs = 0; // steady_clock de la última lectura de posición (0 = nunca)
+    std::uint64_t version = 0;    // Crece solo si cambia algún campo (no la hora de la lectura)
+  };
+
+  /// @brief Mientras exista, el muestreador no envía M114 (conexión, reconexión y streaming).
+  class PollerPause {
+  public:
+    explicit PollerPause(Robot& robot);
+    ~PollerPause();
+  private:
+    Robot& robot_;
+  };
+
+  /// @brief Publica robotStatus en la muestra; la posición solo si 'positionSampled'.
+  void publishStatus(bool positionSampled);
+
+  /// @brief Lee el estado con un M114 y publica lo leído. Para los hilos que no son dueños
+  /// de robotStatus (los de RPC que solo consultan): parsea en un RobotStatus propio.
+  /// @param time Tiempo máximo de espera de la respuesta, en segundos.
+  void sampleStatus(int time);
+
+  /// @brief Modifica la muestra publicada; si cambió algo más que la hora de la lectura,
+  /// sube su versión y despierta a los que esperan en waitForChange().
+  template <typename Mutate>
+  void updateSnapshot(Mutate&& mutate);
+
+  /// @brief Hilo de muestreo: M114 cada statusPollIntervalMs, más espaciado si nada cambia.
+  void pollStatus();
+  void startStatusPoller();
+  void stopStatusPoller();
+
+  /// @brief Avisa al muestreador que se envió un comando (vuelve al ritmo configurado).
+  void noteActivity();
+
+  /// @brief Registra un movimiento cuyo OK acaba de llegar y devuelve su id.
+  std::uint64_t startMotion(MotionJob job);
+
+  /// @brief Da por terminados los movimientos que empezaron antes de 'submittedAtUs', el
+  /// momento en que se envió el comando cuya respuesta acaba de llegar. Si esa respuesta
+  /// trae la posición ('reported'), el último de ellos debe haber llegado a su destino.
+  void settleMotions(std::int64_t submittedAtUs, const Position* reported);
+
+  /// @brief Marca como fallidos los movimientos en curso (desconexión o reinicio de la placa).
+  void abandonMotions(const std::string& reason);
+
+  /// @brief Segundos que faltan, según lo estimado, para que terminen los movimientos en
+  /// curso; se suman al timeout de los comandos que el firmware encola detrás.
+  int motionBacklogSeconds();
+
+  /// @brief Abre el puerto a BASE_BAUD y espera el arranque del firmware.
+  void openAtBaseRate();
+
+  /// @brief Cierra el puerto, espera RESET_HOLD_MS y lo reabre a BASE_BAUD.
+  void resetToBaseRate();
+
+  /// @brief Comunicador de este brazo; si no se asignó uno, el del ServiceLocator.
+  ComunicatorPort::ISerialCommunicator& communicator();
+
+  /// @brief Abre el puerto, espera a que el firmware arranque y negocia la velocidad y el protocolo.
+  /// @throws SerialCommunicationException Si el puerto no abre o el firmware no responde.
+  void openLink();
+
+  /// @brief Reabre el enlace perdido con espera exponencial entre intentos y restaura
+  /// el modo de coordenadas. Si no lo logra, el robot queda desconectado. Requiere reconnectMutex.
+  void reconnect();
+
+  /// @brief Reconecta si el comunicador detectó que el enlace se cortó. Si varios hilos lo
+  /// ven a la vez, reabre el puerto solo el primero; los demás usan el enlace que recuperó.
+  void ensureLink();
+
+  /// @brief Envía un comando (ver sendAndReceive) reconectando antes si el enlace se
+  /// había cortado, y después si se cortó durante el envío.
+  /// @param status Si no es nulo, se actualiza con el modo, los motores y la posición que informe la respuesta.
+  std::string sendCommand(const std::string& command, int time = 2, RobotStatus* status = nullptr);
+
   // Private attributes  
   RobotStatus robotStatus;
   std::string connectionStartTime; // New attribute
   std::string executeState;
-  std::list<Order> lastOrders; // Lista de las últimas órdenes ejecutadas
+  OrderHistory orderHistory; // Últimas órdenes ejecutadas; el registro elige el archivo de desborde
+  std::string serialPort = "/dev/ttyUSB0"; // Dispositivo que se abre al conectar
+  ComunicatorPort::LinkStats linkStats;    // Latencias y contadores del enlace serie
+  bool binaryFraming = false;              // Negociar el protocolo binario (M900) al conectar
+  ComunicatorPort::ISerialCommunicator* communicator_ = nullptr; // Puerto propio (no es dueño)
+  bool autoReconnect = true;               // Reabrir el enlace solo si se corta
+  std::uint64_t reconnectCount = 0;        // Reconexiones automáticas exitosas
+  std::mutex reconnectMutex;               // Un solo hilo reabre el puerto a la vez
+  std::atomic<bool> reconnecting{false};   // Hay una reconexión en curso (el puerto ya puede estar abierto)
+  int baudRate = BASE_BAUD;                // Velocidad pedida (AUTO_BAUD = medir y elegir)
+  int selectedBaud = 0;                    // Elegida por la medición, reutilizada al reconectar
+  ComunicatorPort::BaudSelection baudSelection; // Última medición del enlace
+
+  // Muestreo de estado en segundo plano; getStatus() lee statusSnapshot sin bloquear.
+  SeqLock<StatusSample> statusSnapshot;
+  std::thread statusPoller;
+  std::mutex pollerMutex;
+  std::condition_variable pollerWake;
+  bool pollerRunning = false;                    // Protegido por pollerMutex
+  std::atomic<int> statusPollIntervalMs{DEFAULT_STATUS_POLL_MS};
+  std::atomic<bool> recentActivity{false};
+  std::atomic<int> pollPauses{0};
+  std::atomic<bool> pollInFlight{false};
+  std::mutex changeMutex;                        // Solo para dormir en stateChanged
+  std::condition_variable stateChanged;
+
+  // Movimientos en curso y recientes; los confirma cualquier hilo que reciba una respuesta.
+  std::mutex motionMutex;
+  std::condition_variable motionChanged;
+  std::deque<MotionJob> motionJobs;              // Protegido por motionMutex
+  std::uint64_t nextMotionId = 1;                // Protegido por motionMutex
+  std::atomic<int> pendingMotions{0};
+  double lastCommandedE = 0.0; // E del último moveTo() (el firmware arranca en INITIAL_E0 = 0)
 
 public:
   // --- Getters Públicos ---
@@ -138,12 +356,46 @@ public:
     return executeState;
   }
 
-  /// 
-  /// Get the value of lastOrders
-  /// @return the value of lastOrders
-  const std::list<Order>& getLastOrders() const
+  /// @brief Copia de las órdenes que siguen en memoria, de la más vieja a la más nueva.
+  std::vector<Order> getLastOrders() const
+  {
+    return orderHistory.snapshot();
+  }
+
+  /// @brief Historial de órdenes (capacidad y archivo de desborde).
+  OrderHistory& getOrderHistory()
+  {
+    return orderHistory;
+  }
+
+  /// @brief Estadísticas del enlace serie (latencia envío→OK por familia, bytes, errores).
+  ComunicatorPort::LinkStats& getLinkStats()
+  {
+    return linkStats;
+  }
+
+  /// @brief Cantidad de veces que se recuperó el enlace automáticamente.
+  std::uint64_t getReconnectCount() const
+  {
+    return reconnectCount;
+  }
+
+  /// @brief Velocidad a la que está funcionando el enlace (0 si nunca se abrió).
+  int getLinkBaudRate()
   {
-    return lastOrders;
+    return communicator().getBaudRate();
+  }
+
+  /// @brief Velocidades medidas la última vez que se eligió con AUTO_BAUD.
+  const ComunicatorPort::BaudSelection& getBaudSelection() const
+  {
+    return baudSelection;
+  }
+
+  /// @brief Dispositivo serie que se abre en connect().
+  const std::string& getSerialPort() const
+  {
+    return serialPort;
   }
 
 
@@ -154,14 +406,55 @@ public:
   {
     executeState = state;
   }
-  
 
-  RobotStatus getRobotStatus() const {
-    return robotStatus;
+  /// @brief Cambia el dispositivo serie que se abre en connect() (p. ej. el pty del emulador).
+  void setSerialPort(const std::string& port)
+  {
+    serialPort = port;
+  }
+
+  /// @brief Asigna el comunicador (y con él el hilo de E/S) de este brazo.
+  /// Con varios brazos cada Robot necesita el suyo; nullptr vuelve al del ServiceLocator.
+  void setCommunicator(ComunicatorPort::ISerialCommunicator* communicator)
+  {
+    communicator_ = communicator;
   }
 
-  void setRobotStatus(const RobotStatus& status) {
-    robotStatus = status;
+  /// @brief Si es true (por defecto), al detectar que el enlace se cortó se reabre el
+  /// puerto automáticamente antes del próximo comando.
+  void setAutoReconnect(bool enabled)
+  {
+    autoReconnect = enabled;
+  }
+
+  /// @brief Velocidad a negociar al conectar (M901); el firmware siempre arranca a BASE_BAUD.
+  /// Con AUTO_BAUD se mide el enlace una vez y se usa la más rápida estable; si una
+  /// velocidad falla, se vuelve a abrir el puerto a BASE_BAUD.
+  void setBaudRate(int rate)
+  {
+    baudRate = rate;
+    selectedBaud = 0;
+  }
+
+  /// @brief Si es true, connect() pide al firmware el protocolo binario con tramas;
+  /// si el firmware no lo soporta se sigue en texto.
+  void setBinaryFraming(bool enabled)
+  {
+    binaryFraming = enabled;
+  }
+  
+
+  /// @brief Último estado publicado, sin consultar al firmware (lectura sin bloqueos).
+  RobotStatus getRobotStatus() const;
+
+  void setRobotStatus(const RobotStatus& status);
+
+  /// @brief Intervalo (ms) del muestreo de estado en segundo plano; 0 lo apaga.
+  void setStatusPollInterval(int intervalMs);
+
+  int getStatusPollInterval() const
+  {
+    return statusPollIntervalMs.load();
   }
 };
 
@@ -0,0 +1,107 @@
+#ifndef ROBOTREGISTRY_H
+#define ROBOTREGISTRY_H
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "Robot.h"
+#include "ISerialCommunicator.h"
+
+namespace RobotNamespace {
+
+/// @brief Brazos que maneja el servidor, indexados por id.
+/// Cada robot tiene su propio comunicador serie, y con él su hilo de E/S, así que las
+/// órdenes a brazos distintos avanzan en paralelo desde los hilos de Abyss.
+/// Los robots se registran al arrancar, antes de atender peticiones; a partir de ahí
+/// el registro solo se lee y no necesita exclusión mutua.
+class RobotRegistry
+{
+public:
+  /// @brief Id del brazo que se crea cuando no se configura ninguno.
+  static constexpr const char* DEFAULT_ROBOT_ID = "robot1";
+
+  RobotRegistry();
+  virtual ~RobotRegistry();
+
+  /// @brief Registra un brazo que usa un comunicador ajeno (nullptr = el del ServiceLocator).
+  /// @param id Identificador con el que lo piden los clientes.
+  /// @param serialPort Dispositivo que se abre en connect(); vacío deja el predeterminado del Robot.
+  /// @return El robot creado. El primero registrado es el brazo por defecto.
+  /// @throws RobotException Si el id está vacío o ya existe.
+  Robot& add(const std::string& id, const std::string& serialPort,
+             ComunicatorPort::ISerialCommunicator* communicator = nullptr);
+
+  /// @brief Registra un brazo que se queda con su comunicador.
+  Robot& add(const std::string& id, const std::string& serialPort,
+             std::unique_ptr<ComunicatorPort::ISerialCommunicator> communicator);
+
+  /// @brief Busca un brazo por id; un id vacío devuelve el brazo por defecto.
+  /// @throws RobotException Si no existe.
+  Robot& get(const std::string& id);
+
+  /// @brief El primer brazo registrado.
+  /// @throws RobotException Si no hay ninguno.
+  Robot& defaultRobot();
+
+  const std::string& getDefaultId() const
+  {
+    return defaultId;
+  }
+
+  /// @brief Ids registrados, en orden alfabético.
+  std::vector<std::string> ids() const;
+
+  bool contains(const std::string& id) const
+  {
+    return robots.count(id) != 0;
+  }
+
+  std::size_t size() const
+  {
+    return robots.size();
+  }
+
+  bool empty() const
+  {
+    return robots.empty();
+  }
+
+  /// @brief Negociar el protocolo binario al conectar, en los brazos actuales y en los próximos.
+  void setBinaryFraming(bool enabled);
+
+  /// @brief Velocidad a negociar al conectar (Robot::AUTO_BAUD = medir y elegir), en todos los brazos.
+  void setBaudRate(int rate);
+
+  /// @brief Intervalo (ms) del muestreo de estado en segundo plano de todos los brazos; 0 lo apaga.
+  void setStatusPollInterval(int intervalMs);
+
+  /// @brief Órdenes que cada brazo guarda en memoria (ver setOrderSpillDirectory).
+  /// @throws std::invalid_argument Si capacity es 0.
+  void setOrderHistoryCapacity(std::size_t capacity);
+
+  /// @brief Carpeta donde cada brazo deja sus órdenes desplazadas, en orders-<id>.csv.
+  /// Vacía (por defecto) = se descartan, para que los tests no dejen archivos.
+  void setOrderSpillDirectory(const std::string& directory);
+
+private:
+  struct Entry {
+    std::unique_ptr<ComunicatorPort::ISerialCommunicator> ownedCommunicator;
+    std::unique_ptr<Robot> robot;
+  };
+
+  std::map<std::string, Entry> robots;
+  std::string defaultId;
+  bool binaryFraming = false;
+  int baudRate = Robot::BASE_BAUD;
+  int statusPollIntervalMs = Robot::DEFAULT_STATUS_POLL_MS;
+  std::size_t orderHistoryCapacity = OrderHistory::DEFAULT_CAPACITY;
+  std::string orderSpillDirectory;
+
+  /// @brief Archivo de desborde del brazo 'id' (vacío si no hay carpeta configurada).
+  std::string orderSpillPath(const std::string& id) const;
+};
+
+} // namespace RobotNamespace
+
+#endif // ROBOTREGISTRY_H
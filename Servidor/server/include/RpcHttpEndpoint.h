@@ -0,0 +1,49 @@
+#ifndef RPCHTTPENDPOINT_H
+#define RPCHTTPENDPOINT_H
+
+#include <string>
+#include <xmlrpc-c/abyss.h>
+#include <xmlrpc-c/base.hpp>
+#include <xmlrpc-c/registry.hpp>
+#include "RpcServiceHandler.h"
+
+namespace RpcServiceHandlerNamespace {
+
+/// @brief Las rutas HTTP del servidor, todas sobre el mismo servidor Abyss:
+///  - POST /RPC2    XML-RPC, con el registro de siempre.
+///  - POST /rpc     JSON {"method", "params"}: ejecuta el mismo objeto método que XML-RPC,
+///                  sin el proxy de Node.js. Con "jsonrpc": "2.0" responde en JSON-RPC 2.0
+///                  ({"jsonrpc", "id", "result" | "error"}); sin él, como respondía el proxy
+///                  ({"success", "result"} o {"error": {"code", "message", "faultCode", "faultString"}}).
+///  - GET /health   {"status": "ok"}.
+///  - GET /metrics  llamadas, errores y duración por método, en el formato de texto de Prometheus.
+///  - GET /, /index.html  el index.html del cliente web.
+class RpcHttpEndpoint {
+public:
+  /// @param registry Registro XML-RPC (con los métodos ya cargados).
+  /// @param handler Dueño de los mismos métodos, para JSON y /metrics; nullptr deja solo /RPC2.
+  /// @param webRoot Carpeta del index.html; se lee una vez, al construir. Vacío = sin página.
+  RpcHttpEndpoint(const xmlrpc_c::registry& registry, const RpcServiceHandler* handler, const std::string& webRoot);
+
+  /// @brief Agrega el manejador al servidor Abyss. Va antes de ServerInit().
+  /// @throws std::runtime_error Si Abyss no lo acepta.
+  void install(TServer& server);
+
+  /// @brief Atiende el cuerpo de un POST /rpc y devuelve el JSON de respuesta.
+  /// @param callInfoP Datos de la conexión (IP del cliente); puede ser nullptr.
+  std::string handleJsonCall(const std::string& body, const xmlrpc_c::callInfo* callInfoP) const;
+
+  /// @brief True si se encontró el index.html en webRoot.
+  bool servesIndex() const { return !indexHtml.empty(); }
+
+private:
+  static void handleRequest(void* userdata, TSession* session, abyss_bool* handledP);
+
+  const xmlrpc_c::registry& registry;
+  const RpcServiceHandler* handler;
+  std::string indexHtml;
+};
+
+} // namespace RpcServiceHandlerNamespace
+
+#endif // RPCHTTPENDPOINT_H
@@ -0,0 +1,85 @@
+#ifndef RPCMETRICS_H
+#define RPCMETRICS_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <map>
+#include <memory>
+#include <string>
+
+namespace RpcServiceHandlerNamespace {
+
+/// @brief Contadores de un método RPC: llamadas, en curso, errores por tipo de excepción y
+/// un histograma de duración con las cubetas fijas de Prometheus. Todo se actualiza con
+/// fetch_add relajados, desde cualquier hilo de Abyss sin coordinación.
+class RpcMethodStats {
+public:
+    /// @brief Tipos de error que se distinguen, del más específico al más general.
+    enum class ErrorType {
+        InvalidCredentials,
+        PermissionDenied,
+        Authentication,
+        SerialCommunication,
+        Database,
+        Robot,
+        App,
+        InvalidArgument,
+        Fault,   // xmlrpc_c::fault: parámetros mal tipados y errores del propio xmlrpc-c.
+        Other,
+        COUNT
+    };
+
+    /// @brief Límites superiores (en segundos) de las cubetas; la última, +Inf, es el total.
+    /// Llegan a 30 s porque robot.waitForChange y robot.waitMotion esperan hasta ese tope.
+    static constexpr std::array<double, 14> BUCKET_BOUNDS = {
+        0.001, 0.0025, 0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1, 2.5, 5, 10, 30};
+
+    RpcMethodStats();
+
+    void begin() { inFlight_.fetch_add(1, std::memory_order_relaxed); }
+
+    /// @brief Cierra una llamada empezada con begin().
+    void end(std::chrono::steady_clock::duration elapsed);
+
+    /// @brief Cuenta un error. Va además de end(), no en su lugar.
+    void recordError(ErrorType type) {
+        errors_[static_cast<int>(type)].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    /// @brief Tipo de error de una excepción, según la jerarquía de Exceptions.h.
+    static ErrorType errorTypeOf(const std::exception& e);
+
+    /// @brief Nombre con el que aparece el tipo en la etiqueta 'exception'.
+    static const char* errorTypeName(ErrorType type);
+
+private:
+    friend class RpcMetrics;
+
+    std::array<std::atomic<std::uint64_t>, BUCKET_BOUNDS.size() + 1> buckets_; // No acumulativas.
+    std::array<std::atomic<std::uint64_t>, static_cast<int>(ErrorType::COUNT)> errors_;
+    std::atomic<std::uint64_t> calls_{0};
+    std::atomic<std::uint64_t> inFlight_{0};
+    std::atomic<std::uint64_t> totalMicros_{0};
+};
+
+/// @brief Métricas de todos los métodos RPC, en el formato de texto de Prometheus.
+/// Los métodos se agregan al registrarlos, antes de arrancar el servidor; después el
+/// mapa solo se lee, así que buscar y actualizar no necesita locks.
+class RpcMetrics {
+public:
+    /// @brief Contadores del método; si ya existían, los mismos.
+    RpcMethodStats& add(const std::string& method);
+
+    /// @brief Exposición de texto (text/plain; version=0.0.4) para GET /metrics.
+    std::string render() const;
+
+private:
+    std::map<std::string, std::unique_ptr<RpcMethodStats>> methods_;
+};
+
+} // namespace RpcServiceHandlerNamespace
+
+#endif // RPCMETRICS_H
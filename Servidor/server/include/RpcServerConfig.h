@@ -0,0 +1,33 @@
+#ifndef RPCSERVERCONFIG_H
+#define RPCSERVERCONFIG_H
+
+#include <string>
+#include <xmlrpc-c/abyss.h>
+
+namespace RpcServiceHandlerNamespace {
+
+/// @brief Parámetros del servidor HTTP (Abyss) que atiende XML-RPC y JSON. Abyss atiende
+/// cada conexión en su propio hilo, así que 'workers' es a la vez el máximo de conexiones
+/// abiertas y de pedidos en curso: una conexión keep-alive ociosa o un robot.waitForChange
+/// esperando ocupan un hilo igual que un pedido.
+struct RpcServerConfig {
+  unsigned int port = 8080;
+  unsigned int workers = 64;            // Conexiones atendidas a la vez (hilos de Abyss).
+  unsigned int backlog = 64;            // Conexiones esperando accept() cuando no hay hilo libre.
+  unsigned int keepaliveSeconds = 15;   // Tiempo que una conexión ociosa conserva su hilo.
+  unsigned int keepaliveRequests = 1000; // Pedidos por conexión antes de cerrarla.
+  unsigned int timeoutSeconds = 15;     // Tiempo máximo para recibir un pedido completo.
+  std::string webRoot;                  // Carpeta con el index.html del cliente web; vacío = la de ClienteWeb.
+
+  /// @brief Crea el servidor Abyss con estos valores, escuchando en todas las interfaces.
+  /// Los manejadores (XML-RPC, JSON) se agregan después, antes de ServerInit().
+  /// @throws std::runtime_error Si Abyss no puede crear el servidor.
+  void create(TServer& server) const;
+
+  /// @brief Resumen para el log de arranque.
+  std::string describe() const;
+};
+
+} // namespace RpcServiceHandlerNamespace
+
+#endif // RPCSERVERCONFIG_H
@@ -2,11 +2,14 @@
 #ifndef RPCSERVICEHANDLER_H
 #define RPCSERVICEHANDLER_H
 
+#include <map>
 #include <string>
 #include "Robot.h"
+#include "RobotRegistry.h"
 #include "ReportGenerator.h"
 #include "TaskManager.h"
 #include "AuthenticationService.h"
+#include "RpcMetrics.h"
 
 #include <xmlrpc-c/registry.hpp>
 
@@ -24,7 +27,7 @@ public:
   // Constructors/Destructors  
   RpcServiceHandler(
     AuthenticationServiceNamespace::AuthenticationService& authService,
-    RobotNamespace::Robot& robot,
+    RobotNamespace::RobotRegistry& robots,
     TaskManager& taskManager
   );
 
@@ -36,11 +39,24 @@ public:
   /// @param registry El registro del servidor XML-RPC.
   void registerMethods(xmlrpc_c::registry &registry);
 
+  /// @brief Ejecuta un método registrado sin pasar por XML (lo usa el endpoint JSON).
+  /// Los números se ajustan a la firma del método, porque JSON no distingue enteros de reales.
+  /// @throws xmlrpc_c::fault Si el método no existe o falla.
+  void call(const std::string& method,
+            xmlrpc_c::paramList const& paramList,
+            const xmlrpc_c::callInfo* callInfoP,
+            xmlrpc_c::value* retvalP) const;
+
+  /// @brief Llamadas, errores y duración de cada método registrado (GET /metrics).
+  const RpcMetrics& getMetrics() const { return metrics; }
+
 private:
   AuthenticationServiceNamespace::AuthenticationService& authService;
-  RobotNamespace::Robot& robot;
+  RobotNamespace::RobotRegistry& robots;
   TaskManager& taskManager;
   ReportGenerator reportGenerator;
+  std::map<std::string, xmlrpc_c::methodPtr> methods; // Los mismos objetos que registerMethods puso en el registro.
+  RpcMetrics metrics;
 
 };
 
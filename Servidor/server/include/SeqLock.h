@@ -0,0 +1,95 @@
+#ifndef SEQLOCK_H
+#define SEQLOCK_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+
+/// @brief Valor compartido con lecturas sin bloqueos (seqlock).
+/// Los escritores se turnan con un mutex y marcan la escritura en curso con un contador
+/// impar; los lectores copian el valor y reintentan si el contador cambió en el medio.
+/// El valor se guarda en palabras atómicas, así que una lectura que se cruza con una
+/// escritura nunca es una carrera de datos, solo un reintento.
+/// @tparam T Tipo trivialmente copiable (sin std::string ni punteros a memoria propia).
+template <typename T>
+class SeqLock {
+    static_assert(std::is_trivially_copyable<T>::value, "SeqLock necesita un tipo trivialmente copiable");
+
+public:
+    SeqLock() {
+        store(T{});
+    }
+
+    SeqLock(const SeqLock&) = delete;
+    SeqLock& operator=(const SeqLock&) = delete;
+
+    /// @brief Copia del último valor publicado. Nunca bloquea a los escritores.
+    T load() const {
+        std::uint64_t words[WORDS];
+        for (;;) {
+            std::uint64_t before = sequence_.load(std::memory_order_acquire);
+            if (before & 1) {
+                std::this_thread::yield(); // Escritura en curso.
+                continue;
+            }
+            for (std::size_t i = 0; i < WORDS; ++i) {
+                words[i] = data_[i].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (sequence_.load(std::memory_order_relaxed) == before) {
+                break;
+            }
+        }
+        T value;
+        std::memcpy(&value, words, sizeof(T));
+        return value;
+    }
+
+    /// @brief Publica un valor nuevo.
+    void store(const T& value) {
+        std::lock_guard<std::mutex> lock(writeMutex_);
+        publish(value);
+    }
+
+    /// @brief Modifica el último valor publicado y lo vuelve a publicar, sin que otro
+    /// escritor se cuele entre la lectura y la escritura.
+    /// @param mutate Se llama con una referencia al valor vigente.
+    template <typename Mutate>
+    void update(Mutate&& mutate) {
+        std::lock_guard<std::mutex> lock(writeMutex_);
+        T value = current_;
+        mutate(value);
+        publish(value);
+    }
+
+    /// @brief Cantidad de publicaciones hechas; cambia con cada store() o update().
+    std::uint64_t version() const {
+        return sequence_.load(std::memory_order_acquire) / 2;
+    }
+
+private:
+    static constexpr std::size_t WORDS = (sizeof(T) + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t);
+
+    void publish(const T& value) {
+        std::uint64_t words[WORDS] = {};
+        std::memcpy(words, &value, sizeof(T));
+        std::uint64_t sequence = sequence_.load(std::memory_order_relaxed);
+        sequence_.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (std::size_t i = 0; i < WORDS; ++i) {
+            data_[i].store(words[i], std::memory_order_relaxed);
+        }
+        sequence_.store(sequence + 2, std::memory_order_release);
+        current_ = value;
+    }
+
+    std::atomic<std::uint64_t> sequence_{0};
+    std::atomic<std::uint64_t> data_[WORDS];
+    std::mutex writeMutex_;
+    T current_{}; // Copia del escritor; solo se toca con writeMutex_ tomado.
+};
+
+#endif // SEQLOCK_H
@@ -4,8 +4,13 @@
 
 #include <string>
 #include <any>
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <thread>
 #include "ISerialCommunicator.h" // Incluimos la nueva interfaz
 #include "SerialPortConfiguration.h"
+#include "MpscRing.h"
 
 
 namespace ComunicatorPort{
@@ -42,12 +47,65 @@ public:
   std::string sendMessage(const std::string& message) override;
 
 
-  /// 
-  /// @return string
-  /// @param  message 
+  /// @brief Espera la respuesta del firmware usando poll() en lugar de una espera activa.
+  /// Retorna apenas llega una línea terminal ("OK" o "ERROR: ..."), con todas las
+  /// líneas completas recibidas hasta ella. Las líneas parciales (y lo que llegue
+  /// después de la línea terminal) se conservan para la siguiente llamada.
+  /// @param time Tiempo máximo de espera en segundos.
+  /// @return Las líneas recibidas, o las líneas completas acumuladas si se agota el tiempo.
   std::string reciveMessage(int time = 2) override;
 
 
+  /// @brief Encola el comando para el hilo de E/S del puerto, que lo escribe y
+  /// entrega la respuesta al callback. El hilo se crea con el primer envío.
+  /// Es seguro llamarlo desde varios hilos a la vez: los comandos nunca se intercalan.
+  /// Una vez iniciado el hilo, sendMessage/reciveMessage dejan de estar disponibles.
+  void submitAsync(const std::string& command, ReplyCallback callback, int time = 2) override;
+
+  /// @brief Negocia el protocolo binario (M900) y, si el firmware lo acepta, pasa a
+  /// enviar cada comando como trama con secuencia y CRC. Las tramas que el firmware
+  /// rechaza (NAK) se reenvían desde la secuencia que pide, aunque su pedido ya haya
+  /// vencido; si el enlace queda mudo se reenvía la última trama, cada vez más espaciado,
+  /// para que el firmware reporte lo que le falta.
+  bool enableBinaryFraming(int time = 2) override;
+
+  /// @brief Pide al firmware la nueva velocidad (M901 S<baudios>). El hilo de E/S
+  /// reconfigura el puerto apenas llega el "OK", antes de escribir nada más, y luego se
+  /// repite el M901 (hasta BAUD_VERIFY_ATTEMPTS veces) para confirmar la velocidad: si
+  /// su respuesta llega intacta, la línea funciona en ambos sentidos.
+  /// No está disponible con el protocolo binario activo.
+  bool changeBaudRate(int speed, int time = 2) override;
+
+  int getBaudRate() const override {
+    return baudRate_.load(std::memory_order_acquire);
+  }
+
+  /// @brief Saludo inicial: lee lo que envía el firmware al reiniciarse y termina apenas
+  /// llega el mensaje de arranque (seguido de un M114 para sincronizar) o apenas el
+  /// firmware contesta alguno de los sondeos M114, que se repiten con espera exponencial.
+  /// Así la conexión tarda lo que tarda en arrancar la placa y no una espera fija.
+  /// Debe llamarse antes del primer submit() (todavía sin hilo de E/S).
+  HandshakeResult waitForFirmware(const std::string& banner, std::chrono::milliseconds timeout) override;
+
+  /// @brief True si el hilo de E/S terminó porque el puerto se colgó o dio error.
+  bool linkLost() const override {
+    return linkLost_.load(std::memory_order_acquire);
+  }
+
+  bool isBinaryFraming() const {
+    return binaryFraming_.load(std::memory_order_acquire);
+  }
+
+  /// @brief Tramas reenviadas desde que se abrió el puerto.
+  std::uint64_t framesResent() const {
+    return framesResent_.load(std::memory_order_relaxed);
+  }
+
+  /// @brief Limita cuántos comandos puede haber escritos sin respuesta a la vez.
+  void setMaxInFlight(std::size_t maxInFlight) {
+    maxInFlight_ = maxInFlight == 0 ? 1 : maxInFlight;
+  }
+
   /// 
   void cleanBuffer() override;
 
@@ -63,10 +121,13 @@ public:
   // Prevent copying to avoid double-free issues
   SerialComunicator(const SerialComunicator&) = delete;
   SerialComunicator& operator=(const SerialComunicator&) = delete;
-    
-  // Allow moving if needed
-  SerialComunicator(SerialComunicator&&) noexcept = default;
-  SerialComunicator& operator=(SerialComunicator&&) noexcept = default;
+
+  // Tampoco se puede mover: el hilo de E/S guarda un puntero a este objeto.
+  SerialComunicator(SerialComunicator&&) = delete;
+  SerialComunicator& operator=(SerialComunicator&&) = delete;
+
+  /// @brief Cantidad de comandos que el firmware puede tener en cola (QUEUE_SIZE en config.h).
+  static constexpr std::size_t DEFAULT_MAX_IN_FLIGHT = 15;
 
 
 private:
@@ -75,11 +136,116 @@ private:
   int fileDescriptor_ = -1;
   char buffer_[4096];
   bool isConfigured_ = false;
+  std::string pendingInput_; // Bytes recibidos que aún no se entregaron (líneas parciales incluidas).
+
+  // Tiempo extra que se espera tras una línea "ERROR" por el "OK" que el firmware
+  // suele enviar a continuación, para que no quede desfasado para el próximo comando.
+  static constexpr int ERROR_LINGER_MS = 50;
+
+  // Saludo inicial: primer sondeo M114 si no llegó el mensaje de arranque, tope de la
+  // espera exponencial entre sondeos y silencio con el que se dan por drenadas las
+  // respuestas a sondeos anteriores.
+  static constexpr int HANDSHAKE_FIRST_PROBE_MS = 100;
+  static constexpr int HANDSHAKE_MAX_PROBE_MS = 1000;
+  static constexpr int HANDSHAKE_QUIET_MS = 50;
+
+  // Cambio de velocidad: confirmaciones (con su tiempo límite, en segundos) que se
+  // envían a la nueva velocidad antes de darla por buena.
+  static constexpr int BAUD_VERIFY_ATTEMPTS = 2;
+  static constexpr int BAUD_VERIFY_TIMEOUT_S = 1;
+
+  // Protocolo binario: sin tráfico durante este tiempo se reenvía la última trama en vuelo
+  // (salvo tras un NAK, el doble de espera tras cada reenvío sin respuesta, hasta
+  // RESEND_MAX_IDLE_MS), y los NAK repetidos para la misma secuencia dentro de la ventana
+  // se ignoran.
+  static constexpr int RESEND_IDLE_MS = 1000;
+  static constexpr int RESEND_MAX_IDLE_MS = 16000;
+  static constexpr int NAK_HOLDOFF_MS = 100;
+
+  // Un pedido vencido sigue ocupando su lugar hasta que llega su respuesta (que se descarta
+  // para no atribuírsela al siguiente) o hasta que pasa este tiempo sin ella. Con el
+  // protocolo binario eso último da el enlace por perdido: sin esa trama el firmware no
+  // acepta las siguientes.
+  static constexpr int ABANDONED_REPLY_MS = 60000;
 
   // Public attribute accessor methods  
 
   void initAttributes();
 
+  /// @brief Busca en pendingInput_ el fin de una respuesta completa.
+  /// Antes descarta los saltos de línea vacíos que haya al principio.
+  /// @param errorSeen Se pone en true si la respuesta contiene una línea "ERROR".
+  /// @return La posición posterior a la línea terminal, o std::string::npos si aún no llegó.
+  std::size_t findReplyEnd(bool& errorSeen);
+
+  /// @brief Un comando encolado para el hilo de E/S.
+  struct Request {
+    std::string command;
+    ReplyCallback callback;
+    int timeoutSeconds = 2;
+    SerialReply reply;
+    std::chrono::steady_clock::time_point deadline;
+    bool negotiatesFraming = false; // Pedido M900: nada más se escribe hasta su respuesta.
+    int switchesBaud = 0;           // Pedido M901: velocidad a aplicar cuando llegue su "OK".
+    std::string frame;              // Trama enviada (modo binario), guardada para reenviarla.
+    std::uint8_t seq = 0;
+    bool abandoned = false;         // Venció y ya se entregó incompleto; su respuesta se descarta.
+
+    /// @brief Lo que se escriba detrás de este pedido depende de su respuesta.
+    bool holdsWrites() const {
+      return !abandoned && (negotiatesFraming || switchesBaud != 0);
+    }
+  };
+
+  MpscRing<Request> submissions_{256};
+  std::thread ioThread_;
+  std::atomic<bool> ioRunning_{false};
+  std::mutex ioStartMutex_;    // Solo protege el arranque/parada del hilo, no el envío.
+  std::mutex drainMutex_;      // submissions_ admite un solo consumidor: el hilo de E/S o quien la vacía.
+  int wakeFd_ = -1;            // eventfd con el que los productores despiertan al hilo.
+  std::size_t maxInFlight_ = DEFAULT_MAX_IN_FLIGHT;
+  std::atomic<bool> linkLost_{false}; // El hilo de E/S terminó por un error del puerto.
+  std::atomic<int> baudRate_{0};
+
+  // Estado del protocolo binario. Salvo los atómicos, solo lo toca el hilo de E/S.
+  std::atomic<bool> binaryFraming_{false};
+  std::atomic<std::uint64_t> framesResent_{0};
+  std::uint8_t nextSeq_ = 0;
+  std::string framedText_; // Líneas de texto recibidas que preceden al próximo ACK.
+  bool gapReported_ = false; // Lo último que avisó el firmware fue un NAK: le falta una trama.
+  std::uint8_t lastNakSeq_ = 0;
+  std::chrono::steady_clock::time_point lastNakAt_;
+  std::chrono::steady_clock::time_point lastTrafficAt_;
+
+  /// @brief Encola un pedido para el hilo de E/S y lo despierta.
+  void enqueue(Request&& request);
+
+  /// @brief Falla los pedidos que quedaron en submissions_ sin que el hilo de E/S los tome.
+  /// @param error El error a entregar; si es nulo, "puerto cerrado" (se crea solo si hay
+  /// pedidos, porque crear la excepción la registra en el log).
+  void failSubmissions(std::exception_ptr error = nullptr);
+
+  /// @brief Escribe todos los bytes en el puerto.
+  void writeAll(const std::string& data);
+
+  /// @brief Con el protocolo binario: separa tramas y líneas de texto de pendingInput_,
+  /// completa los pedidos confirmados con ACK y reenvía ante un NAK.
+  void processFramedInput(std::deque<Request>& inFlight, std::chrono::steady_clock::time_point now);
+
+  /// @brief Arranca el hilo de E/S si todavía no está corriendo.
+  void startIoThread();
+
+  /// @brief Detiene el hilo de E/S y falla los pedidos que quedaron sin respuesta.
+  void stopIoThread();
+
+  /// @brief Bucle del hilo de E/S: escribe pedidos y reparte respuestas en orden FIFO.
+  void ioLoop();
+
+  /// @brief Espera datos en el descriptor con poll() y los añade a pendingInput_.
+  /// @param timeoutMs Tiempo máximo de espera en milisegundos.
+  /// @return True si se leyeron bytes, false si se agotó el tiempo.
+  bool fillPending(int timeoutMs);
+
 };
 
 } // namespace ComunicatorPort
@@ -31,8 +31,23 @@ public:
   /// @param  port 
   /// @param  speed 
   /// @param  fileDescriptor El descriptor del archivo del puerto a configurar.
+  /// @throws std::runtime_error Si la velocidad no se puede configurar en este sistema.
   bool applyConfig(int fileDescriptor, int speed);
 
+  /// @brief True si la velocidad tiene su constante Bxxx en termios (300..4000000).
+  static bool isStandardRate(int speed);
+
+  /// @brief True si applyConfig() acepta la velocidad: las estándar y, en Linux,
+  /// cualquier otra entre MIN_CUSTOM_RATE y MAX_CUSTOM_RATE (termios2 con BOTHER).
+  static bool isSupportedRate(int speed);
+
+  /// @brief Velocidad de salida que el driver tiene configurada en el puerto, en baudios.
+  /// @return -1 si no se pudo leer.
+  static int currentRate(int fileDescriptor);
+
+  static constexpr int MIN_CUSTOM_RATE = 1200;
+  static constexpr int MAX_CUSTOM_RATE = 4000000;
+
 private:
 
   std::string port_;
@@ -2,10 +2,14 @@
 #ifndef SERVER_H
 #define SERVER_H
 
+#include <chrono>
 #include <string>
 #include <thread> // Para std::thread
+#include <memory>
 #include "Robot.h"
+#include "RobotRegistry.h"
 #include "RpcServiceHandler.h"
+#include "RpcServerConfig.h"
 #include "AuthenticationService.h" // El servidor es dueño de los servicios
 #include "DatabaseManager.h"
 #include "ReportGenerator.h"
@@ -39,6 +43,53 @@ public:
   /// 
   void shutdown();
 
+  /// @brief Agrega un brazo que usa el comunicador del ServiceLocator.
+  /// Si al arrancar no se agregó ninguno, se crea el brazo por defecto en /dev/ttyUSB0.
+  void addRobot(const std::string& id, const std::string& port) {
+    robots.add(id, port);
+  }
+
+  /// @brief Agrega un brazo con su propio comunicador (y su propio hilo de E/S).
+  void addRobot(const std::string& id, const std::string& port,
+                std::unique_ptr<ComunicatorPort::ISerialCommunicator> communicator) {
+    robots.add(id, port, std::move(communicator));
+  }
+
+  /// @brief Negociar el protocolo binario con el firmware al conectar.
+  void setBinaryFraming(bool enabled) {
+    robots.setBinaryFraming(enabled);
+  }
+
+  /// @brief Velocidad del enlace serie a negociar al conectar (ver Robot::setBaudRate).
+  void setBaudRate(int rate) {
+    robots.setBaudRate(rate);
+  }
+
+  /// @brief Intervalo (ms) del muestreo de estado que alimenta robot.getStatus (0 = apagado).
+  void setStatusPollInterval(int intervalMs) {
+    robots.setStatusPollInterval(intervalMs);
+  }
+
+  /// @brief Órdenes que cada brazo guarda en memoria para los reportes (ver OrderHistory).
+  void setOrderHistoryCapacity(std::size_t capacity) {
+    robots.setOrderHistoryCapacity(capacity);
+  }
+
+  /// @brief Carpeta de los orders-<id>.csv con las órdenes que salen del historial (vacía = se descartan).
+  void setOrderSpillDirectory(const std::string& directory) {
+    robots.setOrderSpillDirectory(directory);
+  }
+
+  /// @brief Puerto, hilos, backlog y keep-alive del servidor XML-RPC.
+  void setRpcConfig(const RpcServiceHandlerNamespace::RpcServerConfig& config) {
+    rpcConfig = config;
+  }
+
+  /// @brief Vencimiento de las sesiones: sin uso y desde el login (0 = nunca).
+  void setSessionTimeouts(std::chrono::seconds idleTtl, std::chrono::seconds absoluteTtl) {
+    sessionManager.setTimeouts(idleTtl, absoluteTtl);
+  }
+
 private:
   // Private attributes  
 
@@ -55,12 +106,13 @@ private:
   DatabaseManagerNamespace::DatabaseManager dbManager;
   AuthenticationServiceNamespace::AuthenticationService authService;
 
-  RobotNamespace::Robot robot;
+  RobotNamespace::RobotRegistry robots; // Brazos por id, cada uno con su puerto serie
   ReportGenerator reportGenerator; // Se mantiene por si los métodos RPC la necesitan
   TaskManager taskManager;
 
   // --- Capa de Aplicación/Interfaces (Servidor RPC) ---
   RpcServiceHandlerNamespace::RpcServiceHandler rpcHandler;
+  RpcServiceHandlerNamespace::RpcServerConfig rpcConfig;
 
 };
 
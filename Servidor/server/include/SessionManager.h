@@ -1,17 +1,49 @@
 #ifndef SESSIONMANAGER_H
 #define SESSIONMANAGER_H
 
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
 #include <string>
 #include <map>
-#include <optional>
+#include <memory>
 #include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
 #include "User.h"
 
 /// @brief Gestiona las sesiones de usuario activas basadas en tokens.
 /// Esta clase es segura para su uso en entornos multihilo.
+///
+/// Validar un token ocurre en cada pedido autenticado, así que la tabla está repartida en
+/// SHARD_COUNT partes, cada una con su propio shared_mutex: las lecturas de distintos hilos
+/// no se excluyen entre sí y las escrituras (login, logout, vencimientos) solo bloquean su
+/// parte. El usuario de la sesión se comparte como shared_ptr<const User>, sin copiarlo.
+///
+/// Una sesión vence si pasa idleTtl sin usarse o absoluteTtl desde el login (0 = nunca).
+/// Un hilo propio las borra con una rueda de temporización de un segundo por ranura.
 class SessionManager {
 public:
-    SessionManager() = default;
+    static constexpr std::chrono::seconds DEFAULT_IDLE_TTL{30 * 60};          // 30 minutos
+    static constexpr std::chrono::seconds DEFAULT_ABSOLUTE_TTL{12 * 60 * 60}; // 12 horas
+
+    explicit SessionManager(std::chrono::seconds idleTtl = DEFAULT_IDLE_TTL,
+                            std::chrono::seconds absoluteTtl = DEFAULT_ABSOLUTE_TTL);
+
+    /// @brief Detiene el hilo que borra las sesiones vencidas.
+    ~SessionManager();
+
+    SessionManager(const SessionManager&) = delete;
+    SessionManager& operator=(const SessionManager&) = delete;
+
+    /// @brief Cambia los vencimientos; rige también para las sesiones ya abiertas.
+    /// @param idleTtl Tiempo máximo sin usar la sesión (0 = sin límite).
+    /// @param absoluteTtl Duración máxima desde el login (0 = sin límite).
+    void setTimeouts(std::chrono::seconds idleTtl, std::chrono::seconds absoluteTtl);
 
     /// @brief Crea una nueva sesión para un usuario y genera un token único.
     /// @param user El objeto User que ha sido autenticado.
@@ -19,10 +51,11 @@ public:
     /// @return Un string que representa el token de sesión.
     std::string createSession(const UserNamespace::User& user, const std::string& ip_address);
 
-    /// @brief Valida un token y devuelve el usuario asociado si es válido.
+    /// @brief Valida un token y devuelve el usuario asociado si es válido. Renueva el plazo sin uso.
     /// @param token El token de sesión a validar.
-    /// @return Un std::optional que contiene el objeto User si el token es válido, o está vacío si no.
-    std::optional<UserNamespace::User> getUserByToken(const std::string& token) const;
+    /// @return El usuario de la sesión (sin el hash de la contraseña), o nullptr si el token
+    /// no existe o la sesión venció.
+    std::shared_ptr<const UserNamespace::User> getUserByToken(const std::string& token) const;
 
     /// @brief Finaliza una sesión, invalidando el token.
     /// @param token El token de sesión a eliminar.
@@ -32,13 +65,63 @@ public:
     /// @return Un mapa de token a un par de {Usuario, IP}.
     std::map<std::string, std::pair<UserNamespace::User, std::string>> getActiveSessions() const;
 
+    /// @brief Borra las sesiones vencidas en los segundos ya cumplidos de la rueda (puede llegar
+    /// hasta un segundo después del vencimiento). El hilo propio la llama cada segundo.
+    /// @return Cantidad de sesiones borradas.
+    std::size_t sweepExpired();
+
+    /// @brief Cantidad de sesiones guardadas, incluidas las vencidas que todavía no se borraron.
+    std::size_t size() const;
+
 private:
+    static constexpr std::size_t SHARD_COUNT = 16;   // Potencia de dos.
+    static constexpr std::int64_t WHEEL_SLOTS = 512; // Segundos por vuelta de la rueda.
+
+    struct Session {
+        std::shared_ptr<const UserNamespace::User> user;
+        std::string ipAddress;
+        std::int64_t createdMs;
+        mutable std::atomic<std::int64_t> lastSeenMs;
+    };
+
+    struct alignas(64) Shard {
+        mutable std::shared_mutex mutex;
+        std::unordered_map<std::string, std::shared_ptr<Session>> sessions;
+    };
+
+    /// @brief Una sesión pendiente de revisar en la rueda, con el segundo en que vence.
+    struct WheelEntry {
+        std::string token;
+        std::int64_t dueTick;
+    };
+
     /// @brief Genera una cadena de texto aleatoria y segura para ser usada como token.
     /// @return Un token de 32 caracteres hexadecimales.
-    std::string generateToken();
+    static std::string generateToken();
+
+    static std::int64_t nowMs();
+    Shard& shardFor(const std::string& token) const;
+
+    /// @brief Momento (ms) en que vence la sesión; -1 si no vence.
+    std::int64_t deadlineMs(const Session& session) const;
+    bool expired(const Session& session, std::int64_t now) const;
+
+    /// @brief Anota la sesión en la ranura del segundo en que vence. Requiere wheelMutex_.
+    void schedule(const std::string& token, std::int64_t deadline);
+    void sweep();
+
+    mutable std::array<Shard, SHARD_COUNT> shards_;
+    std::atomic<std::int64_t> idleTtlMs_;
+    std::atomic<std::int64_t> absoluteTtlMs_;
+
+    std::mutex wheelMutex_;
+    std::array<std::vector<WheelEntry>, WHEEL_SLOTS> wheel_; // Protegido por wheelMutex_
+    std::int64_t wheelTick_;                                 // Último segundo revisado
 
-    mutable std::mutex sessionMutex_; // `mutable` para poder usarlo en métodos const
-    std::map<std::string, std::pair<UserNamespace::User, std::string>> activeSessions_;
+    std::thread sweeper_;
+    std::mutex sweeperMutex_;
+    std::condition_variable sweeperWake_;
+    bool sweeperRunning_ = true; // Protegido por sweeperMutex_
 };
 
-#endif // SESSIONMANAGER_H
\ No newline at end of file
+#endif // SESSIONMANAGER_H
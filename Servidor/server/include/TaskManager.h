@@ -5,6 +5,7 @@
 #include <vector>
 #include <optional>
 #include "json.hpp" // Incluimos la librería para parsear JSON
+#include "GCodeOptimizer.h"
 
 // Usamos el alias 'json' para nlohmann::json para que sea más corto
 using json = nlohmann::json;
@@ -15,6 +16,9 @@ struct Task {
     std::string name;
     std::string description;
     std::vector<std::string> gcode;
+    /// @brief El G-Code que se envía al brazo; se recalcula al cargar o añadir la tarea
+    /// y no se guarda en el archivo, que conserva el programa tal como se escribió.
+    GCodeNamespace::OptimizedProgram optimized;
 };
 
 /// @brief Gestiona la carga y el acceso a las tareas predefinidas desde un archivo JSON.
@@ -43,6 +47,9 @@ public:
     bool addTask(const Task& newTask);
 
 private:
+    /// @brief Calcula task.optimized a partir de task.gcode.
+    static void optimize(Task& task);
+
     std::string tasksFilePath_;
     std::vector<Task> tasks_;
     bool tasksLoaded_ = false;
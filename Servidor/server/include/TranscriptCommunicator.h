@@ -0,0 +1,121 @@
+#ifndef TRANSCRIPTCOMMUNICATOR_H
+#define TRANSCRIPTCOMMUNICATOR_H
+
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include "ISerialCommunicator.h"
+
+namespace ComunicatorPort {
+
+/// @brief Formato del archivo de transcripción (binario, little-endian):
+///   Cabecera: "TPTR" + uint32 versión.
+///   Registros: uint64 nanosegundos desde el inicio de la grabación (reloj monotónico),
+///              uint8 dirección, uint32 id de intercambio, uint32 longitud, bytes.
+/// El id de intercambio une cada respuesta con el comando que la produjo; vale 0
+/// para lo que el firmware envía sin que se le haya pedido nada.
+namespace Transcript {
+    constexpr char MAGIC[4] = {'T', 'P', 'T', 'R'};
+    constexpr std::uint32_t VERSION = 1;
+
+    enum class Direction : std::uint8_t {
+        ToFirmware = 0,   // Bytes enviados por el servidor.
+        FromFirmware = 1  // Bytes recibidos del firmware.
+    };
+
+    struct Record {
+        std::uint64_t timestampNs = 0;
+        Direction direction = Direction::ToFirmware;
+        std::uint32_t exchangeId = 0;
+        std::string bytes;
+    };
+
+    /// @brief Lee un archivo de transcripción completo.
+    /// @throws SerialCommunicationException si el archivo no existe o está dañado.
+    std::vector<Record> load(const std::string& path);
+}
+
+/// @brief Decorador que registra en un archivo binario todo lo que pasa por otro
+/// comunicador, con marcas de tiempo monotónicas, sin alterar su comportamiento.
+/// Se registra lo que el comunicador entrega al servidor (respuestas ya enmarcadas
+/// por líneas), no los bytes crudos del puerto; con el protocolo binario se graban
+/// los comandos en texto y las respuestas tal como las reconstruye el comunicador.
+class RecordingSerialCommunicator : public ISerialCommunicator {
+public:
+    /// @param inner Comunicador real al que se delegan todas las operaciones.
+    /// @param path Archivo de transcripción a crear (se sobrescribe si existe).
+    RecordingSerialCommunicator(ISerialCommunicator& inner, const std::string& path);
+
+    void config(const std::string& port, int speed) override;
+    std::string sendMessage(const std::string& message) override;
+    std::string reciveMessage(int time = 2) override;
+    void submitAsync(const std::string& command, ReplyCallback callback, int time = 2) override;
+    void cleanBuffer() override;
+    void close() override;
+    bool isConfigured() const override;
+    bool enableBinaryFraming(int time = 2) override;
+    bool changeBaudRate(int speed, int time = 2) override;
+    int getBaudRate() const override;
+    HandshakeResult waitForFirmware(const std::string& banner, std::chrono::milliseconds timeout) override;
+    bool linkLost() const override;
+
+private:
+    void writeRecord(Transcript::Direction direction, std::uint32_t exchangeId, const std::string& bytes);
+
+    ISerialCommunicator& inner_;
+    std::ofstream out_;
+    std::mutex fileMutex_;
+    std::chrono::steady_clock::time_point start_;
+    std::atomic<std::uint32_t> nextExchangeId_{1};
+    std::atomic<std::uint32_t> lastSyncExchangeId_{0}; // Último comando enviado con sendMessage().
+};
+
+/// @brief Comunicador que reproduce el lado del firmware de una transcripción grabada.
+/// Cada respuesta se entrega con el mismo retardo respecto de su comando que en la
+/// grabación, dividido por el factor de velocidad. No abre ningún puerto.
+class ReplaySerialCommunicator : public ISerialCommunicator {
+public:
+    /// @param path Archivo grabado con RecordingSerialCommunicator.
+    /// @param speed Factor de velocidad (1.0 = tiempos originales, 10.0 = diez veces más rápido).
+    explicit ReplaySerialCommunicator(const std::string& path, double speed = 1.0);
+
+    void config(const std::string& port, int speed) override;
+    std::string sendMessage(const std::string& message) override;
+    std::string reciveMessage(int time = 2) override;
+    void submitAsync(const std::string& command, ReplyCallback callback, int time = 2) override;
+    void cleanBuffer() override;
+    HandshakeResult waitForFirmware(const std::string& banner, std::chrono::milliseconds timeout) override;
+    bool changeBaudRate(int speed, int time = 2) override;
+    void close() override;
+    bool isConfigured() const override;
+
+    /// @brief Cantidad de comandos enviados que no coincidieron con los grabados.
+    std::size_t mismatchCount() const { return mismatches_; }
+
+    /// @brief True si ya se entregaron todas las respuestas grabadas.
+    bool finished() const;
+
+private:
+    std::vector<Transcript::Record> sent_;      // Registros ToFirmware, en orden.
+    std::vector<Transcript::Record> received_;  // Registros FromFirmware, en orden.
+    std::size_t sentCursor_ = 0;
+    std::size_t receivedCursor_ = 0;
+    double speed_;
+
+    // Para cada id de intercambio: cuándo se grabó el comando y cuándo se reprodujo.
+    std::map<std::uint32_t, std::pair<std::uint64_t, std::chrono::steady_clock::time_point>> anchors_;
+    std::chrono::steady_clock::time_point replayStart_;
+    std::atomic<std::size_t> mismatches_{0};
+    bool isConfigured_ = false;
+    mutable std::mutex stateMutex_; // Protege cursores y anclas.
+    std::mutex exchangeMutex_;      // Serializa los submit(), como lo haría el puerto real.
+};
+
+} // namespace ComunicatorPort
+
+#endif // TRANSCRIPTCOMMUNICATOR_H
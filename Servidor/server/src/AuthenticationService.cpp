@@ -33,7 +33,7 @@ void AuthenticationServiceNamespace::AuthenticationService::logout(const std::st
     sessionManager_.endSession(token);
 }
 
-std::optional<UserNamespace::User> AuthenticationServiceNamespace::AuthenticationService::validateToken(const std::string& token) const {
+std::shared_ptr<const UserNamespace::User> AuthenticationServiceNamespace::AuthenticationService::validateToken(const std::string& token) const {
     return sessionManager_.getUserByToken(token);
 }
 
@@ -0,0 +1,172 @@
+#include "BinaryFraming.h"
+
+#include <cctype>
+#include <charconv>
+#include <cstring>
+
+namespace {
+
+/// @brief Normaliza la línea igual que Command::processMessage del firmware:
+/// sin terminador, sin espacios y en mayúsculas.
+std::string normalize(const std::string& gcode) {
+    std::string text;
+    text.reserve(gcode.size());
+    for (char c : gcode) {
+        if (c == ' ' || c == '\t' || c == '\r' || c == '\n') {
+            continue;
+        }
+        text.push_back(static_cast<char>(std::toupper(static_cast<unsigned char>(c))));
+    }
+    return text;
+}
+
+bool isLetter(char c) {
+    return std::isalpha(static_cast<unsigned char>(c)) != 0;
+}
+
+/// @brief Lee el número que va desde 'pos' hasta la próxima letra (como el firmware,
+/// "X1E5" son dos parámetros y no 1e5).
+bool parseNumber(const std::string& text, std::size_t& pos, float& value) {
+    std::size_t end = pos;
+    while (end < text.size() && !isLetter(text[end])) {
+        end++;
+    }
+    const char* first = text.data() + pos;
+    const char* last = text.data() + end;
+    if (first != last && *first == '+') {
+        first++;
+    }
+    auto result = std::from_chars(first, last, value);
+    if (result.ec != std::errc() || result.ptr != last) {
+        return false;
+    }
+    pos = end;
+    return true;
+}
+
+void appendFloat(std::string& out, float value) {
+    char bytes[sizeof(float)];
+    std::memcpy(bytes, &value, sizeof(float)); // El firmware (AVR) también es little-endian.
+    out.append(bytes, sizeof(float));
+}
+
+/// @brief Arma la carga útil de una trama MOVE si la línea es un G0/G1 con ejes X/Y/Z/E/F.
+bool encodeMove(const std::string& text, std::size_t pos, bool rapid, std::string& payload) {
+    float values[5] = {0, 0, 0, 0, 0};
+    std::uint8_t flags = rapid ? 0x80 : 0x00;
+    while (pos < text.size()) {
+        int axis;
+        switch (text[pos]) {
+            case 'X': axis = 0; break;
+            case 'Y': axis = 1; break;
+            case 'Z': axis = 2; break;
+            case 'E': axis = 3; break;
+            case 'F': axis = 4; break;
+            default: return false; // Parámetro sin lugar en la trama fija: viaja como texto.
+        }
+        pos++;
+        if (!parseNumber(text, pos, values[axis])) {
+            return false;
+        }
+        flags |= static_cast<std::uint8_t>(1u << axis);
+    }
+    payload.assign(1, static_cast<char>(flags));
+    for (float value : values) {
+        appendFloat(payload, value);
+    }
+    return true;
+}
+
+} // namespace
+
+std::uint16_t ComunicatorPort::Framing::crc16(const std::uint8_t* data, std::size_t length) {
+    std::uint16_t crc = 0xFFFF;
+    for (std::size_t i = 0; i < length; ++i) {
+        crc ^= static_cast<std::uint16_t>(data[i]) << 8;
+        for (int bit = 0; bit < 8; ++bit) {
+            crc = (crc & 0x8000) ? static_cast<std::uint16_t>((crc << 1) ^ 0x1021) : static_cast<std::uint16_t>(crc << 1);
+        }
+    }
+    return crc;
+}
+
+std::string ComunicatorPort::Framing::buildFrame(std::uint8_t type, std::uint8_t seq, const std::string& payload) {
+    std::string frame;
+    frame.reserve(HEADER_SIZE + payload.size() + CRC_SIZE);
+    frame.push_back(static_cast<char>(SOF));
+    frame.push_back(static_cast<char>(type));
+    frame.push_back(static_cast<char>(seq));
+    frame.push_back(static_cast<char>(payload.size()));
+    frame += payload;
+    std::uint16_t crc = crc16(reinterpret_cast<const std::uint8_t*>(frame.data()) + 1, frame.size() - 1);
+    frame.push_back(static_cast<char>(crc & 0xFF));
+    frame.push_back(static_cast<char>(crc >> 8));
+    return frame;
+}
+
+bool ComunicatorPort::Framing::encodeCommand(const std::string& gcode, std::uint8_t seq, std::string& frame) {
+    std::string text = normalize(gcode);
+    if (text.empty()) {
+        return false;
+    }
+
+    // Letra y número del comando, como los lee el firmware ("G01" es G1).
+    if ((text[0] == 'G' || text[0] == 'M') && text.size() > 1 && std::isdigit(static_cast<unsigned char>(text[1]))) {
+        std::size_t pos = 1;
+        int number = 0;
+        while (pos < text.size() && std::isdigit(static_cast<unsigned char>(text[pos])) && number < 10000) {
+            number = number * 10 + (text[pos] - '0');
+            pos++;
+        }
+        bool noParams = (pos == text.size());
+        std::string payload;
+
+        if (text[0] == 'G' && (number == 0 || number == 1) && encodeMove(text, pos, number == 0, payload)) {
+            frame = buildFrame(MOVE, seq, payload);
+            return true;
+        }
+        if (noParams && text[0] == 'G' && (number == 90 || number == 91)) {
+            frame = buildFrame(MODE, seq, std::string(1, number == 91 ? 1 : 0));
+            return true;
+        }
+        if (noParams && text[0] == 'M' && (number == 3 || number == 5)) {
+            frame = buildFrame(EFFECTOR, seq, std::string(1, number == 3 ? 1 : 0));
+            return true;
+        }
+        if (noParams && text[0] == 'M' && (number == 17 || number == 18)) {
+            frame = buildFrame(MOTORS, seq, std::string(1, number == 17 ? 1 : 0));
+            return true;
+        }
+    }
+
+    if (text.size() > MAX_PAYLOAD) {
+        return false;
+    }
+    frame = buildFrame(TEXT, seq, text);
+    return true;
+}
+
+ComunicatorPort::Framing::DecodeStatus ComunicatorPort::Framing::decodeFrame(const std::string& buffer, std::size_t offset,
+                                                                             Frame& frame, std::size_t& size) {
+    if (buffer.size() - offset < HEADER_SIZE) {
+        return DecodeStatus::Incomplete;
+    }
+    const std::uint8_t* data = reinterpret_cast<const std::uint8_t*>(buffer.data()) + offset;
+    std::size_t length = data[3];
+    if (length > MAX_PAYLOAD) {
+        return DecodeStatus::Corrupt;
+    }
+    std::size_t total = HEADER_SIZE + length + CRC_SIZE;
+    if (buffer.size() - offset < total) {
+        return DecodeStatus::Incomplete;
+    }
+    std::uint16_t received = static_cast<std::uint16_t>(data[HEADER_SIZE + length] | (data[HEADER_SIZE + length + 1] << 8));
+    if (received != crc16(data + 1, HEADER_SIZE - 1 + length)) {
+        return DecodeStatus::Corrupt;
+    }
+    frame.type = data[1];
+    frame.seq = data[2];
+    frame.payload.assign(reinterpret_cast<const char*>(data) + HEADER_SIZE, length);
+    size = total;
+    return DecodeStatus::Ok;
+}
@@ -0,0 +1,364 @@
+#include "GCodeOptimizer.h"
+
+#include <cctype>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <optional>
+
+namespace {
+
+constexpr int AXES = 4; // X, Y, Z, E (el firmware interpola E como un eje más).
+constexpr const char AXIS_LETTERS[AXES] = {'X', 'Y', 'Z', 'E'};
+constexpr double ZERO_MM = 1e-9;
+
+/// @brief Una línea de G-Code ya separada en código y parámetros.
+struct Command {
+    char letter = 0;
+    int number = -1;
+    bool hasAxis[AXES] = {false, false, false, false};
+    double axis[AXES] = {0, 0, 0, 0};
+    bool hasFeed = false;
+    double feed = 0;
+    bool hasOther = false; // Algún parámetro que no es X/Y/Z/E/F.
+    bool hasParams = false;
+
+    bool is(char l, int n) const { return letter == l && number == n; }
+    bool isMove() const { return letter == 'G' && (number == 0 || number == 1) && !hasOther; }
+};
+
+/// @brief Interpreta la línea como Command::processMessage del firmware: sin espacios,
+/// en mayúsculas, y cada número llega hasta la próxima letra ("X1E5" son dos parámetros).
+bool parse(const std::string& line, Command& command) {
+    std::string text;
+    text.reserve(line.size());
+    for (char c : line) {
+        if (c == ' ' || c == '\t' || c == '\r' || c == '\n') {
+            continue;
+        }
+        text.push_back(static_cast<char>(std::toupper(static_cast<unsigned char>(c))));
+    }
+    if (text.size() < 2 || (text[0] != 'G' && text[0] != 'M') || !std::isdigit(static_cast<unsigned char>(text[1]))) {
+        return false;
+    }
+    command.letter = text[0];
+
+    std::size_t pos = 1;
+    int number = 0;
+    while (pos < text.size() && std::isdigit(static_cast<unsigned char>(text[pos]))) {
+        number = number * 10 + (text[pos] - '0');
+        if (number > 10000) {
+            return false;
+        }
+        pos++;
+    }
+    command.number = number;
+
+    while (pos < text.size()) {
+        char param = text[pos++];
+        if (!std::isalpha(static_cast<unsigned char>(param))) {
+            return false;
+        }
+        std::size_t end = pos;
+        while (end < text.size() && !std::isalpha(static_cast<unsigned char>(text[end]))) {
+            end++;
+        }
+        const char* first = text.data() + pos;
+        const char* last = text.data() + end;
+        if (first != last && *first == '+') {
+            first++;
+        }
+        double value = 0;
+        auto result = std::from_chars(first, last, value);
+        if (result.ec != std::errc() || result.ptr != last) {
+            return false;
+        }
+        pos = end;
+        command.hasParams = true;
+
+        bool isAxis = false;
+        for (int a = 0; a < AXES; ++a) {
+            if (param == AXIS_LETTERS[a]) {
+                command.hasAxis[a] = true;
+                command.axis[a] = value;
+                isAxis = true;
+            }
+        }
+        if (param == 'F') {
+            command.hasFeed = true;
+            command.feed = value;
+        } else if (!isAxis) {
+            command.hasOther = true;
+        }
+    }
+    return true;
+}
+
+std::string formatNumber(double value) {
+    char text[64];
+    std::snprintf(text, sizeof(text), "%.4f", value);
+    std::string result(text);
+    result.erase(result.find_last_not_of('0') + 1);
+    if (!result.empty() && result.back() == '.') {
+        result.pop_back();
+    }
+    if (result == "-0") {
+        result = "0";
+    }
+    return result;
+}
+
+bool isBlankOrComment(const std::string& line) {
+    std::size_t first = line.find_first_not_of(" \t\r\n");
+    return first == std::string::npos || line[first] == ';';
+}
+
+std::string trim(const std::string& line) {
+    std::size_t first = line.find_first_not_of(" \t\r\n");
+    std::size_t last = line.find_last_not_of(" \t\r\n");
+    return line.substr(first, last - first + 1);
+}
+
+/// @brief Movimiento en espera de saber si el siguiente lo continúa en línea recta.
+struct PendingMove {
+    GCodeNamespace::OptimizedLine line;
+    Command command;      // El primero del tramo (código, F y modo).
+    bool relative = false;
+    bool used[AXES] = {false, false, false, false};
+    double delta[AXES] = {0, 0, 0, 0};  // Desplazamiento total del tramo.
+    double target[AXES] = {0, 0, 0, 0}; // Destino absoluto de los ejes usados (modo G90).
+};
+
+/// @brief Estado del brazo que se puede deducir del programa recorrido hasta ahora.
+class Optimizer {
+public:
+    explicit Optimizer(GCodeNamespace::OptimizedProgram& program) : program_(program) {}
+
+    void feed(const std::string& line, std::size_t index) {
+        if (isBlankOrComment(line)) {
+            return; // Tampoco viajan al firmware sin optimizar.
+        }
+        Command command;
+        if (!parse(line, command)) {
+            passThrough(line, index, true);
+            return;
+        }
+
+        if (command.isMove()) {
+            move(line, index, command);
+        } else if ((command.is('G', 90) || command.is('G', 91)) && !command.hasParams) {
+            bool relative = command.is('G', 91);
+            if (relative_ && *relative_ == relative) {
+                return;
+            }
+            passThrough(line, index, false);
+            relative_ = relative;
+        } else if ((command.is('M', 3) || command.is('M', 5)) && !command.hasParams) {
+            bool on = command.is('M', 3);
+            if (effector_ && *effector_ == on) {
+                return;
+            }
+            passThrough(line, index, false);
+            effector_ = on;
+        } else if (command.is('G', 4) || command.is('M', 17) || command.is('M', 18) || command.is('M', 106) ||
+                   command.is('M', 107) || command.is('M', 114) || command.is('M', 119)) {
+            // No cambian modo, posición ni efector, pero cortan el tramo en curso.
+            passThrough(line, index, false);
+        } else {
+            passThrough(line, index, true);
+        }
+    }
+
+    void finish() {
+        flush();
+    }
+
+private:
+    void move(const std::string& line, std::size_t index, const Command& command) {
+        if (!relative_) {
+            // Sin saber el modo no sabemos qué posición deja: se envía tal cual.
+            passThrough(line, index, false);
+            for (int a = 0; a < AXES; ++a) {
+                if (command.hasAxis[a]) position_[a].reset();
+            }
+            return;
+        }
+
+        double delta[AXES];
+        bool known = true;
+        for (int a = 0; a < AXES; ++a) {
+            if (!command.hasAxis[a]) {
+                delta[a] = 0;
+            } else if (*relative_) {
+                delta[a] = command.axis[a];
+            } else if (position_[a]) {
+                delta[a] = command.axis[a] - *position_[a];
+            } else {
+                known = false;
+                delta[a] = 0;
+            }
+        }
+
+        // Actualizamos la posición conocida con el destino de este movimiento.
+        for (int a = 0; a < AXES; ++a) {
+            if (!command.hasAxis[a]) continue;
+            if (!*relative_) {
+                position_[a] = command.axis[a];
+            } else if (position_[a]) {
+                *position_[a] += command.axis[a];
+            }
+        }
+
+        if (known && length(delta) < ZERO_MM) {
+            return; // No mueve nada (incluye el G1 con solo F).
+        }
+        if (known && pending_ && continues(command, delta)) {
+            extend(index, command, delta);
+            return;
+        }
+
+        flush();
+        if (!known) {
+            emit(trim(line), index, index);
+            return;
+        }
+        pending_.emplace();
+        pending_->line.command = trim(line);
+        pending_->line.firstSource = index;
+        pending_->line.lastSource = index;
+        pending_->command = command;
+        pending_->relative = *relative_;
+        extendAxes(command, delta);
+    }
+
+    /// @brief True si 'delta' sigue la recta del tramo pendiente, en el mismo sentido y con la
+    /// misma F explícita (sin ella, la velocidad depende del largo de cada tramo).
+    bool continues(const Command& command, const double delta[AXES]) const {
+        const Command& first = pending_->command;
+        if (first.number != command.number || !first.hasFeed || !command.hasFeed ||
+            first.feed != command.feed || first.feed < GCodeNamespace::GCodeOptimizer::MIN_MERGE_FEED) {
+            return false;
+        }
+        double dot = 0;
+        double pendingSquared = 0;
+        for (int a = 0; a < AXES; ++a) {
+            dot += delta[a] * pending_->delta[a];
+            pendingSquared += pending_->delta[a] * pending_->delta[a];
+        }
+        if (dot <= 0 || pendingSquared < ZERO_MM * ZERO_MM) {
+            return false;
+        }
+        double t = dot / pendingSquared;
+        double deviation[AXES];
+        for (int a = 0; a < AXES; ++a) {
+            deviation[a] = delta[a] - t * pending_->delta[a];
+        }
+        return length(deviation) <= GCodeNamespace::GCodeOptimizer::COLLINEAR_TOLERANCE_MM;
+    }
+
+    void extend(std::size_t index, const Command& command, const double delta[AXES]) {
+        pending_->line.lastSource = index;
+        extendAxes(command, delta);
+    }
+
+    void extendAxes(const Command& command, const double delta[AXES]) {
+        for (int a = 0; a < AXES; ++a) {
+            pending_->delta[a] += delta[a];
+            if (command.hasAxis[a]) {
+                pending_->used[a] = true;
+                pending_->target[a] = command.axis[a];
+            }
+        }
+    }
+
+    /// @brief Emite el tramo pendiente: la línea original si no se fusionó nada.
+    void flush() {
+        if (!pending_) {
+            return;
+        }
+        PendingMove move = std::move(*pending_);
+        pending_.reset();
+        if (move.line.firstSource != move.line.lastSource) {
+            std::string text = "G" + std::to_string(move.command.number);
+            for (int a = 0; a < AXES; ++a) {
+                if (!move.used[a]) continue;
+                text += " ";
+                text += AXIS_LETTERS[a];
+                text += formatNumber(move.relative ? move.delta[a] : move.target[a]);
+            }
+            if (move.command.hasFeed) {
+                text += " F" + formatNumber(move.command.feed);
+            }
+            move.line.command = text;
+        }
+        program_.lines.push_back(std::move(move.line));
+    }
+
+    /// @brief Emite la línea tal cual; si 'forget', lo deducido hasta aquí deja de valer.
+    void passThrough(const std::string& line, std::size_t index, bool forget) {
+        flush();
+        emit(trim(line), index, index);
+        if (forget) {
+            relative_.reset();
+            effector_.reset();
+            for (auto& axis : position_) {
+                axis.reset();
+            }
+        }
+    }
+
+    void emit(const std::string& command, std::size_t first, std::size_t last) {
+        GCodeNamespace::OptimizedLine line;
+        line.command = command;
+        line.firstSource = first;
+        line.lastSource = last;
+        program_.lines.push_back(std::move(line));
+    }
+
+    static double length(const double vector[AXES]) {
+        double sum = 0;
+        for (int a = 0; a < AXES; ++a) {
+            sum += vector[a] * vector[a];
+        }
+        return std::sqrt(sum);
+    }
+
+    GCodeNamespace::OptimizedProgram& program_;
+    std::optional<bool> relative_;
+    std::optional<bool> effector_;
+    std::optional<double> position_[AXES];
+    std::optional<PendingMove> pending_;
+};
+
+} // namespace
+
+std::vector<std::string> GCodeNamespace::OptimizedProgram::commands() const {
+    std::vector<std::string> result;
+    result.reserve(lines.size());
+    for (const auto& line : lines) {
+        result.push_back(line.command);
+    }
+    return result;
+}
+
+std::string GCodeNamespace::OptimizedProgram::describeSource(std::size_t index) const {
+    if (index >= lines.size()) {
+        return "línea ?";
+    }
+    const OptimizedLine& line = lines[index];
+    if (line.firstSource == line.lastSource) {
+        return "línea " + std::to_string(line.firstSource + 1);
+    }
+    return "líneas " + std::to_string(line.firstSource + 1) + "-" + std::to_string(line.lastSource + 1);
+}
+
+GCodeNamespace::OptimizedProgram GCodeNamespace::GCodeOptimizer::optimize(const std::vector<std::string>& gcode) {
+    OptimizedProgram program;
+    program.sourceLines = gcode.size();
+    Optimizer optimizer(program);
+    for (std::size_t i = 0; i < gcode.size(); ++i) {
+        optimizer.feed(gcode[i], i);
+    }
+    optimizer.finish();
+    return program;
+}
@@ -0,0 +1,118 @@
+#include "LinkBenchmark.h"
+#include "SerialPortConfiguration.h"
+#include "Logger.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <future>
+#include <string>
+
+namespace {
+
+const char* BENCHMARK_COMMAND = "M114\r\n";
+const char* BENCHMARK_REPLY = "CURRENT POSITION";
+
+std::string describe(const ComunicatorPort::ThroughputSample& sample) {
+    char text[160];
+    if (sample.commands == 0) {
+        std::snprintf(text, sizeof(text), "%d baudios: cambio rechazado", sample.baudRate);
+    } else {
+        std::snprintf(text, sizeof(text), "%d baudios: %.0f cmd/s, %.0f B/s enviados, %.0f B/s recibidos%s",
+                      sample.baudRate, sample.commandsPerSecond, sample.bytesSentPerSecond,
+                      sample.bytesReceivedPerSecond, sample.stable ? "" : " (inestable)");
+    }
+    return text;
+}
+
+} // namespace
+
+std::vector<int> ComunicatorPort::LinkBenchmark::defaultCandidates() {
+    std::vector<int> candidates;
+    for (int rate : {230400, 250000, 500000, 1000000}) {
+        if (ConfigurationPort::SerialPortConfiguration::isSupportedRate(rate)) {
+            candidates.push_back(rate);
+        }
+    }
+    return candidates;
+}
+
+ComunicatorPort::LinkBenchmark::LinkBenchmark(ISerialCommunicator& communicator, std::size_t commandsPerRate)
+    : communicator_(communicator), commandsPerRate_(commandsPerRate == 0 ? 1 : commandsPerRate) {
+}
+
+ComunicatorPort::ThroughputSample ComunicatorPort::LinkBenchmark::measure() {
+    ThroughputSample sample;
+    sample.baudRate = communicator_.getBaudRate();
+    sample.commands = commandsPerRate_;
+
+    std::vector<std::future<SerialReply>> replies;
+    replies.reserve(commandsPerRate_);
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < commandsPerRate_; ++i) {
+        replies.push_back(communicator_.submit(BENCHMARK_COMMAND));
+    }
+
+    std::size_t sent = 0;
+    std::size_t received = 0;
+    for (auto& future : replies) {
+        SerialReply reply = future.get();
+        // Los comunicadores que no cuentan bytes de línea se miden por el texto.
+        sent += reply.wireBytesSent != 0 ? reply.wireBytesSent : std::string(BENCHMARK_COMMAND).size();
+        received += reply.wireBytesReceived != 0 ? reply.wireBytesReceived : reply.text.size();
+        if (!reply.complete || reply.error || reply.text.find(BENCHMARK_REPLY) == std::string::npos) {
+            sample.failures++;
+        }
+    }
+    sample.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    sample.stable = (sample.failures == 0);
+    if (sample.seconds > 0) {
+        sample.commandsPerSecond = sample.commands / sample.seconds;
+        sample.bytesSentPerSecond = sent / sample.seconds;
+        sample.bytesReceivedPerSecond = received / sample.seconds;
+    }
+    return sample;
+}
+
+ComunicatorPort::BaudSelection ComunicatorPort::LinkBenchmark::selectFastest(const std::vector<int>& candidates,
+                                                                            const std::function<void()>& reopen) {
+    BaudSelection selection;
+    ThroughputSample best = measure();
+    selection.samples.push_back(best);
+    Logger::getInstance().log(LogLevel::INFO, "[Link Benchmark] " + describe(best));
+
+    std::vector<int> rates(candidates);
+    std::sort(rates.begin(), rates.end());
+    bool failed = !best.stable;
+    for (int rate : rates) {
+        if (failed) {
+            break;
+        }
+        if (rate <= best.baudRate) {
+            continue;
+        }
+        ThroughputSample sample;
+        sample.baudRate = rate;
+        if (communicator_.changeBaudRate(rate)) {
+            sample = measure();
+        }
+        selection.samples.push_back(sample);
+        Logger::getInstance().log(LogLevel::INFO, "[Link Benchmark] " + describe(sample));
+        if (!sample.stable) {
+            failed = true;
+        } else if (sample.commandsPerSecond >= best.commandsPerSecond * MIN_GAIN) {
+            best = sample;
+        }
+    }
+
+    if (failed) {
+        reopen();
+    }
+    if (communicator_.getBaudRate() != best.baudRate && !communicator_.changeBaudRate(best.baudRate)) {
+        // Ya había funcionado; si ahora no, volvemos a la velocidad de arranque.
+        reopen();
+    }
+    selection.baudRate = communicator_.getBaudRate();
+    Logger::getInstance().log(LogLevel::INFO, "[Link Benchmark] Velocidad elegida: " + std::to_string(selection.baudRate) + " baudios.");
+    return selection;
+}
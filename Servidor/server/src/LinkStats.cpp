@@ -0,0 +1,215 @@
+#include "LinkStats.h"
+
+#include <cctype>
+#include <chrono>
+
+// --- LatencyHistogram ---
+
+ComunicatorPort::LatencyHistogram::LatencyHistogram() {
+    for (auto& bucket : buckets_) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+}
+
+int ComunicatorPort::LatencyHistogram::bucketFor(std::uint64_t micros) {
+    if (micros < 2 * SUB_BUCKETS) {
+        return static_cast<int>(micros);
+    }
+    if (micros > 0xFFFFFFFFull) {
+        micros = 0xFFFFFFFFull;
+    }
+    // La cubeta queda definida por la posición del bit más alto y los 4 bits que le siguen.
+    int msb = 63 - __builtin_clzll(micros);
+    int shift = msb - 4;
+    return shift * SUB_BUCKETS + static_cast<int>(micros >> shift);
+}
+
+std::uint64_t ComunicatorPort::LatencyHistogram::bucketUpperBound(int bucket) {
+    if (bucket < 2 * SUB_BUCKETS) {
+        return static_cast<std::uint64_t>(bucket);
+    }
+    int shift = bucket / SUB_BUCKETS - 1;
+    std::uint64_t mantissa = static_cast<std::uint64_t>(bucket - shift * SUB_BUCKETS);
+    return ((mantissa + 1) << shift) - 1;
+}
+
+void ComunicatorPort::LatencyHistogram::record(std::uint64_t micros) {
+    buckets_[bucketFor(micros)].fetch_add(1, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+    std::uint64_t currentMax = max_.load(std::memory_order_relaxed);
+    while (micros > currentMax && !max_.compare_exchange_weak(currentMax, micros, std::memory_order_relaxed)) {
+    }
+}
+
+std::uint64_t ComunicatorPort::LatencyHistogram::percentile(double quantile) const {
+    std::uint64_t total = 0;
+    std::array<std::uint64_t, BUCKET_COUNT> counts;
+    for (int i = 0; i < BUCKET_COUNT; ++i) {
+        counts[i] = buckets_[i].load(std::memory_order_relaxed);
+        total += counts[i];
+    }
+    if (total == 0) {
+        return 0;
+    }
+    // Rango de la muestra buscada (1..total), redondeando hacia arriba como HdrHistogram.
+    std::uint64_t target = static_cast<std::uint64_t>(quantile * total + 0.999999);
+    if (target < 1) target = 1;
+    if (target > total) target = total;
+
+    std::uint64_t seen = 0;
+    for (int i = 0; i < BUCKET_COUNT; ++i) {
+        seen += counts[i];
+        if (seen >= target) {
+            // El límite superior de la cubeta nunca supera el máximo real observado.
+            std::uint64_t bound = bucketUpperBound(i);
+            std::uint64_t observedMax = max();
+            return bound < observedMax ? bound : observedMax;
+        }
+    }
+    return max();
+}
+
+void ComunicatorPort::LatencyHistogram::reset() {
+    for (auto& bucket : buckets_) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    count_.store(0, std::memory_order_relaxed);
+    max_.store(0, std::memory_order_relaxed);
+}
+
+// --- LinkStats ---
+
+ComunicatorPort::LinkStats::LinkStats() {
+    for (auto& slot : slots_) {
+        slot.store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+ComunicatorPort::LinkStats::~LinkStats() {
+    for (auto& slot : slots_) {
+        delete slot.load(std::memory_order_relaxed);
+    }
+}
+
+int ComunicatorPort::LinkStats::slotFor(const std::string& command) {
+    std::size_t first = command.find_first_not_of(" \t");
+    if (first == std::string::npos) {
+        return OTHER_SLOT;
+    }
+    char letter = static_cast<char>(std::toupper(static_cast<unsigned char>(command[first])));
+    if (letter != 'G' && letter != 'M') {
+        return OTHER_SLOT;
+    }
+    int number = 0;
+    std::size_t i = first + 1;
+    if (i >= command.size() || !std::isdigit(static_cast<unsigned char>(command[i]))) {
+        return OTHER_SLOT;
+    }
+    for (; i < command.size() && std::isdigit(static_cast<unsigned char>(command[i])); ++i) {
+        number = number * 10 + (command[i] - '0');
+        if (number >= CODES_PER_LETTER) {
+            return OTHER_SLOT;
+        }
+    }
+    return (letter == 'G' ? 0 : CODES_PER_LETTER) + number;
+}
+
+std::string ComunicatorPort::LinkStats::slotName(int slot) {
+    if (slot == OTHER_SLOT) {
+        return "OTHER";
+    }
+    return (slot < CODES_PER_LETTER ? "G" : "M") + std::to_string(slot % CODES_PER_LETTER);
+}
+
+std::string ComunicatorPort::LinkStats::familyOf(const std::string& command) {
+    return slotName(slotFor(command));
+}
+
+ComunicatorPort::LinkStats::FamilySlot& ComunicatorPort::LinkStats::slot(int index) {
+    FamilySlot* existing = slots_[index].load(std::memory_order_acquire);
+    if (existing) {
+        return *existing;
+    }
+    // Primera vez que se ve esta familia: si otro hilo la crea antes, se usa la suya.
+    FamilySlot* created = new FamilySlot();
+    if (slots_[index].compare_exchange_strong(existing, created, std::memory_order_acq_rel)) {
+        return *created;
+    }
+    delete created;
+    return *existing;
+}
+
+void ComunicatorPort::LinkStats::record(const std::string& command, const SerialReply& reply) {
+    FamilySlot& family = slot(slotFor(command));
+    commands_.fetch_add(1, std::memory_order_relaxed);
+    // Con el protocolo binario lo que viaja por el cable no coincide con el texto.
+    bytesSent_.fetch_add(reply.wireBytesSent ? reply.wireBytesSent : command.size(), std::memory_order_relaxed);
+    bytesReceived_.fetch_add(reply.wireBytesReceived ? reply.wireBytesReceived : reply.text.size(), std::memory_order_relaxed);
+
+    if (!reply.complete) {
+        family.timeouts.fetch_add(1, std::memory_order_relaxed);
+        timeouts_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    if (reply.error) {
+        family.errors.fetch_add(1, std::memory_order_relaxed);
+        errors_.fetch_add(1, std::memory_order_relaxed);
+    }
+    auto micros = std::chrono::duration_cast<std::chrono::microseconds>(reply.receivedAt - reply.sentAt).count();
+    family.latency.record(micros > 0 ? static_cast<std::uint64_t>(micros) : 0);
+}
+
+void ComunicatorPort::LinkStats::recordTimeout(const std::string& command) {
+    FamilySlot& family = slot(slotFor(command));
+    commands_.fetch_add(1, std::memory_order_relaxed);
+    bytesSent_.fetch_add(command.size(), std::memory_order_relaxed);
+    family.timeouts.fetch_add(1, std::memory_order_relaxed);
+    timeouts_.fetch_add(1, std::memory_order_relaxed);
+}
+
+ComunicatorPort::LinkStatsSnapshot ComunicatorPort::LinkStats::snapshot() const {
+    LinkStatsSnapshot result;
+    result.commands = commands_.load(std::memory_order_relaxed);
+    result.bytesSent = bytesSent_.load(std::memory_order_relaxed);
+    result.bytesReceived = bytesReceived_.load(std::memory_order_relaxed);
+    result.timeouts = timeouts_.load(std::memory_order_relaxed);
+    result.errors = errors_.load(std::memory_order_relaxed);
+
+    for (int i = 0; i < SLOT_COUNT; ++i) {
+        const FamilySlot* family = slots_[i].load(std::memory_order_acquire);
+        if (!family) {
+            continue;
+        }
+        CommandFamilyStats stats;
+        stats.family = slotName(i);
+        stats.count = family->latency.count();
+        stats.errors = family->errors.load(std::memory_order_relaxed);
+        stats.timeouts = family->timeouts.load(std::memory_order_relaxed);
+        if (stats.count == 0 && stats.timeouts == 0) {
+            continue;
+        }
+        stats.p50Ms = family->latency.percentile(0.50) / 1000.0;
+        stats.p90Ms = family->latency.percentile(0.90) / 1000.0;
+        stats.p99Ms = family->latency.percentile(0.99) / 1000.0;
+        stats.maxMs = family->latency.max() / 1000.0;
+        result.families.push_back(stats);
+    }
+    return result;
+}
+
+void ComunicatorPort::LinkStats::reset() {
+    commands_.store(0, std::memory_order_relaxed);
+    bytesSent_.store(0, std::memory_order_relaxed);
+    bytesReceived_.store(0, std::memory_order_relaxed);
+    timeouts_.store(0, std::memory_order_relaxed);
+    errors_.store(0, std::memory_order_relaxed);
+    // Las ranuras se conservan (otros hilos pueden estar usándolas); solo se vacían.
+    for (auto& slot : slots_) {
+        FamilySlot* family = slot.load(std::memory_order_acquire);
+        if (family) {
+            family->latency.reset();
+            family->errors.store(0, std::memory_order_relaxed);
+            family->timeouts.store(0, std::memory_order_relaxed);
+        }
+    }
+}
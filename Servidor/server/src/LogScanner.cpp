@@ -0,0 +1,102 @@
+#include "LogScanner.h"
+
+#include <ctime>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+bool twoDigits(std::string_view text, std::size_t at, int& value) {
+    char const high = text[at];
+    char const low = text[at + 1];
+    if (high < '0' || high > '9' || low < '0' || low > '9') {
+        return false;
+    }
+    value = (high - '0') * 10 + (low - '0');
+    return true;
+}
+} // namespace
+
+// Constructors/Destructors
+
+LogScanner::LogScanner(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return;
+    }
+    struct stat status;
+    if (::fstat(fd, &status) == 0 && status.st_size > 0) {
+        void* mapped = ::mmap(nullptr, static_cast<std::size_t>(status.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapped != MAP_FAILED) {
+            ::madvise(mapped, static_cast<std::size_t>(status.st_size), MADV_SEQUENTIAL);
+            data_ = static_cast<const char*>(mapped);
+            size_ = static_cast<std::size_t>(status.st_size);
+        }
+    }
+    ::close(fd); // El mapeo sigue valiendo sin el descriptor.
+}
+
+LogScanner::~LogScanner() {
+    if (data_ != nullptr) {
+        ::munmap(const_cast<char*>(data_), size_);
+    }
+}
+
+std::vector<std::string_view> LogScanner::chunks(std::string_view text, std::size_t parts, std::size_t minBytes) {
+    std::vector<std::string_view> result;
+    if (text.empty()) {
+        return result;
+    }
+    parts = std::max<std::size_t>(1, std::min(parts, text.size() / std::max<std::size_t>(minBytes, 1)));
+    std::size_t const target = text.size() / parts;
+    std::size_t start = 0;
+    for (std::size_t i = 0; i < parts && start < text.size(); ++i) {
+        std::size_t end = text.size();
+        if (i + 1 < parts) {
+            std::size_t const newline = text.find('\n', std::max(start, (i + 1) * target));
+            end = newline == std::string_view::npos ? text.size() : newline + 1;
+        }
+        result.push_back(text.substr(start, end - start));
+        start = end;
+    }
+    return result;
+}
+
+LogRow LogScanner::split(std::string_view line) {
+    LogRow result;
+    forEachRow(line, 0, [&result](const LogRow& row) { result = row; });
+    return result;
+}
+
+bool LogScanner::parseTimestamp(std::string_view timestamp, std::int64_t& seconds) {
+    // "AAAA-MM-DD | HH:MM:SS"
+    if (timestamp.size() < 21 || timestamp[4] != '-' || timestamp[7] != '-' || timestamp.substr(10, 3) != " | " ||
+        timestamp[15] != ':' || timestamp[18] != ':') {
+        return false;
+    }
+    int century, year, month, day, hour, minute, second;
+    if (!twoDigits(timestamp, 0, century) || !twoDigits(timestamp, 2, year) || !twoDigits(timestamp, 5, month) ||
+        !twoDigits(timestamp, 8, day) || !twoDigits(timestamp, 13, hour) || !twoDigits(timestamp, 16, minute) ||
+        !twoDigits(timestamp, 19, second)) {
+        return false;
+    }
+    year += century * 100;
+
+    // mktime() resuelve la zona horaria (y toma un lock global): una vez por hora alcanza.
+    thread_local std::int64_t cachedHour = -1;
+    thread_local std::int64_t cachedBase = 0;
+    std::int64_t const hourKey = ((static_cast<std::int64_t>(year) * 100 + month) * 100 + day) * 100 + hour;
+    if (hourKey != cachedHour) {
+        std::tm local{};
+        local.tm_year = year - 1900;
+        local.tm_mon = month - 1;
+        local.tm_mday = day;
+        local.tm_hour = hour;
+        local.tm_isdst = -1;
+        cachedBase = static_cast<std::int64_t>(std::mktime(&local));
+        cachedHour = hourKey;
+    }
+    seconds = cachedBase + minute * 60 + second;
+    return true;
+}
@@ -0,0 +1,532 @@
+#include "LogStore.h"
+#include "LogScanner.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <iostream>
+#include <iterator>
+#include <string_view>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+// Formato del .idx: magia, largo de la cabecera, rango de tiempo, listas por nivel, listas por
+// usuario (nombre + dónde está la lista) y, después de la cabecera, las listas de posiciones.
+constexpr char INDEX_MAGIC[8] = {'L', 'O', 'G', 'I', 'D', 'X', '1', '\n'};
+constexpr std::size_t MAX_READ_RUN_BYTES = 1024 * 1024;
+
+/// @brief Escribe todo el buffer, reintentando las escrituras parciales.
+bool writeAll(int fd, const char* data, std::size_t size) {
+    std::size_t offset = 0;
+    while (offset < size) {
+        ssize_t count = ::write(fd, data + offset, size - offset);
+        if (count < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            std::cerr << "LOG_FALLBACK: no se pudo escribir el log: " << std::strerror(errno) << std::endl;
+            return false;
+        }
+        offset += static_cast<std::size_t>(count);
+    }
+    return true;
+}
+
+bool readAt(int fd, char* data, std::size_t size, std::uint64_t offset) {
+    std::size_t done = 0;
+    while (done < size) {
+        ssize_t count = ::pread(fd, data + done, size - done, static_cast<off_t>(offset + done));
+        if (count < 0 && errno == EINTR) {
+            continue;
+        }
+        if (count <= 0) {
+            return false;
+        }
+        done += static_cast<std::size_t>(count);
+    }
+    return true;
+}
+
+template <typename T>
+void put(std::string& out, T value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+/// @brief Lee valores de la cabecera del .idx sin pasarse del final.
+class HeaderReader {
+public:
+    explicit HeaderReader(const std::string& data) : data_(data) {}
+
+    template <typename T>
+    T get() {
+        T value{};
+        if (position_ + sizeof(T) > data_.size()) {
+            ok_ = false;
+            return value;
+        }
+        std::memcpy(&value, data_.data() + position_, sizeof(T));
+        position_ += sizeof(T);
+        return value;
+    }
+
+    std::string getString(std::size_t size) {
+        if (position_ + size > data_.size()) {
+            ok_ = false;
+            return std::string();
+        }
+        std::string value = data_.substr(position_, size);
+        position_ += size;
+        return value;
+    }
+
+    bool ok() const { return ok_; }
+
+private:
+    const std::string& data_;
+    std::size_t position_ = 0;
+    bool ok_ = true;
+};
+
+std::string_view trimLeft(std::string_view text) {
+    std::size_t start = text.find_first_not_of(" \t\r\n");
+    return start == std::string_view::npos ? std::string_view() : text.substr(start);
+}
+
+/// @brief Lee el nivel, el momento y el usuario de una línea ya escrita.
+bool parseRow(const LogRow& row, LogLevel& level, std::int64_t& time, std::string_view& user) {
+    std::string_view const levelName = trimLeft(row.level);
+    for (LogLevel candidate : {LogLevel::DEBUG, LogLevel::INFO, LogLevel::WARNING, LogLevel::ERROR, LogLevel::CRITICAL}) {
+        if (levelName == Logger::levelToString(candidate)) {
+            level = candidate;
+            user = trimLeft(row.user);
+            return LogScanner::parseTimestamp(row.timestamp, time);
+        }
+    }
+    return false;
+}
+} // namespace
+
+// Constructors/Destructors
+
+LogStore::LogStore(const LogStoreOptions& options)
+    : options_(options),
+      maxSegmentBytes_(options.maxSegmentBytes),
+      maxSegmentAge_(options.maxSegmentAge.count()) {
+    loadSegments();
+    indexExisting();
+    openActive();
+}
+
+LogStore::~LogStore() {
+    if (fd_ >= 0) {
+        ::close(fd_);
+    }
+}
+
+void LogStore::openActive() {
+    fd_ = ::open(options_.activePath.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+}
+
+void LogStore::setLimits(std::uint64_t maxSegmentBytes, std::chrono::seconds maxSegmentAge) {
+    maxSegmentBytes_ = maxSegmentBytes;
+    maxSegmentAge_ = maxSegmentAge.count();
+}
+
+std::size_t LogStore::segmentCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return segments_.size();
+}
+
+std::string LogStore::segmentPath(std::uint64_t sequence, const char* extension) const {
+    char name[48];
+    std::snprintf(name, sizeof(name), "/segment-%06llu%s", static_cast<unsigned long long>(sequence), extension);
+    return options_.segmentDir + name;
+}
+
+void LogStore::loadSegments() {
+    DIR* directory = ::opendir(options_.segmentDir.c_str());
+    if (directory == nullptr) {
+        return; // Todavía no se cerró ningún segmento.
+    }
+    std::vector<std::uint64_t> indexed;
+    while (dirent* entry = ::readdir(directory)) {
+        unsigned long long sequence = 0;
+        char extension[8] = {0};
+        int consumed = 0;
+        if (std::sscanf(entry->d_name, "segment-%llu.%3s%n", &sequence, extension, &consumed) != 2 ||
+            entry->d_name[consumed] != '\0') {
+            continue;
+        }
+        nextSequence_ = std::max<std::uint64_t>(nextSequence_, sequence + 1);
+        if (std::strcmp(extension, "idx") == 0) {
+            indexed.push_back(sequence);
+        }
+    }
+    ::closedir(directory);
+
+    std::sort(indexed.begin(), indexed.end());
+    for (std::uint64_t sequence : indexed) {
+        Segment segment;
+        segment.dataPath = segmentPath(sequence, ".csv");
+        segment.indexPath = segmentPath(sequence, ".idx");
+        if (::access(segment.dataPath.c_str(), R_OK) == 0 && readHeader(segment.indexPath, segment)) {
+            segments_.push_back(std::move(segment));
+        } else {
+            std::cerr << "[Log Store] Se ignora el segmento incompleto " << segment.indexPath << std::endl;
+        }
+    }
+}
+
+void LogStore::indexExisting() {
+    // Se lee una sola vez, al arrancar: de ahí en más el índice se arma al escribir. Un
+    // application.csv de varios GB se escanea mapeado y repartido entre hilos.
+    LogScanner scanner(options_.activePath);
+    using Located = std::pair<std::uint64_t, Entry>;
+    std::vector<Located> lines = scanner.collect<Located>([](const LogRow& row, std::vector<Located>& out) {
+        Entry entry{row.length, LogLevel::INFO, 0, std::string()};
+        std::string_view user;
+        if (parseRow(row, entry.level, entry.time, user)) {
+            entry.user = std::string(user);
+            out.emplace_back(row.offset, std::move(entry));
+        }
+    });
+    for (const Located& line : lines) {
+        addToIndex(line.first, line.second);
+    }
+    active_.bytes = scanner.data().size();
+}
+
+void LogStore::addToIndex(std::uint64_t offset, const Entry& entry) {
+    if (active_.records == 0) {
+        active_.firstTime = entry.time;
+        active_.lastTime = entry.time;
+    }
+    active_.records++;
+    active_.lastTime = std::max(active_.lastTime, entry.time);
+    Posting const posting{offset, entry.length, static_cast<std::int32_t>(entry.time - active_.firstTime)};
+    active_.levels[static_cast<std::size_t>(entry.level)].push_back(posting);
+    if (!entry.user.empty()) {
+        active_.users[entry.user].push_back(posting);
+    }
+}
+
+void LogStore::append(const std::string& batch, const std::vector<Entry>& entries) {
+    if (fd_ < 0 || batch.empty()) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::uint64_t const maxBytes = maxSegmentBytes_.load(std::memory_order_relaxed);
+        std::int64_t const maxAge = maxSegmentAge_.load(std::memory_order_relaxed);
+        bool const full = maxBytes > 0 && active_.bytes >= maxBytes;
+        bool const old = maxAge > 0 && active_.records > 0 && !entries.empty() &&
+                         entries.front().time - active_.firstTime >= maxAge;
+        if (full || old) {
+            sealLocked();
+            if (fd_ < 0) {
+                return;
+            }
+        }
+    }
+
+    bool const written = writeAll(fd_, batch.data(), batch.size());
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!written) {
+        // No se sabe cuánto llegó al archivo: se sigue desde su tamaño real, sin indexar la tanda.
+        struct stat status;
+        if (::fstat(fd_, &status) == 0) {
+            active_.bytes = static_cast<std::uint64_t>(status.st_size);
+        }
+        return;
+    }
+    std::uint64_t offset = active_.bytes;
+    for (const Entry& entry : entries) {
+        addToIndex(offset, entry);
+        offset += entry.length;
+    }
+    active_.bytes += batch.size();
+}
+
+void LogStore::sync() {
+    if (fd_ >= 0) {
+        ::fdatasync(fd_);
+    }
+}
+
+void LogStore::rotate() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    sealLocked();
+}
+
+void LogStore::sealLocked() {
+    if (active_.bytes == 0) {
+        return;
+    }
+    ::mkdir(options_.segmentDir.c_str(), 0755); // Si ya existe, falla sin problema.
+    std::uint64_t const sequence = nextSequence_++;
+    Segment segment;
+    segment.dataPath = segmentPath(sequence, ".csv");
+    segment.indexPath = segmentPath(sequence, ".idx");
+    segment.firstTime = active_.firstTime;
+    segment.lastTime = active_.lastTime;
+
+    // Primero el tamaño de la cabecera, para saber dónde empieza cada lista.
+    std::uint64_t headerBytes = sizeof(INDEX_MAGIC) + sizeof(std::uint64_t) + 2 * sizeof(std::int64_t) +
+                                sizeof(std::uint32_t) + LEVEL_COUNT * 2 * sizeof(std::uint64_t) + sizeof(std::uint32_t);
+    for (const auto& user : active_.users) {
+        headerBytes += sizeof(std::uint32_t) + user.first.size() + 2 * sizeof(std::uint64_t);
+    }
+    std::uint64_t next = headerBytes;
+    for (std::size_t level = 0; level < LEVEL_COUNT; ++level) {
+        segment.levels[level] = PostingList{next, active_.levels[level].size()};
+        next += active_.levels[level].size() * sizeof(Posting);
+    }
+    for (const auto& user : active_.users) {
+        segment.users[user.first] = PostingList{next, user.second.size()};
+        next += user.second.size() * sizeof(Posting);
+    }
+
+    std::string index;
+    index.reserve(next);
+    index.append(INDEX_MAGIC, sizeof(INDEX_MAGIC));
+    put<std::uint64_t>(index, headerBytes);
+    put<std::int64_t>(index, segment.firstTime);
+    put<std::int64_t>(index, segment.lastTime);
+    put<std::uint32_t>(index, static_cast<std::uint32_t>(LEVEL_COUNT));
+    for (const PostingList& list : segment.levels) {
+        put<std::uint64_t>(index, list.offset);
+        put<std::uint64_t>(index, list.count);
+    }
+    put<std::uint32_t>(index, static_cast<std::uint32_t>(segment.users.size()));
+    for (const auto& user : segment.users) {
+        put<std::uint32_t>(index, static_cast<std::uint32_t>(user.first.size()));
+        index += user.first;
+        put<std::uint64_t>(index, user.second.offset);
+        put<std::uint64_t>(index, user.second.count);
+    }
+    for (const auto& postings : active_.levels) {
+        index.append(reinterpret_cast<const char*>(postings.data()), postings.size() * sizeof(Posting));
+    }
+    for (const auto& user : active_.users) {
+        index.append(reinterpret_cast<const char*>(user.second.data()), user.second.size() * sizeof(Posting));
+    }
+
+    // El índice queda completo antes de mover los datos: un .idx sin su .csv se ignora al arrancar.
+    std::string const temporary = segment.indexPath + ".tmp";
+    int indexFd = ::open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    bool ok = indexFd >= 0 && writeAll(indexFd, index.data(), index.size());
+    if (indexFd >= 0) {
+        ::close(indexFd);
+    }
+    ok = ok && ::rename(temporary.c_str(), segment.indexPath.c_str()) == 0;
+    if (!ok) {
+        std::cerr << "[Log Store] No se pudo escribir el índice " << segment.indexPath << ": "
+                  << std::strerror(errno) << "; se sigue en el mismo segmento." << std::endl;
+        ::unlink(temporary.c_str());
+        return;
+    }
+
+    ::close(fd_);
+    if (::rename(options_.activePath.c_str(), segment.dataPath.c_str()) != 0) {
+        std::cerr << "[Log Store] No se pudo mover " << options_.activePath << " a " << segment.dataPath
+                  << ": " << std::strerror(errno) << std::endl;
+        ::unlink(segment.indexPath.c_str());
+        openActive();
+        return;
+    }
+    segments_.push_back(std::move(segment));
+    active_ = ActiveIndex();
+    openActive();
+}
+
+bool LogStore::readHeader(const std::string& indexPath, Segment& segment) {
+    int fd = ::open(indexPath.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    char prefix[sizeof(INDEX_MAGIC) + sizeof(std::uint64_t)];
+    std::uint64_t headerBytes = 0;
+    bool ok = readAt(fd, prefix, sizeof(prefix), 0) && std::memcmp(prefix, INDEX_MAGIC, sizeof(INDEX_MAGIC)) == 0;
+    if (ok) {
+        std::memcpy(&headerBytes, prefix + sizeof(INDEX_MAGIC), sizeof(headerBytes));
+        ok = headerBytes >= sizeof(prefix) && headerBytes < (std::uint64_t(1) << 32);
+    }
+    std::string header;
+    if (ok) {
+        header.resize(headerBytes - sizeof(prefix));
+        ok = readAt(fd, header.data(), header.size(), sizeof(prefix));
+    }
+    ::close(fd);
+    if (!ok) {
+        return false;
+    }
+
+    HeaderReader reader(header);
+    segment.firstTime = reader.get<std::int64_t>();
+    segment.lastTime = reader.get<std::int64_t>();
+    if (reader.get<std::uint32_t>() != LEVEL_COUNT) {
+        return false;
+    }
+    for (PostingList& list : segment.levels) {
+        list.offset = reader.get<std::uint64_t>();
+        list.count = reader.get<std::uint64_t>();
+    }
+    std::uint32_t const users = reader.get<std::uint32_t>();
+    for (std::uint32_t i = 0; i < users && reader.ok(); ++i) {
+        std::string name = reader.getString(reader.get<std::uint32_t>());
+        PostingList list;
+        list.offset = reader.get<std::uint64_t>();
+        list.count = reader.get<std::uint64_t>();
+        segment.users.emplace(std::move(name), list);
+    }
+    return reader.ok();
+}
+
+bool LogStore::readPostings(const std::string& indexPath, const std::vector<PostingList>& lists,
+                            std::vector<std::vector<Posting>>& postings) {
+    int fd = ::open(indexPath.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    bool ok = true;
+    for (const PostingList& list : lists) {
+        std::vector<Posting> values(list.count);
+        ok = ok && readAt(fd, reinterpret_cast<char*>(values.data()), values.size() * sizeof(Posting), list.offset);
+        postings.push_back(std::move(values));
+    }
+    ::close(fd);
+    return ok;
+}
+
+std::vector<LogStore::Posting> LogStore::combine(std::vector<std::vector<Posting>> lists, const Query& query,
+                                                 std::int64_t firstTime) {
+    auto byOffset = [](const Posting& a, const Posting& b) { return a.offset < b.offset; };
+    std::vector<Posting> result;
+    if (query.level && query.user && lists.size() == 2) {
+        std::set_intersection(lists[0].begin(), lists[0].end(), lists[1].begin(), lists[1].end(),
+                              std::back_inserter(result), byOffset);
+    } else if (lists.size() == 1) {
+        result = std::move(lists[0]);
+    } else {
+        for (auto& list : lists) {
+            result.insert(result.end(), list.begin(), list.end());
+        }
+        std::sort(result.begin(), result.end(), byOffset);
+    }
+
+    if (query.from != std::numeric_limits<std::int64_t>::min() || query.to != std::numeric_limits<std::int64_t>::max()) {
+        result.erase(std::remove_if(result.begin(), result.end(), [&](const Posting& posting) {
+            std::int64_t const time = firstTime + posting.time;
+            return time < query.from || time > query.to;
+        }), result.end());
+    }
+    return result;
+}
+
+void LogStore::readLines(int fd, const std::vector<Posting>& postings, std::vector<std::string>& lines) {
+    // Las líneas contiguas se leen juntas, con un solo pread().
+    std::string buffer;
+    std::size_t first = 0;
+    while (first < postings.size()) {
+        std::size_t last = first + 1;
+        std::uint64_t end = postings[first].offset + postings[first].length;
+        while (last < postings.size() && postings[last].offset == end &&
+               end + postings[last].length - postings[first].offset <= MAX_READ_RUN_BYTES) {
+            end += postings[last].length;
+            last++;
+        }
+        buffer.resize(static_cast<std::size_t>(end - postings[first].offset));
+        if (readAt(fd, buffer.data(), buffer.size(), postings[first].offset)) {
+            std::size_t position = 0;
+            for (std::size_t i = first; i < last; ++i) {
+                std::size_t length = postings[i].length;
+                if (length > 0 && buffer[position + length - 1] == '\n') {
+                    lines.emplace_back(buffer, position, length - 1);
+                } else {
+                    lines.emplace_back(buffer, position, length);
+                }
+                position += postings[i].length;
+            }
+        }
+        first = last;
+    }
+}
+
+std::vector<std::string> LogStore::query(const Query& query) const {
+    std::size_t const levelIndex = query.level ? static_cast<std::size_t>(*query.level) : 0;
+    std::vector<Plan> plans;
+    std::vector<Posting> activePostings;
+    int activeFd = -1;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const Segment& segment : segments_) {
+            if (segment.lastTime < query.from || segment.firstTime > query.to) {
+                continue;
+            }
+            Plan plan{segment.dataPath, segment.indexPath, segment.firstTime, {}};
+            if (query.level) {
+                if (segment.levels[levelIndex].count == 0) {
+                    continue;
+                }
+                plan.lists.push_back(segment.levels[levelIndex]);
+            }
+            if (query.user) {
+                auto user = segment.users.find(*query.user);
+                if (user == segment.users.end()) {
+                    continue;
+                }
+                plan.lists.push_back(user->second);
+            }
+            if (!query.level && !query.user) {
+                plan.lists.assign(segment.levels.begin(), segment.levels.end());
+            }
+            plans.push_back(std::move(plan));
+        }
+
+        if (active_.records > 0 && active_.lastTime >= query.from && active_.firstTime <= query.to) {
+            std::vector<std::vector<Posting>> lists;
+            if (query.level) {
+                lists.push_back(active_.levels[levelIndex]);
+            }
+            if (query.user) {
+                auto user = active_.users.find(*query.user);
+                lists.push_back(user == active_.users.end() ? std::vector<Posting>() : user->second);
+            }
+            if (!query.level && !query.user) {
+                lists.assign(active_.levels.begin(), active_.levels.end());
+            }
+            activePostings = combine(std::move(lists), query, active_.firstTime);
+        }
+        if (!activePostings.empty()) {
+            // Se abre con el lock tomado: si después se cierra el segmento, el descriptor sigue valiendo.
+            activeFd = ::open(options_.activePath.c_str(), O_RDONLY | O_CLOEXEC);
+        }
+    }
+
+    std::vector<std::string> lines;
+    for (const Plan& plan : plans) {
+        std::vector<std::vector<Posting>> lists;
+        if (!readPostings(plan.indexPath, plan.lists, lists)) {
+            continue;
+        }
+        std::vector<Posting> const postings = combine(std::move(lists), query, plan.firstTime);
+        if (postings.empty()) {
+            continue;
+        }
+        int fd = ::open(plan.dataPath.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd >= 0) {
+            readLines(fd, postings, lines);
+            ::close(fd);
+        }
+    }
+    if (activeFd >= 0) {
+        readLines(activeFd, activePostings, lines);
+        ::close(activeFd);
+    }
+    return lines;
+}
@@ -1,10 +1,16 @@
 #include "Logger.h"
+#include "LogStore.h"
 
 #include <iostream>
-#include <chrono>
-#include <iomanip>
-#include <sstream>
-#include <mutex> // Para std::mutex y std::lock_guard
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace {
+// Las tandas grandes se escriben en partes, para no acumular todo en memoria.
+constexpr std::size_t BATCH_WRITE_BYTES = 256 * 1024;
+} // namespace
 
 // Constructors/Destructors
 
@@ -16,22 +22,29 @@ Logger& Logger::getInstance() {
 }
 
 Logger::Logger() {
-    // El constructor del Logger ahora le pide al FileManager que abra el archivo.
-    if (!fileManager_.open("application.csv", true)) {
+    store_ = std::make_unique<LogStore>();
+    if (!store_->isOpen()) {
         // Si no se puede abrir, lo notificamos por la consola de errores.
         std::cerr << "CRITICAL: No se pudo abrir el archivo de log 'application.csv'." << std::endl;
     }
+    writer_ = std::thread(&Logger::writerLoop, this);
     // Mensaje inicial al crear el logger por primera vez.
     log(LogLevel::INFO, "Logger inicializado.");
 }
 
 Logger::~Logger() {
     log(LogLevel::INFO, "Logger finalizado.");
-    // El destructor del Logger le pide al FileManager que cierre el archivo.
-    fileManager_.close();
+    {
+        std::lock_guard<std::mutex> lock(writerMutex_);
+        writerRunning_ = false;
+    }
+    writerWake_.notify_all();
+    if (writer_.joinable()) {
+        writer_.join(); // Antes de salir vacía la cola.
+    }
 }
 
-std::string Logger::levelToString(LogLevel level) {
+const char* Logger::levelToString(LogLevel level) {
     switch (level) {
         case LogLevel::DEBUG:    return "DEBUG";
         case LogLevel::INFO:     return "INFO";
@@ -42,32 +55,259 @@ std::string Logger::levelToString(LogLevel level) {
     }
 }
 
-void Logger::log(LogLevel level, 
-                 const std::string& message, 
-                 const std::optional<std::string>& user, 
+void Logger::configure(const LoggerOptions& options) {
+    flushIntervalMs_ = static_cast<int>(options.flushInterval.count());
+    durability_ = options.durability;
+    overflow_ = options.overflow;
+    store_->setLimits(options.segmentBytes, options.segmentAge);
+    wakeRequested_ = true; // Para que tome el intervalo nuevo.
+    writerWake_.notify_one();
+}
+
+void Logger::log(LogLevel level,
+                 const std::string& message,
+                 const std::optional<std::string>& user,
                  const std::optional<std::string>& node) {
-    // Obtener la fecha y hora actual
-    auto now = std::chrono::system_clock::now();
-    auto in_time_t = std::chrono::system_clock::to_time_t(now);
-
-    std::stringstream ss;
-    ss << std::put_time(std::localtime(&in_time_t), "%Y-%m-%d | %H:%M:%S");
-
-    // Formato CSV: timestamp, level, message, user, node
-    ss << ", " << levelToString(level) 
-       << ", " << message
-       << (user.has_value() ? ", "+*user : "") // Si no hay usuario, ponemos ""
-       << (node.has_value() ? ", "+*node : "");   // Si no hay nodo, ponemos ""
-
-    std::string log_line = ss.str() + "\n";
-
-    // Delegamos la escritura al FileManager.
-    if (fileManager_.isOpen()) {
-        fileManager_.write(log_line);
-        fileManager_.flush(); // Aseguramos que se escriba en disco inmediatamente.
-        std::cout << log_line; // También mostramos el log por la consola
+    if (!isEnabled(level, LogCategory::GENERAL)) {
+        return;
+    }
+    enqueue(level, message, user ? &*user : nullptr, node ? &*node : nullptr);
+}
+
+void Logger::logf(LogLevel level, LogCategory category, const char* format, ...) {
+    if (!isEnabled(level, category)) {
+        return; // Ni se recorren los argumentos.
+    }
+    va_list args;
+    va_start(args, format);
+    std::string const message = formatMessage(format, args);
+    va_end(args);
+    enqueue(level, message, nullptr, nullptr);
+}
+
+void Logger::logfAs(LogLevel level, LogCategory category, const std::string& user, const std::string& node,
+                    const char* format, ...) {
+    if (!isEnabled(level, category)) {
+        return;
+    }
+    va_list args;
+    va_start(args, format);
+    std::string const message = formatMessage(format, args);
+    va_end(args);
+    enqueue(level, message, &user, &node);
+}
+
+std::string Logger::formatMessage(const char* format, va_list args) {
+    // Casi todos los mensajes entran en el buffer de la pila: una sola pasada.
+    char buffer[512];
+    va_list retry;
+    va_copy(retry, args);
+    int const length = std::vsnprintf(buffer, sizeof(buffer), format, args);
+    std::string message;
+    if (length < 0) {
+        message = format; // Formato inválido: al menos queda el texto.
+    } else if (static_cast<std::size_t>(length) < sizeof(buffer)) {
+        message.assign(buffer, static_cast<std::size_t>(length));
     } else {
-        // Si el archivo no está abierto, mostramos el log por la consola como último recurso.
-        std::cerr << "LOG_FALLBACK: " << log_line;
+        message.resize(static_cast<std::size_t>(length));
+        std::vsnprintf(message.data(), message.size() + 1, format, retry);
+    }
+    va_end(retry);
+    return message;
+}
+
+void Logger::setMinLevel(LogLevel level) {
+    minLevel_.store(static_cast<int>(level), std::memory_order_relaxed);
+}
+
+LogLevel Logger::minLevel() {
+    return static_cast<LogLevel>(minLevel_.load(std::memory_order_relaxed));
+}
+
+void Logger::setCategoryEnabled(LogCategory category, bool enabled) {
+    unsigned const bit = 1u << static_cast<unsigned>(category);
+    if (enabled) {
+        quietCategories_.fetch_and(~bit, std::memory_order_relaxed);
+    } else {
+        quietCategories_.fetch_or(bit, std::memory_order_relaxed);
+    }
+}
+
+std::optional<LogLevel> Logger::levelFromString(const std::string& name) {
+    for (LogLevel level : {LogLevel::DEBUG, LogLevel::INFO, LogLevel::WARNING, LogLevel::ERROR, LogLevel::CRITICAL}) {
+        std::string levelName = levelToString(level);
+        for (char& c : levelName) {
+            c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        }
+        if (levelName == name) {
+            return level;
+        }
+    }
+    return std::nullopt;
+}
+
+std::optional<LogCategory> Logger::categoryFromString(const std::string& name) {
+    static const char* const names[] = {"general", "rpc", "auth", "serial", "robot", "database", "tasks"};
+    static_assert(sizeof(names) / sizeof(names[0]) == static_cast<std::size_t>(LogCategory::COUNT));
+    for (std::size_t i = 0; i < static_cast<std::size_t>(LogCategory::COUNT); ++i) {
+        if (name == names[i]) {
+            return static_cast<LogCategory>(i);
+        }
+    }
+    return std::nullopt;
+}
+
+void Logger::enqueue(LogLevel level, const std::string& message, const std::string* user, const std::string* node) {
+    // Formato CSV: timestamp, level, message, user, node. La fecha la agrega el hilo de escritura.
+    LogRecord record;
+    record.time = std::chrono::system_clock::now();
+    record.level = level;
+    if (user != nullptr) {
+        record.user = *user;
+    }
+    const char* levelName = levelToString(level);
+    record.text.reserve(4 + std::strlen(levelName) + message.size() +
+                        (user ? user->size() + 2 : 0) + (node ? node->size() + 2 : 0) + 1);
+    record.text += ", ";
+    record.text += levelName;
+    record.text += ", ";
+    record.text += message;
+    if (user != nullptr) { // Si no hay usuario, no ponemos nada
+        record.text += ", ";
+        record.text += *user;
+    }
+    if (node != nullptr) { // Si no hay nodo, no ponemos nada
+        record.text += ", ";
+        record.text += *node;
+    }
+    if (record.text.size() > MAX_LINE_BYTES) {
+        record.text.resize(MAX_LINE_BYTES - 3);
+        record.text += "...";
+    }
+    record.text += '\n';
+
+    bool const mayDrop = level < LogLevel::WARNING && overflow_.load(std::memory_order_relaxed) == LogOverflow::DROP;
+    while (!queue_.tryPush(std::move(record))) { // Si falla, 'record' no se movió.
+        // Sin lock: si el aviso se pierde, el siguiente reintento lo repite.
+        wakeRequested_.store(true, std::memory_order_relaxed);
+        writerWake_.notify_one();
+        if (mayDrop) {
+            dropped_.fetch_add(1, std::memory_order_relaxed);
+            droppedTotal_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        std::this_thread::yield();
+    }
+    queued_.fetch_add(1, std::memory_order_release);
+
+    if (level == LogLevel::CRITICAL) {
+        flush(); // Un CRITICAL suele preceder a una caída: que quede escrito antes de seguir.
+    }
+}
+
+void Logger::flush() {
+    std::uint64_t const target = queued_.load(std::memory_order_acquire);
+    std::unique_lock<std::mutex> lock(writerMutex_);
+    if (written_ >= target) {
+        return;
+    }
+    if (flushRequested_ < target) {
+        flushRequested_ = target;
+    }
+    writerWake_.notify_one();
+    batchWritten_.wait(lock, [this, target] { return written_ >= target || !writerRunning_; });
+}
+
+void Logger::writerLoop() {
+    std::string batch;
+    batch.reserve(BATCH_WRITE_BYTES);
+    while (true) {
+        bool running;
+        {
+            std::unique_lock<std::mutex> lock(writerMutex_);
+            writerWake_.wait_for(lock, std::chrono::milliseconds(flushIntervalMs_.load()), [this] {
+                return !writerRunning_ || flushRequested_ > written_ || wakeRequested_.load(std::memory_order_relaxed);
+            });
+            running = writerRunning_;
+            wakeRequested_.store(false, std::memory_order_relaxed);
+        }
+        writeBatch(batch);
+        if (!running) {
+            return;
+        }
+    }
+}
+
+void Logger::writeBatch(std::string& batch) {
+    bool const toFile = store_->isOpen();
+    std::uint64_t count = 0;
+    std::vector<LogStore::Entry> entries; // Una por línea de 'batch', para el índice
+    auto writeOut = [this, &batch, &entries, toFile] {
+        if (batch.empty()) {
+            return;
+        }
+        if (toFile) {
+            store_->append(batch, entries);
+            std::cout << batch; // También mostramos el log por la consola
+        } else {
+            // Si el archivo no está abierto, mostramos el log por la consola como último recurso.
+            std::cerr << batch;
+        }
+        batch.clear();
+        entries.clear();
+    };
+    auto addEntry = [&batch, &entries](std::size_t start, LogLevel level, std::int64_t time, std::string&& user) {
+        entries.push_back(LogStore::Entry{static_cast<std::uint32_t>(batch.size() - start), level, time, std::move(user)});
+    };
+
+    LogRecord record;
+    while (queue_.tryPop(record)) {
+        std::size_t const start = batch.size();
+        if (!toFile) {
+            batch += "LOG_FALLBACK: ";
+        }
+        appendTimestamp(batch, record.time);
+        batch += record.text;
+        addEntry(start, record.level, std::chrono::system_clock::to_time_t(record.time), std::move(record.user));
+        count++;
+        if (batch.size() >= BATCH_WRITE_BYTES) {
+            writeOut();
+        }
+    }
+    std::uint64_t const dropped = dropped_.exchange(0, std::memory_order_relaxed);
+    if (dropped > 0) {
+        std::size_t const start = batch.size();
+        auto const now = std::chrono::system_clock::now();
+        appendTimestamp(batch, now);
+        batch += ", WARNING, [Logger] Se descartaron " + std::to_string(dropped) +
+                 " mensajes de log: la cola estaba llena.\n";
+        addEntry(start, LogLevel::WARNING, std::chrono::system_clock::to_time_t(now), std::string());
+    }
+    writeOut();
+    if (count == 0 && dropped == 0) {
+        return;
+    }
+    std::cout.flush();
+    if (toFile && durability_.load(std::memory_order_relaxed) == LogDurability::FSYNC) {
+        store_->sync();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(writerMutex_);
+        written_ += count;
+    }
+    batchWritten_.notify_all();
+}
+
+void Logger::appendTimestamp(std::string& batch, std::chrono::system_clock::time_point time) {
+    std::time_t const second = std::chrono::system_clock::to_time_t(time);
+    if (second != cachedSecond_) {
+        std::tm local;
+        localtime_r(&second, &local); // localtime() no es segura entre hilos.
+        char buffer[32];
+        std::size_t length = std::strftime(buffer, sizeof(buffer), "%Y-%m-%d | %H:%M:%S", &local);
+        cachedTimestamp_.assign(buffer, length);
+        cachedSecond_ = second;
     }
+    batch += cachedTimestamp_;
 }
@@ -0,0 +1,276 @@
+#include "OrderHistory.h"
+#include "Logger.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <stdexcept>
+#include <unistd.h>
+
+namespace {
+
+/// @brief Largo a recortar sin partir una secuencia UTF-8.
+std::size_t utf8Prefix(const std::string& text, std::size_t length) {
+    if (length >= text.size()) {
+        return text.size();
+    }
+    while (length > 0 && (static_cast<unsigned char>(text[length]) & 0xC0) == 0x80) {
+        --length;
+    }
+    return length;
+}
+
+/// @brief Agrega un campo al CSV; entre comillas si tiene comas, comillas o saltos de línea.
+void appendCsvField(std::string& line, const char* text, std::size_t length) {
+    if (std::find_if(text, text + length, [](char c) { return c == ',' || c == '"' || c == '\n' || c == '\r'; }) ==
+        text + length) {
+        line.append(text, length);
+        return;
+    }
+    line += '"';
+    for (std::size_t i = 0; i < length; ++i) {
+        if (text[i] == '"') {
+            line += '"';
+        }
+        line += text[i];
+    }
+    line += '"';
+}
+
+std::string formatTime(std::int64_t seconds, const char* format) {
+    std::time_t const time = static_cast<std::time_t>(seconds);
+    std::tm local{};
+    localtime_r(&time, &local);
+    char buffer[32];
+    std::size_t const length = std::strftime(buffer, sizeof(buffer), format, &local);
+    return std::string(buffer, length);
+}
+
+} // namespace
+
+OrderHistory::OrderHistory(std::size_t capacity, const std::string& spillPath)
+    : spillPath_(spillPath) {
+    if (capacity == 0) {
+        throw std::invalid_argument("[Order History] La capacidad debe ser al menos 1.");
+    }
+    ring_ = std::make_shared<Ring>(capacity);
+}
+
+OrderHistory::~OrderHistory() {
+    clear();
+    if (spillFd_ >= 0) {
+        ::close(spillFd_);
+    }
+}
+
+OrderHistory::Record OrderHistory::pack(std::int64_t time, const std::string& username, const std::string& commandName,
+                                        const std::string& details, const std::string& success) {
+    const std::string* fields[4] = {&username, &commandName, &details, &success};
+    Record record;
+    record.time = time;
+
+    // Si no entran todos, los campos cortos quedan enteros y los largos se reparten lo que sobra.
+    std::size_t order[4] = {0, 1, 2, 3};
+    std::sort(order, order + 4, [&](std::size_t a, std::size_t b) { return fields[a]->size() < fields[b]->size(); });
+    std::size_t remaining = TEXT_BYTES;
+    for (std::size_t i = 0; i < 4; ++i) {
+        std::size_t const share = remaining / (4 - i);
+        std::size_t const length = utf8Prefix(*fields[order[i]], share);
+        record.lengths[order[i]] = static_cast<std::uint16_t>(length);
+        remaining -= length;
+    }
+
+    char* out = record.text;
+    for (std::size_t i = 0; i < 4; ++i) {
+        std::memcpy(out, fields[i]->data(), record.lengths[i]);
+        out += record.lengths[i];
+    }
+    std::memset(out, 0, static_cast<std::size_t>(record.text + TEXT_BYTES - out));
+    return record;
+}
+
+Order OrderHistory::unpack(const Record& record) {
+    std::string* fields[4];
+    Order order;
+    fields[0] = &order.username;
+    fields[1] = &order.commandName;
+    fields[2] = &order.details;
+    fields[3] = &order.success;
+    const char* in = record.text;
+    for (std::size_t i = 0; i < 4; ++i) {
+        fields[i]->assign(in, record.lengths[i]);
+        in += record.lengths[i];
+    }
+    order.timestamp = formatTime(record.time, "%H:%M:%S");
+    return order;
+}
+
+bool OrderHistory::read(const Ring& ring, std::uint64_t n, Record& record) {
+    const Slot& slot = ring.slots[n % ring.capacity];
+    std::uint64_t const expected = 2 * n + 2;
+    if (slot.version.load(std::memory_order_acquire) != expected) {
+        return false; // Todavía no está o ya se pisó con una orden más nueva.
+    }
+    std::uint64_t words[WORDS];
+    for (std::size_t i = 0; i < WORDS; ++i) {
+        words[i] = slot.words[i].load(std::memory_order_relaxed);
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot.version.load(std::memory_order_relaxed) != expected) {
+        return false;
+    }
+    std::memcpy(&record, words, sizeof(Record));
+    return true;
+}
+
+void OrderHistory::write(Ring& ring, std::uint64_t n, const Record& record) {
+    Slot& slot = ring.slots[n % ring.capacity];
+    std::uint64_t words[WORDS];
+    std::memcpy(words, &record, sizeof(Record));
+    slot.version.store(2 * n + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (std::size_t i = 0; i < WORDS; ++i) {
+        slot.words[i].store(words[i], std::memory_order_relaxed);
+    }
+    slot.version.store(2 * n + 2, std::memory_order_release);
+}
+
+void OrderHistory::record(std::int64_t time, const std::string& username, const std::string& commandName,
+                          const std::string& details, const std::string& success) {
+    Record const record = pack(time, username, commandName, details, success);
+    std::lock_guard<std::mutex> lock(writeMutex_);
+    Ring& ring = *ring_;
+    std::uint64_t const n = ring.end.load(std::memory_order_relaxed);
+    if (n - ring.begin.load(std::memory_order_relaxed) == ring.capacity) {
+        spillLocked(ring, n - ring.capacity + 1);
+    }
+    write(ring, n, record);
+    ring.end.store(n + 1, std::memory_order_release);
+}
+
+std::vector<Order> OrderHistory::snapshot() const {
+    std::shared_ptr<const Ring> const ring = std::atomic_load(&ring_);
+    std::uint64_t const end = ring->end.load(std::memory_order_acquire);
+    std::uint64_t const begin = std::max(ring->begin.load(std::memory_order_acquire),
+                                         end > ring->capacity ? end - ring->capacity : 0);
+    std::vector<Order> orders;
+    orders.reserve(static_cast<std::size_t>(end - std::min(begin, end)));
+    Record record;
+    for (std::uint64_t n = begin; n < end; ++n) {
+        if (read(*ring, n, record)) {
+            orders.push_back(unpack(record));
+        } else {
+            // Se pisó mientras copiábamos: esta y todas las anteriores ya salieron del anillo.
+            orders.clear();
+        }
+    }
+    return orders;
+}
+
+void OrderHistory::clear() {
+    std::lock_guard<std::mutex> lock(writeMutex_);
+    spillLocked(*ring_, ring_->end.load(std::memory_order_relaxed));
+}
+
+void OrderHistory::setCapacity(std::size_t capacity) {
+    if (capacity == 0) {
+        throw std::invalid_argument("[Order History] La capacidad debe ser al menos 1.");
+    }
+    std::lock_guard<std::mutex> lock(writeMutex_);
+    Ring& old = *ring_;
+    std::uint64_t const end = old.end.load(std::memory_order_relaxed);
+    if (end - old.begin.load(std::memory_order_relaxed) > capacity) {
+        spillLocked(old, end - capacity);
+    }
+
+    // Las órdenes conservan su número, así que un lector del anillo viejo no se confunde.
+    auto ring = std::make_shared<Ring>(capacity);
+    std::uint64_t const begin = old.begin.load(std::memory_order_relaxed);
+    Record record;
+    for (std::uint64_t n = begin; n < end; ++n) {
+        if (read(old, n, record)) {
+            write(*ring, n, record);
+        }
+    }
+    ring->begin.store(begin, std::memory_order_relaxed);
+    ring->end.store(end, std::memory_order_relaxed);
+    std::atomic_store(&ring_, ring);
+}
+
+std::size_t OrderHistory::capacity() const {
+    return std::atomic_load(&ring_)->capacity;
+}
+
+void OrderHistory::setSpillPath(const std::string& path) {
+    std::lock_guard<std::mutex> lock(writeMutex_);
+    if (path == spillPath_) {
+        return;
+    }
+    if (spillFd_ >= 0) {
+        ::close(spillFd_);
+        spillFd_ = -1;
+    }
+    spillPath_ = path;
+}
+
+std::string OrderHistory::spillPath() const {
+    std::lock_guard<std::mutex> lock(writeMutex_);
+    return spillPath_;
+}
+
+void OrderHistory::spillLocked(Ring& ring, std::uint64_t until) {
+    std::uint64_t const begin = ring.begin.load(std::memory_order_relaxed);
+    if (until <= begin) {
+        return;
+    }
+    // Primero se corre el inicio, así ningún lector nuevo toma las órdenes que salen.
+    ring.begin.store(until, std::memory_order_release);
+    if (spillPath_.empty()) {
+        return;
+    }
+
+    std::string lines;
+    Record record;
+    for (std::uint64_t n = begin; n < until; ++n) {
+        if (!read(ring, n, record)) {
+            continue;
+        }
+        lines += formatTime(record.time, "%Y-%m-%d | %H:%M:%S");
+        const char* in = record.text;
+        for (std::size_t i = 0; i < 4; ++i) {
+            lines += ',';
+            appendCsvField(lines, in, record.lengths[i]);
+            in += record.lengths[i];
+        }
+        lines += '\n';
+    }
+
+    if (spillFd_ < 0) {
+        spillFd_ = ::open(spillPath_.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+        if (spillFd_ < 0) {
+            Logger::getInstance().logf(LogLevel::ERROR, LogCategory::ROBOT,
+                                       "[Order History] No se pudo abrir %s: %s. Se pierden %llu órdenes.",
+                                       spillPath_.c_str(), std::strerror(errno),
+                                       static_cast<unsigned long long>(until - begin));
+            return;
+        }
+    }
+    const char* data = lines.data();
+    std::size_t left = lines.size();
+    while (left > 0) {
+        ssize_t const written = ::write(spillFd_, data, left);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            Logger::getInstance().logf(LogLevel::ERROR, LogCategory::ROBOT,
+                                       "[Order History] Error al escribir en %s: %s.", spillPath_.c_str(),
+                                       std::strerror(errno));
+            return;
+        }
+        data += written;
+        left -= static_cast<std::size_t>(written);
+    }
+    spilled_.fetch_add(until - begin, std::memory_order_relaxed);
+}
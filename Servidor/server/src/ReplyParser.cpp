@@ -0,0 +1,99 @@
+#include "ReplyParser.h"
+
+#include <charconv>
+
+namespace {
+
+bool startsWith(std::string_view text, std::string_view prefix) {
+    return text.substr(0, prefix.size()) == prefix;
+}
+
+bool endsWith(std::string_view text, std::string_view suffix) {
+    return text.size() >= suffix.size() && text.substr(text.size() - suffix.size()) == suffix;
+}
+
+/// @brief Lo que va entre corchetes ("[X:1.00 Y:2.00]"); vacío si no hay corchete.
+std::string_view bracketed(std::string_view text) {
+    std::size_t open = text.find('[');
+    return open == std::string_view::npos ? std::string_view() : text.substr(open + 1);
+}
+
+/// @brief Lee el número que sigue a "<axis>:" dentro de 'text' (hasta un espacio o ']').
+bool readField(std::string_view text, char axis, double& value) {
+    const char key[2] = {axis, ':'};
+    std::size_t pos = text.find(std::string_view(key, 2));
+    if (pos == std::string_view::npos) {
+        return false;
+    }
+    const char* first = text.data() + pos + 2;
+    const char* last = text.data() + text.size();
+    auto result = std::from_chars(first, last, value);
+    return result.ec == std::errc() && (result.ptr == last || *result.ptr == ' ' || *result.ptr == ']');
+}
+
+/// @brief "[X:.. Y:.. Z:.. E:..]" de CURRENT POSITION y LINEAR MOVE.
+bool readCoordinates(std::string_view text, ComunicatorPort::ReplyEvent& event) {
+    text = bracketed(text); // "LINEAR MOVE:" también contiene "E:".
+    return readField(text, 'X', event.x) && readField(text, 'Y', event.y) && readField(text, 'Z', event.z) &&
+           readField(text, 'E', event.e);
+}
+
+} // namespace
+
+ComunicatorPort::ReplyEvent ComunicatorPort::ReplyParser::parseLine(std::string_view line) {
+    ReplyEvent event;
+    event.line = line;
+    event.text = line;
+
+    if (line == "OK") {
+        event.kind = ReplyKind::Ok;
+        return event;
+    }
+    if (startsWith(line, "ERROR")) {
+        event.kind = ReplyKind::Error;
+        event.text = line.substr(startsWith(line, "ERROR: ") ? 7 : 5);
+        if (event.text == "COMMAND NOT RECOGNIZED") {
+            event.error = ReplyError::CommandNotRecognized;
+        } else if (endsWith(event.text, "NOT IMPLEMENTED")) {
+            event.error = ReplyError::NotImplemented;
+        } else if (event.text == "ROBOT FAILURE") {
+            event.error = ReplyError::RobotFailure;
+        } else {
+            event.error = ReplyError::Other;
+        }
+        return event;
+    }
+    if (!startsWith(line, "INFO: ")) {
+        return event; // DEBUG, el banner de arranque o ruido: Info con la línea tal cual.
+    }
+
+    std::string_view text = line.substr(6);
+    event.text = text;
+    if (text == "ABSOLUTE MODE" || text == "RELATIVE MODE") {
+        event.kind = ReplyKind::Mode;
+        event.absolute = (text[0] == 'A');
+    } else if (text == "MOTORS ENABLED" || text == "MOTORS DISABLED") {
+        event.kind = ReplyKind::MotorsState;
+        event.motorsEnabled = (text == "MOTORS ENABLED");
+    } else if (text == "HOMING COMPLETE") {
+        event.kind = ReplyKind::HomingComplete;
+    } else if (startsWith(text, "CURRENT POSITION: ")) {
+        if (readCoordinates(text, event)) {
+            event.kind = ReplyKind::Position;
+        }
+    } else if (startsWith(text, "LINEAR MOVE: ")) {
+        if (readCoordinates(text, event)) {
+            event.kind = ReplyKind::LinearMove;
+        }
+    } else if (startsWith(text, "ENDSTOP: ")) {
+        double x = 0, y = 0, z = 0;
+        text = bracketed(text);
+        if (readField(text, 'X', x) && readField(text, 'Y', y) && readField(text, 'Z', z)) {
+            event.kind = ReplyKind::LimitReached;
+            event.limitX = (x != 0);
+            event.limitY = (y != 0);
+            event.limitZ = (z != 0);
+        }
+    }
+    return event;
+}
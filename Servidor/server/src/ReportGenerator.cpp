@@ -2,8 +2,12 @@
 #include <vector>
 #include <algorithm> // Para std::find
 #include <iostream> // Para std::cout
-#include <sstream> // Para std::stringstream
-#include "FileManager.h"
+#include <cstdio>
+#include <ctime>
+#include <stdexcept>
+#include "Logger.h"
+#include "LogScanner.h"
+#include "LogStore.h"
 
 // Constructors/Destructors
 
@@ -101,56 +105,68 @@ xmlrpc_c::value ReportGenerator::generateLogReport(const std::map<std::string, s
     std::map<std::string, xmlrpc_c::value> reportMap;
     std::vector<xmlrpc_c::value> logsVector;
 
-    FileNamespace::FileManager fileManager;
-    std::string fileContent = fileManager.read("application.csv");
-
-    std::stringstream ss(fileContent);
-    std::string line;
+    // Los filtros pasan al índice del log: solo se leen las líneas que coinciden.
+    LogStore::Query query;
+    if (filters.count("username")) {
+        query.user = filters.at("username");
+    }
+    bool knownLevel = true;
+    if (filters.count("level")) {
+        knownLevel = false;
+        for (LogLevel level : {LogLevel::DEBUG, LogLevel::INFO, LogLevel::WARNING, LogLevel::ERROR, LogLevel::CRITICAL}) {
+            if (filters.at("level") == Logger::levelToString(level)) {
+                query.level = level;
+                knownLevel = true;
+            }
+        }
+    }
+    if (filters.count("from")) {
+        query.from = parseLogTime(filters.at("from"));
+    }
+    if (filters.count("to")) {
+        query.to = parseLogTime(filters.at("to"));
+    }
 
-    while (std::getline(ss, line)) {
-        if (line.empty()) continue;
+    Logger::getInstance().flush(); // Que el reporte incluya lo que todavía está en la cola del log.
+    std::vector<std::string> lines;
+    if (knownLevel) { // Un nivel que no existe no coincide con ninguna línea.
+        lines = Logger::getInstance().store().query(query);
+    }
 
-        std::stringstream lineStream(line);
-        std::string timestamp, level, message, user, node;
-        
+    for (const std::string& line : lines) {
         // Parseo simple de CSV. Asume que no hay comas en el mensaje.
-        std::getline(lineStream, timestamp, ',');
-        std::getline(lineStream, level, ',');
-        std::getline(lineStream, message, ',');
-        std::getline(lineStream, user, ',');
-        std::getline(lineStream, node);
-
+        LogRow const row = LogScanner::split(line);
+        std::string level(row.level);
+        std::string user(row.user);
         // Limpiar espacios en blanco al inicio de los campos
         level.erase(0, level.find_first_not_of(" \t\n\r"));
         user.erase(0, user.find_first_not_of(" \t\n\r"));
 
-        bool match = true;
-        if (filters.count("username")) {
-            if (user != filters.at("username")) {
-                match = false;
-            }
-        }
-        if (filters.count("level")) {
-            if (level != filters.at("level")) {
-                match = false;
-            }
-        }
-
-        if (match) {
-            std::map<std::string, xmlrpc_c::value> logEntryMap;
-            logEntryMap["timestamp"] = xmlrpc_c::value_string(timestamp);
-            logEntryMap["level"] = xmlrpc_c::value_string(level);
-            logEntryMap["message"] = xmlrpc_c::value_string(message);
-            logEntryMap["user"] = xmlrpc_c::value_string(user);
-            logEntryMap["node"] = xmlrpc_c::value_string(node);
-            logsVector.push_back(xmlrpc_c::value_struct(logEntryMap));
-        }
+        std::map<std::string, xmlrpc_c::value> logEntryMap;
+        logEntryMap["timestamp"] = xmlrpc_c::value_string(std::string(row.timestamp));
+        logEntryMap["level"] = xmlrpc_c::value_string(level);
+        logEntryMap["message"] = xmlrpc_c::value_string(std::string(row.message));
+        logEntryMap["user"] = xmlrpc_c::value_string(user);
+        logEntryMap["node"] = xmlrpc_c::value_string(std::string(row.node));
+        logsVector.push_back(xmlrpc_c::value_struct(logEntryMap));
     }
 
     reportMap["logs"] = xmlrpc_c::value_array(logsVector);
     return xmlrpc_c::value_struct(reportMap);
 }
 
+std::int64_t ReportGenerator::parseLogTime(const std::string& text) {
+    std::tm local{};
+    if (std::sscanf(text.c_str(), "%d-%d-%d%*[ |]%d:%d:%d", &local.tm_year, &local.tm_mon, &local.tm_mday,
+                    &local.tm_hour, &local.tm_min, &local.tm_sec) != 6) {
+        throw std::invalid_argument("Fecha inválida: '" + text + "' (use AAAA-MM-DD HH:MM:SS).");
+    }
+    local.tm_year -= 1900;
+    local.tm_mon -= 1;
+    local.tm_isdst = -1;
+    return static_cast<std::int64_t>(std::mktime(&local));
+}
+
 
 // Accessor methods
 
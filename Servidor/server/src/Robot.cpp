@@ -2,17 +2,91 @@
 #include <thread>           // Para std::this_thread::sleep_for
 #include <unistd.h>         // Para usleep
 #include <algorithm>        // Para std::remove
-#include <iomanip>          // Para std::put_time
+#include <ctime>            // Para std::time_t en el historial de órdenes
 #include <sstream>
-#include <regex>            // Para expresiones regulares
+#include <deque>            // Para los comandos en vuelo del streaming
+#include <future>           // Para las respuestas asíncronas del puerto
+#include <cctype>           // Para std::toupper
+#include <cstdio>           // Para std::snprintf
+#include <cmath>            // Para std::sqrt en la estimación de los movimientos
+#include <cstring>          // Para std::strcmp
 #include "ServiceLocator.h" // Incluimos el Service Locator
 #include "GCode.h"          // Incluimos la clase GCode para usar su funcionalidad
 #include "Exceptions.h"
 #include "Utils.h"
+#include "ReplyParser.h"
 
 // --- Declaración de la nueva función privada ---
-static std::string sendAndReceive(ComunicatorPort::ISerialCommunicator& serial, const std::string& command, int time = 2);
+static std::string sendAndReceive(ComunicatorPort::ISerialCommunicator& serial, ComunicatorPort::LinkStats& stats,
+                                  const std::string& command, int time = 2, RobotStatus* status = nullptr);
+
+/// @brief Una respuesta del firmware recorrida una sola vez con el ReplyParser.
+struct ParsedReply {
+    std::string text;  // Las líneas sin saltos, con cada "OK" reemplazado por 'okText'.
+    std::string error; // Desde la primera línea ERROR; vacío si no hubo error.
+};
+
+/// @brief Vuelca en 'status' lo que informa una línea (modo, motores y posición).
+static void applyStatusEvent(RobotStatus& status, const ComunicatorPort::ReplyEvent& event) {
+    switch (event.kind) {
+        case ComunicatorPort::ReplyKind::Mode:
+            status.isAbsolute = event.absolute;
+            break;
+        case ComunicatorPort::ReplyKind::MotorsState:
+            status.areMotorsEnabled = event.motorsEnabled;
+            break;
+        case ComunicatorPort::ReplyKind::Position:
+            status.currentPosition.x = event.x;
+            status.currentPosition.y = event.y;
+            status.currentPosition.z = event.z;
+            break;
+        default:
+            break;
+    }
+}
 
+/// @brief Recorre la respuesta cruda; si 'status' no es nulo, lo actualiza con lo que informa.
+static ParsedReply parseReply(const std::string& raw, const char* okText, RobotStatus* status) {
+    ParsedReply parsed;
+    ComunicatorPort::ReplyParser parser;
+    auto onEvent = [&](const ComunicatorPort::ReplyEvent& event) {
+        if (event.kind == ComunicatorPort::ReplyKind::Error || !parsed.error.empty()) {
+            if (event.kind != ComunicatorPort::ReplyKind::Ok) {
+                parsed.error += parsed.error.empty() ? "" : " ";
+                parsed.error.append(event.line);
+            }
+            return;
+        }
+        if (event.kind == ComunicatorPort::ReplyKind::Ok) {
+            parsed.text += okText;
+        } else {
+            parsed.text.append(event.line);
+        }
+        if (status != nullptr) {
+            applyStatusEvent(*status, event);
+        }
+    };
+    parser.feed(raw, onEvent);
+    parser.finish(onEvent);
+    return parsed;
+}
+
+
+static std::int64_t steadyMicros() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/// @brief Duración (ms) de un G0/G1 según Interpolation::setInterpolation del firmware:
+/// recorre max(distancia XYZ, |ΔE|) a F mm/s, o a sqrt(distancia) * 10 si F < 5 (sin F).
+static double predictMoveMs(double dx, double dy, double dz, double de, double feed) {
+    double distance = std::max(std::sqrt(dx * dx + dy * dy + dz * dz), std::abs(de));
+    if (distance <= 0) {
+        return 0;
+    }
+    double speed = std::max(feed < 5 ? std::sqrt(distance) * 10 : feed, 5.0);
+    return distance / speed * 1000.0;
+}
 
 RobotNamespace::Robot::Robot()
 {
@@ -20,61 +94,234 @@ RobotNamespace::Robot::Robot()
 
 RobotNamespace::Robot::~Robot()
 {
+    stopStatusPoller();
+}
+
+RobotNamespace::Robot::PollerPause::PollerPause(Robot& robot) : robot_(robot) {
+    // Dekker con el muestreador: o ve la pausa antes de enviar, o esperamos su M114.
+    robot_.pollPauses++;
+    while (robot_.pollInFlight.load()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+RobotNamespace::Robot::PollerPause::~PollerPause() {
+    robot_.pollPauses--;
 }
 
-/// @brief Parsea la respuesta del comando M114 y actualiza el estado del robot.
+ComunicatorPort::ISerialCommunicator& RobotNamespace::Robot::communicator() {
+    // Sin un comunicador propio se usa el global (un único brazo, como hasta ahora).
+    return communicator_ ? *communicator_ : ServiceLocator::getCommunicator();
+}
+
+/// @brief Parsea la respuesta cruda del comando M114 (con sus saltos de línea) y actualiza el estado del robot.
 void RobotNamespace::Robot::parseM114Response(const std::string& response) {
-    // La respuesta puede no tener saltos de línea, así que buscamos en toda la cadena.
-    if (response.find("ABSOLUTE MODE") != std::string::npos) {
-        robotStatus.isAbsolute = true;
-    } else if (response.find("RELATIVE MODE") != std::string::npos) {
-        robotStatus.isAbsolute = false;
+    ComunicatorPort::ReplyParser parser;
+    auto apply = [this](const ComunicatorPort::ReplyEvent& event) { applyStatusEvent(robotStatus, event); };
+    parser.feed(response, apply);
+    parser.finish(apply);
+}
+
+RobotStatus RobotNamespace::Robot::getStatus(int maxStalenessMs) {
+    if (maxStalenessMs == ANY_STALENESS && statusPollIntervalMs.load() <= 0) {
+        maxStalenessMs = 0; // Sin muestreo en segundo plano la memoria no se refresca sola.
     }
-    if (response.find("MOTORS ENABLED") != std::string::npos) {
-        robotStatus.areMotorsEnabled = true;
-    } else if (response.find("MOTORS DISABLED") != std::string::npos) {
-        robotStatus.areMotorsEnabled = false;
+    StatusSample sample = statusSnapshot.load();
+    bool stale = sample.sampledAtUs == 0 || (steadyMicros() - sample.sampledAtUs) / 1000 > maxStalenessMs;
+    if (sample.isConnected && maxStalenessMs != ANY_STALENESS && stale) {
+        // Lo llaman muchos hilos de RPC a la vez: nada de escribir robotStatus desde acá.
+        sampleStatus(2);
     }
+    return getRobotStatus();
+}
 
-    // Expresión regular para extraer los valores de X, Y, Z
-    std::regex re(R"(X:([-\d.]+) Y:([-\d.]+) Z:([-\d.]+))");
-    std::smatch match;
-    if (std::regex_search(response, match, re) && match.size() == 4) {
-        try {
-            robotStatus.currentPosition.x = std::stod(match[1].str());
-            robotStatus.currentPosition.y = std::stod(match[2].str());
-            robotStatus.currentPosition.z = std::stod(match[3].str());
-        } catch (const std::invalid_argument& e) {
-            exceptionAndExecute("[Robot] Error al convertir posición desde M114: " + std::string(e.what()));
+RobotStatus RobotNamespace::Robot::waitForChange(unsigned long long lastVersion, int timeoutMs) {
+    auto deadline = std::chrono::steady_clock::now() +
+                    std::chrono::milliseconds(std::clamp(timeoutMs, 0, MAX_CHANGE_WAIT_MS));
+    std::unique_lock<std::mutex> lock(changeMutex);
+    stateChanged.wait_until(lock, deadline, [this, lastVersion] { return statusSnapshot.load().version != lastVersion; });
+    lock.unlock();
+    return getRobotStatus();
+}
+
+RobotStatus RobotNamespace::Robot::getRobotStatus() const {
+    StatusSample sample = statusSnapshot.load();
+    RobotStatus status;
+    status.isConnected = sample.isConnected;
+    status.areMotorsEnabled = sample.areMotorsEnabled;
+    status.isAbsolute = sample.isAbsolute;
+    status.currentPosition = sample.currentPosition;
+    status.activityState = sample.activityState;
+    status.statusAgeMs = sample.sampledAtUs == 0 ? -1 : (steadyMicros() - sample.sampledAtUs) / 1000;
+    status.version = sample.version;
+    return status;
+}
+
+void RobotNamespace::Robot::setRobotStatus(const RobotStatus& status) {
+    robotStatus = status;
+    publishStatus(true);
+}
+
+template <typename Mutate>
+void RobotNamespace::Robot::updateSnapshot(Mutate&& mutate) {
+    bool changed = false;
+    statusSnapshot.update([&](StatusSample& sample) {
+        StatusSample before = sample;
+        mutate(sample);
+        changed = sample.isConnected != before.isConnected || sample.areMotorsEnabled != before.areMotorsEnabled ||
+                  sample.isAbsolute != before.isAbsolute || sample.currentPosition.x != before.currentPosition.x ||
+                  sample.currentPosition.y != before.currentPosition.y ||
+                  sample.currentPosition.z != before.currentPosition.z ||
+                  std::strcmp(sample.activityState, before.activityState) != 0;
+        if (changed) {
+            sample.version++;
         }
+    });
+    if (changed) {
+        // Tomar el mutex evita que el aviso se pierda entre el chequeo y la espera de waitForChange().
+        { std::lock_guard<std::mutex> lock(changeMutex); }
+        stateChanged.notify_all();
     }
 }
 
-RobotStatus RobotNamespace::Robot::getStatus() {
-    std::string response;
-    if (robotStatus.isConnected) {
-        response = sendAndReceive(ServiceLocator::getCommunicator(), "M114\r\n");
-        parseM114Response(response);
+void RobotNamespace::Robot::publishStatus(bool positionSampled) {
+    const RobotStatus& status = robotStatus;
+    updateSnapshot([&](StatusSample& sample) {
+        sample.isConnected = status.isConnected;
+        sample.areMotorsEnabled = status.areMotorsEnabled;
+        sample.isAbsolute = status.isAbsolute;
+        // Con un movimiento en curso se publica MOVIENDO; settleMotions() lo cambia al terminar.
+        const char* activity = pendingMotions.load() > 0 ? "MOVIENDO" : status.activityState.c_str();
+        std::snprintf(sample.activityState, sizeof(sample.activityState), "%s", activity);
+        if (positionSampled) {
+            sample.currentPosition = status.currentPosition;
+            sample.sampledAtUs = steadyMicros();
+        }
+    });
+}
+
+void RobotNamespace::Robot::sampleStatus(int time) {
+    StatusSample before = statusSnapshot.load();
+    RobotStatus parsed;
+    parsed.isAbsolute = before.isAbsolute;
+    parsed.areMotorsEnabled = before.areMotorsEnabled;
+    parsed.currentPosition = before.currentPosition;
+    sendCommand("M114\r\n", time, &parsed);
+    std::int64_t now = steadyMicros();
+    updateSnapshot([&](StatusSample& sample) {
+        sample.areMotorsEnabled = parsed.areMotorsEnabled;
+        sample.isAbsolute = parsed.isAbsolute;
+        sample.currentPosition = parsed.currentPosition;
+        sample.sampledAtUs = now;
+    });
+}
+
+void RobotNamespace::Robot::setStatusPollInterval(int intervalMs) {
+    statusPollIntervalMs = intervalMs;
+    if (intervalMs <= 0) {
+        stopStatusPoller();
+    } else if (robotStatus.isConnected) {
+        startStatusPoller();
+    }
+}
+
+void RobotNamespace::Robot::startStatusPoller() {
+    if (statusPoller.joinable() || statusPollIntervalMs.load() <= 0) {
+        return;
+    }
+    pollerRunning = true;
+    statusPoller = std::thread(&Robot::pollStatus, this);
+}
+
+void RobotNamespace::Robot::stopStatusPoller() {
+    {
+        std::lock_guard<std::mutex> lock(pollerMutex);
+        pollerRunning = false;
+    }
+    pollerWake.notify_all();
+    if (statusPoller.joinable()) {
+        statusPoller.join();
+    }
+}
+
+void RobotNamespace::Robot::noteActivity() {
+    if (!recentActivity.exchange(true)) {
+        std::lock_guard<std::mutex> lock(pollerMutex);
+        pollerWake.notify_all();
+    }
+}
+
+void RobotNamespace::Robot::pollStatus() {
+    int interval = statusPollIntervalMs.load();
+    while (true) {
+        {
+            // Quieto, el intervalo se duplica hasta STATUS_POLL_MAX_MS; un comando nuevo
+            // despierta al muestreador para volver al ritmo configurado.
+            std::unique_lock<std::mutex> lock(pollerMutex);
+            pollerWake.wait_for(lock, std::chrono::milliseconds(interval), [this, interval] {
+                return !pollerRunning || (recentActivity && interval > statusPollIntervalMs.load());
+            });
+            if (!pollerRunning) {
+                return;
+            }
+        }
+        int base = std::max(1, statusPollIntervalMs.load());
+        if (recentActivity.exchange(false) && interval > base) {
+            interval = base;
+            continue;
+        }
+
+        pollInFlight = true;
+        StatusSample before = statusSnapshot.load();
+        if (pollPauses.load() > 0 || !before.isConnected || communicator().linkLost()) {
+            pollInFlight = false;
+            continue;
+        }
+        RobotStatus parsed;
+        parsed.isAbsolute = before.isAbsolute;
+        parsed.areMotorsEnabled = before.areMotorsEnabled;
+        parsed.currentPosition = before.currentPosition;
+        bool sampled = false;
+        std::int64_t submittedAt = steadyMicros();
+        try {
+            // Si hay un movimiento en curso, el firmware responde recién cuando termina.
+            sendAndReceive(communicator(), linkStats, "M114\r\n", 2 + motionBacklogSeconds(), &parsed);
+            sampled = true;
+        } catch (const std::exception& e) {
+            Logger::getInstance().logf(LogLevel::DEBUG, LogCategory::ROBOT, "[Robot] Muestreo de estado fallido: %s", e.what());
+        }
+        pollInFlight = false;
+        if (!sampled) {
+            interval = base;
+            continue;
+        }
+        settleMotions(submittedAt, &parsed.currentPosition);
+
+        std::int64_t now = steadyMicros();
+        updateSnapshot([&](StatusSample& sample) {
+            sample.areMotorsEnabled = parsed.areMotorsEnabled;
+            sample.isAbsolute = parsed.isAbsolute;
+            sample.currentPosition = parsed.currentPosition;
+            sample.sampledAtUs = now;
+        });
+        bool changed = parsed.areMotorsEnabled != before.areMotorsEnabled || parsed.isAbsolute != before.isAbsolute ||
+                       parsed.currentPosition.x != before.currentPosition.x ||
+                       parsed.currentPosition.y != before.currentPosition.y ||
+                       parsed.currentPosition.z != before.currentPosition.z;
+        interval = changed ? base : std::min(interval * 2, std::max(base, STATUS_POLL_MAX_MS));
     }
-    return robotStatus;
 }
 
 void RobotNamespace::Robot::connect() {
     if (!robotStatus.isConnected) {
         try{
             Logger::getInstance().log(LogLevel::INFO, "[Robot] Iniciando conexión...");
-            ServiceLocator::getCommunicator().config("/dev/ttyUSB0", 115200);
-
-            // Al abrir el puerto, el Arduino se reinicia. Esperamos un tiempo prudencial
-            // para que termine su secuencia de arranque y envíe cualquier mensaje inicial.
-
-            Logger::getInstance().log(LogLevel::INFO, "[Robot] Limpiando mensajes de arranque...");
-            std::this_thread::sleep_for(std::chrono::seconds(2));
-
-            ServiceLocator::getCommunicator().cleanBuffer(); // Ahora limpiamos cualquier mensaje de arranque.
+            openLink();
             robotStatus.isConnected = true;
-            lastOrders.clear(); // Limpiamos el historial de órdenes al conectar.
+            orderHistory.clear(); // Empezamos un historial nuevo al conectar; el anterior queda en el archivo.
             robotStatus.activityState = "CONECTADO";
+            publishStatus(false);
+            startStatusPoller();
             logAndExecuteState(LogLevel::INFO, "[Robot] Conexión establecida.");
         } catch (const SerialCommunicationException& e){
             logAndExecuteState(LogLevel::CRITICAL, "[Robot] Fallo crítico al conectar: " + std::string(e.what()));
@@ -85,14 +332,152 @@ void RobotNamespace::Robot::connect() {
     }
 }
 
+void RobotNamespace::Robot::openLink() {
+    openAtBaseRate();
+
+    if (baudRate == AUTO_BAUD && selectedBaud == 0) {
+        // Se mide una sola vez; las reconexiones van directo a la velocidad elegida.
+        ComunicatorPort::LinkBenchmark benchmark(communicator());
+        baudSelection = benchmark.selectFastest(ComunicatorPort::LinkBenchmark::defaultCandidates(),
+                                                [this]() { resetToBaseRate(); });
+        selectedBaud = baudSelection.baudRate;
+    } else {
+        int target = (baudRate == AUTO_BAUD) ? selectedBaud : baudRate;
+        if (target != BASE_BAUD && !communicator().changeBaudRate(target)) {
+            Logger::getInstance().logf(LogLevel::WARNING, LogCategory::ROBOT, "[Robot] No se pudo pasar a %d baudios; se sigue a %d.",
+                                       target, BASE_BAUD);
+            resetToBaseRate();
+        }
+    }
+
+    if (binaryFraming) {
+        bool framed = communicator().enableBinaryFraming();
+        Logger::getInstance().log(framed ? LogLevel::INFO : LogLevel::WARNING,
+                                  framed ? "[Robot] Protocolo binario con el firmware activado."
+                                         : "[Robot] El firmware no soporta el protocolo binario; se usa texto.");
+    }
+}
+
+void RobotNamespace::Robot::resetToBaseRate() {
+    // El firmware pudo haber quedado a la velocidad que falló: el reinicio lo devuelve a BAUD.
+    communicator().close();
+    std::this_thread::sleep_for(std::chrono::milliseconds(RESET_HOLD_MS));
+    openAtBaseRate();
+}
+
+void RobotNamespace::Robot::openAtBaseRate() {
+    communicator().config(serialPort, BASE_BAUD);
+
+    // Al abrir el puerto, el Arduino se reinicia. En lugar de esperar un tiempo fijo,
+    // esperamos su mensaje de arranque (o que conteste un M114) y descartamos lo anterior.
+    ComunicatorPort::HandshakeResult handshake =
+        communicator().waitForFirmware(BOOT_BANNER, std::chrono::milliseconds(BOOT_TIMEOUT_MS));
+    if (!handshake.ready) {
+        communicator().close();
+        throw SerialCommunicationException("El firmware no respondió en " + std::to_string(BOOT_TIMEOUT_MS) +
+                                           " ms (" + std::to_string(handshake.probes) + " sondeos M114).");
+    }
+    Logger::getInstance().logf(LogLevel::INFO, LogCategory::ROBOT, "[Robot] Firmware listo en %lld ms (%s).",
+                               static_cast<long long>(handshake.elapsed.count()),
+                               handshake.bannerSeen ? "mensaje de arranque" : "respuesta a M114");
+}
+
+void RobotNamespace::Robot::reconnect() {
+    PollerPause pause(*this);
+    Logger::getInstance().log(LogLevel::WARNING, "[Robot] Se perdió el enlace con el firmware; reconectando...");
+    auto start = std::chrono::steady_clock::now();
+    auto deadline = start + std::chrono::milliseconds(RECONNECT_TIMEOUT_MS);
+    auto delay = std::chrono::milliseconds(RECONNECT_FIRST_DELAY_MS);
+
+    // El dispositivo puede tardar en reaparecer (p. ej. un USB que se re-enumera):
+    // reintentamos con espera exponencial hasta agotar el plazo.
+    while (true) {
+        communicator().close();
+        try {
+            openLink();
+            break;
+        } catch (const SerialCommunicationException& e) {
+            if (std::chrono::steady_clock::now() + delay >= deadline) {
+                communicator().close();
+                abandonMotions("Se perdió el enlace con el firmware.");
+                robotStatus.isConnected = false;
+                robotStatus.areMotorsEnabled = false;
+                robotStatus.activityState = "DESCONECTADO";
+                publishStatus(false);
+                logAndExecuteState(LogLevel::CRITICAL, "[Robot] No se pudo recuperar el enlace: " + std::string(e.what()));
+                throw;
+            }
+            std::this_thread::sleep_for(delay);
+            delay = std::min(delay * 2, std::chrono::milliseconds(RECONNECT_MAX_DELAY_MS));
+        }
+    }
+    reconnectCount++;
+    abandonMotions("La placa se reinició durante el movimiento.");
+
+    // La placa se reinició: vuelve en modo absoluto, con los motores y la posición de arranque.
+    bool wasAbsolute = robotStatus.isAbsolute;
+    robotStatus.isAbsolute = true;
+    robotStatus.activityState = "CONECTADO";
+    if (!wasAbsolute) {
+        sendAndReceive(communicator(), linkStats, "G91\r\n");
+        robotStatus.isAbsolute = false;
+    }
+    sendAndReceive(communicator(), linkStats, "M114\r\n", 2, &robotStatus);
+    publishStatus(true);
+
+    auto elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count();
+    logAndExecuteState(LogLevel::WARNING, "[Robot] Enlace recuperado en " + std::to_string(elapsedMs) +
+                       " ms (reconexión " + std::to_string(reconnectCount) + ").");
+}
+
+void RobotNamespace::Robot::ensureLink() {
+    // Con una reconexión en curso el puerto puede estar abierto mientras la placa arranca:
+    // hay que esperarla aunque linkLost() ya no lo diga.
+    if (!robotStatus.isConnected || !autoReconnect || (!communicator().linkLost() && !reconnecting.load())) {
+        return;
+    }
+    // Otro hilo pudo haber reconectado (o abandonado) mientras esperábamos el mutex.
+    std::lock_guard<std::mutex> lock(reconnectMutex);
+    if (robotStatus.isConnected && communicator().linkLost()) {
+        reconnecting = true;
+        try {
+            reconnect();
+        } catch (...) {
+            reconnecting = false;
+            throw;
+        }
+        reconnecting = false;
+    }
+}
+
+std::string RobotNamespace::Robot::sendCommand(const std::string& command, int time, RobotStatus* status) {
+    noteActivity();
+    ensureLink();
+    std::int64_t submittedAt = steadyMicros();
+    try {
+        std::string response = sendAndReceive(communicator(), linkStats, command, time, status);
+        bool reportsPosition = status != nullptr && command.compare(0, 4, "M114") == 0;
+        settleMotions(submittedAt, reportsPosition ? &status->currentPosition : nullptr);
+        return response;
+    } catch (const SerialCommunicationException&) {
+        // El comando se perdió con el enlace. No se reintenta: la placa se reinició y
+        // repetirlo a ciegas podría no tener sentido. Dejamos el enlace listo para el próximo.
+        ensureLink();
+        throw;
+    }
+}
+
 void RobotNamespace::Robot::disconnect() {
     if (robotStatus.isConnected) {
         try{
             Logger::getInstance().log(LogLevel::INFO, "[Robot] Cerrando conexión...");
-            ServiceLocator::getCommunicator().close();
+            stopStatusPoller();
+            communicator().close();
+            abandonMotions("El robot se desconectó.");
             robotStatus.isConnected = false;
             robotStatus.areMotorsEnabled = false; // Al desconectar, los motores se apagan
             robotStatus.activityState = "DESCONECTADO";
+            publishStatus(false);
             logAndExecuteState(LogLevel::INFO, "[Robot] Desconexión completada.");
         } catch (const SerialCommunicationException& e){
             logAndExecuteState(LogLevel::ERROR, "[Robot] Error al desconectar: " + std::string(e.what()));
@@ -107,10 +492,12 @@ void RobotNamespace::Robot::enableMotors() {
     isMoving();
     if (robotStatus.isConnected && !robotStatus.areMotorsEnabled) {
         try {
-            std::string response = sendAndReceive(ServiceLocator::getCommunicator(), "M17\r\n");
-            Logger::getInstance().log(LogLevel::INFO, "[Robot] Respuesta de M17: " + (response.empty() ? "[ninguna]" : response));
+            std::string response = sendCommand("M17\r\n");
+            Logger::getInstance().logf(LogLevel::INFO, LogCategory::ROBOT, "[Robot] Respuesta de M17: %s",
+                                       response.empty() ? "[ninguna]" : response.c_str());
             logAndExecuteState(LogLevel::INFO, "[Robot] Motores activados.");
             robotStatus.areMotorsEnabled = true;
+            publishStatus(false);
         } catch (const SerialCommunicationException& e) {
             robotStatus.areMotorsEnabled = false; // Revertimos el estado si falla la comunicación
             logAndExecuteState(LogLevel::ERROR, "[Robot] Error al activar motores: " + std::string(e.what()));
@@ -127,10 +514,12 @@ void RobotNamespace::Robot::disableMotors() {
     isMoving();
     if (robotStatus.areMotorsEnabled) {
         try {
-            std::string response = sendAndReceive(ServiceLocator::getCommunicator(), "M18\r\n");
-            Logger::getInstance().log(LogLevel::INFO, "[Robot] Respuesta de M18: " + (response.empty() ? "[ninguna]" : response));
+            std::string response = sendCommand("M18\r\n");
+            Logger::getInstance().logf(LogLevel::INFO, LogCategory::ROBOT, "[Robot] Respuesta de M18: %s",
+                                       response.empty() ? "[ninguna]" : response.c_str());
             logAndExecuteState(LogLevel::INFO, "[Robot] Motores desactivados.");
             robotStatus.areMotorsEnabled = false;
+            publishStatus(false);
         } catch (const SerialCommunicationException& e) {
             robotStatus.areMotorsEnabled = true; // Revertimos el estado
             logAndExecuteState(LogLevel::ERROR, "[Robot] Error al desactivar motores: " + std::string(e.what()));
@@ -142,20 +531,27 @@ void RobotNamespace::Robot::disableMotors() {
     }
 }
 
-void RobotNamespace::Robot::moveTo(const Position& position, double speed) {
-    executeMoviment(const_cast<Position&>(position), speed);
+std::uint64_t RobotNamespace::Robot::moveTo(const Position& position, double speed) {
+    return executeMoviment(const_cast<Position&>(position), speed);
 }
 
-void RobotNamespace::Robot::moveTo(const Position& position) {
-    executeMoviment(const_cast<Position&>(position));
+std::uint64_t RobotNamespace::Robot::moveTo(const Position& position) {
+    return executeMoviment(const_cast<Position&>(position));
 }
 
 void RobotNamespace::Robot::sendRawGCode(const std::string& gcode) {
     isMoving();
+    std::size_t first = gcode.find_first_not_of(" \t\r\n");
+    char id = first == std::string::npos ? '\0' : static_cast<char>(std::toupper(static_cast<unsigned char>(gcode[first])));
+    if (id != 'G' && id != 'M') {
+        // El firmware responde "ERROR" sin "OK": con otro comando en vuelo, su respuesta se
+        // tomaría como el final de esta y todas las siguientes quedarían desfasadas.
+        exceptionAndExecute("[Robot] Error: El firmware solo acepta comandos G o M: \"" + gcode + "\".");
+    }
     if (robotStatus.isConnected) {
         try {
-            Logger::getInstance().log(LogLevel::INFO, "[Robot] Enviando G-Code crudo: \"" + gcode + "\"");
-            std::string response = sendAndReceive(ServiceLocator::getCommunicator(), gcode + "\r\n");
+            Logger::getInstance().logf(LogLevel::INFO, LogCategory::ROBOT, "[Robot] Enviando G-Code crudo: \"%s\"", gcode.c_str());
+            std::string response = sendCommand(gcode + "\r\n");
             logAndExecuteState(LogLevel::INFO, "[Robot] Respuesta a G-Code crudo: " + (response.empty() ? "[ninguna]" : response));
         } catch (const SerialCommunicationException& e) {
             logAndExecuteState(LogLevel::ERROR, "[Robot] Error al enviar G-Code: " + std::string(e.what()));
@@ -167,16 +563,120 @@ void RobotNamespace::Robot::sendRawGCode(const std::string& gcode) {
 }
 
 
+std::vector<GCodeLineResult> RobotNamespace::Robot::streamGCode(const std::vector<std::string>& lines, std::size_t window) {
+    isMoving();
+    if (!robotStatus.isConnected) {
+        exceptionAndExecute("[Robot] Error: No se puede ejecutar la tarea. El robot no está conectado.");
+    }
+    // Un M114 del muestreador ocuparía un lugar de la cola del firmware que la ventana cuenta como libre.
+    PollerPause pause(*this);
+    noteActivity();
+    ensureLink();
+    if (window == 0) {
+        window = 1;
+    }
+
+    std::vector<GCodeLineResult> results(lines.size());
+    // Índices enviados que todavía esperan su OK, con el futuro de su respuesta.
+    std::deque<std::pair<std::size_t, std::future<ComunicatorPort::SerialReply>>> inFlight;
+    std::size_t next = 0;
+    bool stopFeeding = false;
+    bool replied = false;
+    std::int64_t submittedAt = steadyMicros();
+    ComunicatorPort::ISerialCommunicator& serial = communicator();
+
+    Logger::getInstance().logf(LogLevel::INFO, LogCategory::ROBOT, "[Robot] Iniciando streaming de %zu líneas de G-Code (ventana de %zu).",
+                               lines.size(), window);
+    try {
+        while (next < lines.size() || !inFlight.empty()) {
+            // 1. Llenamos la ventana mientras haya lugar en la cola del firmware.
+            while (!stopFeeding && next < lines.size() && inFlight.size() < window) {
+                GCodeLineResult& result = results[next];
+                result.lineIndex = next;
+                result.command = lines[next];
+
+                std::size_t first = result.command.find_first_not_of(" \t\r\n");
+                if (first == std::string::npos || result.command[first] == ';') {
+                    // Líneas vacías y comentarios no viajan al firmware.
+                    result.success = true;
+                    result.response = "[omitida]";
+                    next++;
+                    continue;
+                }
+                char id = static_cast<char>(std::toupper(static_cast<unsigned char>(result.command[first])));
+                if (id != 'G' && id != 'M') {
+                    // El firmware no responde OK a estas líneas; enviarla desfasaría el conteo.
+                    result.response = "ERROR: COMMAND NOT RECOGNIZED";
+                    stopFeeding = true;
+                    next++;
+                    continue;
+                }
+
+                inFlight.emplace_back(next, serial.submit(result.command + "\r\n", STREAM_REPLY_TIMEOUT));
+                next++;
+            }
+
+            if (inFlight.empty()) {
+                continue;
+            }
+
+            // 2. Cada respuesta completa confirma el comando más antiguo en vuelo.
+            GCodeLineResult& acked = results[inFlight.front().first];
+            ComunicatorPort::SerialReply reply = inFlight.front().second.get();
+            inFlight.pop_front();
+            linkStats.record(acked.command + "\r\n", reply);
+            if (!reply.complete) {
+                throw SerialCommunicationException("Tiempo de espera agotado esperando confirmación de '" +
+                                                   acked.command + "'.");
+            }
+            replied = true;
+            ParsedReply parsed = parseReply(reply.text, "OK", nullptr);
+            acked.success = parsed.error.empty();
+            acked.response = acked.success ? std::move(parsed.text) : std::move(parsed.error);
+            if (!acked.success) {
+                stopFeeding = true; // Dejamos de alimentar la cola, pero drenamos lo ya enviado.
+            }
+        }
+    } catch (const SerialCommunicationException& e) {
+        for (auto& pending : inFlight) {
+            results[pending.first].response = "Sin respuesta: " + std::string(e.what());
+        }
+        logAndExecuteState(LogLevel::ERROR, "[Robot] Error durante el streaming de G-Code: " + std::string(e.what()));
+        ensureLink();
+        throw;
+    }
+
+    if (replied) {
+        settleMotions(submittedAt, nullptr); // La tarea arrancó: el movimiento previo terminó.
+    }
+
+    // Las líneas que no llegaron a enviarse quedan marcadas como fallidas.
+    for (std::size_t i = next; i < lines.size(); ++i) {
+        results[i].lineIndex = i;
+        results[i].command = lines[i];
+        results[i].response = "No enviada: la ejecución se detuvo por un error previo.";
+    }
+
+    std::size_t failed = std::count_if(results.begin(), results.end(),
+                                       [](const GCodeLineResult& r) { return !r.success; });
+    logAndExecuteState(failed == 0 ? LogLevel::INFO : LogLevel::ERROR,
+                       "[Robot] Streaming finalizado: " + std::to_string(lines.size() - failed) + " de " +
+                       std::to_string(lines.size()) + " líneas ejecutadas correctamente.");
+    return results;
+}
+
 void RobotNamespace::Robot::setEffector(bool active) {
     isMoving();
     if (robotStatus.isConnected) {
         try {
             if (active) {
-                std::string response = sendAndReceive(ServiceLocator::getCommunicator(), "M3\r\n");
-                Logger::getInstance().log(LogLevel::INFO, "[Robot] Respuesta de M3: " + (response.empty() ? "[ninguna]" : response));
+                std::string response = sendCommand("M3\r\n");
+                Logger::getInstance().logf(LogLevel::INFO, LogCategory::ROBOT, "[Robot] Respuesta de M3: %s",
+                                           response.empty() ? "[ninguna]" : response.c_str());
             } else {
-                std::string response = sendAndReceive(ServiceLocator::getCommunicator(), "M5\r\n");
-                Logger::getInstance().log(LogLevel::INFO, "[Robot] Respuesta de M5: " + (response.empty() ? "[ninguna]" : response));
+                std::string response = sendCommand("M5\r\n");
+                Logger::getInstance().logf(LogLevel::INFO, LogCategory::ROBOT, "[Robot] Respuesta de M5: %s",
+                                           response.empty() ? "[ninguna]" : response.c_str());
             }
             std::string efector = active ? "activado" : "desactivado";
             logAndExecuteState(LogLevel::INFO, "[Robot] Efector final " + efector + ".");
@@ -194,7 +694,8 @@ void RobotNamespace::Robot::setCoordinateMode(bool isAbsolute) {
         try{
             std::string command = isAbsolute ? "G90\r\n" : "G91\r\n";
             robotStatus.isAbsolute = isAbsolute; // Actualizamos el estado interno inmediatamente
-            std::string response = sendAndReceive(ServiceLocator::getCommunicator(), command);
+            std::string response = sendCommand(command);
+            publishStatus(false);
             response = response.empty() ? "[ninguna]" : response;
             
             std::ostringstream message;
@@ -214,20 +715,8 @@ void RobotNamespace::Robot::setCoordinateMode(bool isAbsolute) {
 
 void RobotNamespace::Robot::recordOrder(const std::string& username, const std::string& commandName, 
                                          const std::string& details) {
-    Order newOrder;
-    
-    auto now = std::chrono::system_clock::now();
-    auto in_time_t = std::chrono::system_clock::to_time_t(now);
-    std::stringstream ss;
-    ss << std::put_time(std::localtime(&in_time_t), "%H:%M:%S");
-
-    newOrder.timestamp = ss.str();
-    newOrder.username = username;
-    newOrder.commandName = commandName;
-    newOrder.details = details;
-    newOrder.success = getExecuteState();
-
-    lastOrders.push_back(newOrder);
+    std::time_t const now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
+    orderHistory.record(static_cast<std::int64_t>(now), username, commandName, details, getExecuteState());
 }
 
 void RobotNamespace::Robot::logAndExecuteState(LogLevel level, std::string state) {
@@ -253,49 +742,42 @@ void RobotNamespace::Robot::isMoving()
     }
 }
 
-/// @brief Envía un comando y espera activamente una respuesta.
-static std::string sendAndReceive(ComunicatorPort::ISerialCommunicator& serial, const std::string& command, int time) {
-    serial.sendMessage(command);
-    
-    std::string full_response;
-    // Intentamos leer varias veces, ya que la respuesta puede llegar en fragmentos.
-    while (true)
-    {
-        full_response = serial.reciveMessage(time);
-        if (full_response.find("OK") != std::string::npos) {
-            std::this_thread::sleep_for(std::chrono::seconds(2));
-            break;
-        }
-    }
-    size_t error_pos = 0;
-    if ((error_pos = full_response.find("ERROR")) != std::string::npos){
-        // Si encontramos "ERROR", lanzamos la excepción solo con el mensaje a partir de ese punto.
-        full_response.erase(std::remove(full_response.begin(), full_response.end(), '\n'), full_response.end());
-        full_response.erase(std::remove(full_response.begin(), full_response.end(), '\r'), full_response.end());
-        throw RobotException(full_response.substr(error_pos-4));
+/// @brief Envía un comando y espera su respuesta. La respuesta está lista apenas
+/// llega la línea terminal ("OK"/"ERROR"), así que no hace falta esperar más.
+static std::string sendAndReceive(ComunicatorPort::ISerialCommunicator& serial, ComunicatorPort::LinkStats& stats,
+                                  const std::string& command, int time, RobotStatus* status) {
+    // El comando pasa por la cola del puerto, así que nunca se intercala con otro hilo.
+    ComunicatorPort::SerialReply reply;
+    try {
+        reply = serial.submit(command, time).get();
+    } catch (const SerialCommunicationException&) {
+        stats.recordTimeout(command);
+        throw;
     }
+    stats.record(command, reply);
 
-    // 1. Reemplazamos la respuesta "OK" para que sea más legible.
-    // Usamos un bucle por si aparece varias veces.
-    size_t pos = 0;
-    std::string replacement = ". OK. ";
-    while ((pos = full_response.find("OK", pos)) != std::string::npos) {
-        full_response.replace(pos, 2, replacement);
-        pos += replacement.length(); // Avanzamos el cursor después de la cadena insertada.
+    if (!reply.complete) {
+        std::string sent = command;
+        sent.erase(std::remove(sent.begin(), sent.end(), '\n'), sent.end());
+        sent.erase(std::remove(sent.begin(), sent.end(), '\r'), sent.end());
+        throw SerialCommunicationException("Tiempo de espera agotado esperando la respuesta a '" + sent + "'.");
     }
 
-    // 2. Eliminamos todos los caracteres de nueva línea y retorno de carro restantes.
-    full_response.erase(std::remove(full_response.begin(), full_response.end(), '\n'), full_response.end());
-    full_response.erase(std::remove(full_response.begin(), full_response.end(), '\r'), full_response.end());
-
-    return full_response; // Devolvemos la cadena procesada.
+    // Una sola pasada: el texto legible ("OK" pasa a ". OK. "), el error y el estado.
+    ParsedReply parsed = parseReply(reply.text, ". OK. ", status);
+    if (!parsed.error.empty()) {
+        // Si hubo "ERROR", lanzamos la excepción solo con el mensaje a partir de ese punto.
+        throw RobotException(parsed.error);
+    }
+    return parsed.text;
 }
 
-void RobotNamespace::Robot::executeMoviment(const Position& position, double speed){
+std::uint64_t RobotNamespace::Robot::executeMoviment(const Position& position, double speed){
     isMoving();
     if (robotStatus.isConnected && robotStatus.areMotorsEnabled) {
         // 1. Generar el comando G-Code a partir de la posición y velocidad.
         std::string gcodeCommand;
+        double commandedE = 0.0; // generateMoveCommand() envía la velocidad en E (0 la por defecto).
         if(position.x == 0 && position.y == 0 && position.z == 0) {
             logAndExecuteState(LogLevel::INFO, "[Robot] Moviendo al origen (0,0,0).");
             robotStatus.activityState = "ORIGEN";
@@ -303,37 +785,226 @@ void RobotNamespace::Robot::executeMoviment(const Position& position, double spe
         } else {
             if (speed != 2000.0){
                 gcodeCommand = GCodeNamespace::GCode::generateMoveCommand(position.x, position.y, position.z, speed);
-                Logger::getInstance().log(LogLevel::INFO, "[Robot] Generado G-Code: \"" + gcodeCommand + "\"");
+                commandedE = speed;
+                Logger::getInstance().logf(LogLevel::INFO, LogCategory::ROBOT, "[Robot] Generado G-Code: \"%s\"", gcodeCommand.c_str());
             } else {
                 gcodeCommand = GCodeNamespace::GCode::generateMoveCommand(position.x, position.y, position.z);
-                Logger::getInstance().log(LogLevel::INFO, "[Robot] Generado G-Code (velocidad por defecto): \"" + gcodeCommand + "\"");
+                Logger::getInstance().logf(LogLevel::INFO, LogCategory::ROBOT, "[Robot] Generado G-Code (velocidad por defecto): \"%s\"",
+                                           gcodeCommand.c_str());
+            }
+        }
+
+        // 2. Destino y duración estimada. El punto de partida es el destino del movimiento
+        // anterior si sigue en curso, o la última posición leída.
+        MotionJob job;
+        job.command = gcodeCommand;
+        if (gcodeCommand != "G28") {
+            RobotStatus sampled = getRobotStatus();
+            if (sampled.statusAgeMs < 0) {
+                sampled = getStatus(0); // Nunca se leyó la posición: la pedimos una vez.
+            }
+            Position start = sampled.currentPosition;
+            bool startKnown = robotStatus.isAbsolute;
+            {
+                std::lock_guard<std::mutex> lock(motionMutex);
+                if (!motionJobs.empty() && motionJobs.back().state == "EN_CURSO") {
+                    start = motionJobs.back().target;
+                    startKnown = motionJobs.back().hasTarget;
+                }
+            }
+            Position target = position;
+            double deltaE = commandedE - lastCommandedE;
+            if (!robotStatus.isAbsolute) {
+                target = Position(start.x + position.x, start.y + position.y, start.z + position.z);
+                deltaE = commandedE;
             }
+            job.target = target;
+            job.hasTarget = robotStatus.isAbsolute || startKnown;
+            job.predictedMs = predictMoveMs(target.x - start.x, target.y - start.y, target.z - start.z, deltaE, 0);
         }
+
         try {
-            // 2. Enviar el comando a través del comunicador serie.
-            Logger::getInstance().log(LogLevel::INFO, "[Robot] Enviando comando al puerto serie...");
-            std::string response = sendAndReceive(ServiceLocator::getCommunicator(), gcodeCommand + "\r\n", 3); // Mayor timeout para movimientos
+            // 3. Enviar el comando. El OK llega cuando el firmware lo saca de su cola, es decir,
+            // cuando terminó el movimiento anterior: el timeout incluye lo que le falte.
+            Logger::getInstance().logf(LogLevel::INFO, LogCategory::ROBOT, "[Robot] Enviando comando al puerto serie...");
+            std::string response = sendCommand(gcodeCommand + "\r\n", 3 + motionBacklogSeconds());
 
             if (!(response.find("ERROR") != std::string::npos)){
-                robotStatus.activityState = "MOVIENDO"; // Cambiar estado ANTES de enviar
-                Logger::getInstance().log(LogLevel::INFO, "[Robot] Comando de movimiento aceptado por el robot. Respuesta: " + response);
-                // NOTA: El robot ahora está físicamente en movimiento.
-                // El estado se quedará en "MOVIENDO". Se necesita un mecanismo (hilo, sondeo) para detectar el fin del movimiento.
-                // Por ahora, lo cambiaremos a EN_POSICION para que no se bloquee.
+                lastCommandedE = robotStatus.isAbsolute ? commandedE : lastCommandedE + commandedE;
+                // Estado al terminar; mientras el movimiento siga en curso se publica MOVIENDO.
                 robotStatus.activityState = "EN_POSICION";
-                logAndExecuteState(LogLevel::INFO, "[Robot] Movimiento completado.");
+                std::uint64_t id = startMotion(job);
+                publishStatus(false);
+                logAndExecuteState(LogLevel::INFO, "[Robot] Movimiento " + std::to_string(id) + " en curso (estimado: " +
+                                   double_a_string_con_precision(job.predictedMs, 0) + " ms). Respuesta: " + response);
+                return id;
             } else {
                 exceptionAndExecute("[Robot] Error: " + response);
             }
         } catch (const SerialCommunicationException& e) {
             logAndExecuteState(LogLevel::ERROR, "[Robot] Error al enviar comando de movimiento." + std::string(e.what()));
             robotStatus.activityState = "ERROR";
-            return; // Salimos si hubo un error al enviar.
+            publishStatus(false);
+            return 0; // Salimos si hubo un error al enviar.
         }
 
     } else {
         exceptionAndExecute("[Robot] Error: No se puede mover. Asegúrese de que el robot esté conectado y los motores estén habilitados.");
     }
+    return 0;
+}
+
+std::uint64_t RobotNamespace::Robot::startMotion(MotionJob job) {
+    std::lock_guard<std::mutex> lock(motionMutex);
+    job.id = nextMotionId++;
+    job.startedAtUs = steadyMicros();
+    job.expectedDoneUs = job.startedAtUs + static_cast<std::int64_t>(job.predictedMs * 1000);
+    motionJobs.push_back(job);
+    if (motionJobs.size() > MOTION_HISTORY) {
+        if (motionJobs.front().state == "EN_CURSO") {
+            pendingMotions--;
+        }
+        motionJobs.pop_front();
+    }
+    pendingMotions++;
+    return job.id;
+}
+
+void RobotNamespace::Robot::settleMotions(std::int64_t submittedAtUs, const Position* reported) {
+    if (pendingMotions.load() == 0) {
+        return;
+    }
+    std::int64_t now = steadyMicros();
+    std::string message;
+    bool failed = false;
+    {
+        std::lock_guard<std::mutex> lock(motionMutex);
+        MotionJob* last = nullptr;
+        for (MotionJob& job : motionJobs) {
+            if (job.state != "EN_CURSO" || job.startedAtUs >= submittedAtUs) {
+                continue;
+            }
+            job.state = "COMPLETADO";
+            job.elapsedMs = (now - job.startedAtUs) / 1000;
+            pendingMotions--;
+            last = &job;
+        }
+        if (last == nullptr) {
+            return;
+        }
+        // Solo el último llegó a la posición informada; los anteriores la atravesaron.
+        if (reported != nullptr && last->hasTarget) {
+            double dx = reported->x - last->target.x;
+            double dy = reported->y - last->target.y;
+            double dz = reported->z - last->target.z;
+            double miss = std::sqrt(dx * dx + dy * dy + dz * dz);
+            if (miss > MOTION_TOLERANCE_MM) {
+                last->state = "FALLIDO";
+                last->detail = "Se detuvo en (" + double_a_string_con_precision(reported->x, 2) + ", " +
+                               double_a_string_con_precision(reported->y, 2) + ", " +
+                               double_a_string_con_precision(reported->z, 2) + "), a " +
+                               double_a_string_con_precision(miss, 2) + " mm del destino.";
+                failed = true;
+                message = "[Robot] Movimiento " + std::to_string(last->id) + " fallido: " + last->detail;
+            }
+        }
+        if (!failed) {
+            message = "[Robot] Movimiento " + std::to_string(last->id) + " completado en " +
+                      std::to_string(last->elapsedMs) + " ms (estimado: " +
+                      double_a_string_con_precision(last->predictedMs, 0) + " ms).";
+        }
+        if (pendingMotions.load() == 0) {
+            updateSnapshot([failed](StatusSample& sample) {
+                if (failed) {
+                    std::snprintf(sample.activityState, sizeof(sample.activityState), "%s", "ERROR");
+                } else if (std::strcmp(sample.activityState, "MOVIENDO") == 0) {
+                    std::snprintf(sample.activityState, sizeof(sample.activityState), "%s", "EN_POSICION");
+                }
+            });
+        }
+    }
+    motionChanged.notify_all();
+    Logger::getInstance().log(failed ? LogLevel::WARNING : LogLevel::INFO, message);
+}
+
+void RobotNamespace::Robot::abandonMotions(const std::string& reason) {
+    if (pendingMotions.load() == 0) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(motionMutex);
+        std::int64_t now = steadyMicros();
+        for (MotionJob& job : motionJobs) {
+            if (job.state == "EN_CURSO") {
+                job.state = "FALLIDO";
+                job.detail = reason;
+                job.elapsedMs = (now - job.startedAtUs) / 1000;
+            }
+        }
+        pendingMotions = 0;
+    }
+    motionChanged.notify_all();
+    Logger::getInstance().log(LogLevel::WARNING, "[Robot] Movimientos en curso abandonados: " + reason);
+}
+
+int RobotNamespace::Robot::motionBacklogSeconds() {
+    if (pendingMotions.load() == 0) {
+        return 0;
+    }
+    std::lock_guard<std::mutex> lock(motionMutex);
+    std::int64_t remainingUs = 0;
+    std::int64_t now = steadyMicros();
+    for (const MotionJob& job : motionJobs) {
+        if (job.state == "EN_CURSO") {
+            remainingUs = std::max(remainingUs, job.expectedDoneUs - now);
+        }
+    }
+    return static_cast<int>((remainingUs + 999999) / 1000000);
+}
+
+MotionJob RobotNamespace::Robot::waitMotion(std::uint64_t jobId, int timeoutMs) {
+    auto deadline = std::chrono::steady_clock::now() +
+                    std::chrono::milliseconds(std::clamp(timeoutMs, 0, MAX_CHANGE_WAIT_MS));
+    std::unique_lock<std::mutex> lock(motionMutex);
+    while (true) {
+        auto it = std::find_if(motionJobs.begin(), motionJobs.end(),
+                               [jobId](const MotionJob& job) { return job.id == jobId; });
+        if (jobId == 0 && !motionJobs.empty()) {
+            it = std::prev(motionJobs.end());
+        }
+        if (it == motionJobs.end()) {
+            lock.unlock();
+            exceptionAndExecute("[Robot] Error: No hay un movimiento con id " + std::to_string(jobId) + ".");
+        }
+        if (it->state != "EN_CURSO" || std::chrono::steady_clock::now() >= deadline) {
+            return *it;
+        }
+
+        // Hasta el fin estimado alcanza con esperar: lo puede confirmar el muestreador u otro comando.
+        std::int64_t remainingUs = it->expectedDoneUs - steadyMicros();
+        if (remainingUs > 0) {
+            motionChanged.wait_until(lock, std::min(deadline, std::chrono::steady_clock::now() +
+                                                                  std::chrono::microseconds(remainingUs)));
+            continue;
+        }
+
+        // Cumplido el tiempo estimado, lo confirmamos: el firmware responde el M114 al terminar.
+        // La espera no pasa del plazo (el puerto cuenta en segundos enteros, así que se
+        // redondea hacia arriba); si vence antes de la respuesta, el movimiento sigue EN_CURSO.
+        lock.unlock();
+        auto leftMs = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now()).count();
+        int replySeconds = static_cast<int>(std::min<long long>(STREAM_REPLY_TIMEOUT, (leftMs + 999) / 1000));
+        if (replySeconds > 0) {
+            try {
+                sampleStatus(replySeconds);
+            } catch (const SerialCommunicationException&) {
+                if (communicator().linkLost() || std::chrono::steady_clock::now() < deadline) {
+                    throw;
+                }
+            }
+        }
+        lock.lock();
+    }
 }
 
 void RobotNamespace::Robot::exceptionAndExecute(std::string e){
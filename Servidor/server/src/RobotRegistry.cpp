@@ -0,0 +1,122 @@
+#include "RobotRegistry.h"
+#include "Exceptions.h"
+#include "Logger.h"
+#include <stdexcept>
+
+RobotNamespace::RobotRegistry::RobotRegistry()
+{
+}
+
+RobotNamespace::RobotRegistry::~RobotRegistry()
+{
+    // Los robots se destruyen antes que los comunicadores que usan (orden de Entry).
+}
+
+RobotNamespace::Robot& RobotNamespace::RobotRegistry::add(const std::string& id, const std::string& serialPort,
+                                                          ComunicatorPort::ISerialCommunicator* communicator) {
+    if (id.empty()) {
+        throw RobotException("[Robot Registry] El id del robot no puede estar vacío.");
+    }
+    if (contains(id)) {
+        throw RobotException("[Robot Registry] Ya existe un robot con id '" + id + "'.");
+    }
+
+    Entry entry;
+    entry.robot = std::make_unique<Robot>();
+    if (!serialPort.empty()) {
+        entry.robot->setSerialPort(serialPort);
+    }
+    entry.robot->setCommunicator(communicator);
+    entry.robot->setBinaryFraming(binaryFraming);
+    entry.robot->setBaudRate(baudRate);
+    entry.robot->setStatusPollInterval(statusPollIntervalMs);
+    entry.robot->getOrderHistory().setCapacity(orderHistoryCapacity);
+    entry.robot->getOrderHistory().setSpillPath(orderSpillPath(id));
+
+    Robot& robot = *entry.robot;
+    robots.emplace(id, std::move(entry));
+    if (defaultId.empty()) {
+        defaultId = id;
+    }
+    Logger::getInstance().log(LogLevel::INFO, "[Robot Registry] Robot '" + id + "' registrado en " + robot.getSerialPort() + ".");
+    return robot;
+}
+
+RobotNamespace::Robot& RobotNamespace::RobotRegistry::add(const std::string& id, const std::string& serialPort,
+                                                          std::unique_ptr<ComunicatorPort::ISerialCommunicator> communicator) {
+    Robot& robot = add(id, serialPort, communicator.get());
+    robots.at(id).ownedCommunicator = std::move(communicator);
+    return robot;
+}
+
+RobotNamespace::Robot& RobotNamespace::RobotRegistry::get(const std::string& id) {
+    if (id.empty()) {
+        return defaultRobot();
+    }
+    auto it = robots.find(id);
+    if (it == robots.end()) {
+        throw RobotException("[Robot Registry] No existe el robot '" + id + "'.");
+    }
+    return *it->second.robot;
+}
+
+RobotNamespace::Robot& RobotNamespace::RobotRegistry::defaultRobot() {
+    if (defaultId.empty()) {
+        throw RobotException("[Robot Registry] No hay robots registrados.");
+    }
+    return *robots.at(defaultId).robot;
+}
+
+std::vector<std::string> RobotNamespace::RobotRegistry::ids() const {
+    std::vector<std::string> result;
+    result.reserve(robots.size());
+    for (const auto& pair : robots) {
+        result.push_back(pair.first);
+    }
+    return result;
+}
+
+void RobotNamespace::RobotRegistry::setBinaryFraming(bool enabled) {
+    binaryFraming = enabled;
+    for (auto& pair : robots) {
+        pair.second.robot->setBinaryFraming(enabled);
+    }
+}
+
+void RobotNamespace::RobotRegistry::setBaudRate(int rate) {
+    baudRate = rate;
+    for (auto& pair : robots) {
+        pair.second.robot->setBaudRate(rate);
+    }
+}
+
+void RobotNamespace::RobotRegistry::setStatusPollInterval(int intervalMs) {
+    statusPollIntervalMs = intervalMs;
+    for (auto& pair : robots) {
+        pair.second.robot->setStatusPollInterval(intervalMs);
+    }
+}
+
+void RobotNamespace::RobotRegistry::setOrderHistoryCapacity(std::size_t capacity) {
+    if (capacity == 0) {
+        throw std::invalid_argument("[Robot Registry] El historial de órdenes necesita lugar para al menos una.");
+    }
+    for (auto& pair : robots) {
+        pair.second.robot->getOrderHistory().setCapacity(capacity);
+    }
+    orderHistoryCapacity = capacity;
+}
+
+void RobotNamespace::RobotRegistry::setOrderSpillDirectory(const std::string& directory) {
+    orderSpillDirectory = directory;
+    for (auto& pair : robots) {
+        pair.second.robot->getOrderHistory().setSpillPath(orderSpillPath(pair.first));
+    }
+}
+
+std::string RobotNamespace::RobotRegistry::orderSpillPath(const std::string& id) const {
+    if (orderSpillDirectory.empty()) {
+        return "";
+    }
+    return orderSpillDirectory + "/orders-" + id + ".csv";
+}
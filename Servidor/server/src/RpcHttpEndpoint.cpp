@@ -0,0 +1,263 @@
+#include "RpcHttpEndpoint.h"
+#include <xmlrpc-c/json.h>
+#include <xmlrpc-c/server_abyss.hpp> // callInfo_abyss
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+#include "Logger.h"
+
+namespace {
+
+// Códigos de JSON-RPC 2.0 para los errores que no vienen de un método.
+constexpr int PARSE_ERROR = -32700;
+constexpr int INVALID_REQUEST = -32600;
+constexpr int METHOD_NOT_FOUND = -32601;
+
+constexpr std::size_t MAX_BODY_BYTES = 1024 * 1024;
+
+/// @brief JSON no distingue enteros: xmlrpc_parse_json los entrega como i8, y la API
+/// XML-RPC usa int. Se achican en todo el árbol (los parámetros de robot.batch también).
+xmlrpc_c::value narrowIntegers(const xmlrpc_c::value& value) {
+    switch (value.type()) {
+        case xmlrpc_c::value::TYPE_I8: {
+            long long const number = xmlrpc_c::value_i8(value).cvalue();
+            if (number >= INT32_MIN && number <= INT32_MAX) {
+                return xmlrpc_c::value_int(static_cast<int>(number));
+            }
+            return value;
+        }
+        case xmlrpc_c::value::TYPE_ARRAY: {
+            std::vector<xmlrpc_c::value> items;
+            for (const auto& item : xmlrpc_c::value_array(value).vectorValueValue()) {
+                items.push_back(narrowIntegers(item));
+            }
+            return xmlrpc_c::value_array(items);
+        }
+        case xmlrpc_c::value::TYPE_STRUCT: {
+            std::map<std::string, xmlrpc_c::value> fields;
+            for (const auto& field : xmlrpc_c::value_struct(value).cvalue()) {
+                fields.emplace(field.first, narrowIntegers(field.second));
+            }
+            return xmlrpc_c::value_struct(fields);
+        }
+        default:
+            return value;
+    }
+}
+
+xmlrpc_c::value parseJson(const std::string& text) {
+    xmlrpc_env env;
+    xmlrpc_env_init(&env);
+    xmlrpc_value* parsed = xmlrpc_parse_json(&env, text.c_str());
+    if (env.fault_occurred) {
+        std::string const error = env.fault_string ? env.fault_string : "JSON inválido";
+        xmlrpc_env_clean(&env);
+        throw xmlrpc_c::fault("JSON inválido: " + error, static_cast<xmlrpc_c::fault::code_t>(PARSE_ERROR));
+    }
+    xmlrpc_c::value const value(parsed); // El wrapper toma su propia referencia.
+    xmlrpc_DECREF(parsed);
+    xmlrpc_env_clean(&env);
+    return narrowIntegers(value);
+}
+
+std::string toJson(const xmlrpc_c::value& value) {
+    xmlrpc_env env;
+    xmlrpc_env_init(&env);
+    xmlrpc_mem_block* block = XMLRPC_MEMBLOCK_NEW(char, &env, 0);
+    xmlrpc_value* cValue = value.cValue(); // Referencia nueva, a cargo nuestro.
+    xmlrpc_serialize_json(&env, cValue, block);
+    xmlrpc_DECREF(cValue);
+    std::string json;
+    if (!env.fault_occurred) {
+        json.assign(XMLRPC_MEMBLOCK_CONTENTS(char, block), XMLRPC_MEMBLOCK_SIZE(char, block));
+    }
+    XMLRPC_MEMBLOCK_FREE(char, block);
+    bool const failed = env.fault_occurred;
+    xmlrpc_env_clean(&env);
+    if (failed) {
+        throw std::runtime_error("No se pudo convertir la respuesta a JSON.");
+    }
+    return json;
+}
+
+xmlrpc_c::value idOrNull(const xmlrpc_c::value& id) {
+    return id.isInstantiated() ? id : xmlrpc_c::value(xmlrpc_c::value_nil());
+}
+
+std::string errorResponse(int faultCode, const std::string& message, bool jsonRpc2, const xmlrpc_c::value& id) {
+    std::map<std::string, xmlrpc_c::value> error;
+    error["code"] = xmlrpc_c::value_int(jsonRpc2 && faultCode == xmlrpc_c::fault::CODE_NO_SUCH_METHOD ? METHOD_NOT_FOUND
+                                                                                                   : faultCode);
+    error["message"] = xmlrpc_c::value_string(message);
+    std::map<std::string, xmlrpc_c::value> response;
+    if (jsonRpc2) {
+        response["jsonrpc"] = xmlrpc_c::value_string("2.0");
+        response["id"] = idOrNull(id);
+    } else {
+        // Los mismos campos que devolvía el proxy de Node.js, que el index.html ya lee.
+        error["faultCode"] = xmlrpc_c::value_int(faultCode);
+        error["faultString"] = xmlrpc_c::value_string(message);
+    }
+    response["error"] = xmlrpc_c::value_struct(error);
+    return toJson(xmlrpc_c::value_struct(response));
+}
+
+void sendResponse(TSession* session, xmlrpc_uint16_t status, const char* contentType, const std::string& body) {
+    ResponseStatus(session, status);
+    ResponseAddField(session, "Access-Control-Allow-Origin", "*");
+    ResponseContentType(session, contentType);
+    ResponseContentLength(session, body.size());
+    ResponseWriteStart(session);
+    ResponseWriteBody(session, body.data(), static_cast<xmlrpc_uint32_t>(body.size()));
+    ResponseWriteEnd(session);
+}
+
+/// @brief Lee el cuerpo del pedido según Content-Length. Devuelve el código HTTP de error, o 0.
+xmlrpc_uint16_t readBody(TSession* session, std::string& body) {
+    const char* header = RequestHeaderValue(session, "content-length");
+    if (!header) {
+        return 411;
+    }
+    std::size_t const length = std::strtoul(header, nullptr, 10);
+    if (length > MAX_BODY_BYTES) {
+        return 413;
+    }
+    body.reserve(length);
+    while (body.size() < length) {
+        if (SessionReadDataAvail(session) == 0 && !SessionRefillBuffer(session)) {
+            return 400; // El cliente cerró o venció el timeout antes de mandar todo.
+        }
+        const char* chunk;
+        std::size_t chunkLength;
+        SessionGetReadData(session, length - body.size(), &chunk, &chunkLength);
+        body.append(chunk, chunkLength);
+    }
+    return 0;
+}
+
+} // namespace
+
+RpcServiceHandlerNamespace::RpcHttpEndpoint::RpcHttpEndpoint(const xmlrpc_c::registry& registry,
+                                                             const RpcServiceHandler* handler,
+                                                             const std::string& webRoot)
+    : registry(registry), handler(handler) {
+    std::ifstream file(webRoot + "/index.html", std::ios::binary);
+    if (!webRoot.empty() && file) {
+        std::ostringstream content;
+        content << file.rdbuf();
+        indexHtml = content.str();
+    }
+}
+
+void RpcServiceHandlerNamespace::RpcHttpEndpoint::install(TServer& server) {
+    struct ServerReqHandler3 requestHandler = {};
+    requestHandler.handleReq = &RpcHttpEndpoint::handleRequest;
+    requestHandler.userdata = this;
+    requestHandler.handleReqStackSize = 256 * 1024; // Los métodos RPC corren en este hilo.
+    abyss_bool success = false;
+    ServerAddHandler3(&server, &requestHandler, &success);
+    if (!success) {
+        throw std::runtime_error("No se pudo agregar el manejador RPC al servidor HTTP.");
+    }
+}
+
+std::string RpcServiceHandlerNamespace::RpcHttpEndpoint::handleJsonCall(const std::string& body,
+                                                                    const xmlrpc_c::callInfo* callInfoP) const {
+    bool jsonRpc2 = false;
+    xmlrpc_c::value id; // Queda sin instanciar (null en la respuesta) si el pedido no trae "id".
+    try {
+        xmlrpc_c::value const request = parseJson(body);
+        if (request.type() != xmlrpc_c::value::TYPE_STRUCT) {
+            throw xmlrpc_c::fault("El pedido debe ser un objeto JSON.", static_cast<xmlrpc_c::fault::code_t>(INVALID_REQUEST));
+        }
+        std::map<std::string, xmlrpc_c::value> const fields = xmlrpc_c::value_struct(request).cvalue();
+        jsonRpc2 = fields.count("jsonrpc") != 0;
+        if (fields.count("id")) {
+            id = fields.at("id");
+        }
+        auto method = fields.find("method");
+        if (method == fields.end() || method->second.type() != xmlrpc_c::value::TYPE_STRING) {
+            throw xmlrpc_c::fault("Falta el campo \"method\".", static_cast<xmlrpc_c::fault::code_t>(INVALID_REQUEST));
+        }
+        xmlrpc_c::paramList params;
+        auto paramsField = fields.find("params");
+        if (paramsField != fields.end() && paramsField->second.type() == xmlrpc_c::value::TYPE_ARRAY) {
+            for (const auto& param : xmlrpc_c::value_array(paramsField->second).vectorValueValue()) {
+                params.add(param);
+            }
+        } else if (paramsField != fields.end() && paramsField->second.type() != xmlrpc_c::value::TYPE_NIL) {
+            throw xmlrpc_c::fault("\"params\" debe ser un arreglo.", static_cast<xmlrpc_c::fault::code_t>(INVALID_REQUEST));
+        }
+
+        xmlrpc_c::value result;
+        handler->call(xmlrpc_c::value_string(method->second).cvalue(), params, callInfoP, &result);
+        std::map<std::string, xmlrpc_c::value> response;
+        if (jsonRpc2) {
+            response["jsonrpc"] = xmlrpc_c::value_string("2.0");
+            response["id"] = idOrNull(id);
+        } else {
+            response["success"] = xmlrpc_c::value_boolean(true);
+        }
+        response["result"] = result;
+        return toJson(xmlrpc_c::value_struct(response));
+    } catch (const xmlrpc_c::fault& f) {
+        return errorResponse(f.getCode(), f.getDescription(), jsonRpc2, id);
+    } catch (const std::exception& e) {
+        return errorResponse(xmlrpc_c::fault::CODE_INTERNAL, e.what(), jsonRpc2, id);
+    }
+}
+
+void RpcServiceHandlerNamespace::RpcHttpEndpoint::handleRequest(void* userdata, TSession* session, abyss_bool* handledP) {
+    auto* self = static_cast<RpcHttpEndpoint*>(userdata);
+    const TRequestInfo* request;
+    SessionGetRequestInfo(session, &request);
+    std::string const uri = request->uri ? request->uri : "";
+
+    *handledP = true;
+    try {
+        if (uri == "/RPC2" && request->method == m_post) {
+            // Se atiende aquí y no con server_abyss_set_handlers: con la versión de xmlrpc-c de
+            // library/ ese manejador envía el comienzo del cuerpo de la respuesta corrompido.
+            std::string body;
+            xmlrpc_uint16_t const status = readBody(session, body);
+            if (status != 0) {
+                sendResponse(session, status, "text/plain", "");
+                return;
+            }
+            xmlrpc_c::callInfo_abyss const callInfo(session);
+            std::string responseXml;
+            self->registry.processCall(body, &callInfo, &responseXml);
+            sendResponse(session, 200, "text/xml; charset=utf-8", responseXml);
+        } else if (uri == "/rpc" && request->method == m_options && self->handler) {
+            // Preflight CORS, para páginas servidas desde otro origen.
+            ResponseAddField(session, "Access-Control-Allow-Methods", "POST, OPTIONS");
+            ResponseAddField(session, "Access-Control-Allow-Headers", "Content-Type");
+            sendResponse(session, 204, "text/plain", "");
+        } else if (uri == "/rpc" && request->method == m_post && self->handler) {
+            std::string body;
+            xmlrpc_uint16_t const status = readBody(session, body);
+            if (status != 0) {
+                sendResponse(session, status, "text/plain", "");
+                return;
+            }
+            xmlrpc_c::callInfo_abyss const callInfo(session);
+            sendResponse(session, 200, "application/json", self->handleJsonCall(body, &callInfo));
+        } else if (uri == "/health" && request->method == m_get) {
+            sendResponse(session, 200, "application/json",
+                         "{\"status\": \"ok\", \"protocol\": \"XML-RPC (/RPC2), JSON (/rpc)\", "
+                         "\"message\": \"Servidor del robot funcionando\"}");
+        } else if (uri == "/metrics" && request->method == m_get && self->handler) {
+            sendResponse(session, 200, "text/plain; version=0.0.4", self->handler->getMetrics().render());
+        } else if ((uri == "/" || uri == "/index.html") && request->method == m_get && self->servesIndex()) {
+            sendResponse(session, 200, "text/html; charset=utf-8", self->indexHtml);
+        } else {
+            *handledP = false; // Abyss responde 404.
+        }
+    } catch (const std::exception& e) {
+        Logger::getInstance().log(LogLevel::ERROR, "[HTTP] Error atendiendo " + uri + ": " + e.what());
+        sendResponse(session, 500, "text/plain", "");
+    }
+}
@@ -0,0 +1,111 @@
+#include "RpcMetrics.h"
+
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include "Exceptions.h"
+
+// --- RpcMethodStats ---
+
+RpcServiceHandlerNamespace::RpcMethodStats::RpcMethodStats() {
+    for (auto& bucket : buckets_) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    for (auto& errors : errors_) {
+        errors.store(0, std::memory_order_relaxed);
+    }
+}
+
+void RpcServiceHandlerNamespace::RpcMethodStats::end(std::chrono::steady_clock::duration elapsed) {
+    double const seconds = std::chrono::duration<double>(elapsed).count();
+    std::size_t bucket = 0;
+    while (bucket < BUCKET_BOUNDS.size() && seconds > BUCKET_BOUNDS[bucket]) {
+        bucket++;
+    }
+    buckets_[bucket].fetch_add(1, std::memory_order_relaxed);
+    totalMicros_.fetch_add(static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count()),
+                           std::memory_order_relaxed);
+    calls_.fetch_add(1, std::memory_order_relaxed);
+    inFlight_.fetch_sub(1, std::memory_order_relaxed);
+}
+
+RpcServiceHandlerNamespace::RpcMethodStats::ErrorType
+RpcServiceHandlerNamespace::RpcMethodStats::errorTypeOf(const std::exception& e) {
+    if (dynamic_cast<const InvalidCredentialsException*>(&e)) return ErrorType::InvalidCredentials;
+    if (dynamic_cast<const PermissionDeniedException*>(&e)) return ErrorType::PermissionDenied;
+    if (dynamic_cast<const AuthenticationException*>(&e)) return ErrorType::Authentication;
+    if (dynamic_cast<const SerialCommunicationException*>(&e)) return ErrorType::SerialCommunication;
+    if (dynamic_cast<const DatabaseException*>(&e)) return ErrorType::Database;
+    if (dynamic_cast<const RobotException*>(&e)) return ErrorType::Robot;
+    if (dynamic_cast<const AppException*>(&e)) return ErrorType::App;
+    if (dynamic_cast<const std::invalid_argument*>(&e)) return ErrorType::InvalidArgument;
+    return ErrorType::Other;
+}
+
+const char* RpcServiceHandlerNamespace::RpcMethodStats::errorTypeName(ErrorType type) {
+    switch (type) {
+        case ErrorType::InvalidCredentials: return "InvalidCredentialsException";
+        case ErrorType::PermissionDenied: return "PermissionDeniedException";
+        case ErrorType::Authentication: return "AuthenticationException";
+        case ErrorType::SerialCommunication: return "SerialCommunicationException";
+        case ErrorType::Database: return "DatabaseException";
+        case ErrorType::Robot: return "RobotException";
+        case ErrorType::App: return "AppException";
+        case ErrorType::InvalidArgument: return "invalid_argument";
+        case ErrorType::Fault: return "fault";
+        default: return "other";
+    }
+}
+
+// --- RpcMetrics ---
+
+RpcServiceHandlerNamespace::RpcMethodStats& RpcServiceHandlerNamespace::RpcMetrics::add(const std::string& method) {
+    auto& stats = methods_[method];
+    if (!stats) {
+        stats = std::make_unique<RpcMethodStats>();
+    }
+    return *stats;
+}
+
+std::string RpcServiceHandlerNamespace::RpcMetrics::render() const {
+    std::ostringstream calls, inFlight, errors, duration;
+    calls << "# HELP rpc_requests_total RPC calls completed, by method.\n"
+          << "# TYPE rpc_requests_total counter\n";
+    inFlight << "# HELP rpc_requests_in_flight RPC calls currently running, by method.\n"
+             << "# TYPE rpc_requests_in_flight gauge\n";
+    errors << "# HELP rpc_errors_total Failed RPC calls, by method and exception type.\n"
+           << "# TYPE rpc_errors_total counter\n";
+    duration << "# HELP rpc_request_duration_seconds RPC call duration, by method.\n"
+             << "# TYPE rpc_request_duration_seconds histogram\n";
+
+    for (const auto& entry : methods_) {
+        const RpcMethodStats& stats = *entry.second;
+        std::string const label = "method=\"" + entry.first + "\"";
+
+        // Cada contador se lee por separado: con llamadas en curso, la suma de las cubetas
+        // puede adelantarse o atrasarse un poco respecto de rpc_requests_total.
+        calls << "rpc_requests_total{" << label << "} " << stats.calls_.load(std::memory_order_relaxed) << "\n";
+        inFlight << "rpc_requests_in_flight{" << label << "} " << stats.inFlight_.load(std::memory_order_relaxed) << "\n";
+        for (int type = 0; type < static_cast<int>(RpcMethodStats::ErrorType::COUNT); ++type) {
+            std::uint64_t const count = stats.errors_[type].load(std::memory_order_relaxed);
+            if (count > 0) {
+                errors << "rpc_errors_total{" << label << ",exception=\""
+                       << RpcMethodStats::errorTypeName(static_cast<RpcMethodStats::ErrorType>(type)) << "\"} "
+                       << count << "\n";
+            }
+        }
+
+        std::uint64_t cumulative = 0;
+        for (std::size_t bucket = 0; bucket < RpcMethodStats::BUCKET_BOUNDS.size(); ++bucket) {
+            cumulative += stats.buckets_[bucket].load(std::memory_order_relaxed);
+            duration << "rpc_request_duration_seconds_bucket{" << label << ",le=\""
+                     << RpcMethodStats::BUCKET_BOUNDS[bucket] << "\"} " << cumulative << "\n";
+        }
+        cumulative += stats.buckets_.back().load(std::memory_order_relaxed);
+        duration << "rpc_request_duration_seconds_bucket{" << label << ",le=\"+Inf\"} " << cumulative << "\n"
+                 << "rpc_request_duration_seconds_sum{" << label << "} " << std::fixed << std::setprecision(6)
+                 << stats.totalMicros_.load(std::memory_order_relaxed) / 1e6 << std::defaultfloat << "\n"
+                 << "rpc_request_duration_seconds_count{" << label << "} " << cumulative << "\n";
+    }
+    return calls.str() + inFlight.str() + errors.str() + duration.str();
+}
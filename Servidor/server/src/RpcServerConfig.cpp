@@ -0,0 +1,20 @@
+#include "RpcServerConfig.h"
+#include <stdexcept>
+
+void RpcServiceHandlerNamespace::RpcServerConfig::create(TServer& server) const {
+    // Sin dirección explícita, Abyss escucha en todas las interfaces (0.0.0.0) del puerto indicado.
+    if (!ServerCreate(&server, "XmlRpcServer", static_cast<xmlrpc_uint16_t>(port), nullptr, nullptr)) {
+        throw std::runtime_error("No se pudo crear el servidor HTTP en el puerto " + std::to_string(port));
+    }
+    ServerSetMaxConn(&server, workers);
+    ServerSetMaxConnBacklog(&server, backlog);
+    ServerSetKeepaliveTimeout(&server, keepaliveSeconds);
+    ServerSetKeepaliveMaxConn(&server, keepaliveRequests);
+    ServerSetTimeout(&server, timeoutSeconds);
+}
+
+std::string RpcServiceHandlerNamespace::RpcServerConfig::describe() const {
+    return "puerto " + std::to_string(port) + ", " + std::to_string(workers) + " hilos, backlog " +
+           std::to_string(backlog) + ", keep-alive " + std::to_string(keepaliveSeconds) + " s / " +
+           std::to_string(keepaliveRequests) + " pedidos";
+}
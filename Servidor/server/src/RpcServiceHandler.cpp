@@ -21,9 +21,9 @@ extern "C" {
 
 RpcServiceHandlerNamespace::RpcServiceHandler::RpcServiceHandler(
     AuthenticationServiceNamespace::AuthenticationService& authService,
-    RobotNamespace::Robot& robot,
+    RobotNamespace::RobotRegistry& robots,
     TaskManager& taskManager
-) : authService(authService), robot(robot), taskManager(taskManager)
+) : authService(authService), robots(robots), taskManager(taskManager)
 {
 }
 
@@ -31,6 +31,26 @@ RpcServiceHandlerNamespace::RpcServiceHandler::~RpcServiceHandler()
 {
 }
 
+/// @brief IP del cliente que hizo el pedido, o "unknown" si no llegó por Abyss.
+/// serverAbyss entrega callInfo_serverAbyss; un TServer propio con server_abyss_set_handlers
+/// (y el endpoint JSON) entregan callInfo_abyss.
+static std::string clientIpOf(const xmlrpc_c::callInfo* callInfoP) {
+    TSession* session = nullptr;
+    if (auto const* serverInfoP = dynamic_cast<const xmlrpc_c::callInfo_serverAbyss*>(callInfoP)) {
+        session = serverInfoP->abyssSessionP;
+    } else if (auto const* abyssInfoP = dynamic_cast<const xmlrpc_c::callInfo_abyss*>(callInfoP)) {
+        session = abyssInfoP->abyssSessionP;
+    }
+    if (session) {
+        // Usamos SessionGetChannelInfo para obtener la IP.
+        struct abyss_unix_chaninfo *channelInfo;
+        SessionGetChannelInfo(session, (void**)&channelInfo);
+        if (channelInfo)
+            return inet_ntoa(((struct sockaddr_in*)&channelInfo->peerAddr)->sin_addr);
+    }
+    return "unknown";
+}
+
 // --- Método especial para el login ---
 // No hereda de AuthenticatedMethod porque este es el punto de entrada.
 class UserLoginMethod : public xmlrpc_c::method2 {
@@ -52,20 +72,13 @@ public:
         std::string const password(paramList.getString(1));
         paramList.verifyEnd(2);
 
-        std::string clientIp = "unknown";
-        auto const * const abyssCallInfoP = dynamic_cast<const xmlrpc_c::callInfo_serverAbyss*>(callInfoP);
-        if (abyssCallInfoP) {
-            struct abyss_unix_chaninfo *channelInfo;
-            SessionGetChannelInfo(abyssCallInfoP->abyssSessionP, (void**)&channelInfo);
-            if (channelInfo)
-                clientIp = inet_ntoa(((struct sockaddr_in*)&channelInfo->peerAddr)->sin_addr);
-        }
+        std::string const clientIp = clientIpOf(callInfoP);
 
         try {
             std::string token = authService.login(username, password, clientIp);
             auto userOpt = authService.validateToken(token); // Obtenemos el usuario para devolver su rol
 
-            Logger::getInstance().log(LogLevel::INFO, "Successful login attempt", username, clientIp);
+            Logger::getInstance().logfAs(LogLevel::INFO, LogCategory::AUTH, username, clientIp, "Successful login attempt");
 
             std::map<std::string, xmlrpc_c::value> result_map;
             result_map["token"] = xmlrpc_c::value_string(token);
@@ -73,8 +86,8 @@ public:
             *retvalP = xmlrpc_c::value_struct(result_map);
 
         } catch (const InvalidCredentialsException& e) {
-            Logger::getInstance().log(LogLevel::WARNING, "Failed login attempt", username, clientIp);
-            throw xmlrpc_c::fault(e.what(), xmlrpc_c::fault::CODE_INTERNAL);
+            Logger::getInstance().logfAs(LogLevel::WARNING, LogCategory::AUTH, username, clientIp, "Failed login attempt");
+            throw; // MeteredMethod la cuenta y la convierte en fault.
         }
     }
 };
@@ -100,33 +113,116 @@ public:
         auto userOpt = authService.validateToken(token);
 
         // Obtenemos la IP del cliente de forma segura.
-        std::string clientIp = "unknown";
-        auto const * const abyssCallInfoP = dynamic_cast<const xmlrpc_c::callInfo_serverAbyss*>(callInfoP);
-        if (abyssCallInfoP) {
-            // Usamos SessionGetChannelInfo para obtener la IP.
-            struct abyss_unix_chaninfo *channelInfo;
-            SessionGetChannelInfo(abyssCallInfoP->abyssSessionP, (void**)&channelInfo);
-            if (channelInfo)
-                clientIp = inet_ntoa(((struct sockaddr_in*)&channelInfo->peerAddr)->sin_addr);
-        }
+        std::string const clientIp = clientIpOf(callInfoP);
 
-        Logger::getInstance().log(LogLevel::INFO, "Successful logout attempt", userOpt->getUsername(), clientIp);
+        Logger::getInstance().logfAs(LogLevel::INFO, LogCategory::AUTH, userOpt->getUsername(), clientIp, "Successful logout attempt");
         authService.logout(token);
         *retvalP = xmlrpc_c::value_boolean(true);
     }
 };
 
+// --- Id de robot opcional ---
+// Cualquier método autenticado acepta, como último parámetro extra, el id del brazo
+// al que va dirigido. Se reconoce porque sin él los parámetros coinciden con alguna
+// de las firmas declaradas del método y con él no.
+
+static bool matchesType(const xmlrpc_c::value& value, char code) {
+    switch (code) {
+        case 'i': return value.type() == xmlrpc_c::value::TYPE_INT;
+        case 'b': return value.type() == xmlrpc_c::value::TYPE_BOOLEAN;
+        case 'd': return value.type() == xmlrpc_c::value::TYPE_DOUBLE;
+        case 's': return value.type() == xmlrpc_c::value::TYPE_STRING;
+        case 'A': return value.type() == xmlrpc_c::value::TYPE_ARRAY;
+        case 'S': return value.type() == xmlrpc_c::value::TYPE_STRUCT;
+        case 'I': return value.type() == xmlrpc_c::value::TYPE_I8;
+        default: return false;
+    }
+}
+
+/// @brief True si los parámetros coinciden con alguna firma de la lista "ret:params,ret:params".
+static bool matchesSignature(xmlrpc_c::paramList const& paramList, const std::string& signature) {
+    std::size_t start = 0;
+    while (start <= signature.size()) {
+        std::size_t end = signature.find(',', start);
+        if (end == std::string::npos) {
+            end = signature.size();
+        }
+        std::size_t colon = signature.find(':', start);
+        if (colon != std::string::npos && colon < end) {
+            std::string const params = signature.substr(colon + 1, end - colon - 1);
+            bool matches = (params.size() == paramList.size());
+            for (std::size_t i = 0; matches && i < params.size(); ++i) {
+                matches = matchesType(paramList[static_cast<unsigned int>(i)], params[i]);
+            }
+            if (matches) {
+                return true;
+            }
+        }
+        start = end + 1;
+    }
+    return false;
+}
+
+/// @brief Ajusta los números a la firma del método: un entero donde se espera un real
+/// pasa a double y un real sin decimales donde se espera un entero pasa a int. Los
+/// clientes JSON (y los de lenguajes sin esa distinción) no pueden elegir el tipo.
+/// Se usa la firma con tantos parámetros como 'paramList', o uno menos si el último
+/// es el id de robot opcional; sin firma que coincida, los parámetros quedan igual.
+static xmlrpc_c::paramList adaptNumbers(xmlrpc_c::paramList const& paramList, const std::string& signature) {
+    std::string expected;
+    std::string withoutRobotId;
+    std::size_t start = 0;
+    while (start <= signature.size()) {
+        std::size_t end = signature.find(',', start);
+        if (end == std::string::npos) {
+            end = signature.size();
+        }
+        std::size_t colon = signature.find(':', start);
+        if (colon != std::string::npos && colon < end) {
+            std::string const params = signature.substr(colon + 1, end - colon - 1);
+            if (params.size() == paramList.size() && expected.empty()) {
+                expected = params;
+            } else if (params.size() + 1 == paramList.size() && withoutRobotId.empty()) {
+                withoutRobotId = params;
+            }
+        }
+        start = end + 1;
+    }
+    if (expected.empty()) {
+        expected = withoutRobotId;
+    }
+
+    xmlrpc_c::paramList adapted;
+    for (std::size_t i = 0; i < paramList.size(); ++i) {
+        xmlrpc_c::value const& param = paramList[static_cast<unsigned int>(i)];
+        char const code = i < expected.size() ? expected[i] : '?';
+        if (code == 'd' && param.type() == xmlrpc_c::value::TYPE_INT) {
+            adapted.add(xmlrpc_c::value_double(xmlrpc_c::value_int(param).cvalue()));
+        } else if (code == 'd' && param.type() == xmlrpc_c::value::TYPE_I8) {
+            adapted.add(xmlrpc_c::value_double(static_cast<double>(xmlrpc_c::value_i8(param).cvalue())));
+        } else if (code == 'i' && param.type() == xmlrpc_c::value::TYPE_DOUBLE) {
+            double const number = xmlrpc_c::value_double(param).cvalue();
+            bool const integral = number == static_cast<double>(static_cast<long long>(number)) &&
+                                  number >= INT32_MIN && number <= INT32_MAX;
+            adapted.add(integral ? xmlrpc_c::value(xmlrpc_c::value_int(static_cast<int>(number))) : param);
+        } else {
+            adapted.add(param);
+        }
+    }
+    return adapted;
+}
+
 // --- Clase Base para Métodos RPC con Autenticación ---
 // Centraliza la lógica de autenticación para no repetirla en cada método.
 class AuthenticatedMethod : public xmlrpc_c::method2 {
 protected:
     AuthenticationServiceNamespace::AuthenticationService& authService;
-    RobotNamespace::Robot& robot;
+    RobotNamespace::RobotRegistry& robots;
     TaskManager& taskManager;
     std::string _name; // Añadimos el miembro _name
 
-    AuthenticatedMethod(AuthenticationServiceNamespace::AuthenticationService& auth, RobotNamespace::Robot& r, TaskManager& tm)
-        : authService(auth), robot(r), taskManager(tm) {}
+    AuthenticatedMethod(AuthenticationServiceNamespace::AuthenticationService& auth, RobotNamespace::RobotRegistry& r, TaskManager& tm)
+        : authService(auth), robots(r), taskManager(tm) {}
 
     // El método execute ahora es un "Template Method". Realiza la autenticación
     // y luego delega la ejecución real al método 'executeAuthenticated'.
@@ -136,51 +232,76 @@ protected:
                  xmlrpc_c::value*       const retvalP) override {
         
         std::string const token(paramList.getString(0));
+
+        // Separamos el id de robot opcional para que el método hijo vea sus parámetros de siempre.
+        std::string robotId;
+        xmlrpc_c::paramList methodParams;
+        std::size_t const count = paramList.size();
+        bool const hasRobotId = count > 1 &&
+                                paramList[static_cast<unsigned int>(count - 1)].type() == xmlrpc_c::value::TYPE_STRING &&
+                                !matchesSignature(paramList, this->_signature);
+        if (hasRobotId) {
+            robotId = paramList.getString(static_cast<unsigned int>(count - 1));
+            for (std::size_t i = 0; i + 1 < count; ++i) {
+                methodParams.add(paramList[static_cast<unsigned int>(i)]);
+            }
+        }
         
         // Obtenemos la IP del cliente de forma segura.
-        std::string clientIp = "unknown";
-        auto const * const abyssCallInfoP = dynamic_cast<const xmlrpc_c::callInfo_serverAbyss*>(callInfoP);
-        
-        if (abyssCallInfoP) {
-            // Usamos SessionGetChannelInfo para obtener la IP.
-            struct abyss_unix_chaninfo *channelInfo;
-            SessionGetChannelInfo(abyssCallInfoP->abyssSessionP, (void**)&channelInfo);
-            if (channelInfo)
-                clientIp = inet_ntoa(((struct sockaddr_in*)&channelInfo->peerAddr)->sin_addr);
-        }
+        std::string const clientIp = clientIpOf(callInfoP);
         
         auto userOpt = authService.validateToken(token);
         try {
             if (!userOpt) {
                 throw InvalidCredentialsException("Token inválido o sesión expirada.");
             }
+            RobotNamespace::Robot& robot = robots.get(robotId);
+
             // Log de la llamada
-            std::string logMessage = "RPC call from user '" + userOpt->getUsername() + "': " + this->_name;
-            Logger::getInstance().log(LogLevel::INFO, "[RPC] " + logMessage, userOpt->getUsername(), clientIp);
+            const std::string& username = userOpt->getUsername();
+            Logger::getInstance().logfAs(LogLevel::INFO, LogCategory::RPC, username, clientIp,
+                                         "[RPC] RPC call from user '%s': %s%s%s%s", username.c_str(), this->_name.c_str(),
+                                         hasRobotId ? " [" : "", hasRobotId ? robotId.c_str() : "", hasRobotId ? "]" : "");
 
             // Llama a la lógica específica del método hijo.
             // El primer parámetro (token) ya fue consumido. Los métodos hijos leen a partir del índice 1.
-            executeAuthenticated(paramList, retvalP, *userOpt, clientIp);
+            executeAuthenticated(hasRobotId ? methodParams : paramList, retvalP, *userOpt, clientIp, robot);
 
         } catch (const std::exception& e) { // Captura cualquier excepción (de validación o de ejecución)
             std::string userForLog = userOpt ? userOpt->getUsername() : "unknown_token";
-            Logger::getInstance().log(LogLevel::WARNING, "Failed RPC call for user '" + userForLog + "': " + std::string(e.what()), userForLog, clientIp);
-            robot.recordOrder(userForLog, "ERROR", e.what());
-            throw xmlrpc_c::fault(e.what(), xmlrpc_c::fault::CODE_INTERNAL);
+            Logger::getInstance().logfAs(LogLevel::WARNING, LogCategory::RPC, userForLog, clientIp,
+                                         "Failed RPC call for user '%s': %s", userForLog.c_str(), e.what());
+            RobotNamespace::Robot& target = robots.contains(robotId) ? robots.get(robotId) : robots.defaultRobot();
+            target.recordOrder(userForLog, "ERROR", e.what());
+            throw; // MeteredMethod la cuenta por tipo y la convierte en fault.
         }
     }
 
+public:
+    // Ejecuta el método para un usuario que ya se validó (lo usa robot.batch para no
+    // volver a buscar el token en cada comando). 'paramList' incluye el token en el índice 0.
+    void executeForUser(xmlrpc_c::paramList const& paramList,
+                        xmlrpc_c::value* const retvalP,
+                        const UserNamespace::User& user,
+                        const std::string& clientIp,
+                        RobotNamespace::Robot& robot) {
+        executeAuthenticated(paramList, retvalP, user, clientIp, robot);
+    }
+
+protected:
     // Método virtual puro que las clases hijas deben implementar con su lógica específica.
+    // 'robot' es el brazo pedido por el cliente (o el brazo por defecto).
     virtual void executeAuthenticated(xmlrpc_c::paramList const& paramList, 
                                       xmlrpc_c::value* const retvalP, 
-                                      UserNamespace::User& user,
-                                      const std::string& clientIp) = 0;
+                                      const UserNamespace::User& user,
+                                      const std::string& clientIp,
+                                      RobotNamespace::Robot& robot) = 0;
 };
 
 // --- Método para listar usuarios conectados (solo para administradores) ---
 class UserListMethod : public AuthenticatedMethod {
 public:
-    UserListMethod(AuthenticationServiceNamespace::AuthenticationService& auth, RobotNamespace::Robot& r, TaskManager& tm)
+    UserListMethod(AuthenticationServiceNamespace::AuthenticationService& auth, RobotNamespace::RobotRegistry& r, TaskManager& tm)
         : AuthenticatedMethod(auth, r, tm) {
         this->_signature = "A:s"; // Devuelve un array de structs
         this->_name = "user.list";
@@ -189,8 +310,9 @@ public:
 
     void executeAuthenticated(xmlrpc_c::paramList const& paramList,
                               xmlrpc_c::value* const retvalP,
-                              UserNamespace::User& adminUser,
-                              const std::string& clientIp) override {
+                              const UserNamespace::User& adminUser,
+                              const std::string& clientIp,
+                              RobotNamespace::Robot& robot) override {
         if (adminUser.getRole() != UserRole::ADMIN) {
             throw PermissionDeniedException("Solo los administradores pueden listar usuarios.");
         }
@@ -211,11 +333,29 @@ public:
     }
 };
 
+/// @brief El estado del robot tal como lo devuelven robot.getStatus y robot.waitForChange.
+static xmlrpc_c::value_struct statusToValue(const RobotStatus& status) {
+    std::map<std::string, xmlrpc_c::value> statusMap;
+    statusMap["isConnected"] = xmlrpc_c::value_boolean(status.isConnected);
+    statusMap["areMotorsEnabled"] = xmlrpc_c::value_boolean(status.areMotorsEnabled);
+    statusMap["activityState"] = xmlrpc_c::value_string(status.activityState);
+    statusMap["coordinateMode"] = xmlrpc_c::value_string(status.isAbsolute ? "ABSOLUTO" : "RELATIVO");
+    statusMap["statusAgeMs"] = xmlrpc_c::value_int(static_cast<int>(status.statusAgeMs));
+    statusMap["version"] = xmlrpc_c::value_int(static_cast<int>(status.version));
+
+    std::map<std::string, xmlrpc_c::value> positionMap;
+    positionMap["x"] = xmlrpc_c::value_double(status.currentPosition.x);
+    positionMap["y"] = xmlrpc_c::value_double(status.currentPosition.y);
+    positionMap["z"] = xmlrpc_c::value_double(status.currentPosition.z);
+    statusMap["position"] = xmlrpc_c::value_struct(positionMap);
+    return xmlrpc_c::value_struct(statusMap);
+}
+
 // --- Implementación de los Métodos RPC Reales ---
 
 class RobotConnectMethod : public AuthenticatedMethod {
 public:
-    RobotConnectMethod(AuthenticationServiceNamespace::AuthenticationService& auth, RobotNamespace::Robot& r, TaskManager& tm)
+    RobotConnectMethod(AuthenticationServiceNamespace::AuthenticationService& auth, RobotNamespace::RobotRegistry& r, TaskManager& tm)
         : AuthenticatedMethod(auth, r, tm) {
         this->_signature = "b:s"; // boolean robot.connect(string token)
         this->_name = "robot.connect";
@@ -223,8 +363,9 @@ public:
     }
     void executeAuthenticated(xmlrpc_c::paramList const& paramList, 
                               xmlrpc_c::value* const retvalP, 
-                              UserNamespace::User& user,
-                              const std::string& clientIp) override {
+                              const UserNamespace::User& user,
+                              const std::string& clientIp,
+                              RobotNamespace::Robot& robot) override {
         robot.connect();
         paramList.verifyEnd(1);
         robot.recordOrder(user.getUsername(), "connect", "CONECTADO");
@@ -234,7 +375,7 @@ public:
 
 class RobotDisconnectMethod : public AuthenticatedMethod {
 public:
-    RobotDisconnectMethod(AuthenticationServiceNamespace::AuthenticationService& auth, RobotNamespace::Robot& r, TaskManager& tm)
+    RobotDisconnectMethod(AuthenticationServiceNamespace::AuthenticationService& auth, RobotNamespace::RobotRegistry& r, TaskManager& tm)
         : AuthenticatedMethod(auth, r, tm) {
         this->_signature = "b:s"; // boolean robot.disconnect(string token)
         this->_name = "robot.disconnect";
@@ -242,8 +383,9 @@ public:
     }
     void executeAuthenticated(xmlrpc_c::paramList const& paramList, 
                               xmlrpc_c::value* const retvalP, 
-                              UserNamespace::User& user,
-                              const std::string& clientIp) override {
+                              const UserNamespace::User& user,
+                              const std::string& clientIp,
+                              RobotNamespace::Robot& robot) override {
         robot.disconnect();
         paramList.verifyEnd(1);
         robot.recordOrder(user.getUsername(), "disconnect", "DESCONECTADO");
@@ -253,39 +395,105 @@ public:
 
 class RobotGetStatusMethod : public AuthenticatedMethod {
 public:
-    RobotGetStatusMethod(AuthenticationServiceNamespace::AuthenticationService& auth, RobotNamespace::Robot& r, TaskManager& tm)
+    RobotGetStatusMethod(AuthenticationServiceNamespace::AuthenticationService& auth, RobotNamespace::RobotRegistry& r, TaskManager& tm)
         : AuthenticatedMethod(auth, r, tm) {
-        this->_signature = "S:s"; // struct robot.getStatus(string token)
+        this->_signature = "S:s,S:si"; // struct robot.getStatus(string token [, int maxStalenessMs])
         this->_name = "robot.getStatus";
-        this->_help = "Gets the robot's current status after authenticating the user.";
+        this->_help = "Gets the robot's current status from the background sampler, without touching the serial port. "
+                      "With maxStalenessMs, a sample older than that is refreshed with M114 first (0 = always).";
     }
     void executeAuthenticated(xmlrpc_c::paramList const& paramList, 
                               xmlrpc_c::value* const retvalP, 
-                              UserNamespace::User& user,
-                              const std::string& clientIp) override {
-        RobotStatus status = robot.getStatus();
-        paramList.verifyEnd(1);
+                              const UserNamespace::User& user,
+                              const std::string& clientIp,
+                              RobotNamespace::Robot& robot) override {
+        int maxStalenessMs = RobotNamespace::Robot::ANY_STALENESS;
+        if (paramList.size() > 1) {
+            maxStalenessMs = paramList.getInt(1, 0);
+            paramList.verifyEnd(2);
+        } else {
+            paramList.verifyEnd(1);
+        }
+        *retvalP = statusToValue(robot.getStatus(maxStalenessMs));
+    }
+};
 
-        std::map<std::string, xmlrpc_c::value> statusMap;
-        statusMap["isConnected"] = xmlrpc_c::value_boolean(status.isConnected);
-        statusMap["areMotorsEnabled"] = xmlrpc_c::value_boolean(status.areMotorsEnabled);
-        statusMap["activityState"] = xmlrpc_c::value_string(status.activityState);
-        statusMap["coordinateMode"] = xmlrpc_c::value_string(status.isAbsolute ? "ABSOLUTO" : "RELATIVO");
-        
-        std::map<std::string, xmlrpc_c::value> positionMap;
-        positionMap["x"] = xmlrpc_c::value_double(status.currentPosition.x);
-        positionMap["y"] = xmlrpc_c::value_double(status.currentPosition.y);
-        positionMap["z"] = xmlrpc_c::value_double(status.currentPosition.z);
-        statusMap["position"] = xmlrpc_c::value_struct(positionMap);
+// --- Método para esperar un cambio de estado (long polling) ---
+class RobotWaitForChangeMethod : public AuthenticatedMethod {
+public:
+    RobotWaitForChangeMethod(AuthenticationServiceNamespace::AuthenticationService& auth, RobotNamespace::RobotRegistry& r, TaskManager& tm)
+        : AuthenticatedMethod(auth, r, tm) {
+        this->_signature = "S:sii"; // struct robot.waitForChange(string token, int lastVersion, int timeoutMs)
+        this->_name = "robot.waitForChange";
+        this->_help = "Returns the robot's status as soon as its version differs from lastVersion, or when timeoutMs "
+                      "(at most 30000) expires. Pass the 'version' of the previous reply to be notified of the next change.";
+    }
+    void executeAuthenticated(xmlrpc_c::paramList const& paramList,
+                              xmlrpc_c::value* const retvalP,
+                              const UserNamespace::User& user,
+                              const std::string& clientIp,
+                              RobotNamespace::Robot& robot) override {
+        int const lastVersion(paramList.getInt(1, 0));
+        int const timeoutMs(paramList.getInt(2, 0));
+        paramList.verifyEnd(3);
 
+        RobotStatus status = robot.waitForChange(static_cast<unsigned long long>(lastVersion), timeoutMs);
+        std::map<std::string, xmlrpc_c::value> statusMap = statusToValue(status).cvalue();
+        statusMap["changed"] = xmlrpc_c::value_boolean(static_cast<int>(status.version) != lastVersion);
         *retvalP = xmlrpc_c::value_struct(statusMap);
     }
 };
 
+// --- Método para listar los brazos que maneja el servidor ---
+class RobotListRobotsMethod : public AuthenticatedMethod {
+public:
+    RobotListRobotsMethod(AuthenticationServiceNamespace::AuthenticationService& auth, RobotNamespace::RobotRegistry& r, TaskManager& tm)
+        : AuthenticatedMethod(auth, r, tm) {
+        this->_signature = "A:s"; // array robot.listRobots(string token)
+        this->_name = "robot.listRobots";
+        this->_help = "Lists every robot arm (id, serial port and last known status). "
+                      "Any robot method accepts a robot id as an extra last parameter; without it the default arm is used.";
+    }
+
+    void executeAuthenticated(xmlrpc_c::paramList const& paramList,
+                              xmlrpc_c::value* const retvalP,
+                              const UserNamespace::User& user,
+                              const std::string& clientIp,
+                              RobotNamespace::Robot& robot) override {
+        paramList.verifyEnd(1);
+
+        std::vector<xmlrpc_c::value> robotList;
+        for (const auto& id : robots.ids()) {
+            RobotNamespace::Robot& arm = robots.get(id);
+            // Último estado conocido: no se consulta al firmware para no frenar a los demás brazos.
+            RobotStatus status = arm.getRobotStatus();
+
+            std::map<std::string, xmlrpc_c::value> robotMap;
+            robotMap["id"] = xmlrpc_c::value_string(id);
+            robotMap["port"] = xmlrpc_c::value_string(arm.getSerialPort());
+            robotMap["isDefault"] = xmlrpc_c::value_boolean(id == robots.getDefaultId());
+            robotMap["isConnected"] = xmlrpc_c::value_boolean(status.isConnected);
+            robotMap["baudRate"] = xmlrpc_c::value_int(arm.getLinkBaudRate());
+            robotMap["areMotorsEnabled"] = xmlrpc_c::value_boolean(status.areMotorsEnabled);
+            robotMap["activityState"] = xmlrpc_c::value_string(status.activityState);
+
+            std::map<std::string, xmlrpc_c::value> positionMap;
+            positionMap["x"] = xmlrpc_c::value_double(status.currentPosition.x);
+            positionMap["y"] = xmlrpc_c::value_double(status.currentPosition.y);
+            positionMap["z"] = xmlrpc_c::value_double(status.currentPosition.z);
+            robotMap["position"] = xmlrpc_c::value_struct(positionMap);
+
+            robotList.push_back(xmlrpc_c::value_struct(robotMap));
+        }
+
+        *retvalP = xmlrpc_c::value_array(robotList);
+    }
+};
+
 // --- Método para mover el robot ---
 class RobotMoveMethod : public AuthenticatedMethod {
 public:
-    RobotMoveMethod(AuthenticationServiceNamespace::AuthenticationService& auth, RobotNamespace::Robot& r, TaskManager& tm)
+    RobotMoveMethod(AuthenticationServiceNamespace::AuthenticationService& auth, RobotNamespace::RobotRegistry& r, TaskManager& tm)
         : AuthenticatedMethod(auth, r, tm) {
         this->_signature = "b:sdddd"; // boolean robot.move(string token, double x, double y, double z, double speed)
         this->_name = "robot.move";
@@ -295,8 +503,9 @@ public:
     // Implementamos el método virtual puro, que ahora recibe la IP.
     void executeAuthenticated(xmlrpc_c::paramList const& paramList, 
                               xmlrpc_c::value* const retvalP, 
-                              UserNamespace::User& user,
-                              const std::string& clientIp) override {
+                              const UserNamespace::User& user,
+                              const std::string& clientIp,
+                              RobotNamespace::Robot& robot) override {
         double const x(paramList.getDouble(1));
         double const y(paramList.getDouble(2));
         double const z(paramList.getDouble(3));
@@ -318,7 +527,7 @@ public:
 // --- Método para mover el robot con velocidad por defecto ---
 class RobotMoveDefaultSpeedMethod : public AuthenticatedMethod {
 public:
-    RobotMoveDefaultSpeedMethod(AuthenticationServiceNamespace::AuthenticationService& auth, RobotNamespace::Robot& r, TaskManager& tm)
+    RobotMoveDefaultSpeedMethod(AuthenticationServiceNamespace::AuthenticationService& auth, RobotNamespace::RobotRegistry& r, TaskManager& tm)
         : AuthenticatedMethod(auth, r, tm) {
         this->_signature = "b:sddd"; // boolean robot.moveDefaultSpeed(string token, double x, double y, double z)
         this->_name = "robot.moveDefaultSpeed";
@@ -327,8 +536,9 @@ public:
 
     void executeAuthenticated(xmlrpc_c::paramList const& paramList, 
                               xmlrpc_c::value* const retvalP, 
-                              UserNamespace::User& user,
-                              const std::string& clientIp) override {
+                              const UserNamespace::User& user,
+                              const std::string& clientIp,
+                              RobotNamespace::Robot& robot) override {
         double const x(paramList.getDouble(1));
         double const y(paramList.getDouble(2));
         double const z(paramList.getDouble(3));
@@ -345,10 +555,96 @@ public:
 };
 
 
+// --- Método para mover el robot sin esperar a que llegue ---
+class RobotMoveAsyncMethod : public AuthenticatedMethod {
+public:
+    RobotMoveAsyncMethod(AuthenticationServiceNamespace::AuthenticationService& auth, RobotNamespace::RobotRegistry& r, TaskManager& tm)
+        : AuthenticatedMethod(auth, r, tm) {
+        this->_signature = "S:sddd,S:sdddd"; // struct robot.moveAsync(string token, double x, double y, double z [, double speed])
+        this->_name = "robot.moveAsync";
+        this->_help = "Starts a move and returns its job id and predicted duration without waiting for it to finish; "
+                      "use robot.waitMotion to wait for it.";
+    }
+
+    void executeAuthenticated(xmlrpc_c::paramList const& paramList,
+                              xmlrpc_c::value* const retvalP,
+                              const UserNamespace::User& user,
+                              const std::string& clientIp,
+                              RobotNamespace::Robot& robot) override {
+        double const x(paramList.getDouble(1));
+        double const y(paramList.getDouble(2));
+        double const z(paramList.getDouble(3));
+        std::uint64_t jobId;
+        std::string details = "Moved to (" + double_a_string_con_precision(x, 2) + ", " +
+                              double_a_string_con_precision(y, 2) + ", " + double_a_string_con_precision(z, 2) + ")";
+        if (paramList.size() > 4) {
+            double const speed(paramList.getDouble(4));
+            paramList.verifyEnd(5);
+            jobId = robot.moveTo(Position(x, y, z), speed);
+            details += " at speed " + double_a_string_con_precision(speed, 2);
+        } else {
+            paramList.verifyEnd(4);
+            jobId = robot.moveTo(Position(x, y, z));
+            details += " at default speed";
+        }
+        if (jobId == 0) {
+            throw RobotException(robot.getExecuteState());
+        }
+        robot.recordOrder(user.getUsername(), "move", details + " (job " + std::to_string(jobId) + ")");
+
+        MotionJob job = robot.waitMotion(jobId, 0);
+        std::map<std::string, xmlrpc_c::value> jobMap;
+        jobMap["jobId"] = xmlrpc_c::value_int(static_cast<int>(job.id));
+        jobMap["predictedMs"] = xmlrpc_c::value_int(static_cast<int>(job.predictedMs));
+        *retvalP = xmlrpc_c::value_struct(jobMap);
+    }
+};
+
+// --- Método para esperar a que termine un movimiento ---
+class RobotWaitMotionMethod : public AuthenticatedMethod {
+public:
+    RobotWaitMotionMethod(AuthenticationServiceNamespace::AuthenticationService& auth, RobotNamespace::RobotRegistry& r, TaskManager& tm)
+        : AuthenticatedMethod(auth, r, tm) {
+        this->_signature = "S:sii"; // struct robot.waitMotion(string token, int jobId, int timeoutMs)
+        this->_name = "robot.waitMotion";
+        this->_help = "Waits up to timeoutMs (at most 30000) for a move to finish (jobId 0 = the last move) and returns its state: "
+                      "EN_CURSO, COMPLETADO or FALLIDO (did not reach the target).";
+    }
+
+    void executeAuthenticated(xmlrpc_c::paramList const& paramList,
+                              xmlrpc_c::value* const retvalP,
+                              const UserNamespace::User& user,
+                              const std::string& clientIp,
+                              RobotNamespace::Robot& robot) override {
+        int const jobId(paramList.getInt(1, 0));
+        int const timeoutMs(paramList.getInt(2, 0));
+        paramList.verifyEnd(3);
+
+        MotionJob job = robot.waitMotion(static_cast<std::uint64_t>(jobId), timeoutMs);
+
+        std::map<std::string, xmlrpc_c::value> jobMap;
+        jobMap["jobId"] = xmlrpc_c::value_int(static_cast<int>(job.id));
+        jobMap["command"] = xmlrpc_c::value_string(job.command);
+        jobMap["state"] = xmlrpc_c::value_string(job.state);
+        jobMap["done"] = xmlrpc_c::value_boolean(job.state != "EN_CURSO");
+        jobMap["detail"] = xmlrpc_c::value_string(job.detail);
+        jobMap["predictedMs"] = xmlrpc_c::value_int(static_cast<int>(job.predictedMs));
+        jobMap["elapsedMs"] = xmlrpc_c::value_int(static_cast<int>(job.elapsedMs));
+        if (job.hasTarget) {
+            std::map<std::string, xmlrpc_c::value> targetMap;
+            targetMap["x"] = xmlrpc_c::value_double(job.target.x);
+            targetMap["y"] = xmlrpc_c::value_double(job.target.y);
+            targetMap["z"] = xmlrpc_c::value_double(job.target.z);
+            jobMap["target"] = xmlrpc_c::value_struct(targetMap);
+        }
+        *retvalP = xmlrpc_c::value_struct(jobMap);
+    }
+};
+
 // --- Método para activar los motores ---
 class RobotEnableMotorsMethod : public AuthenticatedMethod {
 public:
-    RobotEnableMotorsMethod(AuthenticationServiceNamespace::AuthenticationService& auth, RobotNamespace::Robot& r, TaskManager& tm)
+    RobotEnableMotorsMethod(AuthenticationServiceNamespace::AuthenticationService& auth, RobotNamespace::RobotRegistry& r, TaskManager& tm)
         : AuthenticatedMethod(auth, r, tm) {
         this->_signature = "b:s"; // boolean robot.enableMotors(string token)
         this->_name = "robot.enableMotors";
@@ -356,8 +652,9 @@ public:
     }
     void executeAuthenticated(xmlrpc_c::paramList const& paramList, 
                               xmlrpc_c::value* const retvalP, 
-                              UserNamespace::User& user,
-                              const std::string& clientIp) override {
+                              const UserNamespace::User& user,
+                              const std::string& clientIp,
+                              RobotNamespace::Robot& robot) override {
         robot.enableMotors();
         paramList.verifyEnd(1);
         robot.recordOrder(user.getUsername(), "enableMotors", "MOTORES ACTIVADOS");
@@ -368,7 +665,7 @@ public:
 // --- Método para desactivar los motores ---
 class RobotDisableMotorsMethod : public AuthenticatedMethod {
 public:
-    RobotDisableMotorsMethod(AuthenticationServiceNamespace::AuthenticationService& auth, RobotNamespace::Robot& r, TaskManager& tm)
+    RobotDisableMotorsMethod(AuthenticationServiceNamespace::AuthenticationService& auth, RobotNamespace::RobotRegistry& r, TaskManager& tm)
         : AuthenticatedMethod(auth, r, tm) {
         this->_signature = "b:s"; // boolean robot.disableMotors(string token)
         this->_name = "robot.disableMotors";
@@ -376,8 +673,9 @@ public:
     }
     void executeAuthenticated(xmlrpc_c::paramList const& paramList, 
                               xmlrpc_c::value* const retvalP, 
-                              UserNamespace::User& user,
-                              const std::string& clientIp) override {
+                              const UserNamespace::User& user,
+                              const std::string& clientIp,
+                              RobotNamespace::Robot& robot) override {
         robot.disableMotors();
         paramList.verifyEnd(1);
         robot.recordOrder(user.getUsername(), "disableMotors", "MOTORES DESACTIVADOS");
@@ -388,7 +686,7 @@ public:
 // --- Método para activar/desactivar el efector final ---
 class RobotSetEffectorMethod : public AuthenticatedMethod {
 public:
-    RobotSetEffectorMethod(AuthenticationServiceNamespace::AuthenticationService& auth, RobotNamespace::Robot& r, TaskManager& tm)
+    RobotSetEffectorMethod(AuthenticationServiceNamespace::AuthenticationService& auth, RobotNamespace::RobotRegistry& r, TaskManager& tm)
         : AuthenticatedMethod(auth, r, tm) {
         this->_signature = "b:sb"; // boolean robot.setEffector(string token, boolean active)
         this->_name = "robot.setEffector";
@@ -398,8 +696,9 @@ public:
     // Implementamos el método virtual puro.
     void executeAuthenticated(xmlrpc_c::paramList const& paramList, 
                               xmlrpc_c::value* const retvalP, 
-                              UserNamespace::User& user,
-                              const std::string& clientIp) override {
+                              const UserNamespace::User& user,
+                              const std::string& clientIp,
+                              RobotNamespace::Robot& robot) override {
         // Leemos el parámetro booleano específico de este método.
         bool const active(paramList.getBoolean(1));
         paramList.verifyEnd(2);
@@ -415,7 +714,7 @@ public:
 // --- Método para cambiar el modo de coordenadas (Absoluto/Relativo) ---
 class SetCoordinateModeMethod : public AuthenticatedMethod {
 public:
-    SetCoordinateModeMethod(AuthenticationServiceNamespace::AuthenticationService& auth, RobotNamespace::Robot& r, TaskManager& tm)
+    SetCoordinateModeMethod(AuthenticationServiceNamespace::AuthenticationService& auth, RobotNamespace::RobotRegistry& r, TaskManager& tm)
         : AuthenticatedMethod(auth, r, tm) {
         this->_signature = "b:sb"; // boolean robot.setCoordinateMode(string token, boolean isAbsolute)
         this->_name = "robot.setCoordinateMode";
@@ -424,8 +723,9 @@ public:
 
     void executeAuthenticated(xmlrpc_c::paramList const& paramList,
                               xmlrpc_c::value* const retvalP,
-                              UserNamespace::User& user,
-                              const std::string& clientIp) override {
+                              const UserNamespace::User& user,
+                              const std::string& clientIp,
+                              RobotNamespace::Robot& robot) override {
         // Leemos el parámetro booleano específico de este método.
         bool const isAbsolute(paramList.getBoolean(1));
         paramList.verifyEnd(2);
@@ -441,7 +741,7 @@ public:
 // --- Método para añadir usuarios (solo para administradores) ---
 class RobotUserAddMethod : public AuthenticatedMethod {
 public:
-    RobotUserAddMethod(AuthenticationServiceNamespace::AuthenticationService& auth, RobotNamespace::Robot& r, TaskManager& tm)
+    RobotUserAddMethod(AuthenticationServiceNamespace::AuthenticationService& auth, RobotNamespace::RobotRegistry& r, TaskManager& tm)
         : AuthenticatedMethod(auth, r, tm) {
         // Firma: bool user.add(string token, string newUser, string newPass, int newRole)
         this->_signature = "b:sssi";
@@ -452,8 +752,9 @@ public:
     // Implementamos el método virtual puro.
     void executeAuthenticated(xmlrpc_c::paramList const& paramList, 
                               xmlrpc_c::value* const retvalP, 
-                              UserNamespace::User& adminUser,
-                              const std::string& clientIp) override { // Lanza xmlrpc_c::fault
+                              const UserNamespace::User& adminUser,
+                              const std::string& clientIp,
+                              RobotNamespace::Robot& robot) override { // Lanza xmlrpc_c::fault
         // 1. Verificar que el usuario autenticado es un administrador.
         if (adminUser.getRole() != UserRole::ADMIN) {
             throw PermissionDeniedException("Solo los administradores pueden añadir usuarios.");
@@ -479,7 +780,7 @@ public:
 // --- Método para obtener ayuda contextual ---
 class HelpMethod : public AuthenticatedMethod {
 public:
-    HelpMethod(AuthenticationServiceNamespace::AuthenticationService& auth, RobotNamespace::Robot& r, TaskManager& tm)
+    HelpMethod(AuthenticationServiceNamespace::AuthenticationService& auth, RobotNamespace::RobotRegistry& r, TaskManager& tm)
         : AuthenticatedMethod(auth, r, tm) {
         this->_signature = "S:s"; // Devuelve un struct: {command: help_string, ...}
         this->_name = "robot.help";
@@ -488,8 +789,9 @@ public:
 
     void executeAuthenticated(xmlrpc_c::paramList const& paramList,
                               xmlrpc_c::value* const retvalP,
-                              UserNamespace::User& user,
-                              const std::string& clientIp) override {
+                              const UserNamespace::User& user,
+                              const std::string& clientIp,
+                              RobotNamespace::Robot& robot) override {
         
         paramList.verifyEnd(1);
         std::map<std::string, xmlrpc_c::value> helpMap;
@@ -506,6 +808,7 @@ public:
         helpMap["aprender_inicio <id> <nombre>"] = xmlrpc_c::value_string("Inicia el modo de aprendizaje de trayectoria.");
         helpMap["aprender_fin"] = xmlrpc_c::value_string("Finaliza el aprendizaje y guarda la tarea.");
         helpMap["reporte"] = xmlrpc_c::value_string("Muestra un reporte de actividad de la sesión actual.");
+        helpMap["robots"] = xmlrpc_c::value_string("Lista los brazos del servidor con su puerto y estado.");
         helpMap["salir"] = xmlrpc_c::value_string("Cierra la consola del cliente.");
         
         // --- Comandos solo para Administradores ---
@@ -515,6 +818,7 @@ public:
             helpMap["user.add <user> <pass> <role>"] = xmlrpc_c::value_string("Añade un nuevo usuario (role: 0=ADMIN, 1=OPERATOR).");
             helpMap["report_admin [filtro] [val]"] = xmlrpc_c::value_string("Muestra reporte admin con filtros [usuario ó resultado] [valor].");
             helpMap["report_log [filtro] [val]"] = xmlrpc_c::value_string("Muestra reporte de log con filtros [usuario ó nivel] [valor].");
+            helpMap["link_stats [reset]"] = xmlrpc_c::value_string("Muestra latencias y contadores del enlace serie; 'reset' los reinicia.");
         }
 
         *retvalP = xmlrpc_c::value_struct(helpMap);
@@ -525,7 +829,7 @@ public:
 // --- Método para obtener el reporte del operador ---
 class GetReportMethod : public AuthenticatedMethod {
 public:
-    GetReportMethod(AuthenticationServiceNamespace::AuthenticationService& auth, RobotNamespace::Robot& r, TaskManager& tm)
+    GetReportMethod(AuthenticationServiceNamespace::AuthenticationService& auth, RobotNamespace::RobotRegistry& r, TaskManager& tm)
         : AuthenticatedMethod(auth, r, tm) {
         this->_signature = "S:s"; // Devuelve un struct
         this->_name = "robot.getReport";
@@ -534,8 +838,9 @@ public:
 
     void executeAuthenticated(xmlrpc_c::paramList const& paramList,
                               xmlrpc_c::value* const retvalP,
-                              UserNamespace::User& user,
-                              const std::string& clientIp) override {
+                              const UserNamespace::User& user,
+                              const std::string& clientIp,
+                              RobotNamespace::Robot& robot) override {
         ReportGenerator reportGenerator; // Create an instance of ReportGenerator
         paramList.verifyEnd(1);
         *retvalP = reportGenerator.generateOperatorReport(robot, user);
@@ -546,7 +851,7 @@ public:
 // --- Método para obtener el reporte del administrador ---
 class GetAdminReportMethod : public AuthenticatedMethod {
 public:
-    GetAdminReportMethod(AuthenticationServiceNamespace::AuthenticationService& auth, RobotNamespace::Robot& r, TaskManager& tm)
+    GetAdminReportMethod(AuthenticationServiceNamespace::AuthenticationService& auth, RobotNamespace::RobotRegistry& r, TaskManager& tm)
         : AuthenticatedMethod(auth, r, tm) {
         this->_signature = "S:sss"; // struct getAdminReport(string token, string filterKey, string filterValue)
         this->_name = "robot.getAdminReport";
@@ -555,8 +860,9 @@ public:
 
     void executeAuthenticated(xmlrpc_c::paramList const& paramList,
                               xmlrpc_c::value* const retvalP,
-                              UserNamespace::User& user,
-                              const std::string& clientIp) override {
+                              const UserNamespace::User& user,
+                              const std::string& clientIp,
+                              RobotNamespace::Robot& robot) override {
         if (user.getRole() != UserRole::ADMIN) {
             throw xmlrpc_c::fault("Permission denied: Only administrators can access this report.", xmlrpc_c::fault::CODE_INTERNAL);
         }
@@ -579,17 +885,18 @@ public:
 // --- Método para obtener el reporte del log del servidor ---
 class GetLogReportMethod : public AuthenticatedMethod {
 public:
-    GetLogReportMethod(AuthenticationServiceNamespace::AuthenticationService& auth, RobotNamespace::Robot& r, TaskManager& tm)
+    GetLogReportMethod(AuthenticationServiceNamespace::AuthenticationService& auth, RobotNamespace::RobotRegistry& r, TaskManager& tm)
         : AuthenticatedMethod(auth, r, tm) {
         this->_signature = "S:sss"; // struct getLogReport(string token, string filterKey, string filterValue)
         this->_name = "robot.getLogReport";
-        this->_help = "Generates a server log report, with optional filtering by 'username' or 'level'.";
+        this->_help = "Generates a server log report, with optional filtering by 'username', 'level', 'from' or 'to' (local time, YYYY-MM-DD HH:MM:SS).";
     }
 
     void executeAuthenticated(xmlrpc_c::paramList const& paramList,
                               xmlrpc_c::value* const retvalP,
-                              UserNamespace::User& user,
-                              const std::string& clientIp) override {
+                              const UserNamespace::User& user,
+                              const std::string& clientIp,
+                              RobotNamespace::Robot& robot) override {
         if (user.getRole() != UserRole::ADMIN) {
             throw xmlrpc_c::fault("Permission denied: Only administrators can access this report.", xmlrpc_c::fault::CODE_INTERNAL);
         }
@@ -609,10 +916,68 @@ public:
 };
 
 
+// --- Método para obtener las estadísticas del enlace serie (solo para administradores) ---
+class RobotGetLinkStatsMethod : public AuthenticatedMethod {
+public:
+    RobotGetLinkStatsMethod(AuthenticationServiceNamespace::AuthenticationService& auth, RobotNamespace::RobotRegistry& r, TaskManager& tm)
+        : AuthenticatedMethod(auth, r, tm) {
+        this->_signature = "S:s,S:sb"; // struct getLinkStats(string token [, bool reset])
+        this->_name = "robot.getLinkStats";
+        this->_help = "Returns serial link statistics: per command family send->OK latency percentiles (ms), "
+                      "bytes sent/received, timeouts and errors. Pass true to reset the counters after reading.";
+    }
+
+    void executeAuthenticated(xmlrpc_c::paramList const& paramList,
+                              xmlrpc_c::value* const retvalP,
+                              const UserNamespace::User& user,
+                              const std::string& clientIp,
+                              RobotNamespace::Robot& robot) override {
+        if (user.getRole() != UserRole::ADMIN) {
+            throw PermissionDeniedException("Solo los administradores pueden consultar las estadísticas del enlace.");
+        }
+        bool reset = false;
+        if (paramList.size() > 1) {
+            reset = paramList.getBoolean(1);
+        }
+        paramList.verifyEnd(paramList.size() > 1 ? 2 : 1);
+
+        ComunicatorPort::LinkStats& stats = robot.getLinkStats();
+        ComunicatorPort::LinkStatsSnapshot snapshot = stats.snapshot();
+        if (reset) {
+            stats.reset();
+            robot.recordOrder(user.getUsername(), "robot.getLinkStats", "Estadísticas del enlace reiniciadas");
+        }
+
+        std::vector<xmlrpc_c::value> families;
+        for (const auto& family : snapshot.families) {
+            std::map<std::string, xmlrpc_c::value> entry;
+            entry["family"] = xmlrpc_c::value_string(family.family);
+            entry["count"] = xmlrpc_c::value_i8(static_cast<xmlrpc_int64>(family.count));
+            entry["errors"] = xmlrpc_c::value_i8(static_cast<xmlrpc_int64>(family.errors));
+            entry["timeouts"] = xmlrpc_c::value_i8(static_cast<xmlrpc_int64>(family.timeouts));
+            entry["p50Ms"] = xmlrpc_c::value_double(family.p50Ms);
+            entry["p90Ms"] = xmlrpc_c::value_double(family.p90Ms);
+            entry["p99Ms"] = xmlrpc_c::value_double(family.p99Ms);
+            entry["maxMs"] = xmlrpc_c::value_double(family.maxMs);
+            families.push_back(xmlrpc_c::value_struct(entry));
+        }
+
+        std::map<std::string, xmlrpc_c::value> result;
+        result["commands"] = xmlrpc_c::value_i8(static_cast<xmlrpc_int64>(snapshot.commands));
+        result["bytesSent"] = xmlrpc_c::value_i8(static_cast<xmlrpc_int64>(snapshot.bytesSent));
+        result["bytesReceived"] = xmlrpc_c::value_i8(static_cast<xmlrpc_int64>(snapshot.bytesReceived));
+        result["timeouts"] = xmlrpc_c::value_i8(static_cast<xmlrpc_int64>(snapshot.timeouts));
+        result["errors"] = xmlrpc_c::value_i8(static_cast<xmlrpc_int64>(snapshot.errors));
+        result["families"] = xmlrpc_c::value_array(families);
+        *retvalP = xmlrpc_c::value_struct(result);
+    }
+};
+
+
 // --- Método para listar las tareas disponibles ---
 class ListTasksMethod : public AuthenticatedMethod {
 public:
-    ListTasksMethod(AuthenticationServiceNamespace::AuthenticationService& auth, RobotNamespace::Robot& r, TaskManager& tm)
+    ListTasksMethod(AuthenticationServiceNamespace::AuthenticationService& auth, RobotNamespace::RobotRegistry& r, TaskManager& tm)
         : AuthenticatedMethod(auth, r, tm) {
         this->_signature = "A:s"; // Devuelve un array
         this->_name = "robot.listTasks";
@@ -621,8 +986,9 @@ public:
 
     void executeAuthenticated(xmlrpc_c::paramList const& paramList,
                               xmlrpc_c::value* const retvalP,
-                              UserNamespace::User& user,
-                              const std::string& clientIp) override {
+                              const UserNamespace::User& user,
+                              const std::string& clientIp,
+                              RobotNamespace::Robot& robot) override {
         paramList.verifyEnd(1);
         
         std::vector<xmlrpc_c::value> tasksVector;
@@ -640,6 +1006,7 @@ public:
                 gcodeVector.push_back(xmlrpc_c::value_string(gcodeCommand));
             }
             taskMap["gcode"] = xmlrpc_c::value_array(gcodeVector);
+            taskMap["optimizedLength"] = xmlrpc_c::value_int(static_cast<int>(task.optimized.lines.size()));
             
             tasksVector.push_back(xmlrpc_c::value_struct(taskMap));
         }
@@ -651,19 +1018,27 @@ public:
 // --- Método para ejecutar una tarea por ID ---
 class ExecuteTaskMethod : public AuthenticatedMethod {
 public:
-    ExecuteTaskMethod(AuthenticationServiceNamespace::AuthenticationService& auth, RobotNamespace::Robot& r, TaskManager& tm)
+    ExecuteTaskMethod(AuthenticationServiceNamespace::AuthenticationService& auth, RobotNamespace::RobotRegistry& r, TaskManager& tm)
         : AuthenticatedMethod(auth, r, tm) {
-        this->_signature = "b:ss"; // boolean executeTask(token, taskId)
+        this->_signature = "b:ss,b:ssi"; // boolean executeTask(token, taskId [, window])
         this->_name = "robot.executeTask";
-        this->_help = "Executes a pre-defined task by its ID.";
+        this->_help = "Executes a pre-defined task by its ID, streaming up to 'window' commands to the firmware queue.";
     }
 
     void executeAuthenticated(xmlrpc_c::paramList const& paramList,
                               xmlrpc_c::value* const retvalP,
-                              UserNamespace::User& user,
-                              const std::string& clientIp) override {
+                              const UserNamespace::User& user,
+                              const std::string& clientIp,
+                              RobotNamespace::Robot& robot) override {
         std::string const taskId(paramList.getString(1));
-        paramList.verifyEnd(2);
+        std::size_t window = RobotNamespace::Robot::FIRMWARE_QUEUE_DEPTH;
+        if (paramList.size() > 2) {
+            int const requestedWindow(paramList.getInt(2, 1, static_cast<int>(RobotNamespace::Robot::FIRMWARE_QUEUE_DEPTH)));
+            window = static_cast<std::size_t>(requestedWindow);
+            paramList.verifyEnd(3);
+        } else {
+            paramList.verifyEnd(2);
+        }
 
         auto taskOpt = taskManager.getTaskById(taskId);
         if (!taskOpt) {
@@ -673,11 +1048,19 @@ public:
         // Registramos el inicio de la tarea
         robot.recordOrder(user.getUsername(), "execute_task", "Executing task: " + taskId);
 
-        // Ejecutamos cada comando G-Code de la tarea
-        for (const auto& gcode : taskOpt->gcode) {
-            robot.sendRawGCode(gcode);
-            // Podríamos añadir un pequeño delay si es necesario entre comandos
-            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        // Enviamos la tarea ya optimizada manteniendo la cola del firmware llena; los
+        // errores se informan con las líneas de la tarea original que los produjeron.
+        const GCodeNamespace::OptimizedProgram& program = taskOpt->optimized;
+        std::vector<GCodeLineResult> results = robot.streamGCode(program.commands(), window);
+
+        std::string errors;
+        for (const auto& result : results) {
+            if (!result.success) {
+                errors += " [" + program.describeSource(result.lineIndex) + ": '" + result.command + "' -> " + result.response + "]";
+            }
+        }
+        if (!errors.empty()) {
+            throw RobotException("[Robot] La tarea '" + taskId + "' terminó con errores:" + errors);
         }
 
         *retvalP = xmlrpc_c::value_boolean(true);
@@ -687,7 +1070,7 @@ public:
 // --- Método para añadir una nueva tarea ---
 class AddTaskMethod : public AuthenticatedMethod {
 public:
-    AddTaskMethod(AuthenticationServiceNamespace::AuthenticationService& auth, RobotNamespace::Robot& r, TaskManager& tm)
+    AddTaskMethod(AuthenticationServiceNamespace::AuthenticationService& auth, RobotNamespace::RobotRegistry& r, TaskManager& tm)
         : AuthenticatedMethod(auth, r, tm) {
         this->_signature = "b:sssA"; // bool addTask(token, id, name, gcode_array)
         this->_name = "robot.addTask";
@@ -696,8 +1079,9 @@ public:
 
     void executeAuthenticated(xmlrpc_c::paramList const& paramList,
                               xmlrpc_c::value* const retvalP,
-                              UserNamespace::User& user,
-                              const std::string& clientIp) override {
+                              const UserNamespace::User& user,
+                              const std::string& clientIp,
+                              RobotNamespace::Robot& robot) override {
         std::string const taskId(paramList.getString(1));
         std::string const taskName(paramList.getString(2));
         xmlrpc_c::value_array const gcodeArray(paramList.getArray(3));
@@ -724,29 +1108,253 @@ public:
     }
 };
 
+// --- Medición de los métodos ---
+// Envuelve cada método registrado: cuenta la llamada, mide cuánto tarda y clasifica el error.
+// Es también el único lugar donde una excepción de C++ se convierte en fault para el cliente,
+// para que el tipo de excepción llegue hasta las métricas.
+class MeteredMethod : public xmlrpc_c::method2 {
+public:
+    MeteredMethod(xmlrpc_c::methodPtr const& methodP, RpcServiceHandlerNamespace::RpcMethodStats& stats)
+        : methodP(methodP), method(dynamic_cast<xmlrpc_c::method2*>(methodP.operator->())), stats(stats) {
+        this->_signature = method->signature();
+        this->_help = method->help();
+    }
+
+    void execute(xmlrpc_c::paramList const& paramList,
+                 const xmlrpc_c::callInfo * const callInfoP,
+                 xmlrpc_c::value*       const retvalP) override {
+        try {
+            measure([&] { method->execute(paramList, callInfoP, retvalP); });
+        } catch (const std::exception& e) {
+            throw xmlrpc_c::fault(e.what(), xmlrpc_c::fault::CODE_INTERNAL);
+        }
+    }
+
+    // Ejecuta un comando de robot.batch con la misma medición que un pedido suelto.
+    // La excepción sale tal cual: robot.batch la anota en el resultado de ese comando.
+    void executeForUser(xmlrpc_c::paramList const& paramList,
+                        xmlrpc_c::value* const retvalP,
+                        const UserNamespace::User& user,
+                        const std::string& clientIp,
+                        RobotNamespace::Robot& robot) {
+        auto* authenticated = dynamic_cast<AuthenticatedMethod*>(method);
+        measure([&] { authenticated->executeForUser(paramList, retvalP, user, clientIp, robot); });
+    }
+
+private:
+    template <typename Call>
+    void measure(Call call) {
+        using Clock = std::chrono::steady_clock;
+        stats.begin();
+        auto const start = Clock::now();
+        try {
+            call();
+        } catch (const xmlrpc_c::fault&) {
+            stats.end(Clock::now() - start);
+            stats.recordError(RpcServiceHandlerNamespace::RpcMethodStats::ErrorType::Fault);
+            throw;
+        } catch (const std::exception& e) {
+            stats.end(Clock::now() - start);
+            stats.recordError(RpcServiceHandlerNamespace::RpcMethodStats::errorTypeOf(e));
+            throw;
+        }
+        stats.end(Clock::now() - start);
+    }
+
+    xmlrpc_c::methodPtr const methodP;
+    xmlrpc_c::method2* const method;
+    RpcServiceHandlerNamespace::RpcMethodStats& stats;
+};
+
+// --- Método para ejecutar varios comandos en un solo pedido ---
+// El token se valida una vez y cada comando corre en orden con los permisos de ese usuario.
+class RobotBatchMethod : public AuthenticatedMethod {
+public:
+    static constexpr std::size_t MAX_BATCH_COMMANDS = 256;
+
+    RobotBatchMethod(AuthenticationServiceNamespace::AuthenticationService& auth, RobotNamespace::RobotRegistry& r, TaskManager& tm)
+        : AuthenticatedMethod(auth, r, tm) {
+        this->_signature = "S:sA,S:sAS"; // struct robot.batch(string token, array commands [, struct options])
+        this->_name = "robot.batch";
+        this->_help = "Runs several commands in one request. Each command is a struct {method, params [, robot]} where "
+                      "params omits the token. Options: {stopOnError: boolean (default true)}. Returns "
+                      "{results: [{method, ok, result | error}], executed, failed, stopped}.";
+    }
+
+    /// @brief Agrega un método autenticado, ya envuelto en MeteredMethod, a los que se pueden usar dentro de un batch.
+    void addCommand(const std::string& name, xmlrpc_c::methodPtr const& methodP) {
+        commands.emplace(name, methodP);
+    }
+
+    void executeAuthenticated(xmlrpc_c::paramList const& paramList,
+                              xmlrpc_c::value* const retvalP,
+                              const UserNamespace::User& user,
+                              const std::string& clientIp,
+                              RobotNamespace::Robot& robot) override {
+        std::vector<xmlrpc_c::value> const items(paramList.getArray(1));
+        bool stopOnError = true;
+        if (paramList.size() > 2) {
+            std::map<std::string, xmlrpc_c::value> const options(paramList.getStruct(2));
+            auto option = options.find("stopOnError");
+            if (option != options.end()) {
+                stopOnError = xmlrpc_c::value_boolean(option->second);
+            }
+            paramList.verifyEnd(3);
+        } else {
+            paramList.verifyEnd(2);
+        }
+        if (items.size() > MAX_BATCH_COMMANDS) {
+            throw std::invalid_argument("Un batch admite hasta " + std::to_string(MAX_BATCH_COMMANDS) + " comandos.");
+        }
+
+        xmlrpc_c::value_string const token(paramList.getString(0));
+        std::vector<xmlrpc_c::value> results;
+        int failed = 0;
+        bool stopped = false;
+        for (const auto& item : items) {
+            std::map<std::string, xmlrpc_c::value> itemResult;
+            std::string methodName;
+            std::string robotId;
+            try {
+                std::map<std::string, xmlrpc_c::value> const command = xmlrpc_c::value_struct(item).cvalue();
+                auto field = command.find("method");
+                if (field == command.end()) {
+                    throw std::invalid_argument("Falta 'method' en el comando.");
+                }
+                methodName = xmlrpc_c::value_string(field->second).cvalue();
+                itemResult["method"] = xmlrpc_c::value_string(methodName);
+
+                auto entry = commands.find(methodName);
+                if (entry == commands.end()) {
+                    throw std::invalid_argument("Método desconocido o no permitido en un batch: " + methodName);
+                }
+                auto* method = dynamic_cast<MeteredMethod*>(entry->second.operator->());
+
+                // El comando recibe el token en el índice 0, como si lo hubiera enviado el cliente.
+                xmlrpc_c::paramList commandParams;
+                commandParams.add(token);
+                field = command.find("params");
+                if (field != command.end()) {
+                    for (const auto& param : xmlrpc_c::value_array(field->second).vectorValueValue()) {
+                        commandParams.add(param);
+                    }
+                }
+                field = command.find("robot");
+                if (field != command.end()) {
+                    robotId = xmlrpc_c::value_string(field->second).cvalue();
+                }
+                RobotNamespace::Robot& target = robotId.empty() ? robot : robots.get(robotId);
+
+                Logger::getInstance().logfAs(LogLevel::INFO, LogCategory::RPC, user.getUsername(), clientIp,
+                                             "[RPC] RPC call from user '%s': %s > %s%s%s%s", user.getUsername().c_str(),
+                                             this->_name.c_str(), methodName.c_str(), robotId.empty() ? "" : " [",
+                                             robotId.c_str(), robotId.empty() ? "" : "]");
+                xmlrpc_c::value result;
+                method->executeForUser(adaptNumbers(commandParams, method->signature()), &result, user, clientIp, target);
+                itemResult["ok"] = xmlrpc_c::value_boolean(true);
+                itemResult["result"] = result;
+            } catch (const std::exception& e) {
+                recordFailure(itemResult, methodName, e.what(), user, clientIp, robotId, robot);
+            } catch (const xmlrpc_c::fault& f) { // Parámetros mal tipados (paramList) y errores propios de los métodos.
+                recordFailure(itemResult, methodName, f.getDescription(), user, clientIp, robotId, robot);
+            }
+            if (!itemResult.count("result")) {
+                failed++;
+                stopped = stopOnError;
+            }
+            results.push_back(xmlrpc_c::value_struct(itemResult));
+            if (stopped) {
+                break;
+            }
+        }
+
+        std::map<std::string, xmlrpc_c::value> batchResult;
+        batchResult["results"] = xmlrpc_c::value_array(results);
+        batchResult["executed"] = xmlrpc_c::value_int(static_cast<int>(results.size()));
+        batchResult["failed"] = xmlrpc_c::value_int(failed);
+        batchResult["stopped"] = xmlrpc_c::value_boolean(stopped && results.size() < items.size());
+        *retvalP = xmlrpc_c::value_struct(batchResult);
+    }
+
+private:
+    /// @brief Registra un comando fallido igual que AuthenticatedMethod registra un pedido fallido.
+    void recordFailure(std::map<std::string, xmlrpc_c::value>& itemResult,
+                       const std::string& methodName,
+                       const std::string& error,
+                       const UserNamespace::User& user,
+                       const std::string& clientIp,
+                       const std::string& robotId,
+                       RobotNamespace::Robot& robot) {
+        Logger::getInstance().logfAs(LogLevel::WARNING, LogCategory::RPC, user.getUsername(), clientIp,
+                                     "Failed RPC call for user '%s': %s > %s: %s", user.getUsername().c_str(),
+                                     this->_name.c_str(), methodName.c_str(), error.c_str());
+        RobotNamespace::Robot& target = robots.contains(robotId) ? robots.get(robotId) : robot;
+        target.recordOrder(user.getUsername(), "ERROR", error);
+        itemResult.clear(); // Un xmlrpc_c::value ya asignado no se puede reasignar.
+        itemResult["method"] = xmlrpc_c::value_string(methodName);
+        itemResult["ok"] = xmlrpc_c::value_boolean(false);
+        itemResult["error"] = xmlrpc_c::value_string(error);
+    }
+
+    std::map<std::string, xmlrpc_c::methodPtr> commands;
+};
+
 
 void RpcServiceHandlerNamespace::RpcServiceHandler::registerMethods(xmlrpc_c::registry &registry) {
     // --- Métodos de Sesión (no requieren token) ---
-    registry.addMethod("user.login", new UserLoginMethod(authService));
-    registry.addMethod("user.logout", new UserLogoutMethod(authService)); // Logout sí necesita el token para saber qué sesión cerrar
-    registry.addMethod("user.list", new UserListMethod(authService, robot, taskManager));
+    // Cada método queda también en 'methods', para que el endpoint JSON use los mismos objetos.
+    methods.clear();
+    // Al registro, a 'methods' y a robot.batch va el método envuelto en MeteredMethod.
+    auto add = [this, &registry](const std::string& name, xmlrpc_c::method2* method) {
+        xmlrpc_c::methodPtr const methodP(method);
+        xmlrpc_c::methodPtr const meteredP(new MeteredMethod(methodP, metrics.add(name)));
+        registry.addMethod(name, meteredP);
+        methods.emplace(name, meteredP);
+        return meteredP;
+    };
+    add("user.login", new UserLoginMethod(authService));
+    add("user.logout", new UserLogoutMethod(authService)); // Logout sí necesita el token para saber qué sesión cerrar
+
+    // Los métodos con token se registran también en robot.batch, que los ejecuta de a varios.
+    auto* batch = new RobotBatchMethod(authService, robots, taskManager);
+    add("robot.batch", batch);
+    auto addAuthenticated = [&add, batch](const std::string& name, AuthenticatedMethod* method) {
+        batch->addCommand(name, add(name, method));
+    };
+    addAuthenticated("user.list", new UserListMethod(authService, robots, taskManager));
 
     // Registramos los demás métodos protegidos.
-    registry.addMethod("robot.connect", new RobotConnectMethod(authService, robot, taskManager));
-    registry.addMethod("robot.disconnect", new RobotDisconnectMethod(authService, robot, taskManager));
-    registry.addMethod("user.add", new RobotUserAddMethod(authService, robot, taskManager));
-    registry.addMethod("robot.getStatus", new RobotGetStatusMethod(authService, robot, taskManager));
-    registry.addMethod("robot.move", new RobotMoveMethod(authService, robot, taskManager));
-    registry.addMethod("robot.moveDefaultSpeed", new RobotMoveDefaultSpeedMethod(authService, robot, taskManager));
-    registry.addMethod("robot.enableMotors", new RobotEnableMotorsMethod(authService, robot, taskManager));
-    registry.addMethod("robot.disableMotors", new RobotDisableMotorsMethod(authService, robot, taskManager));
-    registry.addMethod("robot.setCoordinateMode", new SetCoordinateModeMethod(authService, robot, taskManager));
-    registry.addMethod("robot.setEffector", new RobotSetEffectorMethod(authService, robot, taskManager));
-    registry.addMethod("robot.help", new HelpMethod(authService, robot, taskManager));
-    registry.addMethod("robot.getReport", new GetReportMethod(authService, robot, taskManager));
-    registry.addMethod("robot.getAdminReport", new GetAdminReportMethod(authService, robot, taskManager));
-    registry.addMethod("robot.getLogReport", new GetLogReportMethod(authService, robot, taskManager));
-    registry.addMethod("robot.listTasks", new ListTasksMethod(authService, robot, taskManager));
-    registry.addMethod("robot.executeTask", new ExecuteTaskMethod(authService, robot, taskManager));
-    registry.addMethod("robot.addTask", new AddTaskMethod(authService, robot, taskManager));
-}
\ No newline at end of file
+    addAuthenticated("robot.connect", new RobotConnectMethod(authService, robots, taskManager));
+    addAuthenticated("robot.disconnect", new RobotDisconnectMethod(authService, robots, taskManager));
+    addAuthenticated("user.add", new RobotUserAddMethod(authService, robots, taskManager));
+    addAuthenticated("robot.getStatus", new RobotGetStatusMethod(authService, robots, taskManager));
+    addAuthenticated("robot.waitForChange", new RobotWaitForChangeMethod(authService, robots, taskManager));
+    addAuthenticated("robot.listRobots", new RobotListRobotsMethod(authService, robots, taskManager));
+    addAuthenticated("robot.move", new RobotMoveMethod(authService, robots, taskManager));
+    addAuthenticated("robot.moveDefaultSpeed", new RobotMoveDefaultSpeedMethod(authService, robots, taskManager));
+    addAuthenticated("robot.moveAsync", new RobotMoveAsyncMethod(authService, robots, taskManager));
+    addAuthenticated("robot.waitMotion", new RobotWaitMotionMethod(authService, robots, taskManager));
+    addAuthenticated("robot.enableMotors", new RobotEnableMotorsMethod(authService, robots, taskManager));
+    addAuthenticated("robot.disableMotors", new RobotDisableMotorsMethod(authService, robots, taskManager));
+    addAuthenticated("robot.setCoordinateMode", new SetCoordinateModeMethod(authService, robots, taskManager));
+    addAuthenticated("robot.setEffector", new RobotSetEffectorMethod(authService, robots, taskManager));
+    addAuthenticated("robot.help", new HelpMethod(authService, robots, taskManager));
+    addAuthenticated("robot.getReport", new GetReportMethod(authService, robots, taskManager));
+    addAuthenticated("robot.getAdminReport", new GetAdminReportMethod(authService, robots, taskManager));
+    addAuthenticated("robot.getLogReport", new GetLogReportMethod(authService, robots, taskManager));
+    addAuthenticated("robot.getLinkStats", new RobotGetLinkStatsMethod(authService, robots, taskManager));
+    addAuthenticated("robot.listTasks", new ListTasksMethod(authService, robots, taskManager));
+    addAuthenticated("robot.executeTask", new ExecuteTaskMethod(authService, robots, taskManager));
+    addAuthenticated("robot.addTask", new AddTaskMethod(authService, robots, taskManager));
+}
+void RpcServiceHandlerNamespace::RpcServiceHandler::call(const std::string& method,
+                                                          xmlrpc_c::paramList const& paramList,
+                                                          const xmlrpc_c::callInfo* callInfoP,
+                                                          xmlrpc_c::value* retvalP) const {
+    auto entry = methods.find(method);
+    if (entry == methods.end()) {
+        throw xmlrpc_c::fault("Método desconocido: " + method, xmlrpc_c::fault::CODE_NO_SUCH_METHOD);
+    }
+    auto* target = dynamic_cast<xmlrpc_c::method2*>(entry->second.operator->());
+    target->execute(adaptNumbers(paramList, target->signature()), callInfoP, retvalP);
+}
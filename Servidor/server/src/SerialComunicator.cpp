@@ -7,8 +7,28 @@
 #include <chrono>    // Para el manejo del tiempo
 #include <cerrno>    // Para errno
 #include <termios.h> // For tcflush()
+#include <poll.h>    // Para poll()
+#include <algorithm> // Para std::min
+#include <sys/eventfd.h> // Para despertar al hilo de E/S
 #include "Logger.h"
 #include "Exceptions.h"
+#include "BinaryFraming.h"
+
+namespace {
+
+/// @brief Entrega la respuesta (o el error) de un pedido. Un callback que falla
+/// no debe tirar abajo el hilo del puerto.
+template <typename Request>
+void finishRequest(Request& request, std::exception_ptr error)
+{
+  try {
+      request.callback(request.reply, error);
+  } catch (...) {
+  }
+}
+
+} // namespace
+
 // Constructors/Destructors
 
 
@@ -21,6 +41,7 @@ ComunicatorPort::SerialComunicator::~SerialComunicator()
 {
   // La lógica de 'close()' se mueve aquí directamente para evitar
   // llamar a un método virtual desde el destructor.
+  stopIoThread();
   if (fileDescriptor_ != -1)
   {
     ::close(fileDescriptor_);
@@ -41,10 +62,12 @@ void ComunicatorPort::SerialComunicator::config(const std::string& port, int spe
 
   // 2. Aplicar la configuración al descriptor de archivo que acabamos de abrir.
   configurator_.applyConfig(fileDescriptor_, speed);
+  baudRate_.store(speed, std::memory_order_release);
 
   Logger::getInstance().log(LogLevel::INFO, "Puerto serie " + port + " abierto con éxito a " + std::to_string(speed) + " baudios.");
 
    isConfigured_ = true;
+   linkLost_.store(false, std::memory_order_release);
 }
 
 std::string ComunicatorPort::SerialComunicator::sendMessage(const std::string& message)
@@ -53,6 +76,10 @@ std::string ComunicatorPort::SerialComunicator::sendMessage(const std::string& m
   {
       throw SerialCommunicationException("Puerto serie no configurado.");
   }
+  if (ioRunning_.load(std::memory_order_acquire))
+  {
+      throw SerialCommunicationException("El puerto está en uso por el hilo de E/S; use submit().");
+  }
 
   ssize_t bytesWritten = write(fileDescriptor_, message.c_str(), message.size());
   if (bytesWritten == -1)
@@ -69,30 +96,760 @@ std::string ComunicatorPort::SerialComunicator::reciveMessage(int time)
   {
       throw SerialCommunicationException("No se puede recibir datos, el puerto no está configurado.");
   }
+  if (ioRunning_.load(std::memory_order_acquire))
+  {
+      throw SerialCommunicationException("El puerto está en uso por el hilo de E/S; use submit().");
+  }
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(time);
+    bool errorSeen = false;
+    std::size_t replyEnd = findReplyEnd(errorSeen);
 
-    std::string full_response;
-    auto startTime = std::chrono::steady_clock::now();
-    
-    while (std::chrono::duration_cast<std::chrono::seconds>(std::chrono::steady_clock::now() - startTime).count() < time) {
-        ssize_t bytesRead = read(fileDescriptor_, buffer_, sizeof(buffer_) - 1);
-        
-        if (bytesRead > 0) {
-            // Si leemos datos, los añadimos a nuestra respuesta.
-            full_response.append(buffer_, bytesRead);
-        } else if (bytesRead < 0) {
-            // En modo no bloqueante, EAGAIN o EWOULDBLOCK no son errores,
-            // simplemente significan que no hay datos ahora.
-            if (errno != EAGAIN && errno != EWOULDBLOCK) {
-                throw SerialCommunicationException("Error al leer desde el puerto serie.");
-            }
+    // Esperamos con poll() hasta tener una respuesta completa o agotar el tiempo.
+    while (replyEnd == std::string::npos) {
+        auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+            deadline - std::chrono::steady_clock::now()).count();
+        if (remaining <= 0) {
+            break;
         }
-        // Si bytesRead es 0 o -1 (con EAGAIN), simplemente continuamos el bucle
-        // hasta que se cumpla el tiempo.
+
+        // Tras un "ERROR" solo esperamos un instante por el "OK" que lo acompaña.
+        int waitMs = errorSeen ? std::min<long long>(remaining, ERROR_LINGER_MS) : static_cast<int>(remaining);
+        if (!fillPending(waitMs) && errorSeen) {
+            break;
+        }
+        replyEnd = findReplyEnd(errorSeen);
+    }
+
+    if (replyEnd == std::string::npos) {
+        // Sin línea terminal: entregamos solo las líneas completas y guardamos la parcial.
+        std::size_t lastNewline = pendingInput_.rfind('\n');
+        replyEnd = (lastNewline == std::string::npos) ? 0 : lastNewline + 1;
     }
 
+    std::string full_response = pendingInput_.substr(0, replyEnd);
+    pendingInput_.erase(0, replyEnd);
     return full_response;
 }
 
+std::size_t ComunicatorPort::SerialComunicator::findReplyEnd(bool& errorSeen)
+{
+    // Los saltos de línea sueltos (p. ej. el "\r\n" del firmware convertido en dos
+    // líneas por el driver) no pertenecen a ninguna respuesta: los descartamos.
+    std::size_t firstChar = pendingInput_.find_first_not_of("\r\n");
+    pendingInput_.erase(0, firstChar == std::string::npos ? pendingInput_.size() : firstChar);
+
+    std::size_t lineStart = 0;
+    std::size_t newline;
+    while ((newline = pendingInput_.find('\n', lineStart)) != std::string::npos) {
+        std::size_t lineEnd = newline;
+        if (lineEnd > lineStart && pendingInput_[lineEnd - 1] == '\r') {
+            lineEnd--;
+        }
+        std::size_t length = lineEnd - lineStart;
+
+        if (length == 2 && pendingInput_.compare(lineStart, 2, "OK") == 0) {
+            return newline + 1;
+        }
+        if (pendingInput_.compare(lineStart, 5, "ERROR") == 0) {
+            errorSeen = true;
+        }
+        lineStart = newline + 1;
+    }
+    return std::string::npos;
+}
+
+ComunicatorPort::HandshakeResult ComunicatorPort::SerialComunicator::waitForFirmware(const std::string& banner,
+                                                                                    std::chrono::milliseconds timeout)
+{
+  if (fileDescriptor_ == -1)
+  {
+      throw SerialCommunicationException("Puerto serie no configurado.");
+  }
+  if (ioRunning_.load(std::memory_order_acquire))
+  {
+      throw SerialCommunicationException("El puerto está en uso por el hilo de E/S; use submit().");
+  }
+
+  HandshakeResult result;
+  const std::string probe = "M114\r\n";
+  auto start = std::chrono::steady_clock::now();
+  auto deadline = start + timeout;
+  auto probeDelay = std::chrono::milliseconds(HANDSHAKE_FIRST_PROBE_MS);
+  auto nextProbe = start + probeDelay;
+  std::size_t scanned = 0; // Hasta dónde se revisaron líneas completas de pendingInput_.
+  int answered = 0;        // Sondeos respondidos con "OK".
+
+  auto scanLines = [&]() {
+      std::size_t newline;
+      while ((newline = pendingInput_.find('\n', scanned)) != std::string::npos)
+      {
+          std::string line = pendingInput_.substr(scanned, newline - scanned);
+          if (!line.empty() && line.back() == '\r')
+          {
+              line.pop_back();
+          }
+          if (!result.bannerSeen && line.find(banner) != std::string::npos)
+          {
+              result.bannerSeen = true;
+              // Un sondeo inmediato: su "OK" marca el final de los mensajes de arranque.
+              writeAll(probe);
+              result.probes++;
+          }
+          else if (line == "OK" && result.probes > 0)
+          {
+              answered++;
+          }
+          scanned = newline + 1;
+      }
+  };
+
+  while (answered == 0)
+  {
+      auto now = std::chrono::steady_clock::now();
+      if (now >= deadline)
+      {
+          break;
+      }
+      if (!result.bannerSeen && now >= nextProbe)
+      {
+          // Sin mensaje de arranque (placa que no se reinicia al abrir, o mensaje perdido):
+          // preguntamos, cada vez más espaciado para no saturar un arranque lento.
+          writeAll(probe);
+          result.probes++;
+          probeDelay = std::min(probeDelay * 2, std::chrono::milliseconds(HANDSHAKE_MAX_PROBE_MS));
+          nextProbe = now + probeDelay;
+      }
+      auto wakeAt = result.bannerSeen ? deadline : std::min(nextProbe, deadline);
+      auto waitMs = std::chrono::duration_cast<std::chrono::milliseconds>(wakeAt - now).count();
+      fillPending(static_cast<int>(std::max<long long>(1, waitMs)));
+      scanLines();
+  }
+
+  if (answered > 0)
+  {
+      // Los sondeos enviados mientras la placa arrancaba pueden contestarse ahora;
+      // los esperamos un instante para que no se tomen como respuesta del próximo comando.
+      while (answered < result.probes && fillPending(HANDSHAKE_QUIET_MS))
+      {
+          scanLines();
+      }
+      result.ready = true;
+  }
+  pendingInput_.clear();
+  result.elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+  return result;
+}
+
+bool ComunicatorPort::SerialComunicator::fillPending(int timeoutMs)
+{
+    struct pollfd pfd;
+    pfd.fd = fileDescriptor_;
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+
+    int ready = poll(&pfd, 1, timeoutMs);
+    if (ready < 0) {
+        if (errno == EINTR) {
+            return false;
+        }
+        throw SerialCommunicationException("Error al esperar datos del puerto serie.");
+    }
+    if (ready == 0) {
+        return false; // Se agotó el tiempo sin datos.
+    }
+    if ((pfd.revents & POLLIN) == 0 && (pfd.revents & (POLLHUP | POLLERR | POLLNVAL))) {
+        throw SerialCommunicationException("Se perdió la conexión con el puerto serie.");
+    }
+
+    ssize_t bytesRead = read(fileDescriptor_, buffer_, sizeof(buffer_));
+    if (bytesRead < 0) {
+        if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+            throw SerialCommunicationException("Error al leer desde el puerto serie.");
+        }
+        return false;
+    }
+    if (bytesRead == 0 && (pfd.revents & (POLLHUP | POLLERR))) {
+        throw SerialCommunicationException("Se perdió la conexión con el puerto serie.");
+    }
+    pendingInput_.append(buffer_, bytesRead);
+    return bytesRead > 0;
+}
+
+void ComunicatorPort::SerialComunicator::submitAsync(const std::string& command, ReplyCallback callback, int time)
+{
+  if (fileDescriptor_ == -1)
+  {
+      throw SerialCommunicationException("Puerto serie no configurado.");
+  }
+  Request request;
+  request.command = command;
+  request.callback = std::move(callback);
+  request.timeoutSeconds = time;
+  enqueue(std::move(request));
+}
+
+void ComunicatorPort::SerialComunicator::enqueue(Request&& request)
+{
+  startIoThread();
+  if (!submissions_.tryPush(std::move(request)))
+  {
+      throw SerialCommunicationException("La cola de envío del puerto serie está llena.");
+  }
+  // Si el hilo terminó por un error justo antes del push, nadie va a tomar el pedido.
+  // El hilo baja ioRunning_ antes de vaciar la cola, así que uno de los dos lo ve.
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (!ioRunning_.load(std::memory_order_relaxed))
+  {
+      failSubmissions();
+  }
+
+  uint64_t one = 1;
+  (void)!::write(wakeFd_, &one, sizeof(one));
+}
+
+bool ComunicatorPort::SerialComunicator::enableBinaryFraming(int time)
+{
+  if (fileDescriptor_ == -1)
+  {
+      throw SerialCommunicationException("Puerto serie no configurado.");
+  }
+  if (binaryFraming_.load(std::memory_order_acquire))
+  {
+      return true;
+  }
+
+  auto promise = std::make_shared<std::promise<SerialReply>>();
+  std::future<SerialReply> future = promise->get_future();
+  Request request;
+  request.command = Framing::NEGOTIATE_COMMAND;
+  request.timeoutSeconds = time;
+  request.negotiatesFraming = true;
+  request.callback = [promise](const SerialReply& reply, std::exception_ptr error) {
+      if (error) {
+          promise->set_exception(error);
+      } else {
+          promise->set_value(reply);
+      }
+  };
+  enqueue(std::move(request));
+
+  // El hilo de E/S cambia de modo antes de entregar la respuesta.
+  SerialReply reply = future.get();
+  if (binaryFraming_.load(std::memory_order_acquire))
+  {
+      Logger::getInstance().log(LogLevel::INFO, "[Serial Communicator] Protocolo binario activado (tramas con secuencia y CRC16).");
+      return true;
+  }
+  Logger::getInstance().log(LogLevel::WARNING, std::string("[Serial Communicator] El firmware no aceptó el protocolo binario (") +
+                            (reply.complete ? "respuesta sin confirmación" : "sin respuesta") + "); se sigue en modo texto.");
+  return false;
+}
+
+bool ComunicatorPort::SerialComunicator::changeBaudRate(int speed, int time)
+{
+  if (fileDescriptor_ == -1)
+  {
+      throw SerialCommunicationException("Puerto serie no configurado.");
+  }
+  if (speed == baudRate_.load(std::memory_order_acquire))
+  {
+      return true;
+  }
+  if (!ConfigurationPort::SerialPortConfiguration::isSupportedRate(speed))
+  {
+      Logger::getInstance().logf(LogLevel::WARNING, LogCategory::SERIAL, "[Serial Communicator] El puerto no admite %d baudios.", speed);
+      return false;
+  }
+  if (binaryFraming_.load(std::memory_order_acquire))
+  {
+      Logger::getInstance().log(LogLevel::WARNING, "[Serial Communicator] La velocidad se cambia antes de activar el protocolo binario.");
+      return false;
+  }
+
+  auto promise = std::make_shared<std::promise<SerialReply>>();
+  std::future<SerialReply> future = promise->get_future();
+  Request request;
+  request.command = "M901 S" + std::to_string(speed) + "\r\n";
+  request.timeoutSeconds = time;
+  request.switchesBaud = speed;
+  request.callback = [promise](const SerialReply& reply, std::exception_ptr error) {
+      if (error) {
+          promise->set_exception(error);
+      } else {
+          promise->set_value(reply);
+      }
+  };
+  int previous = baudRate_.load(std::memory_order_acquire);
+  enqueue(std::move(request));
+
+  // Igual que con M900, el hilo de E/S reconfigura el puerto antes de entregar la respuesta.
+  SerialReply reply = future.get();
+  if (baudRate_.load(std::memory_order_acquire) != speed)
+  {
+      Logger::getInstance().logf(LogLevel::WARNING, LogCategory::SERIAL, "[Serial Communicator] El firmware no aceptó %d baudios (%s).",
+                                 speed, reply.complete ? "respuesta sin confirmación" : "sin respuesta");
+      return false;
+  }
+
+  // El mismo M901 a la nueva velocidad es la confirmación que espera el firmware.
+  std::string confirmation = "M901 S" + std::to_string(speed) + "\r\n";
+  for (int attempt = 0; attempt < BAUD_VERIFY_ATTEMPTS; ++attempt)
+  {
+      SerialReply probe = submit(confirmation, BAUD_VERIFY_TIMEOUT_S).get();
+      if (probe.complete && !probe.error && probe.text.find("BAUD " + std::to_string(speed)) != std::string::npos)
+      {
+          Logger::getInstance().logf(LogLevel::INFO, LogCategory::SERIAL, "[Serial Communicator] Enlace a %d baudios (antes %d).",
+                                     speed, previous);
+          return true;
+      }
+  }
+  Logger::getInstance().logf(LogLevel::WARNING, LogCategory::SERIAL, "[Serial Communicator] La línea no es estable a %d baudios.", speed);
+  return false;
+}
+
+void ComunicatorPort::SerialComunicator::writeAll(const std::string& data)
+{
+  const char* cursor = data.data();
+  std::size_t remaining = data.size();
+  while (remaining > 0)
+  {
+      ssize_t written = ::write(fileDescriptor_, cursor, remaining);
+      if (written < 0)
+      {
+          if (errno == EINTR || errno == EAGAIN) continue;
+          throw SerialCommunicationException("Error al enviar el mensaje.");
+      }
+      cursor += written;
+      remaining -= static_cast<std::size_t>(written);
+  }
+  lastTrafficAt_ = std::chrono::steady_clock::now();
+}
+
+void ComunicatorPort::SerialComunicator::startIoThread()
+{
+  if (ioRunning_.load(std::memory_order_acquire))
+  {
+      return;
+  }
+  std::lock_guard<std::mutex> lock(ioStartMutex_);
+  if (ioRunning_.load(std::memory_order_acquire))
+  {
+      return;
+  }
+  if (ioThread_.joinable())
+  {
+      // El hilo anterior terminó por un error del puerto; lo recogemos antes de crear otro.
+      ioThread_.join();
+  }
+  if (wakeFd_ == -1)
+  {
+      wakeFd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+      if (wakeFd_ == -1)
+      {
+          throw SerialCommunicationException("No se pudo crear el eventfd del hilo de E/S.");
+      }
+  }
+  ioRunning_.store(true, std::memory_order_release);
+  ioThread_ = std::thread(&SerialComunicator::ioLoop, this);
+}
+
+void ComunicatorPort::SerialComunicator::stopIoThread()
+{
+  std::lock_guard<std::mutex> lock(ioStartMutex_);
+  if (ioThread_.joinable())
+  {
+      ioRunning_.store(false, std::memory_order_release);
+      uint64_t one = 1;
+      (void)!::write(wakeFd_, &one, sizeof(one));
+      ioThread_.join();
+  }
+  if (wakeFd_ != -1)
+  {
+      ::close(wakeFd_);
+      wakeFd_ = -1;
+  }
+
+  // Los pedidos que llegaron a encolarse pero nunca se escribieron también fallan.
+  failSubmissions();
+}
+
+void ComunicatorPort::SerialComunicator::failSubmissions(std::exception_ptr error)
+{
+  std::lock_guard<std::mutex> lock(drainMutex_);
+  Request request;
+  while (submissions_.tryPop(request))
+  {
+      if (!error)
+      {
+          error = std::make_exception_ptr(SerialCommunicationException("Puerto serie cerrado antes de enviar el comando."));
+      }
+      finishRequest(request, error);
+  }
+}
+
+void ComunicatorPort::SerialComunicator::ioLoop()
+{
+  std::deque<Request> waiting;  // Encolados, todavía sin escribir.
+  std::deque<Request> inFlight; // Escritos, esperando su respuesta (en orden de envío).
+  bool lingering = false;
+  std::chrono::steady_clock::time_point lingerDeadline;
+  int unansweredProbes = 0;     // Reenvíos por silencio desde lo último recibido.
+  auto finish = [](Request& request, std::exception_ptr error) { finishRequest(request, error); };
+
+  try {
+      while (ioRunning_.load(std::memory_order_acquire))
+      {
+          // 1. Tomamos los pedidos nuevos de la cola. Los productores no toman drainMutex_:
+          //    solo compite con quien la vacía cuando el hilo termina.
+          {
+              std::lock_guard<std::mutex> lock(drainMutex_);
+              Request request;
+              while (submissions_.tryPop(request))
+              {
+                  waiting.push_back(std::move(request));
+              }
+          }
+
+          // 2. Escribimos mientras el firmware tenga lugar en su cola. Mientras se negocia
+          //    el protocolo o la velocidad no se escribe nada más: lo siguiente puede ir ya
+          //    en tramas o a otra velocidad.
+          while (!waiting.empty() && inFlight.size() < maxInFlight_ &&
+                 (inFlight.empty() || !inFlight.back().holdsWrites()))
+          {
+              Request& next = waiting.front();
+              if (binaryFraming_.load(std::memory_order_relaxed))
+              {
+                  next.seq = nextSeq_;
+                  if (!Framing::encodeCommand(next.command, next.seq, next.frame))
+                  {
+                      Request rejected = std::move(next);
+                      waiting.pop_front();
+                      finish(rejected, std::make_exception_ptr(SerialCommunicationException(
+                          "El comando no entra en una trama binaria: " + rejected.command)));
+                      continue;
+                  }
+                  nextSeq_++;
+                  writeAll(next.frame);
+                  next.reply.wireBytesSent = next.frame.size();
+              }
+              else
+              {
+                  writeAll(next.command);
+                  next.reply.wireBytesSent = next.command.size();
+              }
+              next.reply.sentAt = std::chrono::steady_clock::now();
+              next.deadline = next.reply.sentAt + std::chrono::seconds(next.timeoutSeconds);
+              inFlight.push_back(std::move(next));
+              waiting.pop_front();
+          }
+
+          // 3. Repartimos las respuestas completas, siempre al pedido más antiguo.
+          auto now = std::chrono::steady_clock::now();
+          bool errorSeen = false;
+          std::size_t replyEnd;
+          if (binaryFraming_.load(std::memory_order_relaxed))
+          {
+              processFramedInput(inFlight, now);
+          }
+          while (!binaryFraming_.load(std::memory_order_relaxed) &&
+                 ((replyEnd = findReplyEnd(errorSeen)) != std::string::npos || (lingering && now >= lingerDeadline)))
+          {
+              if (replyEnd == std::string::npos)
+              {
+                  // "ERROR" sin el "OK" posterior: cerramos la respuesta en la última línea completa.
+                  std::size_t lastNewline = pendingInput_.rfind('\n');
+                  replyEnd = (lastNewline == std::string::npos) ? 0 : lastNewline + 1;
+              }
+              lingering = false;
+              std::string text = pendingInput_.substr(0, replyEnd);
+              pendingInput_.erase(0, replyEnd);
+
+              if (inFlight.empty())
+              {
+                  Logger::getInstance().logf(LogLevel::DEBUG, LogCategory::SERIAL, "[Serial Communicator] Mensaje no solicitado: %s", text.c_str());
+              }
+              else if (inFlight.front().abandoned)
+              {
+                  // Respuesta tardía de un pedido vencido: ya se entregó, y no es del siguiente.
+                  Logger::getInstance().logf(LogLevel::DEBUG, LogCategory::SERIAL, "[Serial Communicator] Respuesta tardía descartada: %s", text.c_str());
+                  inFlight.pop_front();
+              }
+              else
+              {
+                  Request done = std::move(inFlight.front());
+                  inFlight.pop_front();
+                  done.reply.wireBytesReceived = text.size();
+                  done.reply.text = std::move(text);
+                  done.reply.complete = true;
+                  done.reply.error = errorSeen;
+                  done.reply.receivedAt = now;
+                  if (done.negotiatesFraming && !errorSeen &&
+                      done.reply.text.find(Framing::NEGOTIATE_REPLY) != std::string::npos)
+                  {
+                      // Lo que siga en pendingInput_ ya pertenece al protocolo binario.
+                      nextSeq_ = 0;
+                      framedText_.clear();
+                      gapReported_ = false;
+                      binaryFraming_.store(true, std::memory_order_release);
+                  }
+                  if (done.switchesBaud != 0 && !errorSeen &&
+                      done.reply.text.find("BAUD " + std::to_string(done.switchesBaud)) != std::string::npos)
+                  {
+                      // El firmware cambia de velocidad después de su "OK"; nosotros también.
+                      configurator_.applyConfig(fileDescriptor_, done.switchesBaud);
+                      baudRate_.store(done.switchesBaud, std::memory_order_release);
+                  }
+                  finish(done, nullptr);
+              }
+              errorSeen = false;
+          }
+          if (errorSeen && !lingering)
+          {
+              lingering = true;
+              lingerDeadline = now + std::chrono::milliseconds(ERROR_LINGER_MS);
+          }
+
+          // 4. Los pedidos vencidos se entregan como respuesta incompleta, pero siguen en la
+          //    ventana hasta que llegue la suya (o hasta ABANDONED_REPLY_MS): en modo texto, si
+          //    no, se la llevaría el siguiente; en binario, su trama hace falta si llega un NAK.
+          for (auto it = inFlight.begin(); it != inFlight.end();)
+          {
+              if (now < it->deadline)
+              {
+                  ++it;
+              }
+              else if (it->abandoned)
+              {
+                  if (binaryFraming_.load(std::memory_order_relaxed))
+                  {
+                      throw SerialCommunicationException("El firmware no confirmó la trama " + std::to_string(it->seq) + ".");
+                  }
+                  Logger::getInstance().logf(LogLevel::WARNING, LogCategory::SERIAL,
+                                             "[Serial Communicator] No llegó la respuesta de %s; se deja de esperarla.",
+                                             it->command.substr(0, it->command.find_first_of("\r\n")).c_str());
+                  it = inFlight.erase(it);
+              }
+              else
+              {
+                  it->reply.receivedAt = now;
+                  finish(*it, nullptr);
+                  it->abandoned = true;
+                  it->deadline = now + std::chrono::milliseconds(ABANDONED_REPLY_MS);
+                  ++it;
+              }
+          }
+
+          // Con el protocolo binario, un enlace mudo puede deberse a una trama perdida sin
+          // otra detrás que delate el hueco: reenviamos la última y el firmware la descarta
+          // (si ya la tenía) o responde con un NAK indicando desde dónde reenviar. Si lo último
+          // fue un NAK, el firmware está leyendo y le falta una trama: se insiste a ritmo fijo.
+          // Si no, puede estar con la cola llena sin leer el puerto, así que mientras no
+          // conteste cada reenvío espera el doble para no desbordar su buffer de recepción.
+          auto resendDelay = [this, &unansweredProbes] {
+              int shift = gapReported_ ? 0 : std::min(unansweredProbes, 8);
+              return std::chrono::milliseconds(std::min(RESEND_MAX_IDLE_MS, RESEND_IDLE_MS << shift));
+          };
+          auto resendAt = lastTrafficAt_ + resendDelay();
+          bool probing = binaryFraming_.load(std::memory_order_relaxed) && !inFlight.empty() && !inFlight.back().frame.empty();
+          if (probing && now >= resendAt)
+          {
+              writeAll(inFlight.back().frame);
+              framesResent_.fetch_add(1, std::memory_order_relaxed);
+              unansweredProbes++;
+              resendAt = lastTrafficAt_ + resendDelay();
+          }
+
+          // Si las respuestas liberaron lugar, escribimos los pedidos en espera antes de dormir.
+          if (!waiting.empty() && inFlight.size() < maxInFlight_ &&
+              (inFlight.empty() || !inFlight.back().holdsWrites()))
+          {
+              continue;
+          }
+
+          // 5. Esperamos datos del puerto, un pedido nuevo o el próximo vencimiento.
+          int timeoutMs = -1;
+          auto nearest = std::chrono::steady_clock::time_point::max();
+          for (const Request& pending : inFlight) nearest = std::min(nearest, pending.deadline);
+          if (lingering && lingerDeadline < nearest) nearest = lingerDeadline;
+          if (probing && resendAt < nearest) nearest = resendAt;
+          if (nearest != std::chrono::steady_clock::time_point::max())
+          {
+              auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(nearest - now).count();
+              timeoutMs = static_cast<int>(std::max<long long>(0, wait + 1));
+          }
+
+          struct pollfd fds[2];
+          fds[0].fd = fileDescriptor_;
+          fds[0].events = POLLIN;
+          fds[0].revents = 0;
+          fds[1].fd = wakeFd_;
+          fds[1].events = POLLIN;
+          fds[1].revents = 0;
+          int ready = poll(fds, 2, timeoutMs);
+          if (ready < 0)
+          {
+              if (errno == EINTR) continue;
+              throw SerialCommunicationException("Error al esperar datos del puerto serie.");
+          }
+          if (fds[1].revents & POLLIN)
+          {
+              uint64_t counter;
+              (void)!::read(wakeFd_, &counter, sizeof(counter));
+          }
+          if (fds[0].revents & POLLIN)
+          {
+              ssize_t bytesRead = read(fileDescriptor_, buffer_, sizeof(buffer_));
+              if (bytesRead < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+              {
+                  throw SerialCommunicationException("Error al leer desde el puerto serie.");
+              }
+              if (bytesRead > 0)
+              {
+                  pendingInput_.append(buffer_, bytesRead);
+                  lastTrafficAt_ = std::chrono::steady_clock::now();
+                  unansweredProbes = 0;
+              }
+              else if (fds[0].revents & (POLLHUP | POLLERR))
+              {
+                  // Un pty cuyo otro extremo se cerró reporta POLLIN junto con POLLHUP y read() da 0.
+                  throw SerialCommunicationException("Se perdió la conexión con el puerto serie.");
+              }
+          }
+          else if (fds[0].revents & (POLLHUP | POLLERR | POLLNVAL))
+          {
+              throw SerialCommunicationException("Se perdió la conexión con el puerto serie.");
+          }
+      }
+  } catch (...) {
+      // El puerto falló: todos los pedidos pendientes reciben el error.
+      std::exception_ptr error = std::current_exception();
+      for (Request& request : inFlight) if (!request.abandoned) finish(request, error);
+      for (Request& request : waiting) finish(request, error);
+      linkLost_.store(true, std::memory_order_release);
+      ioRunning_.store(false, std::memory_order_relaxed);
+      // Lo que se encoló mientras tanto tampoco se va a escribir (ver enqueue()).
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      failSubmissions(error);
+      return;
+  }
+
+  std::exception_ptr closed = std::make_exception_ptr(
+      SerialCommunicationException("Puerto serie cerrado antes de recibir la respuesta."));
+  for (Request& request : inFlight) if (!request.abandoned) finish(request, closed);
+  for (Request& request : waiting) finish(request, closed);
+}
+
+
+void ComunicatorPort::SerialComunicator::processFramedInput(std::deque<Request>& inFlight,
+                                                            std::chrono::steady_clock::time_point now)
+{
+  while (true)
+  {
+      std::size_t firstChar = pendingInput_.find_first_not_of("\r\n");
+      pendingInput_.erase(0, firstChar == std::string::npos ? pendingInput_.size() : firstChar);
+      if (pendingInput_.empty())
+      {
+          return;
+      }
+
+      // Líneas de texto ("INFO: ...", "ERROR: ..."): se acumulan hasta el próximo ACK.
+      // Ninguna línea contiene el byte de inicio, así que lo que lo preceda es basura.
+      if (static_cast<std::uint8_t>(pendingInput_[0]) != Framing::SOF)
+      {
+          std::size_t newline = pendingInput_.find('\n');
+          std::size_t frameStart = pendingInput_.find(static_cast<char>(Framing::SOF));
+          if (frameStart != std::string::npos && (newline == std::string::npos || frameStart < newline))
+          {
+              pendingInput_.erase(0, frameStart);
+              continue;
+          }
+          if (newline == std::string::npos)
+          {
+              return; // Línea incompleta.
+          }
+          framedText_.append(pendingInput_, 0, newline + 1);
+          pendingInput_.erase(0, newline + 1);
+          continue;
+      }
+
+      Framing::Frame frame;
+      std::size_t frameSize = 0;
+      Framing::DecodeStatus status = Framing::decodeFrame(pendingInput_, 0, frame, frameSize);
+      if (status == Framing::DecodeStatus::Incomplete)
+      {
+          return;
+      }
+      if (status == Framing::DecodeStatus::Corrupt)
+      {
+          Logger::getInstance().logf(LogLevel::DEBUG, LogCategory::SERIAL, "[Serial Communicator] Trama corrupta recibida; se descarta.");
+          pendingInput_.erase(0, 1);
+          continue;
+      }
+      pendingInput_.erase(0, frameSize);
+
+      if (frame.type == Framing::ACK)
+      {
+          gapReported_ = false;
+          auto acked = std::find_if(inFlight.begin(), inFlight.end(),
+                                    [&frame](const Request& r) { return !r.frame.empty() && r.seq == frame.seq; });
+          if (acked == inFlight.end())
+          {
+              Logger::getInstance().logf(LogLevel::WARNING, LogCategory::SERIAL, "[Serial Communicator] ACK inesperado para la secuencia %u.",
+                                         static_cast<unsigned>(frame.seq));
+              continue;
+          }
+          if (acked->abandoned)
+          {
+              // ACK tardío de un pedido vencido: ya se entregó; sus líneas tampoco son del siguiente.
+              Logger::getInstance().logf(LogLevel::DEBUG, LogCategory::SERIAL, "[Serial Communicator] ACK tardío descartado (secuencia %u).",
+                                         static_cast<unsigned>(frame.seq));
+              inFlight.erase(acked);
+              framedText_.clear();
+              continue;
+          }
+          Request done = std::move(*acked);
+          inFlight.erase(acked);
+
+          bool failed = !frame.payload.empty() && frame.payload[0] != 0;
+          done.reply.text = std::move(framedText_);
+          framedText_.clear();
+          done.reply.wireBytesReceived = done.reply.text.size() + frameSize;
+          done.reply.text += "OK\r\n"; // Mismo formato que en modo texto para quien lo lea.
+          done.reply.complete = true;
+          done.reply.error = failed || done.reply.text.compare(0, 5, "ERROR") == 0 ||
+                             done.reply.text.find("\nERROR") != std::string::npos;
+          done.reply.receivedAt = now;
+          finishRequest(done, nullptr);
+      }
+      else if (frame.type == Framing::NAK)
+      {
+          gapReported_ = true;
+          // Varias tramas detrás del hueco generan el mismo NAK: basta un reenvío.
+          if (frame.seq == lastNakSeq_ && now - lastNakAt_ < std::chrono::milliseconds(NAK_HOLDOFF_MS))
+          {
+              continue;
+          }
+          auto from = std::find_if(inFlight.begin(), inFlight.end(),
+                                   [&frame](const Request& r) { return !r.frame.empty() && r.seq == frame.seq; });
+          if (from == inFlight.end())
+          {
+              continue;
+          }
+          lastNakSeq_ = frame.seq;
+          lastNakAt_ = now;
+          std::size_t resent = 0;
+          for (auto it = from; it != inFlight.end(); ++it, ++resent)
+          {
+              writeAll(it->frame);
+          }
+          framesResent_.fetch_add(resent, std::memory_order_relaxed);
+          Logger::getInstance().logf(LogLevel::DEBUG, LogCategory::SERIAL,
+                                     "[Serial Communicator] NAK del firmware: se reenvían %zu tramas desde la secuencia %u.",
+                                     resent, static_cast<unsigned>(frame.seq));
+      }
+  }
+}
 
 void ComunicatorPort::SerialComunicator::cleanBuffer()
 {
@@ -101,6 +858,9 @@ void ComunicatorPort::SerialComunicator::cleanBuffer()
         // Primero, usamos tcflush para intentar una limpieza instantánea de los buffers de E/S.
         // Esto es muy rápido y descarta cualquier dato que ya esté en el buffer del kernel.
         tcflush(fileDescriptor_, TCIFLUSH);
+        if (!ioRunning_.load(std::memory_order_acquire)) {
+            pendingInput_.clear(); // También descartamos lo que ya habíamos leído.
+        }
 
         // Como el mensaje de Arduino puede llegar justo después de abrir el puerto,
         // es mejor añadir una pequeña espera en la lógica de conexión (`Robot::connect`)
@@ -111,11 +871,19 @@ void ComunicatorPort::SerialComunicator::cleanBuffer()
 
 void ComunicatorPort::SerialComunicator::close()
 {
+  stopIoThread();
   if (fileDescriptor_ != -1)
   {
     ::close(fileDescriptor_); // Usamos ::close para evitar ambigüedad con el método de la clase.
     fileDescriptor_ = -1;
+    pendingInput_.clear();
   }
+  // Al reabrir, la placa se reinicia en modo texto.
+  binaryFraming_.store(false, std::memory_order_release);
+  linkLost_.store(false, std::memory_order_release);
+  framedText_.clear();
+  gapReported_ = false;
+  nextSeq_ = 0;
 }
 // Accessor methods
 
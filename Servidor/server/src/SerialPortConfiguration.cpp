@@ -5,6 +5,97 @@
 #include <fcntl.h>
 #include <unistd.h>
 #include <stdexcept>
+#include <sys/ioctl.h>
+
+namespace {
+
+#ifdef TCSETS2
+// <asm/termbits.h> declara termios2 pero choca con <termios.h>; repetimos aquí la
+// estructura del kernel (asm-generic), que es la que esperan TCGETS2/TCSETS2.
+struct termios2 {
+    tcflag_t c_iflag;
+    tcflag_t c_oflag;
+    tcflag_t c_cflag;
+    tcflag_t c_lflag;
+    cc_t c_line;
+    cc_t c_cc[19];
+    speed_t c_ispeed;
+    speed_t c_ospeed;
+};
+
+#ifndef BOTHER
+#define BOTHER 0010000
+#endif
+#endif
+
+/// @brief Constante de termios para la velocidad, o B0 si no tiene una propia.
+speed_t toTermiosRate(int speed)
+{
+    switch (speed)
+    {
+    case 300: return B300;
+    case 1200: return B1200;
+    case 2400: return B2400;
+    case 4800: return B4800;
+    case 9600: return B9600;
+    case 19200: return B19200;
+    case 38400: return B38400;
+    case 57600: return B57600;
+    case 115200: return B115200;
+    case 230400: return B230400;
+#ifdef B460800
+    case 460800: return B460800;
+    case 500000: return B500000;
+    case 576000: return B576000;
+    case 921600: return B921600;
+    case 1000000: return B1000000;
+    case 1152000: return B1152000;
+    case 1500000: return B1500000;
+    case 2000000: return B2000000;
+    case 2500000: return B2500000;
+    case 3000000: return B3000000;
+    case 3500000: return B3500000;
+    case 4000000: return B4000000;
+#endif
+    default: return B0;
+    }
+}
+
+#ifndef TCGETS2
+int fromTermiosRate(speed_t rate)
+{
+    for (int speed : {300, 1200, 2400, 4800, 9600, 19200, 38400, 57600, 115200, 230400})
+    {
+        if (toTermiosRate(speed) == rate) return speed;
+    }
+    return -1;
+}
+#endif
+
+/// @brief Fija una velocidad arbitraria con BOTHER (Linux); el driver usa el divisor más cercano.
+void applyCustomRate(int fileDescriptor, int speed)
+{
+#ifdef TCSETS2
+    struct termios2 tty2;
+    if (ioctl(fileDescriptor, TCGETS2, &tty2) != 0)
+    {
+        throw std::runtime_error("Error al obtener los atributos del puerto serie (termios2).");
+    }
+    tty2.c_cflag &= ~CBAUD;
+    tty2.c_cflag |= BOTHER;
+    tty2.c_ispeed = static_cast<speed_t>(speed);
+    tty2.c_ospeed = static_cast<speed_t>(speed);
+    if (ioctl(fileDescriptor, TCSETS2, &tty2) != 0)
+    {
+        throw std::runtime_error("El driver no acepta la velocidad " + std::to_string(speed) + " baudios.");
+    }
+#else
+    (void)fileDescriptor;
+    throw std::runtime_error("Velocidad no soportada: " + std::to_string(speed));
+#endif
+}
+
+} // namespace
 
 
 // Constructors/Destructors
@@ -31,40 +122,18 @@ bool ConfigurationPort::SerialPortConfiguration::applyConfig(int fileDescriptor,
         throw std::runtime_error("Error al obtener los atributos del puerto serie.");
     }
 
-    // Configurar la velocidad
-    speed_t baudRate;
-    switch (speed_)
+    // Configurar la velocidad. Las que no tienen constante Bxxx (p. ej. 250000, la más
+    // exacta para un ATmega a 16 MHz) se fijan después con termios2/BOTHER.
+    speed_t baudRate = toTermiosRate(speed_);
+    bool customRate = (baudRate == B0);
+    if (customRate && !isSupportedRate(speed_))
     {
-    case 300:
-        baudRate = B300;
-        break;
-    case 1200:
-        baudRate = B1200;
-        break;
-    case 2400:
-        baudRate = B2400;
-        break;
-    case 4800:
-        baudRate = B4800;
-        break;
-    case 9600:
-        baudRate = B9600;
-        break;
-    case 19200:
-        baudRate = B19200;
-        break;
-    case 38400:
-        baudRate = B38400;
-        break;
-    case 57600:
-        baudRate = B57600;
-        break;
-    case 115200:
-        baudRate = B115200;
-        break;
-    default:
         throw std::runtime_error("Velocidad no soportada: " + std::to_string(speed_));
     }
+    if (customRate)
+    {
+        baudRate = B38400; // Provisoria hasta aplicar la velocidad exacta.
+    }
 
     cfsetospeed(&tty, baudRate);
     cfsetispeed(&tty, baudRate);
@@ -77,6 +146,9 @@ bool ConfigurationPort::SerialPortConfiguration::applyConfig(int fileDescriptor,
     tty.c_cflag |= CS8;              // 8 data bits
     tty.c_lflag = 0;                 // No local flags
     tty.c_oflag = 0;                 // No output processing
+    // Entrada cruda: sin CR->LF, sin control de flujo XON/XOFF ni recorte a 7 bits,
+    // para que las tramas binarias (protocolo M900) lleguen intactas.
+    tty.c_iflag &= ~(IGNBRK | BRKINT | PARMRK | ISTRIP | INLCR | IGNCR | ICRNL | IXON | IXOFF | IXANY);
     // Configuración de lectura no bloqueante.
     tty.c_cc[VMIN] = 0;  // read() puede devolver 0 bytes.
     tty.c_cc[VTIME] = 0; // read() no espera, devuelve inmediatamente.
@@ -86,9 +158,51 @@ bool ConfigurationPort::SerialPortConfiguration::applyConfig(int fileDescriptor,
         throw std::runtime_error("Error al establecer los atributos del puerto serie.");
     }
 
+    if (customRate)
+    {
+        applyCustomRate(fileDescriptor, speed_);
+    }
+
     return true;
 }
 
+bool ConfigurationPort::SerialPortConfiguration::isStandardRate(int speed)
+{
+    return toTermiosRate(speed) != B0;
+}
+
+bool ConfigurationPort::SerialPortConfiguration::isSupportedRate(int speed)
+{
+    if (isStandardRate(speed))
+    {
+        return true;
+    }
+#ifdef TCSETS2
+    return speed >= MIN_CUSTOM_RATE && speed <= MAX_CUSTOM_RATE;
+#else
+    return false;
+#endif
+}
+
+int ConfigurationPort::SerialPortConfiguration::currentRate(int fileDescriptor)
+{
+#ifdef TCGETS2
+    struct termios2 tty2;
+    if (ioctl(fileDescriptor, TCGETS2, &tty2) != 0)
+    {
+        return -1;
+    }
+    return static_cast<int>(tty2.c_ospeed);
+#else
+    struct termios tty;
+    if (tcgetattr(fileDescriptor, &tty) != 0)
+    {
+        return -1;
+    }
+    return fromTermiosRate(cfgetospeed(&tty));
+#endif
+}
+
 
 
 // Other methods
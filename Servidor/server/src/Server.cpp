@@ -8,6 +8,9 @@
 #include <string>
 #include <filesystem> // Requerido para C++17
 #include "Logger.h"
+#include "RpcHttpEndpoint.h"
+#include <csignal>
+#include <stdexcept>
 
 // Helper para obtener la ruta del directorio del proyecto
 std::string getProjectDirectory() {
@@ -24,10 +27,10 @@ Server::Server()
       dbManager(getProjectDirectory() + "/server_database.db"),
       sessionManager(), // Se inicializa aquí
       authService(dbManager, sessionManager), // Pasamos el sessionManager
-      robot(),
+      robots(),
       reportGenerator(), // Se mantiene por si los métodos RPC la necesitan
       taskManager("./tasks.json"),
-      rpcHandler(authService, robot, taskManager) // rpcHandler también necesitará el authService modificado
+      rpcHandler(authService, robots, taskManager) // rpcHandler también necesitará el authService modificado
 { 
     // Cargamos las tareas al iniciar el servidor.
     if (taskManager.loadTasks()) {
@@ -46,20 +49,35 @@ void Server::startRpcServer() {
         xmlrpc_c::registry myRegistry;
         rpcHandler.registerMethods(myRegistry);
 
-        struct sockaddr_in addr;
-        memset(&addr, 0, sizeof(addr));
-        addr.sin_family = AF_INET;
-        addr.sin_addr.s_addr = INADDR_ANY;  // 0.0.0.0 - escucha en todas las interfaces
-        addr.sin_port = htons(8080);
+        const char* error = nullptr;
+        AbyssInit(&error);
+        if (error) {
+            throw std::runtime_error(error);
+        }
+        signal(SIGPIPE, SIG_IGN); // Un cliente que corta la conexión no debe terminar el proceso.
 
-        xmlrpc_c::serverAbyss myAbyssServer(
-            xmlrpc_c::serverAbyss::constrOpt()
-            .registryP(&myRegistry)
-            .sockAddrP((struct sockaddr*)&addr)
-            .sockAddrLen(sizeof(addr)));
-        
-        Logger::getInstance().log(LogLevel::INFO, "[RPC Server] Servidor XML-RPC iniciado en el puerto 8080. Esperando peticiones...");
-        myAbyssServer.run(); // Esto bloquea este hilo y empieza a escuchar.
+        // Un solo servidor HTTP, con los hilos y el keep-alive de rpcConfig: XML-RPC en /RPC2
+        // y, con los mismos objetos método, JSON en /rpc y el cliente web en /.
+        std::string const webRoot = rpcConfig.webRoot.empty() ? getProjectDirectory() + "/../ClienteWeb"
+                                                              : rpcConfig.webRoot;
+        RpcServiceHandlerNamespace::RpcHttpEndpoint httpEndpoint(myRegistry, &rpcHandler, webRoot);
+        TServer abyssServer;
+        rpcConfig.create(abyssServer);
+        httpEndpoint.install(abyssServer);
+        ServerInit(&abyssServer);
+
+        Logger::getInstance().log(LogLevel::INFO, "[RPC Server] Servidor XML-RPC iniciado (" + rpcConfig.describe() +
+                                  "). Esperando peticiones...");
+        if (httpEndpoint.servesIndex()) {
+            Logger::getInstance().log(LogLevel::INFO, "[RPC Server] Cliente web en http://localhost:" +
+                                      std::to_string(rpcConfig.port) + "/ (JSON en /rpc).");
+        } else {
+            Logger::getInstance().log(LogLevel::WARNING, "[RPC Server] No se encontró index.html en " + webRoot +
+                                      "; solo se atiende JSON en /rpc.");
+        }
+        ServerRun(&abyssServer); // Esto bloquea este hilo y empieza a escuchar.
+        ServerFree(&abyssServer);
+        AbyssTerm();
 
     } catch (std::exception const& e) {
         Logger::getInstance().log(LogLevel::CRITICAL, "[RPC Server] Excepción crítica: " + std::string(e.what()));
@@ -69,6 +87,9 @@ void Server::startRpcServer() {
 void Server::run()
 {
     // El servidor ahora solo inicia el RPC Server y bloquea el hilo principal.
+    if (robots.empty()) {
+        robots.add(RobotNamespace::RobotRegistry::DEFAULT_ROBOT_ID, "");
+    }
     Logger::getInstance().log(LogLevel::INFO, "[Main] Iniciando Servidor RPC. Use Ctrl+C para detener.");
     startRpcServer(); // Esta llamada es bloqueante.
     // Cuando startRpcServer() termina (por ejemplo, por Ctrl+C), el programa finaliza.
@@ -1,52 +1,234 @@
 #include "SessionManager.h"
-#include <random>
-#include <sstream>
+#include <cerrno>
 #include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <sys/random.h>
+
+SessionManager::SessionManager(std::chrono::seconds idleTtl, std::chrono::seconds absoluteTtl)
+    : idleTtlMs_(std::chrono::duration_cast<std::chrono::milliseconds>(idleTtl).count()),
+      absoluteTtlMs_(std::chrono::duration_cast<std::chrono::milliseconds>(absoluteTtl).count()),
+      wheelTick_(nowMs() / 1000) {
+    sweeper_ = std::thread(&SessionManager::sweep, this);
+}
+
+SessionManager::~SessionManager() {
+    {
+        std::lock_guard<std::mutex> lock(sweeperMutex_);
+        sweeperRunning_ = false;
+    }
+    sweeperWake_.notify_all();
+    if (sweeper_.joinable()) {
+        sweeper_.join();
+    }
+}
+
+void SessionManager::setTimeouts(std::chrono::seconds idleTtl, std::chrono::seconds absoluteTtl) {
+    idleTtlMs_ = std::chrono::duration_cast<std::chrono::milliseconds>(idleTtl).count();
+    absoluteTtlMs_ = std::chrono::duration_cast<std::chrono::milliseconds>(absoluteTtl).count();
+
+    // Las sesiones se vuelven a anotar con los plazos nuevos; las que no vencían no estaban en la rueda.
+    std::lock_guard<std::mutex> wheelLock(wheelMutex_);
+    for (auto& slot : wheel_) {
+        slot.clear();
+    }
+    for (auto& shard : shards_) {
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
+        for (const auto& entry : shard.sessions) {
+            schedule(entry.first, deadlineMs(*entry.second));
+        }
+    }
+}
 
 std::string SessionManager::createSession(const UserNamespace::User& user, const std::string& ip_address) {
-    std::lock_guard<std::mutex> lock(sessionMutex_);
+    // La sesión guarda al usuario sin el hash de la contraseña: nadie lo necesita después del login.
+    auto session = std::make_shared<Session>();
+    session->user = std::make_shared<const UserNamespace::User>(user.getId(), user.getUsername(), "", user.getRole());
+    session->ipAddress = ip_address;
+    session->createdMs = nowMs();
+    session->lastSeenMs = session->createdMs;
+
     std::string token = generateToken();
-    // Nos aseguramos de que el token sea único (muy improbable que no lo sea)
-    while (activeSessions_.count(token)) {
+    while (true) {
+        Shard& shard = shardFor(token);
+        std::unique_lock<std::shared_mutex> lock(shard.mutex);
+        // Nos aseguramos de que el token sea único (muy improbable que no lo sea)
+        if (shard.sessions.emplace(token, session).second) {
+            break;
+        }
+        lock.unlock();
         token = generateToken();
     }
-    activeSessions_.insert({token, {user, ip_address}});
+
+    std::lock_guard<std::mutex> wheelLock(wheelMutex_);
+    schedule(token, deadlineMs(*session));
     return token;
 }
 
-std::optional<UserNamespace::User> SessionManager::getUserByToken(const std::string& token) const {
-    std::lock_guard<std::mutex> lock(sessionMutex_);
-    auto it = activeSessions_.find(token);
-    if (it != activeSessions_.end()) {
-        return it->second.first; // Devuelve solo el objeto User del par
+std::shared_ptr<const UserNamespace::User> SessionManager::getUserByToken(const std::string& token) const {
+    Shard& shard = shardFor(token);
+    std::shared_lock<std::shared_mutex> lock(shard.mutex);
+    auto it = shard.sessions.find(token);
+    if (it == shard.sessions.end()) {
+        return nullptr; // Token no encontrado
     }
-    return std::nullopt; // Token no encontrado
+    const Session& session = *it->second;
+    std::int64_t const now = nowMs();
+    if (expired(session, now)) {
+        return nullptr; // Vencida; el barrido la borra.
+    }
+    // Con resolución de un segundo alcanza: evita escribir la misma línea de caché en cada pedido.
+    if (now - session.lastSeenMs.load(std::memory_order_relaxed) >= 1000) {
+        session.lastSeenMs.store(now, std::memory_order_relaxed);
+    }
+    return session.user;
 }
 
 void SessionManager::endSession(const std::string& token) {
-    std::lock_guard<std::mutex> lock(sessionMutex_);
-    activeSessions_.erase(token);
+    // La entrada de la rueda queda huérfana y se descarta cuando le toca.
+    Shard& shard = shardFor(token);
+    std::unique_lock<std::shared_mutex> lock(shard.mutex);
+    shard.sessions.erase(token);
 }
 
 std::map<std::string, std::pair<UserNamespace::User, std::string>> SessionManager::getActiveSessions() const {
-    std::lock_guard<std::mutex> lock(sessionMutex_);
-    return activeSessions_;
+    std::map<std::string, std::pair<UserNamespace::User, std::string>> active;
+    std::int64_t const now = nowMs();
+    for (const auto& shard : shards_) {
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
+        for (const auto& entry : shard.sessions) {
+            if (!expired(*entry.second, now)) {
+                active.emplace(entry.first, std::make_pair(*entry.second->user, entry.second->ipAddress));
+            }
+        }
+    }
+    return active;
+}
+
+std::size_t SessionManager::sweepExpired() {
+    std::int64_t const now = nowMs();
+    std::int64_t const nowTick = now / 1000;
+    std::size_t removed = 0;
+
+    std::lock_guard<std::mutex> wheelLock(wheelMutex_);
+    // Si pasó más de una vuelta desde el último barrido, alcanza con revisar cada ranura una vez.
+    std::int64_t first = std::max(wheelTick_ + 1, nowTick - WHEEL_SLOTS + 1);
+    for (std::int64_t tick = first; tick <= nowTick; ++tick) {
+        std::vector<WheelEntry> due;
+        due.swap(wheel_[tick % WHEEL_SLOTS]);
+        for (auto& entry : due) {
+            if (entry.dueTick > nowTick) {
+                wheel_[tick % WHEEL_SLOTS].push_back(std::move(entry)); // Vence en otra vuelta.
+                continue;
+            }
+            Shard& shard = shardFor(entry.token);
+            std::unique_lock<std::shared_mutex> lock(shard.mutex);
+            auto it = shard.sessions.find(entry.token);
+            if (it == shard.sessions.end()) {
+                continue; // Ya se cerró con logout.
+            }
+            if (expired(*it->second, now)) {
+                shard.sessions.erase(it);
+                removed++;
+                continue;
+            }
+            // Se usó desde que se anotó: se vuelve a anotar con el plazo nuevo.
+            std::int64_t const deadline = deadlineMs(*it->second);
+            lock.unlock();
+            schedule(entry.token, deadline);
+        }
+    }
+    wheelTick_ = std::max(wheelTick_, nowTick);
+    return removed;
+}
+
+std::size_t SessionManager::size() const {
+    std::size_t total = 0;
+    for (const auto& shard : shards_) {
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
+        total += shard.sessions.size();
+    }
+    return total;
 }
 
 std::string SessionManager::generateToken() {
-    // Generador de números aleatorios seguro
-    std::random_device rd;
-    std::mt19937_64 gen(rd());
-    std::uniform_int_distribution<uint64_t> dis;
+    // getrandom() lee del generador criptográfico del kernel. Cada hilo guarda un bloque de
+    // bytes para no hacer una llamada al sistema por token; los bytes usados se borran.
+    constexpr std::size_t TOKEN_BYTES = 16; // 128 bits de aleatoriedad
+    thread_local std::array<unsigned char, 16 * TOKEN_BYTES> pool;
+    thread_local std::size_t used = pool.size();
 
-    // Generamos dos números de 64 bits para tener 128 bits de aleatoriedad
-    uint64_t part1 = dis(gen);
-    uint64_t part2 = dis(gen);
+    if (used + TOKEN_BYTES > pool.size()) {
+        std::size_t filled = 0;
+        while (filled < pool.size()) {
+            ssize_t const count = getrandom(pool.data() + filled, pool.size() - filled, 0);
+            if (count < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                throw std::runtime_error("No se pudo generar un token de sesión: getrandom() falló.");
+            }
+            filled += static_cast<std::size_t>(count);
+        }
+        used = 0;
+    }
 
     // Convertimos a una cadena hexadecimal de 32 caracteres
     std::stringstream ss;
-    ss << std::hex << std::setw(16) << std::setfill('0') << part1
-       << std::setw(16) << std::setfill('0') << part2;
-
+    ss << std::hex << std::setfill('0');
+    for (std::size_t i = 0; i < TOKEN_BYTES; ++i) {
+        ss << std::setw(2) << static_cast<int>(pool[used + i]);
+        pool[used + i] = 0;
+    }
+    used += TOKEN_BYTES;
     return ss.str();
-}
\ No newline at end of file
+}
+
+std::int64_t SessionManager::nowMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+SessionManager::Shard& SessionManager::shardFor(const std::string& token) const {
+    return shards_[std::hash<std::string>{}(token) & (SHARD_COUNT - 1)];
+}
+
+std::int64_t SessionManager::deadlineMs(const Session& session) const {
+    std::int64_t const idle = idleTtlMs_.load(std::memory_order_relaxed);
+    std::int64_t const absolute = absoluteTtlMs_.load(std::memory_order_relaxed);
+    std::int64_t deadline = -1;
+    if (idle > 0) {
+        deadline = session.lastSeenMs.load(std::memory_order_relaxed) + idle;
+    }
+    if (absolute > 0 && (deadline < 0 || session.createdMs + absolute < deadline)) {
+        deadline = session.createdMs + absolute;
+    }
+    return deadline;
+}
+
+bool SessionManager::expired(const Session& session, std::int64_t now) const {
+    std::int64_t const deadline = deadlineMs(session);
+    return deadline >= 0 && now >= deadline;
+}
+
+void SessionManager::schedule(const std::string& token, std::int64_t deadline) {
+    if (deadline < 0) {
+        return;
+    }
+    // Redondeado hacia arriba: la ranura se revisa cuando el plazo ya pasó.
+    std::int64_t tick = std::max((deadline + 999) / 1000, wheelTick_ + 1);
+    wheel_[tick % WHEEL_SLOTS].push_back({token, tick});
+}
+
+void SessionManager::sweep() {
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(sweeperMutex_);
+            sweeperWake_.wait_for(lock, std::chrono::seconds(1), [this] { return !sweeperRunning_; });
+            if (!sweeperRunning_) {
+                return;
+            }
+        }
+        sweepExpired();
+    }
+}
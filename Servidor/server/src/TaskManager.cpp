@@ -27,6 +27,7 @@ bool TaskManager::loadTasks() {
             newTask.name = item.at("name").get<std::string>();
             newTask.description = item.at("description").get<std::string>();
             newTask.gcode = item.at("gcode").get<std::vector<std::string>>();
+            optimize(newTask);
             tasks_.push_back(newTask);
         }
         
@@ -70,6 +71,7 @@ bool TaskManager::addTask(const Task& newTask) {
 
     // Añadir la nueva tarea a la lista en memoria
     tasks_.push_back(newTask);
+    optimize(tasks_.back());
 
     // Ahora, reconstruir el objeto JSON completo y guardarlo en el archivo
     json tasksJson;
@@ -88,3 +90,11 @@ bool TaskManager::addTask(const Task& newTask) {
     FileNamespace::FileManager fileManager;
     return fileManager.write(tasksFilePath_, tasksJson.dump(2)); // Usamos dump(2) para que el JSON se guarde formateado
 }
+
+void TaskManager::optimize(Task& task) {
+    task.optimized = GCodeNamespace::GCodeOptimizer::optimize(task.gcode);
+    if (task.optimized.lines.size() != task.gcode.size()) {
+        Logger::getInstance().logf(LogLevel::DEBUG, LogCategory::TASKS, "[TaskManager] Tarea '%s' optimizada: %zu -> %zu comandos.",
+                                   task.id.c_str(), task.gcode.size(), task.optimized.lines.size());
+    }
+}
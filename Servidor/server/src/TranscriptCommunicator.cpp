@@ -0,0 +1,282 @@
+#include "TranscriptCommunicator.h"
+
+#include <cstring>   // Para std::memcmp
+#include <thread>    // Para std::this_thread::sleep_until
+#include "Logger.h"
+#include "Exceptions.h"
+
+namespace {
+
+// Los enteros se escriben siempre en little-endian, byte a byte, para que una
+// transcripción grabada en una máquina pueda reproducirse en cualquier otra.
+template <typename T>
+void putLE(std::string& out, T value) {
+    for (std::size_t i = 0; i < sizeof(T); ++i) {
+        out += static_cast<char>((static_cast<std::uint64_t>(value) >> (8 * i)) & 0xFF);
+    }
+}
+
+template <typename T>
+bool getLE(std::istream& in, T& value) {
+    unsigned char bytes[sizeof(T)];
+    if (!in.read(reinterpret_cast<char*>(bytes), sizeof(T))) {
+        return false;
+    }
+    std::uint64_t result = 0;
+    for (std::size_t i = 0; i < sizeof(T); ++i) {
+        result |= static_cast<std::uint64_t>(bytes[i]) << (8 * i);
+    }
+    value = static_cast<T>(result);
+    return true;
+}
+
+// Quita el terminador de línea de un comando para mostrarlo en el log.
+std::string trimCommand(const std::string& command) {
+    return command.substr(0, command.find_first_of("\r\n"));
+}
+
+} // namespace
+
+// --- Transcript ---
+
+std::vector<ComunicatorPort::Transcript::Record> ComunicatorPort::Transcript::load(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        throw SerialCommunicationException("No se pudo abrir la transcripción '" + path + "'.");
+    }
+
+    char magic[4];
+    std::uint32_t version = 0;
+    if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, MAGIC, sizeof(magic)) != 0 ||
+        !getLE(in, version) || version != VERSION) {
+        throw SerialCommunicationException("El archivo '" + path + "' no es una transcripción válida.");
+    }
+
+    std::vector<Record> records;
+    for (;;) {
+        Record record;
+        std::uint8_t direction = 0;
+        std::uint32_t length = 0;
+        if (!getLE(in, record.timestampNs)) {
+            break; // Fin de archivo entre registros: lectura completa.
+        }
+        if (!getLE(in, direction) || !getLE(in, record.exchangeId) || !getLE(in, length) || direction > 1) {
+            throw SerialCommunicationException("Transcripción '" + path + "' truncada o dañada.");
+        }
+        record.direction = static_cast<Direction>(direction);
+        record.bytes.resize(length);
+        if (length > 0 && !in.read(&record.bytes[0], length)) {
+            throw SerialCommunicationException("Transcripción '" + path + "' truncada o dañada.");
+        }
+        records.push_back(std::move(record));
+    }
+    return records;
+}
+
+// --- RecordingSerialCommunicator ---
+
+ComunicatorPort::RecordingSerialCommunicator::RecordingSerialCommunicator(ISerialCommunicator& inner, const std::string& path)
+    : inner_(inner), out_(path, std::ios::binary | std::ios::trunc), start_(std::chrono::steady_clock::now()) {
+    if (!out_) {
+        throw SerialCommunicationException("No se pudo crear la transcripción '" + path + "'.");
+    }
+    std::string header(Transcript::MAGIC, sizeof(Transcript::MAGIC));
+    putLE(header, Transcript::VERSION);
+    out_.write(header.data(), header.size());
+    out_.flush();
+    Logger::getInstance().log(LogLevel::INFO, "[Transcript] Grabando tráfico serie en '" + path + "'.");
+}
+
+void ComunicatorPort::RecordingSerialCommunicator::writeRecord(Transcript::Direction direction, std::uint32_t exchangeId, const std::string& bytes) {
+    std::uint64_t timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - start_).count();
+
+    std::string record;
+    record.reserve(17 + bytes.size());
+    putLE(record, timestamp);
+    putLE(record, static_cast<std::uint8_t>(direction));
+    putLE(record, exchangeId);
+    putLE(record, static_cast<std::uint32_t>(bytes.size()));
+    record += bytes;
+
+    std::lock_guard<std::mutex> lock(fileMutex_);
+    out_.write(record.data(), record.size());
+    // Se vuelca en cada registro para no perder el final de la sesión si el servidor cae.
+    out_.flush();
+}
+
+void ComunicatorPort::RecordingSerialCommunicator::config(const std::string& port, int speed) {
+    inner_.config(port, speed);
+}
+
+std::string ComunicatorPort::RecordingSerialCommunicator::sendMessage(const std::string& message) {
+    std::uint32_t id = nextExchangeId_++;
+    lastSyncExchangeId_ = id;
+    writeRecord(Transcript::Direction::ToFirmware, id, message);
+    return inner_.sendMessage(message);
+}
+
+std::string ComunicatorPort::RecordingSerialCommunicator::reciveMessage(int time) {
+    std::string response = inner_.reciveMessage(time);
+    // Una lectura sin comando previo (por ejemplo, el mensaje de arranque) queda con id 0.
+    writeRecord(Transcript::Direction::FromFirmware, lastSyncExchangeId_.exchange(0), response);
+    return response;
+}
+
+void ComunicatorPort::RecordingSerialCommunicator::submitAsync(const std::string& command, ReplyCallback callback, int time) {
+    std::uint32_t id = nextExchangeId_++;
+    writeRecord(Transcript::Direction::ToFirmware, id, command);
+    inner_.submitAsync(command, [this, id, callback](const SerialReply& reply, std::exception_ptr error) {
+        if (!error) {
+            writeRecord(Transcript::Direction::FromFirmware, id, reply.text);
+        }
+        callback(reply, error);
+    }, time);
+}
+
+void ComunicatorPort::RecordingSerialCommunicator::cleanBuffer() {
+    inner_.cleanBuffer();
+}
+
+void ComunicatorPort::RecordingSerialCommunicator::close() {
+    inner_.close();
+    std::lock_guard<std::mutex> lock(fileMutex_);
+    out_.flush();
+}
+
+bool ComunicatorPort::RecordingSerialCommunicator::isConfigured() const {
+    return inner_.isConfigured();
+}
+
+bool ComunicatorPort::RecordingSerialCommunicator::enableBinaryFraming(int time) {
+    return inner_.enableBinaryFraming(time);
+}
+
+// Igual que M900, el cambio de velocidad y su comprobación no se graban.
+bool ComunicatorPort::RecordingSerialCommunicator::changeBaudRate(int speed, int time) {
+    return inner_.changeBaudRate(speed, time);
+}
+
+int ComunicatorPort::RecordingSerialCommunicator::getBaudRate() const {
+    return inner_.getBaudRate();
+}
+
+// El saludo inicial no se graba: al reproducir no hay placa que arranque.
+ComunicatorPort::HandshakeResult ComunicatorPort::RecordingSerialCommunicator::waitForFirmware(
+    const std::string& banner, std::chrono::milliseconds timeout) {
+    return inner_.waitForFirmware(banner, timeout);
+}
+
+bool ComunicatorPort::RecordingSerialCommunicator::linkLost() const {
+    return inner_.linkLost();
+}
+
+// --- ReplaySerialCommunicator ---
+
+ComunicatorPort::ReplaySerialCommunicator::ReplaySerialCommunicator(const std::string& path, double speed)
+    : speed_(speed > 0.0 ? speed : 1.0), replayStart_(std::chrono::steady_clock::now()) {
+    for (Transcript::Record& record : Transcript::load(path)) {
+        if (record.direction == Transcript::Direction::ToFirmware) {
+            sent_.push_back(std::move(record));
+        } else {
+            received_.push_back(std::move(record));
+        }
+    }
+    Logger::getInstance().log(LogLevel::INFO, "[Transcript] Reproduciendo '" + path + "' (" +
+        std::to_string(sent_.size()) + " comandos, " + std::to_string(received_.size()) +
+        " respuestas, velocidad x" + std::to_string(speed_) + ").");
+}
+
+void ComunicatorPort::ReplaySerialCommunicator::config(const std::string& port, int speed) {
+    (void)port; (void)speed;
+    std::lock_guard<std::mutex> lock(stateMutex_);
+    replayStart_ = std::chrono::steady_clock::now();
+    isConfigured_ = true;
+}
+
+std::string ComunicatorPort::ReplaySerialCommunicator::sendMessage(const std::string& message) {
+    std::lock_guard<std::mutex> lock(stateMutex_);
+    if (sentCursor_ >= sent_.size()) {
+        mismatches_++;
+        Logger::getInstance().log(LogLevel::WARNING, "[Transcript] Comando fuera de la grabación: " + trimCommand(message));
+        return "OK";
+    }
+    const Transcript::Record& record = sent_[sentCursor_++];
+    if (record.bytes != message) {
+        mismatches_++;
+        Logger::getInstance().log(LogLevel::WARNING, "[Transcript] Se envió '" + trimCommand(message) +
+            "' pero la grabación tenía '" + trimCommand(record.bytes) + "'.");
+    }
+    anchors_[record.exchangeId] = {record.timestampNs, std::chrono::steady_clock::now()};
+    return "OK";
+}
+
+std::string ComunicatorPort::ReplaySerialCommunicator::reciveMessage(int time) {
+    std::chrono::steady_clock::time_point due;
+    std::string response;
+    {
+        std::lock_guard<std::mutex> lock(stateMutex_);
+        if (receivedCursor_ >= received_.size()) {
+            // Grabación agotada: el puerto real habría agotado el tiempo de espera.
+            due = std::chrono::steady_clock::now() +
+                std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(time / speed_));
+        } else {
+            const Transcript::Record& record = received_[receivedCursor_++];
+            auto anchor = anchors_.find(record.exchangeId);
+            std::uint64_t recordedNs = record.timestampNs;
+            std::chrono::steady_clock::time_point replayedAt = replayStart_;
+            if (anchor != anchors_.end()) {
+                // Retardo original entre el comando y su respuesta.
+                recordedNs = record.timestampNs > anchor->second.first ? record.timestampNs - anchor->second.first : 0;
+                replayedAt = anchor->second.second;
+                anchors_.erase(anchor);
+            }
+            due = replayedAt + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                std::chrono::duration<double, std::nano>(recordedNs / speed_));
+            response = record.bytes;
+        }
+    }
+    std::this_thread::sleep_until(due);
+    return response;
+}
+
+void ComunicatorPort::ReplaySerialCommunicator::submitAsync(const std::string& command, ReplyCallback callback, int time) {
+    std::lock_guard<std::mutex> lock(exchangeMutex_);
+    ISerialCommunicator::submitAsync(command, std::move(callback), time);
+}
+
+void ComunicatorPort::ReplaySerialCommunicator::cleanBuffer() {
+    // Lo que el puerto real descartaba nunca llegó al servidor, así que no está grabado.
+}
+
+ComunicatorPort::HandshakeResult ComunicatorPort::ReplaySerialCommunicator::waitForFirmware(
+    const std::string& banner, std::chrono::milliseconds timeout) {
+    // No hay placa que arranque: la transcripción empieza con el firmware ya listo.
+    (void)banner;
+    (void)timeout;
+    HandshakeResult result;
+    result.ready = true;
+    return result;
+}
+
+bool ComunicatorPort::ReplaySerialCommunicator::changeBaudRate(int speed, int time) {
+    // Las respuestas grabadas no dependen de la velocidad a la que viajaron.
+    (void)speed;
+    (void)time;
+    return true;
+}
+
+void ComunicatorPort::ReplaySerialCommunicator::close() {
+    std::lock_guard<std::mutex> lock(stateMutex_);
+    isConfigured_ = false;
+}
+
+bool ComunicatorPort::ReplaySerialCommunicator::isConfigured() const {
+    std::lock_guard<std::mutex> lock(stateMutex_);
+    return isConfigured_;
+}
+
+bool ComunicatorPort::ReplaySerialCommunicator::finished() const {
+    std::lock_guard<std::mutex> lock(stateMutex_);
+    return receivedCursor_ >= received_.size();
+}
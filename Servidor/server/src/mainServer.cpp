@@ -1,16 +1,272 @@
 #include "Server.h"
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
 #include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
 #include "ServiceLocator.h"
 #include "SerialComunicator.h"
+#include "TranscriptCommunicator.h"
+#include "Exceptions.h"
+#include "Logger.h"
 
 int main(int argc, char* argv[]) {
+    // Opciones para trabajar sin hardware o capturar un incidente:
+    //   --record <archivo>   graba el tráfico serie real en una transcripción.
+    //   --replay <archivo>   reproduce una transcripción en lugar de abrir el puerto.
+    //   --speed <factor>     acelera la reproducción (por defecto 1).
+    //   --port <dispositivo> abre otro puerto en lugar de /dev/ttyUSB0 (p. ej. el emulador).
+    //   --framing <modo>     "binary" negocia tramas binarias con el firmware; "text" (por defecto).
+    //   --baud <n|auto>      velocidad del puerto serie tras el arranque (por defecto 115200);
+    //                        "auto" mide el enlace y elige la más rápida estable.
+    //   --status-poll <ms>   intervalo del muestreo de estado en segundo plano (por defecto 250;
+    //                        0 lo apaga y robot.getStatus vuelve a consultar al firmware).
+    //   --order-history <n>  órdenes por brazo que se guardan en memoria para los reportes (por defecto
+    //                        1000); las más viejas pasan a orders-<id>.csv.
+    //   --order-dir <carpeta> dónde se escriben los orders-<id>.csv (por defecto, la carpeta actual).
+    //   --robot <id>=<disp>  agrega un brazo con su propio puerto; se repite una vez por brazo.
+    //                        El primero es el brazo por defecto de los métodos RPC.
+    //   --rpc-port <n>       puerto del servidor XML-RPC (por defecto 8080).
+    //   --rpc-workers <n>    conexiones atendidas a la vez, una por hilo (por defecto 64).
+    //   --rpc-backlog <n>    conexiones en espera de un hilo libre (por defecto, igual a --rpc-workers).
+    //   --rpc-keepalive <s>  segundos que una conexión ociosa conserva su hilo (por defecto 15).
+    //   --rpc-keepalive-requests <n>  pedidos por conexión antes de cerrarla (por defecto 1000).
+    //   --web-root <carpeta> carpeta del index.html que se sirve en / (por defecto ../ClienteWeb);
+    //                        el cliente web llama a /rpc en JSON, sin el proxy de Node.js.
+    //   --session-idle <s>   segundos sin usar una sesión antes de que venza (por defecto 1800; 0 = nunca).
+    //   --session-ttl <s>    duración máxima de una sesión desde el login (por defecto 43200; 0 = nunca).
+    //   --log-flush <ms>     cada cuánto se escribe lo acumulado en el log (por defecto 50).
+    //   --log-durability <m> "buffered" (por defecto) o "fsync" para sincronizar cada tanda con el disco.
+    //   --log-overflow <m>   con la cola llena, "drop" descarta DEBUG/INFO (por defecto) y "block" espera.
+    //   --log-segment-mb <n> application.csv pasa a logs/ como segmento indexado al llegar a n MiB (por defecto 16).
+    //   --log-segment-age <s> ...o a los s segundos de su primera línea (por defecto 86400; 0 = nunca).
+    //   --log-level <n>      nivel mínimo: debug, info (por defecto), warning, error o critical.
+    //   --log-quiet <c,...>  silencia DEBUG e INFO de esas categorías: general, rpc, auth, serial,
+    //                        robot, database, tasks (p. ej. "--log-level debug --log-quiet rpc").
+    std::string recordPath;
+    std::string serialPort;
+    std::string replayPath;
+    double replaySpeed = 1.0;
+    bool binaryFraming = false;
+    int baudRate = RobotNamespace::Robot::BASE_BAUD;
+    int statusPollMs = RobotNamespace::Robot::DEFAULT_STATUS_POLL_MS;
+    long orderHistory = static_cast<long>(OrderHistory::DEFAULT_CAPACITY);
+    std::string orderDirectory = ".";
+    std::chrono::seconds sessionIdle = SessionManager::DEFAULT_IDLE_TTL;
+    std::chrono::seconds sessionTtl = SessionManager::DEFAULT_ABSOLUTE_TTL;
+    LoggerOptions logOptions;
+    std::vector<std::pair<std::string, std::string>> robotPorts;
+    RpcServiceHandlerNamespace::RpcServerConfig rpcConfig;
+    bool backlogGiven = false;
+    for (int i = 1; i < argc; i += 2) {
+        std::string option = argv[i];
+        if (i + 1 == argc) {
+            std::cerr << "Falta el valor de " << option << ". Uso: mainServer [--opción valor]..." << std::endl;
+            return 1;
+        }
+        try {
+            if (option.compare(0, 6, "--rpc-") == 0) {
+                int value = std::stoi(argv[i + 1]);
+                if (value <= 0) {
+                    std::cerr << "Valor inválido para " << option << ": " << argv[i + 1] << std::endl;
+                    return 1;
+                }
+                if (option == "--rpc-port") {
+                    rpcConfig.port = value;
+                } else if (option == "--rpc-workers") {
+                    rpcConfig.workers = value;
+                } else if (option == "--rpc-backlog") {
+                    rpcConfig.backlog = value;
+                    backlogGiven = true;
+                } else if (option == "--rpc-keepalive") {
+                    rpcConfig.keepaliveSeconds = value;
+                } else if (option == "--rpc-keepalive-requests") {
+                    rpcConfig.keepaliveRequests = value;
+                } else {
+                    std::cerr << "Opción desconocida: " << option << std::endl;
+                    return 1;
+                }
+                continue;
+            }
+            if (option == "--record") {
+                recordPath = argv[i + 1];
+            } else if (option == "--replay") {
+                replayPath = argv[i + 1];
+            } else if (option == "--port") {
+                serialPort = argv[i + 1];
+            } else if (option == "--speed") {
+                replaySpeed = std::stod(argv[i + 1]);
+                if (replaySpeed <= 0) {
+                    std::cerr << "Velocidad de reproducción inválida: " << argv[i + 1] << std::endl;
+                    return 1;
+                }
+            } else if (option == "--framing") {
+                std::string mode = argv[i + 1];
+                if (mode != "binary" && mode != "text") {
+                    std::cerr << "Modo de protocolo desconocido: " << mode << " (use binary o text)" << std::endl;
+                    return 1;
+                }
+                binaryFraming = (mode == "binary");
+            } else if (option == "--baud") {
+                std::string rate = argv[i + 1];
+                if (rate == "auto") {
+                    baudRate = RobotNamespace::Robot::AUTO_BAUD;
+                } else {
+                    baudRate = std::stoi(rate);
+                    if (!ConfigurationPort::SerialPortConfiguration::isSupportedRate(baudRate)) {
+                        std::cerr << "Velocidad no soportada: " << rate << std::endl;
+                        return 1;
+                    }
+                }
+            } else if (option == "--status-poll") {
+                statusPollMs = std::stoi(argv[i + 1]);
+                if (statusPollMs < 0) {
+                    std::cerr << "Intervalo de muestreo inválido: " << argv[i + 1] << std::endl;
+                    return 1;
+                }
+            } else if (option == "--order-history") {
+                orderHistory = std::stol(argv[i + 1]);
+                if (orderHistory <= 0) {
+                    std::cerr << "Capacidad del historial de órdenes inválida: " << argv[i + 1] << std::endl;
+                    return 1;
+                }
+            } else if (option == "--order-dir") {
+                orderDirectory = argv[i + 1];
+            } else if (option == "--session-idle" || option == "--session-ttl") {
+                int seconds = std::stoi(argv[i + 1]);
+                if (seconds < 0) {
+                    std::cerr << "Valor inválido para " << option << ": " << argv[i + 1] << std::endl;
+                    return 1;
+                }
+                (option == "--session-idle" ? sessionIdle : sessionTtl) = std::chrono::seconds(seconds);
+            } else if (option == "--log-flush") {
+                int intervalMs = std::stoi(argv[i + 1]);
+                if (intervalMs <= 0) {
+                    std::cerr << "Intervalo de log inválido: " << argv[i + 1] << std::endl;
+                    return 1;
+                }
+                logOptions.flushInterval = std::chrono::milliseconds(intervalMs);
+            } else if (option == "--log-durability") {
+                std::string mode = argv[i + 1];
+                if (mode != "buffered" && mode != "fsync") {
+                    std::cerr << "Durabilidad de log desconocida: " << mode << " (use buffered o fsync)" << std::endl;
+                    return 1;
+                }
+                logOptions.durability = mode == "fsync" ? LogDurability::FSYNC : LogDurability::BUFFERED;
+            } else if (option == "--log-overflow") {
+                std::string mode = argv[i + 1];
+                if (mode != "drop" && mode != "block") {
+                    std::cerr << "Política de log desconocida: " << mode << " (use drop o block)" << std::endl;
+                    return 1;
+                }
+                logOptions.overflow = mode == "block" ? LogOverflow::BLOCK : LogOverflow::DROP;
+            } else if (option == "--log-segment-mb" || option == "--log-segment-age") {
+                int value = std::stoi(argv[i + 1]);
+                if (value < 0 || (value == 0 && option == "--log-segment-mb")) {
+                    std::cerr << "Valor inválido para " << option << ": " << argv[i + 1] << std::endl;
+                    return 1;
+                }
+                if (option == "--log-segment-mb") {
+                    logOptions.segmentBytes = static_cast<std::uint64_t>(value) * 1024 * 1024;
+                } else {
+                    logOptions.segmentAge = std::chrono::seconds(value);
+                }
+            } else if (option == "--log-level") {
+                auto level = Logger::levelFromString(argv[i + 1]);
+                if (!level) {
+                    std::cerr << "Nivel de log desconocido: " << argv[i + 1] << " (use debug, info, warning, error o critical)" << std::endl;
+                    return 1;
+                }
+                Logger::setMinLevel(*level);
+            } else if (option == "--log-quiet") {
+                std::stringstream categories(argv[i + 1]);
+                std::string name;
+                while (std::getline(categories, name, ',')) {
+                    auto category = Logger::categoryFromString(name);
+                    if (!category) {
+                        std::cerr << "Categoría de log desconocida: " << name << std::endl;
+                        return 1;
+                    }
+                    Logger::setCategoryEnabled(*category, false);
+                }
+            } else if (option == "--web-root") {
+                rpcConfig.webRoot = argv[i + 1];
+            } else if (option == "--robot") {
+                std::string spec = argv[i + 1];
+                std::size_t equals = spec.find('=');
+                if (equals == std::string::npos || equals == 0 || equals + 1 == spec.size()) {
+                    std::cerr << "Formato de robot inválido: " << spec << " (use <id>=<dispositivo>)" << std::endl;
+                    return 1;
+                }
+                robotPorts.emplace_back(spec.substr(0, equals), spec.substr(equals + 1));
+            } else {
+                std::cerr << "Opción desconocida: " << option << std::endl;
+                return 1;
+            }
+        } catch (const std::invalid_argument&) {
+            std::cerr << "Valor inválido para " << option << ": " << argv[i + 1] << std::endl;
+            return 1;
+        } catch (const std::out_of_range&) {
+            std::cerr << "Valor fuera de rango para " << option << ": " << argv[i + 1] << std::endl;
+            return 1;
+        }
+    }
+
+    if (!backlogGiven) {
+        rpcConfig.backlog = rpcConfig.workers; // Que entren todos los clientes aunque los hilos estén ocupados.
+    }
+
+    if (!robotPorts.empty() && (!serialPort.empty() || !recordPath.empty() || !replayPath.empty())) {
+        std::cerr << "--robot no se combina con --port, --record ni --replay (son para un solo brazo)." << std::endl;
+        return 1;
+    }
+    if (baudRate == RobotNamespace::Robot::AUTO_BAUD && !replayPath.empty()) {
+        std::cerr << "--baud auto necesita un enlace real; no se combina con --replay." << std::endl;
+        return 1;
+    }
+
+    Logger::getInstance().configure(logOptions);
+
     // 1. Creamos el objeto principal de la aplicación.
     Server serverApp;
-    
+    try {
+        if (robotPorts.empty()) {
+            serverApp.addRobot(RobotNamespace::RobotRegistry::DEFAULT_ROBOT_ID, serialPort);
+        }
+        for (const auto& robotPort : robotPorts) {
+            // Cada brazo tiene su propio comunicador y, con él, su propio hilo de E/S.
+            serverApp.addRobot(robotPort.first, robotPort.second, std::make_unique<ComunicatorPort::SerialComunicator>());
+        }
+    } catch (const RobotException& e) {
+        std::cerr << e.what() << std::endl;
+        return 1;
+    }
+    serverApp.setBinaryFraming(binaryFraming);
+    serverApp.setBaudRate(baudRate);
+    serverApp.setStatusPollInterval(statusPollMs);
+    serverApp.setOrderHistoryCapacity(static_cast<std::size_t>(orderHistory));
+    serverApp.setOrderSpillDirectory(orderDirectory);
+    serverApp.setRpcConfig(rpcConfig);
+    serverApp.setSessionTimeouts(sessionIdle, sessionTtl);
+
 
-    // Creamos el comunicador real y lo registramos en el ServiceLocator.
+    // Creamos el comunicador (real, grabado o reproducido) y lo registramos en el ServiceLocator.
     ComunicatorPort::SerialComunicator realCommunicator;
-    ServiceLocator::provide(&realCommunicator);
+    std::unique_ptr<ComunicatorPort::ISerialCommunicator> transcriptCommunicator;
+    if (!replayPath.empty()) {
+        transcriptCommunicator = std::make_unique<ComunicatorPort::ReplaySerialCommunicator>(replayPath, replaySpeed);
+        ServiceLocator::provide(transcriptCommunicator.get());
+    } else if (!recordPath.empty()) {
+        transcriptCommunicator = std::make_unique<ComunicatorPort::RecordingSerialCommunicator>(realCommunicator, recordPath);
+        ServiceLocator::provide(transcriptCommunicator.get());
+    } else {
+        ServiceLocator::provide(&realCommunicator);
+    }
 
 
     // 2. Ejecutamos el servidor. La clase Server se encargará de
@@ -18,4 +274,4 @@ int main(int argc, char* argv[]) {
     serverApp.run();
 
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,505 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+#include "SerialComunicator.h"
+#include "BinaryFraming.h"
+#include "RobotRegistry.h"
+#include "Exceptions.h"
+#include <iostream>
+#include <string>
+#include <vector>
+#include <future>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <cstdlib>
+#include <csignal>
+#include <unistd.h>
+#include <sys/wait.h>
+
+// --- Firmware emulado en un proceso aparte ---
+// Lanza bin/firmware_emulator (o el indicado en FIRMWARE_EMULATOR) con un reloj
+// acelerado y espera a que publique su pty.
+class EmulatedFirmware {
+public:
+    /// @param noise Si no es 0, el emulador corrompe uno de cada 'noise' bytes recibidos.
+    /// @param bootMs Milisegundos que tarda el bootloader en cada conexión.
+    /// @param maxBaud Si no es 0, la línea viaja a la velocidad del firmware y falla por encima de esta.
+    explicit EmulatedFirmware(double speed, unsigned long noise = 0, int bootMs = 0, long maxBaud = 0)
+        : speed_(speed), noise_(noise), bootMs_(bootMs), maxBaud_(maxBaud) {
+        static int instances = 0; // Varios emuladores a la vez necesitan pty distintos.
+        linkPath_ = "/tmp/firmware_emulator_test_" + std::to_string(getpid()) + "_" + std::to_string(instances++);
+        launch();
+    }
+
+    ~EmulatedFirmware() {
+        stop();
+    }
+
+    /// @brief Mata el emulador (el servidor ve el enlace colgado) y lo vuelve a lanzar
+    /// en la misma ruta, como una placa que se desconecta y reaparece.
+    void restart() {
+        stop();
+        launch();
+    }
+
+    const std::string& port() const { return linkPath_; }
+
+private:
+    void launch() {
+        const char* binary = std::getenv("FIRMWARE_EMULATOR");
+        std::string path = binary ? binary : "./bin/firmware_emulator";
+        std::string speedText = std::to_string(speed_);
+        std::string noiseText = std::to_string(noise_);
+        std::string bootText = std::to_string(bootMs_);
+        std::string maxBaudText = std::to_string(maxBaud_);
+
+        pid_ = fork();
+        REQUIRE(pid_ != -1);
+        if (pid_ == 0) {
+            execl(path.c_str(), path.c_str(), "--speed", speedText.c_str(), "--link", linkPath_.c_str(),
+                  "--noise", noiseText.c_str(), "--boot-ms", bootText.c_str(), "--max-baud", maxBaudText.c_str(),
+                  (char*)nullptr);
+            _exit(127);
+        }
+        for (int i = 0; i < 200 && access(linkPath_.c_str(), F_OK) != 0; ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        REQUIRE_MESSAGE(access(linkPath_.c_str(), F_OK) == 0, "No arrancó el emulador: " << path);
+    }
+
+    void stop() {
+        kill(pid_, SIGTERM);
+        waitpid(pid_, nullptr, 0);
+    }
+
+    double speed_;
+    unsigned long noise_;
+    int bootMs_;
+    long maxBaud_;
+    pid_t pid_ = -1;
+    std::string linkPath_;
+};
+
+static double elapsedMs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+TEST_SUITE("Firmware emulado sobre un pty") {
+
+    TEST_CASE("El firmware real responde por el pty con el reloj acelerado") {
+        const double speed = 20.0;
+        EmulatedFirmware firmware(speed);
+        ComunicatorPort::SerialComunicator serial;
+        serial.config(firmware.port(), 115200);
+
+        // Al abrir el puerto la placa "se reinicia" y envía su mensaje de arranque (sin OK).
+        std::string banner = serial.reciveMessage(1);
+        CHECK(banner.find("INFO: ROBOT ONLINE") != std::string::npos);
+
+        std::string status = serial.submit("M114\r\n").get().text;
+        CHECK(status.find("ABSOLUTE MODE") != std::string::npos);
+        CHECK(status.find("CURRENT POSITION: [X:0.00 Y:170.00 Z:120.00 E:0.00]") != std::string::npos);
+
+        // Un comando desconocido produce ERROR y luego OK.
+        ComunicatorPort::SerialReply unknown = serial.submit("M999\r\n").get();
+        CHECK(unknown.error);
+        CHECK(unknown.text.find("COMMAND NOT RECOGNIZED") != std::string::npos);
+
+        // El siguiente comando se ejecuta recién al terminar la interpolación:
+        // 20 mm a sqrt(20)*10 mm/s son ~450 ms reales, ~22 ms con el reloj x20.
+        auto start = std::chrono::steady_clock::now();
+        std::future<ComunicatorPort::SerialReply> move = serial.submit("G1 X0 Y170 Z100\r\n");
+        std::string after = serial.submit("M114\r\n").get().text;
+        double moveMs = elapsedMs(start);
+        CHECK(move.get().text.find("LINEAR MOVE") != std::string::npos);
+        CHECK(after.find("Z:100.00") != std::string::npos);
+        std::cout << "  [BENCH] Movimiento de 20 mm con reloj x" << speed << ": " << moveMs << " ms" << std::endl;
+        CHECK(moveMs < 450.0);
+
+        // Throughput: comandos sin movimiento con la ventana completa del hilo de E/S.
+        const int commands = 200; // Por debajo de la capacidad de la cola de envío (256).
+        std::vector<std::future<ComunicatorPort::SerialReply>> replies;
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < commands; ++i) {
+            replies.push_back(serial.submit(i % 2 == 0 ? "M17\r\n" : "M18\r\n"));
+        }
+        int completed = 0;
+        for (auto& reply : replies) {
+            completed += reply.get().complete ? 1 : 0;
+        }
+        double totalMs = elapsedMs(start);
+        std::cout << "  [BENCH] " << commands << " comandos en " << totalMs << " ms ("
+                  << commands * 1000.0 / totalMs << " comandos/s, " << totalMs / commands
+                  << " ms por comando)" << std::endl;
+        CHECK(completed == commands);
+
+        serial.close();
+    }
+
+    TEST_CASE("El protocolo binario negociado con M900 reduce los bytes por movimiento") {
+        std::string frame;
+        REQUIRE(ComunicatorPort::Framing::encodeCommand("G1 X10.5 Y-20 Z30 E0.0\r\n", 7, frame));
+        CHECK(static_cast<std::uint8_t>(frame[1]) == ComunicatorPort::Framing::MOVE);
+        CHECK(frame.size() == ComunicatorPort::Framing::HEADER_SIZE + ComunicatorPort::Framing::MOVE_PAYLOAD + 2);
+        REQUIRE(ComunicatorPort::Framing::encodeCommand("M114\r\n", 8, frame));
+        CHECK(static_cast<std::uint8_t>(frame[1]) == ComunicatorPort::Framing::TEXT);
+
+        EmulatedFirmware firmware(20.0);
+        ComunicatorPort::SerialComunicator serial;
+        serial.config(firmware.port(), 115200);
+        serial.reciveMessage(1); // Mensaje de arranque.
+
+        // Los mismos movimientos en texto y luego en binario.
+        const std::vector<std::string> moves = {"G1 X10.00 Y160.00 Z110.00 E0.0\r\n", "G1 X0.00 Y170.00 Z120.00 E0.0\r\n"};
+        std::size_t textBytes = 0;
+        for (const auto& move : moves) {
+            ComunicatorPort::SerialReply reply = serial.submit(move).get();
+            CHECK(reply.complete);
+            textBytes += reply.wireBytesSent + reply.wireBytesReceived;
+        }
+
+        REQUIRE(serial.enableBinaryFraming());
+        CHECK(serial.isBinaryFraming());
+        std::size_t binaryBytes = 0;
+        for (const auto& move : moves) {
+            ComunicatorPort::SerialReply reply = serial.submit(move).get();
+            CHECK(reply.complete);
+            CHECK_FALSE(reply.error);
+            binaryBytes += reply.wireBytesSent + reply.wireBytesReceived;
+        }
+        std::cout << "  [BENCH] Bytes por movimiento (envío + respuesta): texto " << textBytes / moves.size()
+                  << ", binario " << binaryBytes / moves.size() << std::endl;
+        CHECK(binaryBytes * 2 < textBytes);
+
+        // El resto del G-Code viaja como texto dentro de una trama, con sus líneas INFO.
+        std::string status = serial.submit("M114\r\n").get().text;
+        CHECK(status.find("CURRENT POSITION: [X:0.00 Y:170.00 Z:120.00 E:0.00]") != std::string::npos);
+        CHECK(status.find("OK") != std::string::npos);
+
+        // Un comando desconocido se confirma con error igual que en texto.
+        ComunicatorPort::SerialReply unknown = serial.submit("M999\r\n").get();
+        CHECK(unknown.complete);
+        CHECK(unknown.error);
+        CHECK(unknown.text.find("COMMAND NOT RECOGNIZED") != std::string::npos);
+
+        // Las líneas que no son G/M tienen su ACK en binario (en texto no tienen "OK").
+        ComunicatorPort::SerialReply garbage = serial.submit("HOLA\r\n").get();
+        CHECK(garbage.complete);
+        CHECK(garbage.error);
+
+        // Al reconectar la placa vuelve a texto.
+        serial.close();
+        CHECK_FALSE(serial.isBinaryFraming());
+    }
+
+    TEST_CASE("Las tramas dañadas por ruido se reenvían hasta llegar") {
+        // Uno de cada 97 bytes recibidos por el firmware llega con un bit invertido.
+        EmulatedFirmware firmware(50.0, 97);
+        ComunicatorPort::SerialComunicator serial;
+        serial.config(firmware.port(), 115200);
+        serial.reciveMessage(1);
+        REQUIRE(serial.enableBinaryFraming());
+
+        const int commands = 150;
+        std::vector<std::future<ComunicatorPort::SerialReply>> replies;
+        for (int i = 0; i < commands; ++i) {
+            // Movimientos cortos alternados con cambios de motores y de modo.
+            switch (i % 3) {
+                case 0: replies.push_back(serial.submit("G1 X" + std::to_string(i % 10) + " Y170 Z120\r\n", 10)); break;
+                case 1: replies.push_back(serial.submit(i % 2 ? "M17\r\n" : "M18\r\n", 10)); break;
+                default: replies.push_back(serial.submit("G90\r\n", 10)); break;
+            }
+        }
+        int completed = 0;
+        for (auto& reply : replies) {
+            ComunicatorPort::SerialReply r = reply.get();
+            completed += (r.complete && !r.error) ? 1 : 0;
+        }
+        std::cout << "  [BENCH] " << commands << " comandos con ruido: " << serial.framesResent()
+                  << " tramas reenviadas" << std::endl;
+        CHECK(completed == commands);
+        CHECK(serial.framesResent() > 0);
+
+        // Nada se ejecutó dos veces ni fuera de orden: la última posición es la del último G1.
+        std::string status = serial.submit("M114\r\n", 10).get().text;
+        CHECK(status.find("CURRENT POSITION: [X:" + std::to_string((commands - 3) % 10) + ".00 Y:170.00 Z:120.00") != std::string::npos);
+        serial.close();
+    }
+    TEST_CASE("Un registro de robots maneja varios brazos en paralelo") {
+        EmulatedFirmware firmwareA(20.0);
+        EmulatedFirmware firmwareB(20.0);
+
+        RobotNamespace::RobotRegistry robots;
+        robots.add("brazoA", firmwareA.port(), std::make_unique<ComunicatorPort::SerialComunicator>());
+        robots.add("brazoB", firmwareB.port(), std::make_unique<ComunicatorPort::SerialComunicator>());
+        CHECK(robots.ids() == std::vector<std::string>{"brazoA", "brazoB"});
+        CHECK(robots.getDefaultId() == "brazoA");
+        CHECK(&robots.get("") == &robots.get("brazoA"));
+        CHECK_THROWS_AS(robots.get("brazoC"), RobotException);
+        CHECK_THROWS_AS(robots.add("brazoB", "/dev/null"), RobotException);
+
+        // Cada brazo conecta por su propio puerto; las esperas de arranque se solapan.
+        auto start = std::chrono::steady_clock::now();
+        auto connectA = std::async(std::launch::async, [&robots]() { robots.get("brazoA").connect(); });
+        auto connectB = std::async(std::launch::async, [&robots]() { robots.get("brazoB").connect(); });
+        connectA.get();
+        connectB.get();
+        CHECK(elapsedMs(start) < 3500.0);
+
+        // Ida y vuelta de 40 mm en Z, varias veces.
+        std::vector<std::string> task;
+        for (int i = 0; i < 6; ++i) {
+            task.push_back(i % 2 == 0 ? "G1 X0 Y170 Z80" : "G1 X0 Y170 Z120");
+        }
+        task.push_back("G1 X0 Y170 Z90");
+
+        start = std::chrono::steady_clock::now();
+        std::vector<GCodeLineResult> alone = robots.get("brazoA").streamGCode(task);
+        double aloneMs = elapsedMs(start);
+
+        start = std::chrono::steady_clock::now();
+        auto streamA = std::async(std::launch::async, [&]() { return robots.get("brazoA").streamGCode(task); });
+        auto streamB = std::async(std::launch::async, [&]() { return robots.get("brazoB").streamGCode(task); });
+        std::vector<GCodeLineResult> resultsA = streamA.get();
+        std::vector<GCodeLineResult> resultsB = streamB.get();
+        double parallelMs = elapsedMs(start);
+        std::cout << "  [BENCH] Tarea de " << task.size() << " movimientos: un brazo " << aloneMs
+                  << " ms, dos brazos en paralelo " << parallelMs << " ms" << std::endl;
+
+        for (const auto& results : {alone, resultsA, resultsB}) {
+            REQUIRE(results.size() == task.size());
+            for (const auto& result : results) {
+                CHECK(result.success);
+            }
+        }
+        // Si los brazos compartieran un hilo o un puerto, el doble de trabajo tardaría el doble.
+        CHECK(parallelMs < aloneMs * 1.6);
+
+        CHECK(robots.get("brazoA").getStatus().currentPosition.z == doctest::Approx(90.0));
+        CHECK(robots.get("brazoB").getStatus().currentPosition.z == doctest::Approx(90.0));
+        robots.get("brazoA").disconnect();
+        robots.get("brazoB").disconnect();
+    }
+    TEST_CASE("El saludo termina apenas arranca el firmware y el enlace se recupera solo") {
+        // Sin mensaje de arranque reconocible, el firmware se detecta por su respuesta a M114.
+        {
+            EmulatedFirmware firmware(20.0);
+            ComunicatorPort::SerialComunicator serial;
+            serial.config(firmware.port(), 115200);
+            ComunicatorPort::HandshakeResult probed = serial.waitForFirmware("NO EXISTE", std::chrono::milliseconds(3000));
+            CHECK(probed.ready);
+            CHECK_FALSE(probed.bannerSeen);
+            CHECK(probed.probes >= 1);
+            // Lo que quedó del arranque y de los sondeos se descartó: la próxima respuesta es limpia.
+            std::string status = serial.submit("M114\r\n").get().text;
+            CHECK(status.find("ROBOT ONLINE") == std::string::npos);
+            CHECK(status.find("CURRENT POSITION") != std::string::npos);
+            serial.close();
+        }
+
+        // Una placa que tarda 300 ms en arrancar: la conexión dura eso y no los 2 s fijos de antes.
+        const int bootMs = 300;
+        EmulatedFirmware firmware(20.0, 0, bootMs);
+        ComunicatorPort::SerialComunicator serial;
+        RobotNamespace::Robot robot;
+        robot.setSerialPort(firmware.port());
+        robot.setCommunicator(&serial);
+
+        auto start = std::chrono::steady_clock::now();
+        robot.connect();
+        double connectMs = elapsedMs(start);
+        std::cout << "  [BENCH] Conexión con arranque de " << bootMs << " ms: " << connectMs << " ms" << std::endl;
+        CHECK(connectMs >= bootMs);
+        CHECK(connectMs < bootMs + 500.0);
+        CHECK(robot.getStatus().currentPosition.y == doctest::Approx(170.0));
+        robot.setCoordinateMode(false);
+
+        // La placa desaparece y vuelve: el próximo comando reabre el puerto por su cuenta.
+        firmware.restart();
+        for (int i = 0; i < 100 && !serial.linkLost(); ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        REQUIRE(serial.linkLost());
+
+        // Varios pedidos ven el enlace caído a la vez: uno solo reabre el puerto.
+        start = std::chrono::steady_clock::now();
+        std::vector<std::thread> others;
+        for (int i = 0; i < 3; ++i) {
+            others.emplace_back([&robot] { robot.getStatus(); });
+        }
+        RobotStatus status = robot.getStatus();
+        double reconnectMs = elapsedMs(start);
+        for (auto& other : others) {
+            other.join();
+        }
+        std::cout << "  [BENCH] Reconexión automática: " << reconnectMs << " ms" << std::endl;
+        CHECK(robot.getReconnectCount() == 1);
+        CHECK(status.isConnected);
+        CHECK_FALSE(status.isAbsolute); // El modo relativo se restauró tras el reinicio de la placa.
+        CHECK(status.currentPosition.y == doctest::Approx(170.0));
+        CHECK(reconnectMs < bootMs + 500.0);
+
+        robot.disconnect();
+    }
+
+    TEST_CASE("La medición del enlace elige la velocidad más rápida que la línea sostiene") {
+        // La línea emulada transporta 10 bits por byte a la velocidad del firmware y por
+        // encima de 500000 baudios corrompe bytes, como un adaptador que no da para más.
+        EmulatedFirmware firmware(20.0, 0, 0, 500000);
+        ComunicatorPort::SerialComunicator serial;
+        RobotNamespace::Robot robot;
+        robot.setSerialPort(firmware.port());
+        robot.setCommunicator(&serial);
+        robot.setBaudRate(RobotNamespace::Robot::AUTO_BAUD);
+
+        robot.connect();
+        const ComunicatorPort::BaudSelection& selection = robot.getBaudSelection();
+        for (const auto& sample : selection.samples) {
+            std::cout << "  [BENCH] " << sample.baudRate << " baudios: " << sample.commandsPerSecond << " cmd/s, "
+                      << sample.bytesSentPerSecond << " B/s enviados, " << sample.bytesReceivedPerSecond << " B/s recibidos"
+                      << (sample.stable ? "" : " (inestable)") << std::endl;
+        }
+        CHECK(robot.getLinkBaudRate() == 500000);
+        CHECK(selection.baudRate == 500000);
+
+        REQUIRE(selection.samples.size() >= 3);
+        const ComunicatorPort::ThroughputSample& base = selection.samples.front();
+        CHECK(base.baudRate == RobotNamespace::Robot::BASE_BAUD);
+        CHECK(base.stable);
+        CHECK(base.bytesReceivedPerSecond < 11520.0); // Nunca más de lo que la línea transporta.
+        CHECK_FALSE(selection.samples.back().stable); // 1000000 falla y la prueba se detiene ahí.
+        for (const auto& sample : selection.samples) {
+            if (sample.baudRate == 250000) {
+                CHECK(sample.stable); // Velocidad no estándar, configurada con BOTHER.
+            }
+            if (sample.baudRate == 500000) {
+                CHECK(sample.commandsPerSecond > base.commandsPerSecond * 2.0);
+            }
+        }
+
+        // El enlace sigue sano a la velocidad elegida.
+        CHECK(robot.getStatus().currentPosition.y == doctest::Approx(170.0));
+        robot.disconnect();
+    }
+
+    TEST_CASE("robot.getStatus responde desde la muestra en memoria y el muestreo se espacia si nada cambia") {
+        EmulatedFirmware firmware(20.0);
+        ComunicatorPort::SerialComunicator serial;
+        RobotNamespace::Robot robot;
+        robot.setSerialPort(firmware.port());
+        robot.setCommunicator(&serial);
+        robot.setStatusPollInterval(50);
+        robot.connect();
+        robot.enableMotors();
+
+        auto m114Count = [&robot]() -> std::uint64_t {
+            for (const auto& family : robot.getLinkStats().snapshot().families) {
+                if (family.family == "M114") return family.count;
+            }
+            return 0;
+        };
+
+        // El muestreador ve el movimiento sin que nadie pida el estado.
+        robot.sendRawGCode("G1 X0 Y170 Z60");
+        RobotStatus status;
+        for (int i = 0; i < 100; ++i) {
+            status = robot.getStatus(RobotNamespace::Robot::ANY_STALENESS);
+            if (status.currentPosition.z == doctest::Approx(60.0)) break;
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        }
+        CHECK(status.currentPosition.z == doctest::Approx(60.0));
+        CHECK(status.areMotorsEnabled);
+
+        // Lo que no es G ni M no viaja: el firmware no le respondería OK y se llevaría la
+        // respuesta del M114 del muestreador.
+        CHECK_THROWS_AS(robot.sendRawGCode("HOLA"), RobotException);
+        CHECK_THROWS_AS(robot.sendRawGCode(""), RobotException);
+        CHECK(robot.getStatus(0).currentPosition.z == doctest::Approx(60.0));
+
+        // Varios lectores que piden el estado fresco a la vez: cada uno lee su propio M114.
+        std::atomic<int> wrongReads{0};
+        std::vector<std::thread> readers;
+        for (int t = 0; t < 4; ++t) {
+            readers.emplace_back([&robot, &wrongReads] {
+                for (int i = 0; i < 20; ++i) {
+                    RobotStatus fresh = robot.getStatus(0);
+                    if (fresh.currentPosition.z != doctest::Approx(60.0) || fresh.statusAgeMs < 0) wrongReads++;
+                }
+            });
+        }
+        for (auto& reader : readers) reader.join();
+        CHECK(wrongReads == 0);
+
+        // Desde memoria: las lecturas no mandan M114; los pocos que aparezcan son del muestreador.
+        std::uint64_t before = m114Count();
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < 10000; ++i) {
+            status = robot.getStatus(RobotNamespace::Robot::ANY_STALENESS);
+        }
+        double perCallUs = elapsedMs(start) * 1000.0 / 10000;
+        std::cout << "  [BENCH] getStatus desde memoria: " << perCallUs << " us por llamada" << std::endl;
+        CHECK(m114Count() - before < 100);
+        CHECK(status.currentPosition.z == doctest::Approx(60.0));
+        CHECK(status.statusAgeMs >= 0);
+
+        // Quieto, el intervalo se duplica: en 1,5 s hay muchos menos de los 30 M114 de un ritmo fijo.
+        std::this_thread::sleep_for(std::chrono::milliseconds(1500));
+        std::uint64_t idlePolls = m114Count() - before;
+        std::cout << "  [BENCH] M114 del muestreador en 1,5 s quieto: " << idlePolls << std::endl;
+        CHECK(idlePolls >= 2);
+        CHECK(idlePolls < 12);
+
+        // Con antigüedad máxima 0 se lee al firmware en el momento: la muestra es posterior al pedido.
+        before = m114Count();
+        auto requested = std::chrono::steady_clock::now();
+        status = robot.getStatus(0);
+        CHECK(m114Count() > before);
+        CHECK(status.statusAgeMs >= 0);
+        CHECK(status.statusAgeMs <= elapsedMs(requested));
+        robot.disconnect();
+        CHECK_FALSE(robot.getStatus(RobotNamespace::Robot::ANY_STALENESS).isConnected);
+    }
+
+    TEST_CASE("Cada movimiento tiene un id y se da por terminado cuando el firmware lo confirma") {
+        EmulatedFirmware firmware(1.0); // Reloj real: la duración estimada tiene que coincidir.
+        ComunicatorPort::SerialComunicator serial;
+        RobotNamespace::Robot robot;
+        robot.setSerialPort(firmware.port());
+        robot.setCommunicator(&serial);
+        robot.setStatusPollInterval(0); // Sin muestreador: la confirmación la pide waitMotion().
+        robot.connect();
+        robot.enableMotors();
+
+        // Desde el arranque (0, 170, 120): 60 mm a sqrt(60) * 10 mm/s, unos 775 ms.
+        std::uint64_t first = robot.moveTo(Position(0, 170, 60), 0.0);
+        MotionJob job = robot.waitMotion(first, 0);
+        CHECK(job.state == "EN_CURSO");
+        CHECK(job.predictedMs == doctest::Approx(774.6).epsilon(0.01));
+        CHECK(robot.getRobotStatus().activityState == "MOVIENDO");
+        CHECK(robot.waitMotion(first, 100).state == "EN_CURSO"); // Vence antes del fin estimado.
+
+        auto start = std::chrono::steady_clock::now();
+        job = robot.waitMotion(first, 5000);
+        double waitedMs = elapsedMs(start);
+        std::cout << "  [BENCH] Movimiento " << job.id << ": estimado " << job.predictedMs << " ms, confirmado a los "
+                  << job.elapsedMs << " ms" << std::endl;
+        CHECK(job.state == "COMPLETADO");
+        CHECK(job.elapsedMs >= job.predictedMs - 50);
+        CHECK(waitedMs < job.predictedMs + 500);
+        RobotStatus status = robot.getRobotStatus();
+        CHECK(status.activityState == "EN_POSICION");
+        CHECK(status.currentPosition.z == doctest::Approx(60.0));
+
+        // El OK del segundo llega cuando el firmware terminó el primero: ya no está en curso.
+        std::uint64_t up = robot.moveTo(Position(0, 170, 120), 0.0);
+        std::uint64_t down = robot.moveTo(Position(0, 170, 90), 0.0);
+        CHECK(robot.waitMotion(up, 0).state == "COMPLETADO");
+        job = robot.waitMotion(0, 5000);
+        CHECK(job.id == down);
+        CHECK(job.state == "COMPLETADO");
+        CHECK(job.target.z == doctest::Approx(90.0));
+
+        CHECK_THROWS_AS(robot.waitMotion(down + 100, 0), RobotException);
+        robot.disconnect();
+    }
+}
@@ -0,0 +1,63 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+#include "GCodeOptimizer.h"
+#include <string>
+#include <vector>
+
+using GCodeNamespace::GCodeOptimizer;
+using GCodeNamespace::OptimizedProgram;
+
+TEST_SUITE("Optimizador de G-Code de las tareas") {
+
+    TEST_CASE("Fusiona tramos colineales y descarta lo que no cambia nada") {
+        std::vector<std::string> gcode = {
+            "G90",
+            "M3",
+            "G1 X0 Y0 Z0",
+            "G1 X10 Y10 Z0 F50",   // línea 4
+            "G1 X20 Y20 F50",      // línea 5: sigue la misma recta, con la misma F
+            "g1 x30 y30 z0 f50",   // línea 6: también
+            "; comentario",
+            "",
+            "M3",              // el efector ya está encendido
+            "G90",             // el modo ya es absoluto
+            "G1 X30 Y30",      // no se mueve
+            "G1 F2000",        // F no es modal: no hace nada
+            "G1 X30 Y40",      // línea 13: cambia de dirección
+            "G91",
+            "G1 X5 F100",      // línea 15
+            "G1 X5 F100",      // línea 16: misma recta, misma F
+            "G1 X5 F200",      // línea 17: otra F, no se fusiona
+            "G1 X-5 F200",     // línea 18: vuelve atrás, no se fusiona
+            "G1 X5",           // línea 19: sin F la velocidad depende del largo del tramo,
+            "G1 X5",           // línea 20: así que no se fusiona
+            "G1 X5 F3",        // línea 21: F < 5 el firmware la ignora: tampoco
+            "G1 X5 F3",        // línea 22
+            "M5",
+        };
+
+        OptimizedProgram program = GCodeOptimizer::optimize(gcode);
+        CHECK(program.sourceLines == gcode.size());
+        CHECK(program.commands() == std::vector<std::string>{
+            "G90", "M3", "G1 X0 Y0 Z0", "G1 X30 Y30 Z0 F50", "G1 X30 Y40", "G91",
+            "G1 X10 F100", "G1 X5 F200", "G1 X-5 F200", "G1 X5", "G1 X5", "G1 X5 F3", "G1 X5 F3", "M5"});
+
+        // Los errores se informan con las líneas originales.
+        CHECK(program.describeSource(3) == "líneas 4-6");
+        CHECK(program.describeSource(4) == "línea 13");
+        CHECK(program.describeSource(6) == "líneas 15-16");
+        CHECK(program.describeSource(9) == "línea 19");
+        CHECK(program.describeSource(13) == "línea 23");
+    }
+
+    TEST_CASE("Sin conocer el estado no se descarta ni se fusiona nada") {
+        // La tarea puede empezar en cualquier modo: los G1 sin G90/G91 previo viajan intactos,
+        // y un comando desconocido (G28) olvida lo deducido hasta ahí.
+        std::vector<std::string> gcode = {
+            "G1 X10", "G1 X20", "M3", "M3",
+            "G90", "G1 X0", "G28", "G1 X0", "G90", "G1 X5", "G1 X10 Y0", "M3"};
+        OptimizedProgram program = GCodeOptimizer::optimize(gcode);
+        CHECK(program.commands() == std::vector<std::string>{
+            "G1 X10", "G1 X20", "M3", "G90", "G1 X0", "G28", "G1 X0", "G90", "G1 X5", "G1 X10 Y0", "M3"});
+    }
+}
@@ -0,0 +1,114 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+#include "RpcHttpEndpoint.h"
+#include "RpcServiceHandler.h"
+#include "AuthenticationService.h"
+#include "DatabaseManager.h"
+#include "SessionManager.h"
+#include "RobotRegistry.h"
+#include "TaskManager.h"
+#include <xmlrpc-c/base.hpp>
+#include <xmlrpc-c/json.h>
+#include <xmlrpc-c/registry.hpp>
+#include <cstdio>
+#include <map>
+#include <regex>
+#include <string>
+#include <unistd.h>
+
+// Los mismos servicios que arma Server, con el endpoint JSON llamado sin HTTP.
+struct InProcessServer {
+    std::string dbPath = "/tmp/json_rpc_test_" + std::to_string(getpid()) + ".db";
+    DatabaseManagerNamespace::DatabaseManager db{dbPath};
+    SessionManager sessions;
+    AuthenticationServiceNamespace::AuthenticationService auth{db, sessions};
+    RobotNamespace::RobotRegistry robots;
+    TaskManager tasks{"/tmp/json_rpc_test_tasks.json"};
+    RpcServiceHandlerNamespace::RpcServiceHandler handler{auth, robots, tasks};
+    xmlrpc_c::registry registry;
+
+    InProcessServer() {
+        robots.add(RobotNamespace::RobotRegistry::DEFAULT_ROBOT_ID, "");
+        robots.setStatusPollInterval(0);
+        handler.registerMethods(registry);
+    }
+
+    ~InProcessServer() {
+        std::remove(dbPath.c_str());
+    }
+};
+
+// xmlrpc_serialize_json escribe los reales con exponente (0.000000e+00), que JSON admite
+// pero el propio xmlrpc_parse_json no lee: se pasan a notación fija antes de parsear.
+static std::string fixedDoubles(const std::string& json) {
+    // Solo en posición de valor, para no tocar strings como los tokens hexadecimales.
+    static const std::regex exponent(R"(([:\[,]\s*)(-?\d+(\.\d+)?[eE][+-]?\d+))");
+    std::string out;
+    std::size_t last = 0;
+    for (std::sregex_iterator it(json.begin(), json.end(), exponent), end; it != end; ++it) {
+        out.append(json, last, it->position(2) - last);
+        out += std::to_string(std::stod(it->str(2)));
+        last = it->position(2) + it->length(2);
+    }
+    return out + json.substr(last);
+}
+
+static std::map<std::string, xmlrpc_c::value> parse(const std::string& json) {
+    xmlrpc_env env;
+    xmlrpc_env_init(&env);
+    xmlrpc_value* parsed = xmlrpc_parse_json(&env, fixedDoubles(json).c_str());
+    REQUIRE_MESSAGE(!env.fault_occurred, json);
+    xmlrpc_c::value const value(parsed);
+    xmlrpc_DECREF(parsed);
+    xmlrpc_env_clean(&env);
+    return xmlrpc_c::value_struct(value).cvalue();
+}
+
+// xmlrpc_parse_json devuelve los enteros JSON como i8.
+static long long integer(const xmlrpc_c::value& value) {
+    return xmlrpc_c::value_i8(value).cvalue();
+}
+
+static std::map<std::string, xmlrpc_c::value> member(const std::map<std::string, xmlrpc_c::value>& object,
+                                                     const std::string& name) {
+    return xmlrpc_c::value_struct(object.at(name)).cvalue();
+}
+
+TEST_SUITE("Endpoint JSON") {
+
+    TEST_CASE("Ejecuta los métodos del registro desde JSON, en el formato del proxy y en JSON-RPC 2.0") {
+        InProcessServer server;
+        RpcServiceHandlerNamespace::RpcHttpEndpoint endpoint(server.registry, &server.handler, "");
+
+        // Formato del proxy de Node.js, el que usa index.html.
+        auto login = parse(endpoint.handleJsonCall(R"({"method": "user.login", "params": ["principalAdmin", "1234"]})", nullptr));
+        REQUIRE(login.count("success"));
+        std::string const token = xmlrpc_c::value_string(member(login, "result").at("token"));
+
+        // JSON-RPC 2.0: el id vuelve tal cual. 60000.0 llega como real y la firma pide int.
+        auto status = parse(endpoint.handleJsonCall(
+            R"({"jsonrpc": "2.0", "id": 7, "method": "robot.getStatus", "params": [")" + token + R"(", 60000.0]})", nullptr));
+        CHECK(integer(status.at("id")) == 7);
+        CHECK(xmlrpc_c::value_boolean(member(status, "result").at("isConnected")) == false);
+
+        // Enteros JSON donde la firma pide double (x, y, z, velocidad): el método los acepta y
+        // falla por lo esperado, no por el tipo.
+        auto move = parse(endpoint.handleJsonCall(
+            R"({"method": "robot.move", "params": [")" + token + R"(", 10, 20, 30, 5]})", nullptr));
+        std::string const moveError = xmlrpc_c::value_string(member(move, "error").at("faultString"));
+        CHECK(moveError.find("conectado") != std::string::npos);
+
+        // Los parámetros de robot.batch también se ajustan a la firma de cada comando.
+        auto batch = parse(endpoint.handleJsonCall(
+            R"({"method": "robot.batch", "params": [")" + token +
+                R"(", [{"method": "robot.getStatus", "params": [60000.0]}]]})", nullptr));
+        CHECK(integer(member(batch, "result").at("failed")) == 0);
+
+        auto unknown = parse(endpoint.handleJsonCall(R"({"jsonrpc": "2.0", "id": "a", "method": "robot.nada"})", nullptr));
+        CHECK(integer(member(unknown, "error").at("code")) == -32601);
+        CHECK(xmlrpc_c::value_string(unknown.at("id")).cvalue() == "a");
+
+        auto malformed = parse(endpoint.handleJsonCall("{no es json", nullptr));
+        CHECK(integer(member(malformed, "error").at("code")) == -32700);
+    }
+}
@@ -0,0 +1,118 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+#include "LinkStats.h"
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <chrono>
+
+// Arma una respuesta completa que tardó 'micros' microsegundos.
+static ComunicatorPort::SerialReply replyAfter(std::uint64_t micros, bool error = false) {
+    ComunicatorPort::SerialReply reply;
+    reply.text = error ? "ERROR: COMMAND NOT RECOGNIZED\r\nOK\r\n" : "OK\r\n";
+    reply.complete = true;
+    reply.error = error;
+    reply.sentAt = std::chrono::steady_clock::now();
+    reply.receivedAt = reply.sentAt + std::chrono::microseconds(micros);
+    return reply;
+}
+
+TEST_SUITE("Estadísticas del enlace serie") {
+
+    TEST_CASE("Los percentiles del histograma tienen a lo sumo ~6% de error") {
+        ComunicatorPort::LatencyHistogram histogram;
+        CHECK(histogram.percentile(0.5) == 0);
+
+        // 1..10000 us: p50 = 5000, p90 = 9000, p99 = 9900.
+        for (std::uint64_t us = 1; us <= 10000; ++us) {
+            histogram.record(us);
+        }
+        CHECK(histogram.count() == 10000);
+        CHECK(histogram.max() == 10000);
+        CHECK(histogram.percentile(0.50) == doctest::Approx(5000).epsilon(0.07));
+        CHECK(histogram.percentile(0.90) == doctest::Approx(9000).epsilon(0.07));
+        CHECK(histogram.percentile(0.99) == doctest::Approx(9900).epsilon(0.07));
+        CHECK(histogram.percentile(1.0) == 10000);
+
+        // Los valores chicos son exactos y los enormes no se salen de rango.
+        ComunicatorPort::LatencyHistogram small;
+        small.record(7);
+        CHECK(small.percentile(0.5) == 7);
+        small.record(1ull << 40);
+        CHECK(small.percentile(1.0) > 0);
+
+        histogram.reset();
+        CHECK(histogram.count() == 0);
+        CHECK(histogram.percentile(0.99) == 0);
+    }
+
+    TEST_CASE("Los comandos se agrupan por letra y número") {
+        CHECK(ComunicatorPort::LinkStats::familyOf("G1 X10 Y20\r\n") == "G1");
+        CHECK(ComunicatorPort::LinkStats::familyOf("  m114\r\n") == "M114");
+        CHECK(ComunicatorPort::LinkStats::familyOf("G01 X1") == "G1");
+        CHECK(ComunicatorPort::LinkStats::familyOf("M999\r\n") == "OTHER");
+        CHECK(ComunicatorPort::LinkStats::familyOf("HOLA\r\n") == "OTHER");
+        CHECK(ComunicatorPort::LinkStats::familyOf("") == "OTHER");
+    }
+
+    TEST_CASE("Se cuentan bytes, errores y tiempos agotados por familia") {
+        ComunicatorPort::LinkStats stats;
+        stats.record("G1 X10\r\n", replyAfter(2000));
+        stats.record("G1 X20\r\n", replyAfter(4000));
+        stats.record("M999\r\n", replyAfter(500, true));
+        stats.recordTimeout("G28\r\n");
+
+        ComunicatorPort::LinkStatsSnapshot snapshot = stats.snapshot();
+        CHECK(snapshot.commands == 4);
+        CHECK(snapshot.bytesSent == 8 + 8 + 6 + 5);
+        CHECK(snapshot.bytesReceived == 4 + 4 + 35);
+        CHECK(snapshot.errors == 1);
+        CHECK(snapshot.timeouts == 1);
+        REQUIRE(snapshot.families.size() == 3);
+
+        CHECK(snapshot.families[0].family == "G1");
+        CHECK(snapshot.families[0].count == 2);
+        CHECK(snapshot.families[0].p50Ms == doctest::Approx(2.0).epsilon(0.07));
+        CHECK(snapshot.families[0].maxMs == doctest::Approx(4.0));
+        CHECK(snapshot.families[1].family == "G28");
+        CHECK(snapshot.families[1].count == 0);
+        CHECK(snapshot.families[1].timeouts == 1);
+        CHECK(snapshot.families[2].family == "OTHER");
+        CHECK(snapshot.families[2].errors == 1);
+
+        stats.reset();
+        snapshot = stats.snapshot();
+        CHECK(snapshot.commands == 0);
+        CHECK(snapshot.families.empty());
+    }
+
+    TEST_CASE("Varios hilos registran sin perder muestras") {
+        ComunicatorPort::LinkStats stats;
+        const int threads = 8;
+        const int perThread = 100000;
+
+        auto start = std::chrono::steady_clock::now();
+        std::vector<std::thread> workers;
+        for (int t = 0; t < threads; ++t) {
+            workers.emplace_back([&stats, t]() {
+                ComunicatorPort::SerialReply reply = replyAfter(100 + t);
+                const std::string command = (t % 2 == 0) ? "G1 X1\r\n" : "M114\r\n";
+                for (int i = 0; i < perThread; ++i) {
+                    stats.record(command, reply);
+                }
+            });
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        double totalMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "  [BENCH] " << threads * perThread << " registros desde " << threads << " hilos en "
+                  << totalMs << " ms (" << totalMs * 1e6 / (threads * perThread) << " ns por registro)" << std::endl;
+
+        ComunicatorPort::LinkStatsSnapshot snapshot = stats.snapshot();
+        CHECK(snapshot.commands == static_cast<std::uint64_t>(threads * perThread));
+        REQUIRE(snapshot.families.size() == 2);
+        CHECK(snapshot.families[0].count + snapshot.families[1].count == snapshot.commands);
+    }
+}
@@ -0,0 +1,174 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+#include "LogScanner.h"
+#include "FileManager.h"
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+// Fila del reporte del log, ya con strings (lo que el reporte devuelve por cada coincidencia).
+struct ReportRow {
+    std::string timestamp, level, message, user, node;
+    bool operator==(const ReportRow& other) const {
+        return timestamp == other.timestamp && level == other.level && message == other.message &&
+               user == other.user && node == other.node;
+    }
+};
+
+static std::string trimLeft(std::string text) {
+    text.erase(0, text.find_first_not_of(" \t\n\r"));
+    return text;
+}
+
+static std::string_view trimLeft(std::string_view text) {
+    std::size_t start = text.find_first_not_of(" \t\n\r");
+    return start == std::string_view::npos ? std::string_view() : text.substr(start);
+}
+
+// Camino anterior de generateLogReport: todo el archivo a un string y std::getline sobre stringstreams.
+static std::vector<ReportRow> scanWithStreams(const std::string& path, const std::string& username, const std::string& level) {
+    std::vector<ReportRow> rows;
+    FileNamespace::FileManager fileManager;
+    std::string fileContent = fileManager.read(path);
+    std::stringstream ss(fileContent);
+    std::string line;
+    while (std::getline(ss, line)) {
+        if (line.empty()) continue;
+        std::stringstream lineStream(line);
+        ReportRow row;
+        std::getline(lineStream, row.timestamp, ',');
+        std::getline(lineStream, row.level, ',');
+        std::getline(lineStream, row.message, ',');
+        std::getline(lineStream, row.user, ',');
+        std::getline(lineStream, row.node);
+        row.level = trimLeft(row.level);
+        row.user = trimLeft(row.user);
+        if ((username.empty() || row.user == username) && (level.empty() || row.level == level)) {
+            rows.push_back(row);
+        }
+    }
+    return rows;
+}
+
+// Camino nuevo: archivo mapeado, separadores con SSE2, filtros sobre string_view y strings solo al coincidir.
+static std::vector<ReportRow> scanMapped(const std::string& path, const std::string& username, const std::string& level,
+                                         unsigned threads, std::size_t minChunkBytes = LogScanner::MIN_CHUNK_BYTES) {
+    LogScanner scanner(path);
+    return scanner.collect<ReportRow>([&](const LogRow& row, std::vector<ReportRow>& out) {
+        std::string_view const rowUser = trimLeft(row.user);
+        std::string_view const rowLevel = trimLeft(row.level);
+        if ((username.empty() || rowUser == username) && (level.empty() || rowLevel == level)) {
+            out.push_back(ReportRow{std::string(row.timestamp), std::string(rowLevel), std::string(row.message),
+                                    std::string(rowUser), std::string(row.node)});
+        }
+    }, threads, minChunkBytes);
+}
+
+static std::string tempPath(const char* name) {
+    return "/tmp/log_scan_bench_" + std::to_string(getpid()) + "_" + name + ".csv";
+}
+
+/// @brief Log sintético con el formato del Logger: usuarios, niveles y largos variados.
+static void writeSyntheticLog(const std::string& path, std::size_t lines) {
+    static const char* const levels[] = {"INFO", "INFO", "INFO", "WARNING", "DEBUG", "ERROR", "INFO"};
+    static const char* const users[] = {"ana", "beto", "carla", "principalAdmin"};
+    std::ofstream out(path, std::ios::binary);
+    std::string line;
+    for (std::size_t i = 0; i < lines; ++i) {
+        line = "2025-11-16 | 01:";
+        line += static_cast<char>('0' + (i / 600) % 6);
+        line += static_cast<char>('0' + (i / 60) % 10);
+        line += ":";
+        line += static_cast<char>('0' + (i / 10) % 6);
+        line += static_cast<char>('0' + i % 10);
+        line += ", ";
+        line += levels[i % 7];
+        if (i % 5 == 4) {
+            line += ", [Robot] Respuesta de M114: INFO: CURRENT POSITION: [X:12.50 Y:-3.25 Z:140.00 E:0.00]\n";
+            out << line;
+            continue;
+        }
+        line += ", [RPC] RPC call from user '";
+        line += users[i % 4];
+        line += "': robot.move";
+        line += ", ";
+        line += users[i % 4];
+        line += ", 10.0.0.";
+        line += std::to_string(i % 250);
+        line += '\n';
+        out << line;
+    }
+}
+
+TEST_SUITE("Escaneo del log") {
+
+    TEST_CASE("Las mismas filas que std::getline, en una línea y repartido entre hilos") {
+        std::string const path = tempPath("casos");
+        {
+            std::ofstream out(path, std::ios::binary);
+            out << "2025-11-16 | 01:55:20, INFO, Logger inicializado.\n"
+                << "\n"
+                << "2025-11-16 | 01:55:21, WARNING, Failed login attempt, ana, 10.0.0.1\n"
+                << "2025-11-16 | 01:55:22, INFO, mensaje con, coma, ana, 10.0.0.1, extra\n"
+                << "sin campos\n"
+                << "2025-11-16 | 01:55:23, INFO, " << std::string(300, 'x') << ", beto, 10.0.0.2\n"
+                << "2025-11-16 | 01:55:24, WARNING, sin salto final, ana, 10.0.0.3";
+        }
+        for (const char* user : {"", "ana", "beto"}) {
+            for (const char* level : {"", "WARNING"}) {
+                std::vector<ReportRow> const expected = scanWithStreams(path, user, level);
+                CHECK(scanMapped(path, user, level, 1) == expected);
+                CHECK(scanMapped(path, user, level, 4, 16) == expected); // Trozos chicos: cortes en cualquier línea.
+            }
+        }
+        CHECK(scanWithStreams(path, "", "").size() == 6);
+
+        LogRow const row = LogScanner::split("2025-11-16 | 01:55:21, WARNING, Failed login attempt, ana, 10.0.0.1\n");
+        CHECK(row.timestamp == "2025-11-16 | 01:55:21");
+        CHECK(row.message == " Failed login attempt");
+        CHECK(row.node == " 10.0.0.1");
+        std::int64_t first = 0;
+        std::int64_t second = 0;
+        REQUIRE(LogScanner::parseTimestamp(row.timestamp, first));
+        REQUIRE(LogScanner::parseTimestamp("2025-11-16 | 01:56:22", second));
+        CHECK(second - first == 61);
+        CHECK_FALSE(LogScanner::parseTimestamp("sin campos", first));
+        std::remove(path.c_str());
+    }
+
+    TEST_CASE("Benchmark: archivo mapeado con SSE2 vs. stringstream sobre un log sintético") {
+        // 10 millones de líneas por defecto (unos 900 MB); LOG_SCAN_LINES cambia la cantidad.
+        const char* configured = std::getenv("LOG_SCAN_LINES");
+        std::size_t const lines = configured ? std::strtoull(configured, nullptr, 10) : 10000000;
+        std::string const path = tempPath("sintetico");
+        writeSyntheticLog(path, lines);
+
+        auto start = std::chrono::steady_clock::now();
+        std::vector<ReportRow> const streamRows = scanWithStreams(path, "ana", "WARNING");
+        double const streamMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        start = std::chrono::steady_clock::now();
+        std::vector<ReportRow> const singleRows = scanMapped(path, "ana", "WARNING", 1);
+        double const singleMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        start = std::chrono::steady_clock::now();
+        std::vector<ReportRow> const parallelRows = scanMapped(path, "ana", "WARNING", 0);
+        double const parallelMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+        std::cout << "  [BENCH] " << lines << " líneas, " << streamRows.size() << " coincidencias: stringstream "
+                  << streamMs << " ms, mapeado " << singleMs << " ms (x" << streamMs / singleMs << "), mapeado con "
+                  << std::max(1u, std::thread::hardware_concurrency()) << " hilos " << parallelMs << " ms (x"
+                  << streamMs / parallelMs << ")" << std::endl;
+
+        CHECK(singleRows == streamRows);
+        CHECK(parallelRows == streamRows);
+        CHECK(singleMs < streamMs);
+        std::remove(path.c_str());
+    }
+}
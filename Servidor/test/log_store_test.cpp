@@ -0,0 +1,122 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+#include "LogStore.h"
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+// Cada caso usa su propia carpeta, para no mezclar segmentos.
+static LogStoreOptions optionsIn(const std::string& name) {
+    std::string const directory = "/tmp/log_store_test_" + std::to_string(getpid()) + "_" + name;
+    mkdir(directory.c_str(), 0755);
+    LogStoreOptions options;
+    options.activePath = directory + "/application.csv";
+    options.segmentDir = directory + "/logs";
+    options.maxSegmentAge = std::chrono::seconds(0);
+    return options;
+}
+
+/// @brief Agrega una línea con el formato del Logger ("fecha, NIVEL, mensaje[, usuario, nodo]").
+static void append(LogStore& store, std::int64_t time, LogLevel level, const std::string& message,
+                   const std::string& user = "") {
+    std::string line = "2025-01-01 | 00:00:00, " + std::string(Logger::levelToString(level)) + ", " + message;
+    if (!user.empty()) {
+        line += ", " + user + ", 10.0.0.1";
+    }
+    line += '\n';
+    store.append(line, {LogStore::Entry{static_cast<std::uint32_t>(line.size()), level, time, user}});
+}
+
+static std::vector<std::string> messages(const std::vector<std::string>& lines) {
+    std::vector<std::string> result;
+    for (const auto& line : lines) {
+        std::size_t start = line.find(", ", line.find(", ") + 2) + 2;
+        result.push_back(line.substr(start, line.find(',', start) - start));
+    }
+    return result;
+}
+
+TEST_SUITE("LogStore") {
+
+    TEST_CASE("Corta segmentos por tamaño y responde por nivel, usuario y tiempo desde el índice") {
+        LogStoreOptions options = optionsIn("consultas");
+        options.maxSegmentBytes = 200;
+        std::int64_t const start = 1700000000;
+        {
+            LogStore store(options);
+            for (int i = 0; i < 40; ++i) {
+                LogLevel const level = i % 4 == 0 ? LogLevel::WARNING : LogLevel::INFO;
+                append(store, start + i, level, "linea-" + std::to_string(i), i % 2 == 0 ? "ana" : "beto");
+            }
+            CHECK(store.segmentCount() > 5);
+
+            LogStore::Query all;
+            std::vector<std::string> const lines = store.query(all);
+            REQUIRE(lines.size() == 40);
+            CHECK(lines.front().find("linea-0,") != std::string::npos);
+            CHECK(lines.back().find("linea-39,") != std::string::npos);
+
+            LogStore::Query warningsOfAna;
+            warningsOfAna.level = LogLevel::WARNING;
+            warningsOfAna.user = "ana";
+            CHECK(messages(store.query(warningsOfAna)) ==
+                  std::vector<std::string>{"linea-0", "linea-4", "linea-8", "linea-12", "linea-16",
+                                           "linea-20", "linea-24", "linea-28", "linea-32", "linea-36"});
+
+            LogStore::Query window;
+            window.user = "beto";
+            window.from = start + 10;
+            window.to = start + 15;
+            CHECK(messages(store.query(window)) == std::vector<std::string>{"linea-11", "linea-13", "linea-15"});
+
+            LogStore::Query nobody;
+            nobody.user = "nadie";
+            CHECK(store.query(nobody).empty());
+        }
+
+        // Al volver a abrir, los segmentos cerrados se toman de sus índices y el activo se reindexa.
+        LogStore reopened(options);
+        LogStore::Query ana;
+        ana.user = "ana";
+        CHECK(reopened.query(ana).size() == 20);
+        append(reopened, start + 40, LogLevel::ERROR, "linea-40", "ana");
+        ana.level = LogLevel::ERROR;
+        CHECK(messages(reopened.query(ana)) == std::vector<std::string>{"linea-40"});
+    }
+
+    TEST_CASE("Solo abre los segmentos que pueden tener resultados") {
+        LogStoreOptions options = optionsIn("relevantes");
+        options.maxSegmentBytes = 1; // Un segmento por línea.
+        LogStore store(options);
+        append(store, 1700000000, LogLevel::INFO, "de-ana", "ana");
+        append(store, 1700000100, LogLevel::INFO, "de-beto", "beto");
+        append(store, 1700000200, LogLevel::ERROR, "error-de-ana", "ana");
+        append(store, 1700000300, LogLevel::INFO, "activo");
+        REQUIRE(store.segmentCount() == 3);
+
+        // Sin el segmento de beto la consulta de ana sale igual: ni lo abre.
+        REQUIRE(std::remove((options.segmentDir + "/segment-000002.csv").c_str()) == 0);
+        LogStore::Query ana;
+        ana.user = "ana";
+        CHECK(messages(store.query(ana)) == std::vector<std::string>{"de-ana", "error-de-ana"});
+
+        LogStore::Query late;
+        late.from = 1700000150;
+        CHECK(messages(store.query(late)) == std::vector<std::string>{"error-de-ana", "activo"});
+    }
+
+    TEST_CASE("Corta el segmento cuando su primera línea pasa la antigüedad configurada") {
+        LogStoreOptions options = optionsIn("antiguedad");
+        options.maxSegmentAge = std::chrono::seconds(60);
+        LogStore store(options);
+        append(store, 1700000000, LogLevel::INFO, "primera");
+        append(store, 1700000059, LogLevel::INFO, "mismo-segmento");
+        CHECK(store.segmentCount() == 0);
+        append(store, 1700000060, LogLevel::INFO, "otro-segmento");
+        CHECK(store.segmentCount() == 1);
+        CHECK(store.query(LogStore::Query()).size() == 3);
+    }
+}
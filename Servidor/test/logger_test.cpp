@@ -0,0 +1,164 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+#include "Logger.h"
+#include <fstream>
+#include <iostream>
+#include <regex>
+#include <sstream>
+#include <string>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+// El logger escribe application.csv en el directorio actual: cada corrida usa uno propio.
+static std::string logFile() {
+    static const std::string directory = [] {
+        std::string path = "/tmp/logger_test_" + std::to_string(getpid());
+        mkdir(path.c_str(), 0755);
+        REQUIRE(chdir(path.c_str()) == 0);
+        return path;
+    }();
+    return directory + "/application.csv";
+}
+
+static Logger& logger() {
+    logFile(); // Antes de crear el logger.
+    return Logger::getInstance();
+}
+
+static std::vector<std::string> linesWith(const std::string& marker) {
+    std::ifstream file(logFile());
+    std::vector<std::string> lines;
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.find(marker) != std::string::npos) {
+            lines.push_back(line);
+        }
+    }
+    return lines;
+}
+
+TEST_SUITE("Logger") {
+
+    TEST_CASE("Escribe en segundo plano las líneas de varios hilos, con el formato de siempre") {
+        Logger& log = logger();
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t) {
+            threads.emplace_back([&log, t] {
+                for (int i = 0; i < 500; ++i) {
+                    log.log(LogLevel::INFO, "varios-hilos " + std::to_string(t) + "-" + std::to_string(i), "operador", "10.0.0.1");
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        log.flush();
+
+        std::vector<std::string> const lines = linesWith("varios-hilos");
+        REQUIRE(lines.size() == 2000);
+        std::regex const format(R"(\d{4}-\d{2}-\d{2} \| \d{2}:\d{2}:\d{2}, INFO, varios-hilos \d-\d+, operador, 10\.0\.0\.1)");
+        for (const auto& line : lines) {
+            CHECK_MESSAGE(std::regex_match(line, format), line);
+        }
+    }
+
+    TEST_CASE("Un CRITICAL ya está escrito cuando log() vuelve") {
+        Logger& log = logger();
+        LoggerOptions options;
+        options.flushInterval = std::chrono::seconds(10); // Sin esperar al intervalo.
+        log.configure(options);
+        log.log(LogLevel::CRITICAL, "critico-sincronico");
+        CHECK(linesWith("critico-sincronico").size() == 1);
+        log.configure(LoggerOptions());
+    }
+
+    TEST_CASE("Con la cola llena descarta DEBUG e INFO y lo anota; en modo BLOCK no pierde nada") {
+        Logger& log = logger();
+        std::size_t const total = 3 * Logger::QUEUE_CAPACITY;
+        std::uint64_t const droppedBefore = log.droppedCount();
+
+        // La consola pasa a ser un pipe que nadie lee: al llenarse, el hilo de escritura queda
+        // bloqueado y la cola se llena sí o sí, sin depender de cómo se repartan los hilos.
+        int pipeFds[2];
+        REQUIRE(pipe(pipeFds) == 0);
+        std::cout.flush();
+        int const savedStdout = dup(STDOUT_FILENO);
+        dup2(pipeFds[1], STDOUT_FILENO);
+        for (std::size_t i = 0; i < total; ++i) {
+            log.log(LogLevel::INFO, "desborde-drop " + std::to_string(i));
+        }
+        std::uint64_t const dropped = log.droppedCount() - droppedBefore;
+        dup2(savedStdout, STDOUT_FILENO);
+        close(savedStdout);
+        close(pipeFds[1]);
+        std::thread reader([fd = pipeFds[0]] {
+            char buffer[4096];
+            while (read(fd, buffer, sizeof(buffer)) > 0) {
+            }
+            close(fd);
+        });
+        log.log(LogLevel::WARNING, "desborde-warning");
+        log.flush();
+        reader.join();
+
+        CHECK(dropped > 0);
+        CHECK(linesWith("desborde-drop ").size() + dropped == total);
+        CHECK(linesWith("desborde-warning").size() == 1);
+        CHECK_FALSE(linesWith("[Logger] Se descartaron").empty());
+
+        LoggerOptions options;
+        options.overflow = LogOverflow::BLOCK;
+        log.configure(options);
+        for (std::size_t i = 0; i < total; ++i) {
+            log.log(LogLevel::INFO, "desborde-block " + std::to_string(i));
+        }
+        log.flush();
+        CHECK(log.droppedCount() - droppedBefore == dropped);
+        CHECK(linesWith("desborde-block ").size() == total);
+        log.configure(LoggerOptions());
+    }
+
+    TEST_CASE("Por debajo del nivel mínimo o en una categoría silenciada no se formatea nada") {
+        Logger& log = logger();
+        CHECK(Logger::minLevel() == LogLevel::INFO);
+        CHECK_FALSE(Logger::isEnabled(LogLevel::DEBUG, LogCategory::SERIAL));
+
+        // Un %s con un puntero inválido rompería si se formateara.
+        const char* const never = reinterpret_cast<const char*>(1);
+        log.logf(LogLevel::DEBUG, LogCategory::SERIAL, "nivel-debug-apagado %s", never);
+        log.log(LogLevel::DEBUG, "nivel-debug-apagado");
+
+        Logger::setMinLevel(LogLevel::DEBUG);
+        log.logf(LogLevel::DEBUG, LogCategory::SERIAL, "nivel-debug-prendido %d de %s", 3, "serial");
+        Logger::setCategoryEnabled(LogCategory::SERIAL, false);
+        log.logf(LogLevel::INFO, LogCategory::SERIAL, "categoria-silenciada %s", never);
+        log.logf(LogLevel::DEBUG, LogCategory::ROBOT, "categoria-habilitada");
+        log.logf(LogLevel::WARNING, LogCategory::SERIAL, "categoria-warning");
+        log.logfAs(LogLevel::INFO, LogCategory::RPC, "operador", "10.0.0.1", "con-usuario %s", "robot.move");
+        Logger::setCategoryEnabled(LogCategory::SERIAL, true);
+        Logger::setMinLevel(LogLevel::INFO);
+        log.flush();
+
+        CHECK(linesWith("nivel-debug-apagado").empty());
+        CHECK(linesWith("categoria-silenciada").empty());
+        REQUIRE(linesWith("nivel-debug-prendido").size() == 1);
+        CHECK(linesWith("nivel-debug-prendido")[0].find(", DEBUG, nivel-debug-prendido 3 de serial") != std::string::npos);
+        CHECK(linesWith("categoria-habilitada").size() == 1);
+        CHECK(linesWith("categoria-warning").size() == 1);
+        REQUIRE(linesWith("con-usuario").size() == 1);
+        CHECK(linesWith("con-usuario")[0].find(", INFO, con-usuario robot.move, operador, 10.0.0.1") != std::string::npos);
+
+        std::string const longText(2 * Logger::MAX_LINE_BYTES, 'x');
+        log.logf(LogLevel::INFO, LogCategory::GENERAL, "mensaje-largo %s", longText.c_str());
+        log.flush();
+        REQUIRE(linesWith("mensaje-largo").size() == 1);
+        CHECK(linesWith("mensaje-largo")[0].size() < Logger::MAX_LINE_BYTES + 32);
+
+        CHECK(Logger::levelFromString("warning") == LogLevel::WARNING);
+        CHECK_FALSE(Logger::levelFromString("WARN"));
+        CHECK(Logger::categoryFromString("serial") == LogCategory::SERIAL);
+        CHECK_FALSE(Logger::categoryFromString("nada"));
+    }
+}
@@ -0,0 +1,164 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+#include "OrderHistory.h"
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+static std::string tempPath(const char* name) {
+    return "/tmp/order_history_test_" + std::to_string(getpid()) + "_" + name + ".csv";
+}
+
+static std::vector<std::string> readLines(const std::string& path) {
+    std::vector<std::string> lines;
+    std::ifstream in(path);
+    std::string line;
+    while (std::getline(in, line)) {
+        lines.push_back(line);
+    }
+    return lines;
+}
+
+static std::vector<std::string> detailsOf(const std::vector<Order>& orders) {
+    std::vector<std::string> details;
+    for (const auto& order : orders) {
+        details.push_back(order.details);
+    }
+    return details;
+}
+
+TEST_SUITE("Historial de órdenes") {
+
+    TEST_CASE("Guarda las últimas y pasa las más viejas al archivo") {
+        std::string const path = tempPath("desborde");
+        std::remove(path.c_str());
+        {
+            OrderHistory history(3, path);
+            for (int i = 0; i < 5; ++i) {
+                history.record(1700000000 + i, "ana", "robot.move", "orden-" + std::to_string(i), "[Robot] OK");
+            }
+            CHECK(detailsOf(history.snapshot()) == std::vector<std::string>{"orden-2", "orden-3", "orden-4"});
+            CHECK(history.spilledCount() == 2);
+
+            std::vector<std::string> const spilled = readLines(path);
+            REQUIRE(spilled.size() == 2);
+            CHECK(spilled[0].find(",ana,robot.move,orden-0,[Robot] OK") != std::string::npos);
+            CHECK(spilled[1].find(",orden-1,") != std::string::npos);
+
+            // Las comas y comillas del texto no rompen el CSV.
+            history.record(1700000010, "beto", "robot.gcode", "G1 X10, Y20", "dijo \"ok\"");
+            history.clear();
+            CHECK(history.snapshot().empty());
+            std::vector<std::string> const all = readLines(path);
+            REQUIRE(all.size() == 6);
+            CHECK(all[5].find(",beto,robot.gcode,\"G1 X10, Y20\",\"dijo \"\"ok\"\"\"") != std::string::npos);
+
+            history.record(1700000020, "ana", "robot.home", "al destruir", "[Robot] OK");
+        }
+        CHECK(readLines(tempPath("desborde")).size() == 7); // El destructor pasa lo que quedaba.
+        std::remove(path.c_str());
+    }
+
+    TEST_CASE("Recorta los campos largos sin partir caracteres y conserva los cortos") {
+        OrderHistory history(2, "");
+        std::string const details(2000, 'g');
+        std::string success = "[Robot] ";
+        while (success.size() < 1000) {
+            success += "ñ";
+        }
+        history.record(1700000000, "ana", "robot.gcode", details, success);
+        std::vector<Order> const orders = history.snapshot();
+        REQUIRE(orders.size() == 1);
+        CHECK(orders[0].username == "ana");
+        CHECK(orders[0].commandName == "robot.gcode");
+        CHECK(orders[0].details.size() + orders[0].success.size() + 3 + 11 <= OrderHistory::TEXT_BYTES);
+        CHECK(orders[0].details.size() > 200);
+        CHECK(orders[0].success.compare(0, 8, "[Robot] ") == 0);
+        CHECK((orders[0].success.size() - 8) % 2 == 0); // Solo "ñ" enteras (dos bytes cada una).
+        CHECK(orders[0].timestamp.size() == 8);
+    }
+
+    TEST_CASE("Cambiar la capacidad conserva las más nuevas") {
+        std::string const path = tempPath("capacidad");
+        std::remove(path.c_str());
+        OrderHistory history(4, path);
+        for (int i = 0; i < 4; ++i) {
+            history.record(1700000000 + i, "ana", "robot.move", std::to_string(i), "OK");
+        }
+        history.setCapacity(2);
+        CHECK(detailsOf(history.snapshot()) == std::vector<std::string>{"2", "3"});
+        CHECK(history.spilledCount() == 2);
+        history.setCapacity(3);
+        history.record(1700000004, "ana", "robot.move", "4", "OK");
+        CHECK(detailsOf(history.snapshot()) == std::vector<std::string>{"2", "3", "4"});
+        CHECK(history.capacity() == 3);
+        CHECK_THROWS_AS(history.setCapacity(0), std::invalid_argument);
+        history.clear();
+        CHECK(readLines(path).size() == 5);
+        std::remove(path.c_str());
+    }
+
+    TEST_CASE("Los lectores ven órdenes consecutivas mientras se escriben otras") {
+        std::string const path = tempPath("concurrente");
+        std::remove(path.c_str());
+        int const total = 20000;
+        OrderHistory history(64, path);
+        std::atomic<bool> done{false};
+        std::atomic<int> badSnapshots{0};
+
+        std::vector<std::thread> readers;
+        for (int r = 0; r < 3; ++r) {
+            readers.emplace_back([&] {
+                while (!done.load()) {
+                    std::vector<Order> const orders = history.snapshot();
+                    if (orders.size() > 64) {
+                        ++badSnapshots;
+                    }
+                    for (std::size_t i = 1; i < orders.size(); ++i) {
+                        if (std::stoi(orders[i].details) != std::stoi(orders[i - 1].details) + 1) {
+                            ++badSnapshots;
+                        }
+                    }
+                }
+            });
+        }
+        std::vector<std::thread> writers;
+        std::atomic<int> next{0};
+        std::mutex order;
+        for (int w = 0; w < 2; ++w) {
+            writers.emplace_back([&] {
+                for (;;) {
+                    // El número se toma junto con el registro para que los detalles queden en orden.
+                    std::lock_guard<std::mutex> lock(order);
+                    int const n = next++;
+                    if (n >= total) {
+                        return;
+                    }
+                    history.record(1700000000, "ana", "robot.move", std::to_string(n), "OK");
+                }
+            });
+        }
+        for (auto& writer : writers) {
+            writer.join();
+        }
+        done = true;
+        for (auto& reader : readers) {
+            reader.join();
+        }
+
+        CHECK(badSnapshots.load() == 0);
+        CHECK(history.snapshot().size() == 64);
+        CHECK(history.spilledCount() == total - 64);
+        history.clear();
+        std::vector<std::string> const lines = readLines(path);
+        REQUIRE(lines.size() == static_cast<std::size_t>(total));
+        CHECK(lines.back().find("," + std::to_string(total - 1) + ",") != std::string::npos);
+        std::remove(path.c_str());
+    }
+}
@@ -0,0 +1,149 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+#include "ReplyParser.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <regex>
+#include <string>
+#include <vector>
+
+// --- Contador de reservas de memoria, para comprobar que el parser no reserva ---
+static std::atomic<std::size_t> allocations{0};
+
+void* operator new(std::size_t size) {
+    allocations++;
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+using ComunicatorPort::ReplyEvent;
+using ComunicatorPort::ReplyKind;
+using ComunicatorPort::ReplyParser;
+
+// Respuesta típica de M114, tal como la envía el firmware.
+static const std::string M114_REPLY =
+    "INFO: ABSOLUTE MODE\r\n"
+    "INFO: CURRENT POSITION: [X:12.50 Y:-3.25 Z:140.00 E:0.00]\r\n"
+    "INFO: MOTORS ENABLED\r\n"
+    "INFO: FAN ENABLED\r\n"
+    "OK\r\n";
+
+struct Status {
+    bool absolute = false;
+    bool motors = false;
+    double x = 0, y = 0, z = 0;
+};
+
+// Camino anterior de Robot: quitar saltos de línea, buscar los textos y aplicar un std::regex nuevo.
+static void parseWithRegex(const std::string& raw, Status& status) {
+    std::string response = raw;
+    response.erase(std::remove(response.begin(), response.end(), '\n'), response.end());
+    response.erase(std::remove(response.begin(), response.end(), '\r'), response.end());
+    if (response.find("ABSOLUTE MODE") != std::string::npos) {
+        status.absolute = true;
+    } else if (response.find("RELATIVE MODE") != std::string::npos) {
+        status.absolute = false;
+    }
+    if (response.find("MOTORS ENABLED") != std::string::npos) {
+        status.motors = true;
+    } else if (response.find("MOTORS DISABLED") != std::string::npos) {
+        status.motors = false;
+    }
+    std::regex re(R"(X:([-\d.]+) Y:([-\d.]+) Z:([-\d.]+))");
+    std::smatch match;
+    if (std::regex_search(response, match, re) && match.size() == 4) {
+        status.x = std::stod(match[1].str());
+        status.y = std::stod(match[2].str());
+        status.z = std::stod(match[3].str());
+    }
+}
+
+static void parseWithEvents(ReplyParser& parser, const std::string& raw, Status& status) {
+    parser.feed(raw, [&status](const ReplyEvent& event) {
+        switch (event.kind) {
+            case ReplyKind::Mode: status.absolute = event.absolute; break;
+            case ReplyKind::MotorsState: status.motors = event.motorsEnabled; break;
+            case ReplyKind::Position: status.x = event.x; status.y = event.y; status.z = event.z; break;
+            default: break;
+        }
+    });
+}
+
+TEST_SUITE("Parser de respuestas del firmware") {
+
+    TEST_CASE("Cada línea se convierte en un evento tipado, aunque llegue en trozos") {
+        const std::string stream =
+            "INFO: LINEAR MOVE: [X:10.00 Y:0.00 Z:-5.50 E:4000.00]\r\nOK\r\n"
+            "ERROR: COMMAND NOT RECOGNIZED\r\nOK\r\n"
+            "INFO: HOMING COMPLETE\r\nOK\r\n"
+            "INFO: ENDSTOP: [X:1 Y:0 Z:0]\r\nOK\r\n"
+            "INFO: RELATIVE MODE\r\nINFO: MOTORS DISABLED\r\nINFO: GRIPPER ON\r\nOK\r\n";
+
+        std::vector<ReplyKind> kinds;
+        std::vector<ReplyEvent> events;
+        std::vector<std::string> texts;
+        ReplyParser parser;
+        for (std::size_t i = 0; i < stream.size(); i += 3) { // De a tres bytes, cortando líneas y números.
+            parser.feed(std::string_view(stream).substr(i, 3), [&](const ReplyEvent& event) {
+                kinds.push_back(event.kind);
+                events.push_back(event);
+                texts.emplace_back(event.text);
+            });
+        }
+
+        REQUIRE(kinds == std::vector<ReplyKind>{ReplyKind::LinearMove, ReplyKind::Ok, ReplyKind::Error, ReplyKind::Ok,
+                                                ReplyKind::HomingComplete, ReplyKind::Ok, ReplyKind::LimitReached,
+                                                ReplyKind::Ok, ReplyKind::Mode, ReplyKind::MotorsState, ReplyKind::Info,
+                                                ReplyKind::Ok});
+        CHECK(events[0].x == 10.0);
+        CHECK(events[0].z == -5.5);
+        CHECK(events[0].e == 4000.0);
+        CHECK(events[2].error == ComunicatorPort::ReplyError::CommandNotRecognized);
+        CHECK(texts[2] == "COMMAND NOT RECOGNIZED");
+        CHECK((events[6].limitX && !events[6].limitY && events[6].anyLimit()));
+        CHECK(!events[8].absolute);
+        CHECK(!events[9].motorsEnabled);
+        CHECK(texts[10] == "GRIPPER ON");
+    }
+
+    TEST_CASE("Benchmark: eventos vs. regex sobre la respuesta de M114") {
+        const int iterations = 20000;
+        Status regexStatus;
+        Status eventStatus;
+        ReplyParser parser;
+
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; ++i) {
+            parseWithRegex(M114_REPLY, regexStatus);
+        }
+        double regexUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+        std::size_t before = allocations.load();
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; ++i) {
+            parseWithEvents(parser, M114_REPLY, eventStatus);
+        }
+        double eventUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+        std::size_t eventAllocations = allocations.load() - before;
+
+        std::cout << "  [BENCH] M114 x" << iterations << ": regex " << regexUs / iterations << " us/respuesta, "
+                  << "eventos " << eventUs / iterations << " us/respuesta (x" << regexUs / eventUs << "), "
+                  << eventAllocations << " reservas de memoria" << std::endl;
+
+        CHECK(eventStatus.absolute == regexStatus.absolute);
+        CHECK(eventStatus.motors == regexStatus.motors);
+        CHECK(eventStatus.x == regexStatus.x);
+        CHECK(eventStatus.y == regexStatus.y);
+        CHECK(eventStatus.z == regexStatus.z);
+        CHECK(eventAllocations == 0);
+        CHECK(eventUs < regexUs);
+    }
+}
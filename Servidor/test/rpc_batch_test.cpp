@@ -0,0 +1,124 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+#include "RpcServiceHandler.h"
+#include "AuthenticationService.h"
+#include "DatabaseManager.h"
+#include "SessionManager.h"
+#include "RobotRegistry.h"
+#include "TaskManager.h"
+#include <xmlrpc-c/base.hpp>
+#include <xmlrpc-c/registry.hpp>
+#include <xmlrpc-c/xml.hpp>
+#include <cstdio>
+#include <map>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+// Servidor RPC sin HTTP: los pedidos se pasan como XML directamente al registro.
+struct InProcessServer {
+    std::string dbPath = "/tmp/rpc_batch_test_" + std::to_string(getpid()) + ".db";
+    DatabaseManagerNamespace::DatabaseManager db{dbPath};
+    SessionManager sessions;
+    AuthenticationServiceNamespace::AuthenticationService auth{db, sessions};
+    RobotNamespace::RobotRegistry robots;
+    TaskManager tasks{"/tmp/rpc_batch_test_tasks.json"};
+    RpcServiceHandlerNamespace::RpcServiceHandler handler{auth, robots, tasks};
+    xmlrpc_c::registry registry;
+
+    InProcessServer() {
+        robots.add(RobotNamespace::RobotRegistry::DEFAULT_ROBOT_ID, "");
+        robots.setStatusPollInterval(0);
+        handler.registerMethods(registry);
+    }
+
+    ~InProcessServer() {
+        std::remove(dbPath.c_str());
+    }
+
+    /// @brief Ejecuta el método; un fault sale como excepción.
+    xmlrpc_c::value call(const std::string& method, const xmlrpc_c::paramList& params) {
+        std::string callXml, responseXml;
+        xmlrpc_c::xml::generateCall(method, params, &callXml);
+        registry.processCall(callXml, &responseXml);
+        xmlrpc_c::value result;
+        xmlrpc_c::xml::parseSuccessfulResponse(responseXml, &result);
+        return result;
+    }
+};
+
+static xmlrpc_c::value command(const std::string& method, std::vector<xmlrpc_c::value> params = {}) {
+    std::map<std::string, xmlrpc_c::value> item;
+    item["method"] = xmlrpc_c::value_string(method);
+    item["params"] = xmlrpc_c::value_array(params);
+    return xmlrpc_c::value_struct(item);
+}
+
+static std::map<std::string, xmlrpc_c::value> field(const std::vector<xmlrpc_c::value>& results, std::size_t i) {
+    return xmlrpc_c::value_struct(results.at(i)).cvalue();
+}
+
+TEST_SUITE("robot.batch") {
+
+    TEST_CASE("Valida el token una vez y ejecuta los comandos en orden, parando o no ante un error") {
+        InProcessServer server;
+        xmlrpc_c::paramList login;
+        login.add(xmlrpc_c::value_string("principalAdmin"));
+        login.add(xmlrpc_c::value_string("1234"));
+        std::map<std::string, xmlrpc_c::value> const session = xmlrpc_c::value_struct(server.call("user.login", login)).cvalue();
+        xmlrpc_c::value_string const token(session.at("token"));
+
+        std::vector<xmlrpc_c::value> const commands = {
+            command("robot.getStatus"),
+            command("robot.help"),
+            command("robot.noExiste"),
+            command("robot.batch"), // No se anidan.
+            command("robot.getStatus", {xmlrpc_c::value_string("no es un entero")}),
+            command("robot.getStatus", {xmlrpc_c::value_int(60000)}),
+        };
+
+        SUBCASE("Por defecto se detiene en el primer error") {
+            xmlrpc_c::paramList params;
+            params.add(token);
+            params.add(xmlrpc_c::value_array(commands));
+            std::map<std::string, xmlrpc_c::value> const batch = xmlrpc_c::value_struct(server.call("robot.batch", params)).cvalue();
+            std::vector<xmlrpc_c::value> const results = xmlrpc_c::value_array(batch.at("results")).vectorValueValue();
+
+            REQUIRE(results.size() == 3);
+            CHECK(xmlrpc_c::value_int(batch.at("executed")) == 3);
+            CHECK(xmlrpc_c::value_int(batch.at("failed")) == 1);
+            CHECK(xmlrpc_c::value_boolean(batch.at("stopped")) == true);
+            CHECK(xmlrpc_c::value_boolean(field(results, 0).at("ok")) == true);
+            std::map<std::string, xmlrpc_c::value> const status = xmlrpc_c::value_struct(field(results, 0).at("result")).cvalue();
+            CHECK(xmlrpc_c::value_boolean(status.at("isConnected")) == false);
+            CHECK(xmlrpc_c::value_boolean(field(results, 2).at("ok")) == false);
+            CHECK(xmlrpc_c::value_string(field(results, 2).at("method")).cvalue() == "robot.noExiste");
+        }
+
+        SUBCASE("Con stopOnError = false sigue y devuelve un resultado por comando") {
+            std::map<std::string, xmlrpc_c::value> options;
+            options["stopOnError"] = xmlrpc_c::value_boolean(false);
+            xmlrpc_c::paramList params;
+            params.add(token);
+            params.add(xmlrpc_c::value_array(commands));
+            params.add(xmlrpc_c::value_struct(options));
+            std::map<std::string, xmlrpc_c::value> const batch = xmlrpc_c::value_struct(server.call("robot.batch", params)).cvalue();
+            std::vector<xmlrpc_c::value> const results = xmlrpc_c::value_array(batch.at("results")).vectorValueValue();
+
+            REQUIRE(results.size() == commands.size());
+            CHECK(xmlrpc_c::value_int(batch.at("failed")) == 3);
+            CHECK(xmlrpc_c::value_boolean(batch.at("stopped")) == false);
+            CHECK(xmlrpc_c::value_boolean(field(results, 3).at("ok")) == false);
+            CHECK(xmlrpc_c::value_boolean(field(results, 4).at("ok")) == false); // Tipo incorrecto: fault de paramList.
+            CHECK(xmlrpc_c::value_boolean(field(results, 5).at("ok")) == true);
+            CHECK(xmlrpc_c::value_string(field(results, 5).at("method")).cvalue() == "robot.getStatus");
+        }
+
+        SUBCASE("Un token inválido rechaza el batch completo") {
+            xmlrpc_c::paramList params;
+            params.add(xmlrpc_c::value_string("token-invalido"));
+            params.add(xmlrpc_c::value_array(commands));
+            CHECK_THROWS(server.call("robot.batch", params));
+        }
+    }
+}
@@ -0,0 +1,213 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+#include "RpcServerConfig.h"
+#include "RpcHttpEndpoint.h"
+#include "Robot.h"
+#include <xmlrpc-c/base.hpp>
+#include <xmlrpc-c/client.hpp>
+#include <xmlrpc-c/registry.hpp>
+#include <xmlrpc-c/server_abyss.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+
+using RpcServiceHandlerNamespace::RpcServerConfig;
+
+// Un método de la clase de robot.getStatus: lee la muestra en memoria del robot y arma el struct.
+class StatusMethod : public xmlrpc_c::method {
+public:
+    explicit StatusMethod(RobotNamespace::Robot& robot) : robot_(robot) {
+        this->_signature = "S:s";
+    }
+
+    void execute(xmlrpc_c::paramList const& paramList, xmlrpc_c::value* const retvalP) override {
+        paramList.verifyEnd(1);
+        RobotStatus status = robot_.getRobotStatus();
+        std::map<std::string, xmlrpc_c::value> statusMap;
+        statusMap["isConnected"] = xmlrpc_c::value_boolean(status.isConnected);
+        statusMap["areMotorsEnabled"] = xmlrpc_c::value_boolean(status.areMotorsEnabled);
+        statusMap["activityState"] = xmlrpc_c::value_string(status.activityState);
+        statusMap["version"] = xmlrpc_c::value_int(static_cast<int>(status.version));
+        std::map<std::string, xmlrpc_c::value> positionMap;
+        positionMap["x"] = xmlrpc_c::value_double(status.currentPosition.x);
+        positionMap["y"] = xmlrpc_c::value_double(status.currentPosition.y);
+        positionMap["z"] = xmlrpc_c::value_double(status.currentPosition.z);
+        statusMap["position"] = xmlrpc_c::value_struct(positionMap);
+        *retvalP = xmlrpc_c::value_struct(statusMap);
+    }
+
+private:
+    RobotNamespace::Robot& robot_;
+};
+
+// Servidor Abyss en un hilo aparte, construido con RpcServerConfig igual que Server::startRpcServer.
+class RunningServer {
+public:
+    RunningServer(const RpcServerConfig& config, RobotNamespace::Robot& robot) {
+        registry_.addMethod("robot.getStatus", new StatusMethod(robot));
+        const char* error = nullptr;
+        AbyssInit(&error);
+        config.create(server_);
+        endpoint_.install(server_);
+        ServerInit(&server_);
+        thread_ = std::thread([this] { ServerRun(&server_); });
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+
+    ~RunningServer() {
+        ServerTerminate(&server_);
+        thread_.join();
+        ServerFree(&server_);
+        AbyssTerm();
+    }
+
+private:
+    xmlrpc_c::registry registry_;
+    RpcServiceHandlerNamespace::RpcHttpEndpoint endpoint_{registry_, nullptr, ""}; // Solo /RPC2.
+    TServer server_;
+    std::thread thread_;
+};
+
+struct LoadResult {
+    std::size_t requests = 0;
+    std::size_t failures = 0;
+    double requestsPerSecond = 0;
+    double p50Ms = 0, p99Ms = 0, maxMs = 0;
+};
+
+// Cada cliente abre su conexión (keep-alive) y llama a robot.getStatus sin pausa durante 'duration'.
+static LoadResult runLoad(unsigned int port, int clients, std::chrono::milliseconds duration) {
+    std::string const url = "http://localhost:" + std::to_string(port) + "/RPC2";
+    std::vector<std::vector<double>> latencies(clients);
+    std::atomic<std::size_t> failures{0};
+    std::atomic<bool> go{false};
+    std::vector<std::thread> threads;
+    for (int i = 0; i < clients; ++i) {
+        threads.emplace_back([&, i] {
+            xmlrpc_c::clientXmlTransport_curl transport;
+            xmlrpc_c::client_xml client(&transport);
+            xmlrpc_c::carriageParm_curl0 carriage(url);
+            while (!go) {
+                std::this_thread::yield();
+            }
+            auto end = std::chrono::steady_clock::now() + duration;
+            while (std::chrono::steady_clock::now() < end) {
+                xmlrpc_c::paramList params;
+                params.add(xmlrpc_c::value_string("token"));
+                xmlrpc_c::rpcPtr rpc("robot.getStatus", params);
+                auto start = std::chrono::steady_clock::now();
+                try {
+                    rpc->call(&client, &carriage);
+                    latencies[i].push_back(
+                        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+                } catch (const std::exception&) {
+                    failures++;
+                }
+            }
+        });
+    }
+    auto start = std::chrono::steady_clock::now();
+    go = true;
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::vector<double> all;
+    for (const auto& perClient : latencies) {
+        all.insert(all.end(), perClient.begin(), perClient.end());
+    }
+    std::sort(all.begin(), all.end());
+    LoadResult result;
+    result.requests = all.size();
+    result.failures = failures;
+    result.requestsPerSecond = all.size() / seconds;
+    if (!all.empty()) {
+        result.p50Ms = all[all.size() / 2];
+        result.p99Ms = all[std::min(all.size() - 1, all.size() * 99 / 100)];
+        result.maxMs = all.back();
+    }
+    return result;
+}
+
+static void report(const std::string& label, int clients, const LoadResult& result) {
+    std::cout << "  [BENCH] " << std::left << std::setw(22) << label << std::right << std::setw(3) << clients
+              << " clientes: " << std::fixed << std::setprecision(0) << std::setw(6) << result.requestsPerSecond
+              << " pedidos/s, p50 " << std::setprecision(2) << result.p50Ms << " ms, p99 " << result.p99Ms
+              << " ms, máx " << result.maxMs << " ms (" << result.failures << " fallidos)" << std::endl;
+}
+
+TEST_SUITE("Carga concurrente del servidor XML-RPC") {
+
+    TEST_CASE("robot.getStatus con 1, 8 y 64 clientes, con la configuración del servidor y la de Abyss por defecto") {
+        RobotNamespace::Robot robot; // Sin conectar: getStatus lee la muestra en memoria.
+        robot.setStatusPollInterval(0);
+        unsigned int port = 20000 + getpid() % 20000;
+
+        RpcServerConfig tuned; // La de mainServer sin opciones.
+        tuned.port = port;
+        {
+            RunningServer server(tuned, robot);
+            for (int clients : {1, 8, 64}) {
+                LoadResult result = runLoad(port, clients, std::chrono::milliseconds(1000));
+                report("configurado", clients, result);
+                CHECK(result.failures == 0);
+                CHECK(result.requests > 0);
+                if (clients == 64) {
+                    CHECK(result.p99Ms < 100.0); // Cada cliente tiene su hilo: nadie espera un lugar.
+                }
+            }
+        }
+
+        // Valores por defecto de Abyss: 15 conexiones, backlog 15 y 30 pedidos por conexión.
+        // Con 64 clientes, los que no entran esperan a que alguna conexión se cierre.
+        RpcServerConfig defaults;
+        defaults.port = port + 1;
+        defaults.workers = 15;
+        defaults.backlog = 15;
+        defaults.keepaliveRequests = 30;
+        RunningServer server(defaults, robot);
+        LoadResult result = runLoad(defaults.port, 64, std::chrono::milliseconds(1000));
+        report("Abyss por defecto", 64, result);
+        CHECK(result.requests > 0);
+    }
+
+    TEST_CASE("waitForChange despierta a 8 clientes que esperan el mismo cambio") {
+        RobotNamespace::Robot robot; // Sin conectar: el estado cambia con setRobotStatus().
+        robot.setStatusPollInterval(0);
+        RobotStatus initial = robot.getRobotStatus();
+        using Clock = std::chrono::steady_clock;
+
+        const int clients = 8;
+        std::vector<std::thread> waiters;
+        std::vector<Clock::time_point> wokeAt(clients);
+        for (int i = 0; i < clients; ++i) {
+            waiters.emplace_back([&, i] {
+                robot.waitForChange(initial.version, 5000);
+                wokeAt[i] = Clock::now();
+            });
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        RobotStatus moving = initial;
+        moving.activityState = "MOVIENDO";
+        auto changedAt = Clock::now();
+        robot.setRobotStatus(moving);
+        for (auto& waiter : waiters) {
+            waiter.join();
+        }
+
+        double worstMs = 0;
+        for (const auto& woke : wokeAt) {
+            worstMs = std::max(worstMs, std::chrono::duration<double, std::milli>(woke - changedAt).count());
+        }
+        std::cout << "  [BENCH] waitForChange: " << clients << " clientes notificados en " << worstMs << " ms" << std::endl;
+        CHECK(worstMs < 10.0);
+    }
+}
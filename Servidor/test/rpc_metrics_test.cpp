@@ -0,0 +1,143 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+#include "RpcServiceHandler.h"
+#include "AuthenticationService.h"
+#include "DatabaseManager.h"
+#include "SessionManager.h"
+#include "RobotRegistry.h"
+#include "TaskManager.h"
+#include <xmlrpc-c/base.hpp>
+#include <xmlrpc-c/registry.hpp>
+#include <xmlrpc-c/xml.hpp>
+#include <cstdio>
+#include <map>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+// Servidor RPC sin HTTP: los pedidos se pasan como XML directamente al registro.
+struct InProcessServer {
+    std::string dbPath = "/tmp/rpc_metrics_test_" + std::to_string(getpid()) + ".db";
+    DatabaseManagerNamespace::DatabaseManager db{dbPath};
+    SessionManager sessions;
+    AuthenticationServiceNamespace::AuthenticationService auth{db, sessions};
+    RobotNamespace::RobotRegistry robots;
+    TaskManager tasks{"/tmp/rpc_metrics_test_tasks.json"};
+    RpcServiceHandlerNamespace::RpcServiceHandler handler{auth, robots, tasks};
+    xmlrpc_c::registry registry;
+
+    InProcessServer() {
+        robots.add(RobotNamespace::RobotRegistry::DEFAULT_ROBOT_ID, "");
+        robots.setStatusPollInterval(0);
+        handler.registerMethods(registry);
+    }
+
+    ~InProcessServer() {
+        std::remove(dbPath.c_str());
+    }
+
+    /// @brief Ejecuta el método; devuelve false si respondió con un fault.
+    bool call(const std::string& method, const xmlrpc_c::paramList& params, xmlrpc_c::value* result = nullptr) {
+        std::string callXml, responseXml;
+        xmlrpc_c::xml::generateCall(method, params, &callXml);
+        registry.processCall(callXml, &responseXml);
+        xmlrpc_c::rpcOutcome outcome;
+        xmlrpc_c::xml::parseResponse(responseXml, &outcome);
+        if (outcome.succeeded() && result) {
+            *result = outcome.getResult();
+        }
+        return outcome.succeeded();
+    }
+};
+
+static bool contains(const std::string& text, const std::string& line) {
+    return text.find(line + "\n") != std::string::npos;
+}
+
+TEST_SUITE("Métricas RPC") {
+
+    TEST_CASE("Cuenta llamadas, errores por tipo de excepción y duración de cada método") {
+        InProcessServer server;
+
+        xmlrpc_c::paramList badLogin;
+        badLogin.add(xmlrpc_c::value_string("principalAdmin"));
+        badLogin.add(xmlrpc_c::value_string("incorrecta"));
+        CHECK_FALSE(server.call("user.login", badLogin));
+
+        xmlrpc_c::paramList login;
+        login.add(xmlrpc_c::value_string("principalAdmin"));
+        login.add(xmlrpc_c::value_string("1234"));
+        xmlrpc_c::value session;
+        REQUIRE(server.call("user.login", login, &session));
+        xmlrpc_c::value_string const token(xmlrpc_c::value_struct(session).cvalue().at("token"));
+
+        xmlrpc_c::paramList status;
+        status.add(token);
+        CHECK(server.call("robot.getStatus", status));
+
+        // Sin robot conectado: RobotException, que el cliente sigue recibiendo como fault.
+        xmlrpc_c::paramList move;
+        move.add(token);
+        for (double coordinate : {10.0, 20.0, 30.0, 5.0}) {
+            move.add(xmlrpc_c::value_double(coordinate));
+        }
+        CHECK_FALSE(server.call("robot.move", move));
+
+        xmlrpc_c::paramList wrongType;
+        wrongType.add(token);
+        wrongType.add(xmlrpc_c::value_double(1.5)); // Un string al final se tomaría como id de robot.
+        CHECK_FALSE(server.call("robot.getStatus", wrongType));
+
+        std::string const metrics = server.handler.getMetrics().render();
+        CHECK(contains(metrics, "rpc_requests_total{method=\"user.login\"} 2"));
+        CHECK(contains(metrics, "rpc_errors_total{method=\"user.login\",exception=\"InvalidCredentialsException\"} 1"));
+        CHECK(contains(metrics, "rpc_requests_total{method=\"robot.move\"} 1"));
+        CHECK(contains(metrics, "rpc_errors_total{method=\"robot.move\",exception=\"RobotException\"} 1"));
+        CHECK(contains(metrics, "rpc_errors_total{method=\"robot.getStatus\",exception=\"fault\"} 1"));
+        CHECK(contains(metrics, "rpc_request_duration_seconds_count{method=\"robot.getStatus\"} 2"));
+        CHECK(contains(metrics, "rpc_request_duration_seconds_bucket{method=\"robot.getStatus\",le=\"+Inf\"} 2"));
+        CHECK(contains(metrics, "rpc_requests_in_flight{method=\"robot.getStatus\"} 0"));
+        // Los métodos sin llamadas aparecen en cero, sin series de error.
+        CHECK(contains(metrics, "rpc_requests_total{method=\"robot.listTasks\"} 0"));
+        CHECK(metrics.find("rpc_errors_total{method=\"robot.listTasks\"") == std::string::npos);
+    }
+
+    TEST_CASE("Los comandos de robot.batch cuentan en su propio método") {
+        InProcessServer server;
+
+        xmlrpc_c::paramList login;
+        login.add(xmlrpc_c::value_string("principalAdmin"));
+        login.add(xmlrpc_c::value_string("1234"));
+        xmlrpc_c::value session;
+        REQUIRE(server.call("user.login", login, &session));
+        xmlrpc_c::value_string const token(xmlrpc_c::value_struct(session).cvalue().at("token"));
+
+        auto command = [](const std::string& method, std::vector<xmlrpc_c::value> params) {
+            std::map<std::string, xmlrpc_c::value> item;
+            item["method"] = xmlrpc_c::value_string(method);
+            item["params"] = xmlrpc_c::value_array(params);
+            return xmlrpc_c::value_struct(item);
+        };
+        std::vector<xmlrpc_c::value> commands;
+        commands.push_back(command("robot.getStatus", {}));
+        commands.push_back(command("robot.getStatus", {}));
+        commands.push_back(command("robot.move", {xmlrpc_c::value_double(10.0), xmlrpc_c::value_double(20.0),
+                                                  xmlrpc_c::value_double(30.0), xmlrpc_c::value_double(5.0)}));
+        xmlrpc_c::paramList batch;
+        batch.add(token);
+        batch.add(xmlrpc_c::value_array(commands));
+        std::map<std::string, xmlrpc_c::value> options;
+        options["stopOnError"] = xmlrpc_c::value_boolean(false);
+        batch.add(xmlrpc_c::value_struct(options));
+        REQUIRE(server.call("robot.batch", batch));
+
+        std::string const metrics = server.handler.getMetrics().render();
+        CHECK(contains(metrics, "rpc_requests_total{method=\"robot.batch\"} 1"));
+        CHECK(metrics.find("rpc_errors_total{method=\"robot.batch\"") == std::string::npos);
+        CHECK(contains(metrics, "rpc_requests_total{method=\"robot.getStatus\"} 2"));
+        CHECK(contains(metrics, "rpc_request_duration_seconds_count{method=\"robot.getStatus\"} 2"));
+        CHECK(contains(metrics, "rpc_requests_total{method=\"robot.move\"} 1"));
+        CHECK(contains(metrics, "rpc_errors_total{method=\"robot.move\",exception=\"RobotException\"} 1"));
+        CHECK(contains(metrics, "rpc_requests_in_flight{method=\"robot.move\"} 0"));
+    }
+}
@@ -0,0 +1,293 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+#include "SerialComunicator.h"
+#include "BinaryFraming.h"
+#include <iostream>
+#include <string>
+#include <thread>
+#include <atomic>
+#include <future>
+#include <vector>
+#include <chrono>
+#include <fcntl.h>   // para posix_openpt
+#include <poll.h>
+#include <unistd.h>
+
+// --- Firmware simulado sobre un pseudo-terminal ---
+// Lee comandos terminados en '\r' del lado maestro del pty y responde como el
+// firmware real: una línea INFO seguida de "OK". Opcionalmente, un comando tarda
+// en responder (como un G28 que todavía se está ejecutando).
+class FakeFirmware {
+public:
+    explicit FakeFirmware(const std::string& slowCommand = "", std::chrono::milliseconds slowDelay = {})
+        : slowCommand_(slowCommand), slowDelay_(slowDelay) {
+        masterFd_ = posix_openpt(O_RDWR | O_NOCTTY);
+        REQUIRE(masterFd_ != -1);
+        REQUIRE(grantpt(masterFd_) == 0);
+        REQUIRE(unlockpt(masterFd_) == 0);
+        slaveName_ = ptsname(masterFd_);
+        worker_ = std::thread([this] { run(); });
+    }
+
+    ~FakeFirmware() {
+        running_ = false;
+        worker_.join();
+        ::close(masterFd_);
+    }
+
+    const std::string& slaveName() const { return slaveName_; }
+
+private:
+    void run() {
+        std::string line;
+        char buffer[256];
+        while (running_) {
+            struct pollfd pfd = {masterFd_, POLLIN, 0};
+            if (poll(&pfd, 1, 20) <= 0 || !(pfd.revents & POLLIN)) {
+                continue;
+            }
+            ssize_t n = read(masterFd_, buffer, sizeof(buffer));
+            for (ssize_t i = 0; i < n; ++i) {
+                if (buffer[i] == '\r') {
+                    if (!slowCommand_.empty() && line == slowCommand_) {
+                        std::this_thread::sleep_for(slowDelay_);
+                    }
+                    std::string reply = "INFO: " + line + "\r\nOK\r\n";
+                    (void)!write(masterFd_, reply.c_str(), reply.size());
+                    line.clear();
+                } else if (buffer[i] != '\n') {
+                    line += buffer[i];
+                }
+            }
+        }
+    }
+
+    int masterFd_ = -1;
+    std::string slaveName_;
+    std::string slowCommand_;
+    std::chrono::milliseconds slowDelay_;
+    std::atomic<bool> running_{true};
+    std::thread worker_;
+};
+
+// --- Firmware con protocolo binario manejado paso a paso desde el test ---
+class ScriptedFirmware {
+public:
+    ScriptedFirmware() {
+        masterFd_ = posix_openpt(O_RDWR | O_NOCTTY);
+        REQUIRE(masterFd_ != -1);
+        REQUIRE(grantpt(masterFd_) == 0);
+        REQUIRE(unlockpt(masterFd_) == 0);
+        slaveName_ = ptsname(masterFd_);
+    }
+
+    ~ScriptedFirmware() {
+        ::close(masterFd_);
+    }
+
+    const std::string& slaveName() const { return slaveName_; }
+
+    void send(const std::string& data) {
+        (void)!write(masterFd_, data.data(), data.size());
+    }
+
+    /// @brief Espera hasta timeoutMs a que llegue el texto indicado.
+    bool expectText(const std::string& text, int timeoutMs) {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+        while (input_.find(text) == std::string::npos) {
+            if (!fill(deadline)) {
+                return false;
+            }
+        }
+        input_.clear();
+        return true;
+    }
+
+    /// @brief Espera hasta timeoutMs la próxima trama válida.
+    bool readFrame(ComunicatorPort::Framing::Frame& frame, int timeoutMs) {
+        using namespace ComunicatorPort::Framing;
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+        while (true) {
+            std::size_t start = input_.find(static_cast<char>(SOF));
+            input_.erase(0, start == std::string::npos ? input_.size() : start);
+            std::size_t size = 0;
+            DecodeStatus status = input_.empty() ? DecodeStatus::Incomplete : decodeFrame(input_, 0, frame, size);
+            if (status == DecodeStatus::Ok) {
+                input_.erase(0, size);
+                return true;
+            }
+            if (status == DecodeStatus::Corrupt) {
+                input_.erase(0, 1);
+            } else if (!fill(deadline)) {
+                return false;
+            }
+        }
+    }
+
+    /// @brief Descarta lo que llegue durante timeoutMs.
+    void drain(int timeoutMs) {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+        while (fill(deadline)) {
+        }
+        input_.clear();
+    }
+
+private:
+    bool fill(std::chrono::steady_clock::time_point deadline) {
+        auto left = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now()).count();
+        struct pollfd pfd = {masterFd_, POLLIN, 0};
+        if (left <= 0 || poll(&pfd, 1, static_cast<int>(left)) <= 0) {
+            return false;
+        }
+        char buffer[256];
+        ssize_t n = read(masterFd_, buffer, sizeof(buffer));
+        if (n > 0) {
+            input_.append(buffer, static_cast<std::size_t>(n));
+        }
+        return n > 0;
+    }
+
+    int masterFd_ = -1;
+    std::string slaveName_;
+    std::string input_;
+};
+
+// --- Benchmark de ida y vuelta por comando ---
+TEST_SUITE("SerialComunicator Latency Benchmark") {
+
+    TEST_CASE("Round-trip por comando contra un pty en loopback") {
+        FakeFirmware firmware;
+        ComunicatorPort::SerialComunicator serial;
+        serial.config(firmware.slaveName(), 115200);
+
+        const char* commands[] = {"M17", "M3", "M5", "G90", "M18"};
+        const int iterations = 200;
+
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; ++i) {
+            std::string command = std::string(commands[i % 5]) + "\r\n";
+            serial.sendMessage(command);
+            std::string response = serial.reciveMessage(2);
+            REQUIRE(response.find("OK") != std::string::npos);
+        }
+        auto elapsed = std::chrono::steady_clock::now() - start;
+
+        double averageMs = std::chrono::duration<double, std::milli>(elapsed).count() / iterations;
+        std::cout << "  [BENCH] " << iterations << " comandos, promedio por ida y vuelta: "
+                  << averageMs << " ms" << std::endl;
+        std::cout << "  [BENCH] Implementación anterior: >= 4000 ms por comando "
+                  << "(ventana de lectura de 2 s + espera fija de 2 s)." << std::endl;
+
+        CHECK(averageMs < 10.0);
+        serial.close();
+    }
+
+    TEST_CASE("Las líneas parciales se conservan entre llamadas") {
+        FakeFirmware firmware;
+        ComunicatorPort::SerialComunicator serial;
+        serial.config(firmware.slaveName(), 115200);
+
+        // Dos comandos seguidos: la segunda respuesta queda pendiente tras la primera lectura.
+        serial.sendMessage("M17\r\nM18\r\n");
+        std::string first = serial.reciveMessage(2);
+        std::string second = serial.reciveMessage(2);
+
+        CHECK(first.find("INFO: M17") != std::string::npos);
+        CHECK(first.find("M18") == std::string::npos);
+        CHECK(second.find("INFO: M18") != std::string::npos);
+        CHECK(second.find("OK") != std::string::npos);
+        serial.close();
+    }
+
+    TEST_CASE("submit() desde varios hilos no intercala comandos") {
+        FakeFirmware firmware;
+        ComunicatorPort::SerialComunicator serial;
+        serial.config(firmware.slaveName(), 115200);
+
+        const int threads = 8;
+        const int perThread = 50;
+        std::atomic<int> mismatches{0};
+
+        auto start = std::chrono::steady_clock::now();
+        std::vector<std::thread> workers;
+        for (int t = 0; t < threads; ++t) {
+            workers.emplace_back([&, t] {
+                for (int i = 0; i < perThread; ++i) {
+                    std::string command = "G1 X" + std::to_string(t) + " Y" + std::to_string(i);
+                    ComunicatorPort::SerialReply reply = serial.submit(command + "\r\n").get();
+                    std::string expected = "INFO: " + command;
+                    // La primera línea de la respuesta debe ser exactamente la de este comando.
+                    if (!reply.complete || reply.text.compare(0, expected.size(), expected) != 0 ||
+                        reply.text.find_first_of("\r\n") != expected.size()) {
+                        mismatches++;
+                    }
+                }
+            });
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        auto elapsed = std::chrono::steady_clock::now() - start;
+
+        std::cout << "  [BENCH] " << threads * perThread << " comandos desde " << threads
+                  << " hilos en " << std::chrono::duration<double, std::milli>(elapsed).count()
+                  << " ms" << std::endl;
+        CHECK(mismatches == 0);
+        serial.close();
+    }
+
+    TEST_CASE("La respuesta tardía de un pedido vencido no se le atribuye al siguiente") {
+        FakeFirmware firmware("G28", std::chrono::milliseconds(1500));
+        ComunicatorPort::SerialComunicator serial;
+        serial.config(firmware.slaveName(), 115200);
+
+        std::future<ComunicatorPort::SerialReply> homing = serial.submit("G28\r\n", 1);
+        ComunicatorPort::SerialReply expired = homing.get();
+        CHECK_FALSE(expired.complete);
+
+        // El "OK" del G28 llega después de vencido: el M17 debe recibir el suyo.
+        ComunicatorPort::SerialReply next = serial.submit("M17\r\n", 2).get();
+        CHECK(next.complete);
+        CHECK(next.text.find("INFO: M17") != std::string::npos);
+        CHECK(next.text.find("G28") == std::string::npos);
+        serial.close();
+    }
+
+    TEST_CASE("Un NAK para una trama vencida la reenvía y su ACK tardío se descarta") {
+        using namespace ComunicatorPort::Framing;
+        ScriptedFirmware firmware;
+        ComunicatorPort::SerialComunicator serial;
+        serial.config(firmware.slaveName(), 115200);
+
+        std::future<bool> framing = std::async(std::launch::async, [&serial] { return serial.enableBinaryFraming(2); });
+        REQUIRE(firmware.expectText("M900", 1000));
+        firmware.send(std::string("INFO: ") + NEGOTIATE_REPLY + "\r\nOK\r\n");
+        REQUIRE(framing.get());
+
+        // El firmware no contesta el M17 y el pedido vence.
+        std::future<ComunicatorPort::SerialReply> motorsOn = serial.submit("M17\r\n", 1);
+        Frame frame;
+        REQUIRE(firmware.readFrame(frame, 1000));
+        CHECK(frame.seq == 0);
+        CHECK_FALSE(motorsOn.get().complete);
+        firmware.drain(100); // El reenvío por silencio, que coincide con el vencimiento.
+
+        // Recién ahora pide la secuencia 0: la trama tiene que volver a salir.
+        firmware.send(buildFrame(NAK, 0, std::string(1, '\0')));
+        REQUIRE(firmware.readFrame(frame, 500));
+        CHECK(frame.type == MOTORS);
+        CHECK(frame.seq == 0);
+
+        // Su ACK tardío no se le atribuye al comando siguiente.
+        firmware.send("INFO: MOTORS ON\r\n" + buildFrame(ACK, 0, std::string(1, '\0')));
+        std::future<ComunicatorPort::SerialReply> motorsOff = serial.submit("M18\r\n", 2);
+        REQUIRE(firmware.readFrame(frame, 1000));
+        CHECK(frame.seq == 1);
+        firmware.send("INFO: MOTORS OFF\r\n" + buildFrame(ACK, 1, std::string(1, '\0')));
+        ComunicatorPort::SerialReply reply = motorsOff.get();
+        CHECK(reply.complete);
+        CHECK(reply.text.find("MOTORS OFF") != std::string::npos);
+        CHECK(reply.text.find("MOTORS ON") == std::string::npos);
+        serial.close();
+    }
+}
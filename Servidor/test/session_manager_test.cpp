@@ -0,0 +1,106 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+#include "SessionManager.h"
+#include <atomic>
+#include <chrono>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono_literals;
+
+static UserNamespace::User operatorUser(int id) {
+    return UserNamespace::User(id, "operador" + std::to_string(id), "$2b$10$hash", UserRole::OPERATOR);
+}
+
+TEST_SUITE("SessionManager") {
+
+    TEST_CASE("Valida, comparte el usuario sin copiarlo y cierra sesiones") {
+        SessionManager sessions;
+        std::string const token = sessions.createSession(operatorUser(1), "10.0.0.1");
+        CHECK(token.size() == 32);
+
+        auto first = sessions.getUserByToken(token);
+        auto second = sessions.getUserByToken(token);
+        REQUIRE(first);
+        CHECK(first.get() == second.get()); // El mismo objeto, no una copia por pedido.
+        CHECK(first->getUsername() == "operador1");
+        CHECK(first->getRole() == UserRole::OPERATOR);
+
+        auto active = sessions.getActiveSessions();
+        REQUIRE(active.count(token) == 1);
+        CHECK(active.at(token).second == "10.0.0.1");
+
+        sessions.endSession(token);
+        CHECK_FALSE(sessions.getUserByToken(token));
+        CHECK(first->getUsername() == "operador1"); // Quien ya lo tenía lo sigue usando.
+        CHECK_FALSE(sessions.getUserByToken("no-existe"));
+
+        std::set<std::string> tokens;
+        for (int i = 0; i < 1000; ++i) {
+            tokens.insert(sessions.createSession(operatorUser(i), ""));
+        }
+        CHECK(tokens.size() == 1000);
+        CHECK(sessions.size() == 1000);
+    }
+
+    TEST_CASE("Vence por inactividad, se renueva con el uso y vence igual al pasar el máximo") {
+        SUBCASE("Inactividad") {
+            SessionManager sessions(2s, 0s);
+            std::string const token = sessions.createSession(operatorUser(1), "");
+            std::this_thread::sleep_for(1100ms);
+            CHECK(sessions.getUserByToken(token)); // Renueva el plazo.
+            std::this_thread::sleep_for(1100ms);
+            CHECK(sessions.getUserByToken(token));
+            std::this_thread::sleep_for(2100ms);
+            CHECK_FALSE(sessions.getUserByToken(token));
+            // La rueda tiene ranuras de un segundo: el borrado llega a más tardar un segundo después.
+            std::this_thread::sleep_for(1100ms);
+            sessions.sweepExpired();
+            CHECK(sessions.size() == 0);
+        }
+
+        SUBCASE("Máximo desde el login") {
+            SessionManager sessions(0s, 1s);
+            std::string const token = sessions.createSession(operatorUser(1), "");
+            CHECK(sessions.getUserByToken(token));
+            std::this_thread::sleep_for(1100ms);
+            CHECK_FALSE(sessions.getUserByToken(token));
+            CHECK(sessions.getActiveSessions().empty());
+            // El hilo propio la borra sin que nadie llame a sweepExpired().
+            std::this_thread::sleep_for(1500ms);
+            CHECK(sessions.size() == 0);
+        }
+    }
+
+    TEST_CASE("Lecturas desde varios hilos mientras otros abren y cierran sesiones") {
+        SessionManager sessions;
+        std::vector<std::string> tokens;
+        for (int i = 0; i < 64; ++i) {
+            tokens.push_back(sessions.createSession(operatorUser(i), ""));
+        }
+
+        std::atomic<int> misses{0};
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 4; ++t) {
+            threads.emplace_back([&, t] {
+                for (int i = 0; i < 50000; ++i) {
+                    if (!sessions.getUserByToken(tokens[(i + t) % tokens.size()])) {
+                        misses++;
+                    }
+                }
+            });
+        }
+        threads.emplace_back([&] {
+            for (int i = 0; i < 1000; ++i) {
+                sessions.endSession(sessions.createSession(operatorUser(1000 + i), ""));
+            }
+        });
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        CHECK(misses == 0);
+        CHECK(sessions.size() == tokens.size());
+    }
+}
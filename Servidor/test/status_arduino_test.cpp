@@ -5,6 +5,10 @@
 #include "ServiceLocator.h"      // Incluimos el Service Locator
 #include <iostream>
 #include <iomanip>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
 
 // --- Mock del Comunicador Serie ---
 // Esta clase simula el comportamiento de SerialComunicator para las pruebas
@@ -80,4 +84,51 @@ TEST_SUITE("Robot Status Parsing") {
         // Desconectamos para limpiar.
         robot.disconnect();
     }
+
+    TEST_CASE("waitForChange despierta a los que esperan apenas cambia el estado") {
+        RobotNamespace::Robot robot; // Sin conectar: el estado cambia con setRobotStatus().
+        robot.setStatusPollInterval(0);
+        RobotStatus initial = robot.getRobotStatus();
+        using Clock = std::chrono::steady_clock;
+
+        // Sin cambios, vence el plazo y la versión es la misma.
+        auto start = Clock::now();
+        CHECK(robot.waitForChange(initial.version, 100).version == initial.version);
+        CHECK(Clock::now() - start >= std::chrono::milliseconds(100));
+
+        // Varios clientes esperando el próximo cambio.
+        const int clients = 8;
+        std::vector<std::thread> waiters;
+        std::vector<RobotStatus> seen(clients);
+        std::vector<Clock::time_point> wokeAt(clients);
+        for (int i = 0; i < clients; ++i) {
+            waiters.emplace_back([&, i] {
+                seen[i] = robot.waitForChange(initial.version, 5000);
+                wokeAt[i] = Clock::now();
+            });
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        RobotStatus moving = initial;
+        moving.activityState = "MOVIENDO";
+        auto changedAt = Clock::now();
+        robot.setRobotStatus(moving);
+        for (auto& waiter : waiters) {
+            waiter.join();
+        }
+
+        // Todos despertaron por el cambio y no por el plazo: ven la versión nueva con su estado.
+        // El tiempo solo se informa; el límite de latencia está en bench_rpc_load.
+        double worstMs = 0;
+        for (int i = 0; i < clients; ++i) {
+            CHECK(seen[i].version == initial.version + 1);
+            CHECK(seen[i].activityState == "MOVIENDO");
+            worstMs = std::max(worstMs, std::chrono::duration<double, std::milli>(wokeAt[i] - changedAt).count());
+        }
+        std::cout << "  [BENCH] waitForChange: " << clients << " clientes notificados en " << worstMs << " ms" << std::endl;
+
+        // Con una versión vieja vuelve enseguida; publicar lo mismo no cuenta como cambio.
+        CHECK(robot.waitForChange(initial.version, 5000).activityState == "MOVIENDO");
+        robot.setRobotStatus(moving);
+        CHECK(robot.getRobotStatus().version == initial.version + 1);
+    }
 }
\ No newline at end of file
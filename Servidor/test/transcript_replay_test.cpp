@@ -0,0 +1,123 @@
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include "doctest.h"
+#include "TranscriptCommunicator.h"
+#include <iostream>
+#include <string>
+#include <thread>
+#include <chrono>
+#include <cstdio>
+
+// --- Firmware simulado ---
+// Responde a cada comando tras un retardo fijo, como lo haría el Arduino.
+class DelayedMockCommunicator : public ComunicatorPort::ISerialCommunicator {
+public:
+    void config(const std::string& port, int speed) override {
+        (void)port; (void)speed;
+        is_configured = true;
+    }
+    std::string sendMessage(const std::string& message) override {
+        last_message_sent = message;
+        return "OK";
+    }
+    std::string reciveMessage(int time) override {
+        (void)time;
+        std::this_thread::sleep_for(std::chrono::milliseconds(REPLY_DELAY_MS));
+        if (last_message_sent == "M114\r\n") {
+            return "INFO: ABSOLUTE MODE\r\n"
+                   "INFO: CURRENT POSITION: [X:30.00 Y:40.00 Z:100.00 E:0.00]\r\n"
+                   "OK\r\n";
+        }
+        return "INFO: " + last_message_sent.substr(0, last_message_sent.find('\r')) + "\r\nOK\r\n";
+    }
+    void cleanBuffer() override {}
+    void close() override { is_configured = false; }
+    bool isConfigured() const override { return is_configured; }
+
+    static constexpr int REPLY_DELAY_MS = 40;
+
+private:
+    bool is_configured = false;
+    std::string last_message_sent;
+};
+
+static double elapsedMs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+TEST_SUITE("Transcript Record/Replay") {
+
+    const char* path = "transcript_replay_test.bin";
+    const char* commands[] = {"M17\r\n", "M114\r\n", "G1 X10 Y20 Z30 E0\r\n", "M18\r\n"};
+
+    TEST_CASE("Grabar y reproducir devuelve las mismas respuestas") {
+        std::vector<std::string> recorded;
+        {
+            DelayedMockCommunicator firmware;
+            ComunicatorPort::RecordingSerialCommunicator recorder(firmware, path);
+            recorder.config("/dev/ttyUSB0", 115200);
+            for (const char* command : commands) {
+                recorded.push_back(recorder.submit(command).get().text);
+            }
+            recorder.close();
+        }
+
+        std::vector<ComunicatorPort::Transcript::Record> records = ComunicatorPort::Transcript::load(path);
+        REQUIRE(records.size() == 8);
+        CHECK(records[0].direction == ComunicatorPort::Transcript::Direction::ToFirmware);
+        CHECK(records[0].bytes == "M17\r\n");
+        CHECK(records[1].direction == ComunicatorPort::Transcript::Direction::FromFirmware);
+        CHECK(records[1].exchangeId == records[0].exchangeId);
+        CHECK(records[1].timestampNs - records[0].timestampNs >= DelayedMockCommunicator::REPLY_DELAY_MS * 1000000ull);
+
+        // A velocidad original cada respuesta respeta el retardo grabado.
+        ComunicatorPort::ReplaySerialCommunicator replay(path);
+        replay.config("/dev/ttyUSB0", 115200);
+        auto start = std::chrono::steady_clock::now();
+        for (std::size_t i = 0; i < recorded.size(); ++i) {
+            ComunicatorPort::SerialReply reply = replay.submit(commands[i]).get();
+            CHECK(reply.text == recorded[i]);
+            CHECK(reply.complete);
+        }
+        double originalMs = elapsedMs(start);
+        CHECK(replay.finished());
+        CHECK(replay.mismatchCount() == 0);
+        CHECK(originalMs >= 4 * DelayedMockCommunicator::REPLY_DELAY_MS);
+
+        // A x10 la misma sesión tarda aproximadamente una décima parte.
+        ComunicatorPort::ReplaySerialCommunicator fastReplay(path, 10.0);
+        fastReplay.config("/dev/ttyUSB0", 115200);
+        start = std::chrono::steady_clock::now();
+        for (const char* command : commands) {
+            fastReplay.submit(command).get();
+        }
+        double fastMs = elapsedMs(start);
+
+        std::cout << "  [BENCH] Reproducción x1: " << originalMs << " ms, x10: " << fastMs << " ms" << std::endl;
+        CHECK(fastMs < originalMs / 4);
+        std::remove(path);
+    }
+
+    TEST_CASE("Un comando distinto del grabado se cuenta como discrepancia") {
+        {
+            DelayedMockCommunicator firmware;
+            ComunicatorPort::RecordingSerialCommunicator recorder(firmware, path);
+            recorder.sendMessage("M17\r\n");
+            recorder.reciveMessage(2);
+        }
+
+        ComunicatorPort::ReplaySerialCommunicator replay(path, 100.0);
+        replay.sendMessage("M18\r\n");
+        CHECK(replay.reciveMessage(2).find("INFO: M17") != std::string::npos);
+        CHECK(replay.mismatchCount() == 1);
+        std::remove(path);
+    }
+
+    TEST_CASE("Una transcripción inválida se rechaza") {
+        {
+            std::ofstream out(path, std::ios::binary);
+            out << "no es una transcripción";
+        }
+        CHECK_THROWS(ComunicatorPort::ReplaySerialCommunicator(path));
+        std::remove(path);
+    }
+}